@@ -35,6 +35,7 @@
 #include "binder/statement/create_statement.h"
 #include "binder/statement/index_statement.h"
 #include "binder/statement/select_statement.h"
+#include "binder/statement/vacuum_statement.h"
 #include "binder/table_ref/bound_base_table_ref.h"
 #include "binder/table_ref/bound_cross_product_ref.h"
 #include "binder/table_ref/bound_join_ref.h"
@@ -48,6 +49,7 @@
 #include "nodes/primnodes.hpp"
 #include "pg_definitions.hpp"
 #include "postgres_parser.hpp"
+#include "storage/page/pax_page.h"
 #include "type/type_id.h"
 
 namespace bustub {
@@ -92,8 +94,26 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
       case duckdb_libpgquery::T_PGColumnDef: {
         auto cdef = reinterpret_cast<duckdb_libpgquery::PGColumnDef *>(c->data.ptr_value);
         auto centry = BindColumnDefinition(cdef);
+        // `USING COMPRESSION dictionary` stores the values of a VARCHAR column as codes into a table dictionary.
+        bool dictionary_encoded = false;
         if (cdef->constraints != nullptr) {
-          throw NotImplementedException("constraints not supported");
+          for (auto cell = cdef->constraints->head; cell != nullptr; cell = lnext(cell)) {
+            auto constraint = reinterpret_cast<duckdb_libpgquery::PGConstraint *>(cell->data.ptr_value);
+            if (constraint->contype != duckdb_libpgquery::PG_CONSTR_COMPRESSION) {
+              throw NotImplementedException("constraints not supported");
+            }
+            auto compression = StringUtil::Lower(constraint->compression_name);
+            if (compression != "dictionary") {
+              throw NotImplementedException(fmt::format("compression {} not supported", compression));
+            }
+            if (centry.GetType() != TypeId::VARCHAR) {
+              throw bustub::Exception("only VARCHAR columns can be dictionary encoded");
+            }
+            dictionary_encoded = true;
+          }
+        }
+        if (dictionary_encoded) {
+          centry = Column(centry.GetName(), TypeId::VARCHAR, centry.GetVariableLength(), true);
         }
         columns.push_back(std::move(centry));
         column_count++;
@@ -112,7 +132,38 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
     throw bustub::Exception("should have at least 1 column");
   }
 
-  return std::make_unique<CreateStatement>(std::move(table), std::move(columns));
+  // `WITH (format = pax)` stores the table in PAX pages instead of row pages.
+  auto format = TableFormat::ROW;
+  if (pg_stmt->options != nullptr) {
+    for (auto cell = pg_stmt->options->head; cell != nullptr; cell = lnext(cell)) {
+      auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      if (StringUtil::Lower(option->defname) != "format" || option->arg == nullptr) {
+        throw NotImplementedException(fmt::format("table option {} not supported", option->defname));
+      }
+      // The value is a string when quoted, and a type name when it is a bare word.
+      std::string value;
+      if (option->arg->type == duckdb_libpgquery::T_PGString) {
+        value = reinterpret_cast<duckdb_libpgquery::PGValue *>(option->arg)->val.str;
+      } else if (option->arg->type == duckdb_libpgquery::T_PGTypeName) {
+        auto type_name = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(option->arg);
+        value = reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str;
+      }
+      value = StringUtil::Lower(value);
+      if (value == "row") {
+        format = TableFormat::ROW;
+      } else if (value == "pax") {
+        format = TableFormat::PAX;
+      } else {
+        throw NotImplementedException(fmt::format("table format {} not supported", value));
+      }
+    }
+  }
+
+  if (format == TableFormat::PAX && PaxLayout(Schema(columns)).GetCapacity() == 0) {
+    throw bustub::Exception("a row of this table does not fit in a PAX page");
+  }
+
+  return std::make_unique<CreateStatement>(std::move(table), std::move(columns), format);
 }
 
 auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<IndexStatement> {
@@ -129,7 +180,64 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  // `USING HASH` builds a hash index; the parser defaults the access method to "art", which means a B+ tree here.
+  auto index_type = IndexType::BPLUS_TREE;
+  if (stmt->accessMethod != nullptr) {
+    auto access_method = StringUtil::Lower(stmt->accessMethod);
+    if (access_method == "hash") {
+      index_type = IndexType::HASH;
+    } else if (access_method != "art" && access_method != "btree") {
+      throw NotImplementedException(fmt::format("index type {} not supported", access_method));
+    }
+  }
+
+  // `WITH (bloom_filter)` or `WITH (bloom_filter = true)` keeps a Bloom filter of the keys of a B+ tree index.
+  bool bloom_filter = false;
+  if (stmt->options != nullptr) {
+    for (auto cell = stmt->options->head; cell != nullptr; cell = lnext(cell)) {
+      auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      if (StringUtil::Lower(option->defname) != "bloom_filter") {
+        throw NotImplementedException(fmt::format("index option {} not supported", option->defname));
+      }
+      std::string value = "true";
+      if (option->arg != nullptr && option->arg->type == duckdb_libpgquery::T_PGString) {
+        value = StringUtil::Lower(reinterpret_cast<duckdb_libpgquery::PGValue *>(option->arg)->val.str);
+      } else if (option->arg != nullptr) {
+        value.clear();
+      }
+      if (value == "true" || value == "on") {
+        bloom_filter = true;
+      } else if (value == "false" || value == "off") {
+        bloom_filter = false;
+      } else {
+        throw NotImplementedException("bloom_filter must be true or false");
+      }
+    }
+  }
+  if (bloom_filter && index_type != IndexType::BPLUS_TREE) {
+    throw NotImplementedException("only B+ tree indexes support a bloom filter");
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), index_type,
+                                          bloom_filter);
+}
+
+auto Binder::BindVacuum(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<VacuumStatement> {
+  if ((stmt->options & duckdb_libpgquery::PG_VACOPT_ANALYZE) != 0) {
+    throw NotImplementedException("vacuum analyze is not supported");
+  }
+  if (stmt->va_cols != nullptr) {
+    throw NotImplementedException("vacuum works on whole tables, don't specify columns");
+  }
+  if (stmt->relation == nullptr) {
+    return std::make_unique<VacuumStatement>(nullptr);
+  }
+
+  auto table = BindBaseTableRef(stmt->relation->relname, std::nullopt);
+  if (StringUtil::StartsWith(table->table_, "__")) {
+    throw bustub::Exception(fmt::format("invalid table for vacuum: {}", table->table_));
+  }
+  return std::make_unique<VacuumStatement>(std::move(table));
 }
 
 }  // namespace bustub
@@ -9,6 +9,7 @@
 #include "binder/bound_table_ref.h"
 #include "binder/expressions/bound_column_ref.h"
 #include "binder/expressions/bound_constant.h"
+#include "binder/statement/copy_statement.h"
 #include "binder/statement/delete_statement.h"
 #include "binder/statement/insert_statement.h"
 #include "binder/statement/select_statement.h"
@@ -84,4 +85,62 @@ auto Binder::BindUpdate(duckdb_libpgquery::PGUpdateStmt *stmt) -> std::unique_pt
   return std::make_unique<UpdateStatement>(std::move(table), std::move(filter_expr), std::move(target_expr));
 }
 
+auto Binder::BindCopy(duckdb_libpgquery::PGCopyStmt *stmt) -> std::unique_ptr<CopyStatement> {
+  if (!stmt->is_from || stmt->relation == nullptr) {
+    throw NotImplementedException("only COPY table FROM file is supported");
+  }
+  if (stmt->is_program || stmt->filename == nullptr) {
+    throw NotImplementedException("copy only supports loading from a file");
+  }
+  if (stmt->attlist != nullptr) {
+    throw NotImplementedException("copy only supports all columns, don't specify columns");
+  }
+
+  auto table = BindBaseTableRef(stmt->relation->relname, std::nullopt);
+
+  if (StringUtil::StartsWith(table->table_, "__")) {
+    throw bustub::Exception(fmt::format("invalid table for copy: {}", table->table_));
+  }
+
+  std::string format = "csv";
+  std::optional<std::string> delimiter;
+  bool header = false;
+  if (stmt->options != nullptr) {
+    for (auto cell = stmt->options->head; cell != nullptr; cell = cell->next) {
+      auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      auto name = StringUtil::Lower(option->defname);
+      auto arg = reinterpret_cast<duckdb_libpgquery::PGValue *>(option->arg);
+      if (name == "format" && arg != nullptr && arg->type == duckdb_libpgquery::T_PGString) {
+        format = StringUtil::Lower(arg->val.str);
+      } else if (name == "delimiter" && arg != nullptr && arg->type == duckdb_libpgquery::T_PGString) {
+        delimiter = arg->val.str;
+      } else if (name == "header") {
+        // `HEADER` and `(HEADER)` come without an argument, `(HEADER false)` with a boolean string.
+        if (arg == nullptr) {
+          header = true;
+        } else if (arg->type == duckdb_libpgquery::T_PGInteger) {
+          header = arg->val.ival != 0;
+        } else {
+          auto value = StringUtil::Lower(arg->val.str);
+          header = value == "true" || value == "on" || value == "1";
+        }
+      } else {
+        throw NotImplementedException(fmt::format("copy option {} is not supported", name));
+      }
+    }
+  }
+
+  if (format != "csv" && format != "text") {
+    throw NotImplementedException(fmt::format("copy format {} is not supported", format));
+  }
+  if (!delimiter.has_value()) {
+    delimiter = format == "csv" ? "," : "\t";
+  }
+  if (delimiter->size() != 1) {
+    throw bustub::Exception("copy delimiter must be a single character");
+  }
+
+  return std::make_unique<CopyStatement>(std::move(table), stmt->filename, delimiter->front(), header);
+}
+
 }  // namespace bustub
@@ -310,6 +310,9 @@ auto Binder::BindRangeVar(duckdb_libpgquery::PGRangeVar *table_ref) -> std::uniq
     // Firstly, find the table in CTE list.
     for (const auto &cte : *cte_scope_) {
       if (cte->alias_ == table_ref->relname) {
+        if (table_ref->sample != nullptr) {
+          throw NotImplementedException("TABLESAMPLE is only supported on base tables");
+        }
         std::string bound_name;
         if (table_ref->alias != nullptr) {
           bound_name = table_ref->alias->aliasname;
@@ -320,10 +323,45 @@ auto Binder::BindRangeVar(duckdb_libpgquery::PGRangeVar *table_ref) -> std::uniq
       }
     }
   }
+  std::optional<std::string> alias;
   if (table_ref->alias != nullptr) {
-    return BindBaseTableRef(table_ref->relname, std::make_optional(table_ref->alias->aliasname));
+    alias = table_ref->alias->aliasname;
+  }
+  auto base_table_ref = BindBaseTableRef(table_ref->relname, std::move(alias));
+  if (table_ref->sample != nullptr) {
+    base_table_ref->sample_ =
+        BindTableSample(reinterpret_cast<duckdb_libpgquery::PGSampleOptions *>(table_ref->sample));
   }
-  return BindBaseTableRef(table_ref->relname, std::nullopt);
+  return base_table_ref;
+}
+
+auto Binder::BindTableSample(duckdb_libpgquery::PGSampleOptions *options) -> TableSample {
+  TableSample sample;
+  // As in Postgres, the size given to a sampling method is a percentage. Without a method, it must be written as one.
+  auto method = options->method == nullptr ? "system" : StringUtil::Lower(options->method);
+  if (method == "system") {
+    sample.method_ = TableSample::Method::SYSTEM;
+  } else if (method == "bernoulli") {
+    sample.method_ = TableSample::Method::BERNOULLI;
+  } else {
+    throw NotImplementedException(fmt::format("sampling method {} is not supported", method));
+  }
+  auto *size = reinterpret_cast<duckdb_libpgquery::PGSampleSize *>(options->sample_size);
+  if (options->method == nullptr && !size->is_percentage) {
+    throw NotImplementedException("sampling a number of rows is not supported");
+  }
+  if (size->sample_size.type == duckdb_libpgquery::T_PGInteger) {
+    sample.percentage_ = size->sample_size.val.ival;
+  } else {
+    sample.percentage_ = std::stod(size->sample_size.val.str);
+  }
+  if (sample.percentage_ < 0 || sample.percentage_ > 100) {
+    throw bustub::Exception(fmt::format("sample percentage must be between 0 and 100, got {}", sample.percentage_));
+  }
+  if (options->has_seed && options->seed >= 0) {
+    sample.seed_ = options->seed;
+  }
+  return sample;
 }
 
 auto Binder::BindTableRef(duckdb_libpgquery::PGNode *node) -> std::unique_ptr<BoundTableRef> {
@@ -718,6 +756,18 @@ auto Binder::BindAExpr(duckdb_libpgquery::PGAExpr *root) -> std::unique_ptr<Boun
   BUSTUB_ASSERT(root, "nullptr");
   auto name = std::string((reinterpret_cast<duckdb_libpgquery::PGValue *>(root->name->head->data.ptr_value))->val.str);
 
+  // `a BETWEEN b AND c` is bound as `a >= b and a <= c`, `a NOT BETWEEN b AND c` as `a < b or a > c`
+  if (root->kind == duckdb_libpgquery::PG_AEXPR_BETWEEN || root->kind == duckdb_libpgquery::PG_AEXPR_NOT_BETWEEN) {
+    auto bounds = BindExpressionList(reinterpret_cast<duckdb_libpgquery::PGList *>(root->rexpr));
+    BUSTUB_ASSERT(bounds.size() == 2, "BETWEEN should have two bounds");
+    bool negated = root->kind == duckdb_libpgquery::PG_AEXPR_NOT_BETWEEN;
+    auto lower =
+        std::make_unique<BoundBinaryOp>(negated ? "<" : ">=", BindExpression(root->lexpr), std::move(bounds[0]));
+    auto upper =
+        std::make_unique<BoundBinaryOp>(negated ? ">" : "<=", BindExpression(root->lexpr), std::move(bounds[1]));
+    return std::make_unique<BoundBinaryOp>(negated ? "or" : "and", std::move(lower), std::move(upper));
+  }
+
   if (root->kind != duckdb_libpgquery::PG_AEXPR_OP) {
     throw bustub::Exception("unsupported op in AExpr");
   }
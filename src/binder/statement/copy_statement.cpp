@@ -0,0 +1,19 @@
+#include "binder/statement/copy_statement.h"
+#include "fmt/core.h"
+
+namespace bustub {
+
+CopyStatement::CopyStatement(std::unique_ptr<BoundBaseTableRef> table, std::string file_name, char delimiter,
+                             bool header)
+    : BoundStatement(StatementType::COPY_STATEMENT),
+      table_(std::move(table)),
+      file_name_(std::move(file_name)),
+      delimiter_(delimiter),
+      header_(header) {}
+
+auto CopyStatement::ToString() const -> std::string {
+  return fmt::format("BoundCopy {{ table={}, file={}, delimiter='{}', header={} }}", *table_, file_name_, delimiter_,
+                     header_);
+}
+
+}  // namespace bustub
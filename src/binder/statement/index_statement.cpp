@@ -7,14 +7,24 @@
 namespace bustub {
 
 IndexStatement::IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                               std::vector<std::unique_ptr<BoundColumnRef>> cols)
+                               std::vector<std::unique_ptr<BoundColumnRef>> cols, IndexType index_type,
+                               bool bloom_filter)
     : BoundStatement(StatementType::INDEX_STATEMENT),
       index_name_(std::move(index_name)),
       table_(std::move(table)),
-      cols_(std::move(cols)) {}
+      cols_(std::move(cols)),
+      index_type_(index_type),
+      bloom_filter_(bloom_filter) {}
 
 auto IndexStatement::ToString() const -> std::string {
-  return fmt::format("BoundIndex {{ index_name={}, table={}, cols={} }}", index_name_, *table_, cols_);
+  std::string options;
+  if (index_type_ == IndexType::HASH) {
+    options += ", index_type=hash";
+  }
+  if (bloom_filter_) {
+    options += ", bloom_filter=true";
+  }
+  return fmt::format("BoundIndex {{ index_name={}, table={}, cols={}{} }}", index_name_, *table_, cols_, options);
 }
 
 }  // namespace bustub
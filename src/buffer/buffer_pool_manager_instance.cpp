@@ -12,6 +12,12 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <unordered_set>
+#include <vector>
+
 #include "common/exception.h"
 #include "common/macros.h"
 
@@ -30,6 +36,12 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManag
     free_list_.emplace_back(static_cast<int>(i));
   }
 
+  // Resume page allocation after the pages already in the database file, so that reopening a database does not hand
+  // out page ids that are still in use.
+  if (disk_manager_ != nullptr) {
+    next_page_id_ = disk_manager_->GetNumPages();
+  }
+
   // TODO(students): remove this line after you have implemented the buffer pool manager
   // throw NotImplementedException(
   //     "BufferPoolManager is not implemented yet. If you have finished implementing BPM, please remove the throw "
@@ -37,6 +49,13 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManag
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  if (dump_thread_ != nullptr) {
+    enable_dump_ = false;
+    dump_cv_.notify_all();
+    dump_thread_->join();
+    delete dump_thread_;
+    DumpResidentPages(dump_file_name_);
+  }
   delete[] pages_;
   delete page_table_;
   delete replacer_;
@@ -180,4 +199,154 @@ auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
 
 auto BufferPoolManagerInstance::AllocatePage() -> page_id_t { return next_page_id_++; }
 
+void BufferPoolManagerInstance::FlushPages(const std::vector<page_id_t> &page_ids) {
+  std::scoped_lock<std::mutex> lock(latch_);
+
+  std::vector<std::pair<page_id_t, frame_id_t>> resident;
+  resident.reserve(page_ids.size());
+  for (auto page_id : page_ids) {
+    frame_id_t frame_id;
+    if (page_table_->Find(page_id, frame_id)) {
+      resident.emplace_back(page_id, frame_id);
+    }
+  }
+  std::sort(resident.begin(), resident.end());
+
+  std::vector<const char *> run;
+  for (size_t begin = 0; begin < resident.size();) {
+    size_t end = begin;
+    run.clear();
+    while (end < resident.size() &&
+           resident[end].first == resident[begin].first + static_cast<page_id_t>(end - begin)) {
+      run.push_back(pages_[resident[end].second].GetData());
+      end++;
+    }
+    disk_manager_->WritePages(resident[begin].first, static_cast<int>(run.size()), run.data());
+    for (; begin < end; begin++) {
+      pages_[resident[begin].second].is_dirty_ = false;
+    }
+  }
+}
+
+void BufferPoolManagerInstance::DumpResidentPages(const std::string &file_name) {
+  std::vector<page_id_t> page_ids;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    for (auto frame_id : replacer_->GetFramesByRecency()) {
+      if (pages_[frame_id].page_id_ != INVALID_PAGE_ID) {
+        page_ids.push_back(pages_[frame_id].page_id_);
+      }
+    }
+  }
+
+  // Write a temporary file and rename it, so that a crash never leaves a partial list behind.
+  std::string tmp_file_name = file_name + ".tmp";
+  std::ofstream out(tmp_file_name, std::ios::binary | std::ios::trunc);
+  auto count = static_cast<uint32_t>(page_ids.size());
+  out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+  out.write(reinterpret_cast<const char *>(page_ids.data()), page_ids.size() * sizeof(page_id_t));
+  out.close();
+  if (out.fail() || std::rename(tmp_file_name.c_str(), file_name.c_str()) != 0) {
+    LOG_DEBUG("cannot write the buffer pool warm-up file");
+  }
+}
+
+auto BufferPoolManagerInstance::WarmUp(const std::string &file_name, size_t num_threads) -> size_t {
+  std::ifstream in(file_name, std::ios::binary);
+  uint32_t count = 0;
+  in.read(reinterpret_cast<char *>(&count), sizeof(count));
+  if (!in) {
+    return 0;
+  }
+  std::vector<page_id_t> page_ids(count);
+  in.read(reinterpret_cast<char *>(page_ids.data()), count * sizeof(page_id_t));
+  if (!in) {
+    return 0;
+  }
+
+  std::scoped_lock<std::mutex> lock(latch_);
+
+  // Load only as many of the hottest pages as the free frames hold. Pages that are not in the database file, e.g.
+  // because the file was deleted and created again, are skipped.
+  page_id_t num_pages = disk_manager_->GetNumPages();
+  std::vector<page_id_t> hot_pages;
+  std::unordered_set<page_id_t> seen;
+  frame_id_t frame_id;
+  for (auto page_id : page_ids) {
+    if (hot_pages.size() == free_list_.size()) {
+      break;
+    }
+    if (page_id < 0 || page_id >= num_pages || page_table_->Find(page_id, frame_id) || !seen.insert(page_id).second) {
+      continue;
+    }
+    hot_pages.push_back(page_id);
+  }
+
+  // Assign frames in page id order, and split the pages into runs of consecutive page ids, each read at once.
+  std::vector<page_id_t> sorted_pages(hot_pages);
+  std::sort(sorted_pages.begin(), sorted_pages.end());
+  std::unordered_map<page_id_t, frame_id_t> frames;
+  std::vector<char *> buffers;
+  buffers.reserve(sorted_pages.size());
+  for (auto page_id : sorted_pages) {
+    frame_id = free_list_.front();
+    free_list_.pop_front();
+    frames[page_id] = frame_id;
+    buffers.push_back(pages_[frame_id].data_);
+  }
+  std::vector<std::pair<size_t, size_t>> runs;
+  for (size_t i = 0; i < sorted_pages.size(); i++) {
+    if (runs.empty() || sorted_pages[i] != sorted_pages[i - 1] + 1) {
+      runs.emplace_back(i, 0);
+    }
+    runs.back().second++;
+  }
+
+  std::atomic<size_t> next_run{0};
+  auto read_runs = [&]() {
+    for (size_t run = next_run++; run < runs.size(); run = next_run++) {
+      auto [start, length] = runs[run];
+      disk_manager_->ReadPages(sorted_pages[start], static_cast<int>(length), &buffers[start]);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < std::min(num_threads, runs.size()); i++) {
+    threads.emplace_back(read_runs);
+  }
+  read_runs();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Record the accesses from the coldest page on, so that the hottest pages are evicted last.
+  for (auto it = hot_pages.rbegin(); it != hot_pages.rend(); ++it) {
+    frame_id = frames[*it];
+    pages_[frame_id].page_id_ = *it;
+    pages_[frame_id].pin_count_ = 0;
+    pages_[frame_id].is_dirty_ = false;
+    page_table_->Insert(*it, frame_id);
+    replacer_->RecordAccess(frame_id);
+    replacer_->SetEvictable(frame_id, true);
+  }
+
+  return hot_pages.size();
+}
+
+void BufferPoolManagerInstance::StartResidentPagesDump(const std::string &file_name) {
+  BUSTUB_ASSERT(dump_thread_ == nullptr, "the resident pages dump is already running");
+  dump_file_name_ = file_name;
+  enable_dump_ = true;
+  dump_thread_ = new std::thread(&BufferPoolManagerInstance::RunResidentPagesDump, this);
+}
+
+void BufferPoolManagerInstance::RunResidentPagesDump() {
+  std::unique_lock<std::mutex> lock(dump_latch_);
+  while (enable_dump_) {
+    if (dump_cv_.wait_for(lock, buffer_pool_dump_interval, [this] { return !enable_dump_; })) {
+      break;
+    }
+    DumpResidentPages(dump_file_name_);
+  }
+}
+
 }  // namespace bustub
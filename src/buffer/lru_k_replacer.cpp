@@ -12,6 +12,8 @@
 
 #include "buffer/lru_k_replacer.h"
 
+#include <algorithm>
+
 namespace bustub {
 
 LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
@@ -114,4 +116,32 @@ void LRUKReplacer::Remove(frame_id_t frame_id) {
 
 auto LRUKReplacer::Size() -> size_t { return curr_size_; }
 
+auto LRUKReplacer::GetFramesByRecency() -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+
+  // hist_[frame][0] is the time of the latest access, hist_[frame][k_ - 1] that of the k-th latest.
+  std::vector<std::pair<size_t, frame_id_t>> full_hist;
+  std::vector<std::pair<size_t, frame_id_t>> partial_hist;
+  for (auto frame_id : frames_in_buffer_) {
+    const auto &hist = hist_[frame_id];
+    if (hist.size() == k_) {
+      full_hist.emplace_back(hist[k_ - 1], frame_id);
+    } else if (!hist.empty()) {
+      partial_hist.emplace_back(hist[0], frame_id);
+    }
+  }
+  std::sort(full_hist.rbegin(), full_hist.rend());
+  std::sort(partial_hist.rbegin(), partial_hist.rend());
+
+  std::vector<frame_id_t> frames;
+  frames.reserve(full_hist.size() + partial_hist.size());
+  for (const auto &[timestamp, frame_id] : full_hist) {
+    frames.push_back(frame_id);
+  }
+  for (const auto &[timestamp, frame_id] : partial_hist) {
+    frames.push_back(frame_id);
+  }
+  return frames;
+}
+
 }  // namespace bustub
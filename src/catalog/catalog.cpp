@@ -0,0 +1,291 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// catalog.cpp
+//
+// Identification: src/catalog/catalog.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "catalog/catalog.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
+#include "storage/page/catalog_page.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+
+/*
+ * Catalog serialization format. All integers are 4 bytes, strings are a length followed by their bytes.
+ *
+ * | NextTableOid | NumTables | Table ... | NextIndexOid | NumIndexes | Index ... |
+ *
+ * Table: | Oid | Name | FirstPageId | Format | NumColumns | (ColumnName | TypeId | VariableLength) ... |
+ * Index: | Oid | Name | TableName | KeySize | IndexType | DirectoryPageId | BloomFilter | NumKeyAttrs | KeyAttr ... |
+ *
+ * DirectoryPageId is the directory page of a hash index, and INVALID_PAGE_ID for a B+ tree index, whose root is
+ * recorded in the header page under RootRecordName(Oid). BloomFilter is 1 if the index has a Bloom filter, which is
+ * built again on load.
+ */
+namespace {
+
+void WriteUint32(std::string *buf, uint32_t value) {
+  buf->append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void WriteString(std::string *buf, const std::string &value) {
+  WriteUint32(buf, static_cast<uint32_t>(value.size()));
+  buf->append(value);
+}
+
+auto ReadUint32(const char **cursor) -> uint32_t {
+  uint32_t value;
+  memcpy(&value, *cursor, sizeof(value));
+  *cursor += sizeof(value);
+  return value;
+}
+
+auto ReadString(const char **cursor) -> std::string {
+  auto size = ReadUint32(cursor);
+  std::string value(*cursor, size);
+  *cursor += size;
+  return value;
+}
+
+/** Reopen a persisted B+ tree index, with the key type and the comparator picked for its key schema on creation. */
+auto OpenBPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *bpm,
+                        const std::string &root_record_name, bool bloom_filter) -> std::unique_ptr<Index> {
+  const auto &key_schema = *metadata->GetKeySchema();
+  return VisitBPlusTreeIndexTypes(key_schema, [&](auto types) -> std::unique_ptr<Index> {
+    using Types = decltype(types);
+    auto index = std::make_unique<
+        BPlusTreeIndex<typename Types::KeyType, typename Types::ValueType, typename Types::KeyComparator>>(
+        std::move(metadata), bpm, root_record_name);
+    // An index that never had an entry has no root record yet, and stays empty.
+    index->LoadRootPageId();
+    if (bloom_filter) {
+      index->EnableBloomFilter();
+    }
+    return index;
+  });
+}
+
+/** Reopen a persisted hash index from its directory page. */
+auto OpenHashIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *bpm, page_id_t directory_page_id)
+    -> std::unique_ptr<Index> {
+  const auto &key_schema = *metadata->GetKeySchema();
+  return VisitBPlusTreeIndexTypes(key_schema, [&](auto types) -> std::unique_ptr<Index> {
+    using Types = decltype(types);
+    using KeyType = typename Types::KeyType;
+    using HashIndex = ExtendibleHashTableIndex<KeyType, typename Types::ValueType, typename Types::KeyComparator>;
+    return std::make_unique<HashIndex>(std::move(metadata), bpm, HashFunction<KeyType>{}, directory_page_id);
+  });
+}
+
+/** The directory page of a hash index, created with the key type and the comparator picked for its key schema. */
+auto HashIndexDirectoryPageId(Index *index) -> page_id_t {
+  return VisitBPlusTreeIndexTypes(*index->GetKeySchema(), [&](auto types) {
+    using Types = decltype(types);
+    using HashIndex =
+        ExtendibleHashTableIndex<typename Types::KeyType, typename Types::ValueType, typename Types::KeyComparator>;
+    return dynamic_cast<HashIndex &>(*index).GetDirectoryPageId();
+  });
+}
+
+}  // namespace
+
+void Catalog::Bootstrap(bool is_new_database) {
+  BUSTUB_ASSERT(bpm_ != nullptr, "a persistent catalog needs a buffer pool");
+  persistent_ = true;
+
+  if (is_new_database) {
+    page_id_t header_page_id;
+    auto *header_page = static_cast<HeaderPage *>(bpm_->NewPage(&header_page_id));
+    BUSTUB_ENSURE(header_page_id == HEADER_PAGE_ID, "the header page must be the first page of the database");
+    header_page->Init();
+    bpm_->UnpinPage(header_page_id, true);
+    return;
+  }
+
+  auto *header_page = static_cast<HeaderPage *>(bpm_->FetchPage(HEADER_PAGE_ID));
+  bool found = header_page->GetRootId(CATALOG_RECORD_NAME, &catalog_page_id_);
+  bpm_->UnpinPage(HEADER_PAGE_ID, false);
+  if (!found) {
+    catalog_page_id_ = INVALID_PAGE_ID;
+    return;
+  }
+
+  std::string data;
+  for (page_id_t page_id = catalog_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto *page = static_cast<CatalogPage *>(bpm_->FetchPage(page_id));
+    data.append(page->GetPayload(), page->GetDataSize());
+    page_id_t next_page_id = page->GetNextPageId();
+    bpm_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  LoadCatalog(data);
+}
+
+void Catalog::PersistCatalog() {
+  if (!persistent_) {
+    return;
+  }
+
+  // Tables without a table heap (mock tables) cannot be reopened, and cannot have indexes either.
+  std::string data;
+  WriteUint32(&data, next_table_oid_.load());
+  uint32_t num_tables = 0;
+  size_t num_tables_offset = data.size();
+  WriteUint32(&data, 0);
+  for (const auto &[oid, table] : tables_) {
+    if (table->table_ == nullptr) {
+      continue;
+    }
+    WriteUint32(&data, oid);
+    WriteString(&data, table->name_);
+    WriteUint32(&data, static_cast<uint32_t>(table->table_->GetFirstPageId()));
+    WriteUint32(&data, static_cast<uint32_t>(table->table_->GetFormat()));
+    auto *dictionary = table->table_->GetDictionary();
+    WriteUint32(&data, static_cast<uint32_t>(dictionary != nullptr ? dictionary->GetFirstPageId() : INVALID_PAGE_ID));
+    WriteUint32(&data, table->schema_.GetColumnCount());
+    for (const auto &column : table->schema_.GetColumns()) {
+      WriteString(&data, column.GetName());
+      WriteUint32(&data, static_cast<uint32_t>(column.GetType()));
+      WriteUint32(&data, column.GetVariableLength());
+      WriteUint32(&data, column.IsDictionaryEncoded() ? 1 : 0);
+    }
+    num_tables++;
+  }
+  memcpy(data.data() + num_tables_offset, &num_tables, sizeof(num_tables));
+
+  WriteUint32(&data, next_index_oid_.load());
+  WriteUint32(&data, static_cast<uint32_t>(indexes_.size()));
+  for (const auto &[oid, index] : indexes_) {
+    WriteUint32(&data, oid);
+    WriteString(&data, index->name_);
+    WriteString(&data, index->table_name_);
+    WriteUint32(&data, static_cast<uint32_t>(index->key_size_));
+    WriteUint32(&data, static_cast<uint32_t>(index->index_type_));
+    auto directory_page_id =
+        index->index_type_ == IndexType::HASH ? HashIndexDirectoryPageId(index->index_.get()) : INVALID_PAGE_ID;
+    WriteUint32(&data, static_cast<uint32_t>(directory_page_id));
+    WriteUint32(&data, index->index_->GetBloomFilterStats().has_value() ? 1 : 0);
+    const auto &key_attrs = index->index_->GetKeyAttrs();
+    WriteUint32(&data, static_cast<uint32_t>(key_attrs.size()));
+    for (auto key_attr : key_attrs) {
+      WriteUint32(&data, key_attr);
+    }
+  }
+
+  // Overwrite the existing chain in place, appending pages when the catalog has grown.
+  page_id_t page_id = catalog_page_id_;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  CatalogPage *prev_page = nullptr;
+  size_t offset = 0;
+  do {
+    CatalogPage *page;
+    if (page_id == INVALID_PAGE_ID) {
+      page = static_cast<CatalogPage *>(bpm_->NewPage(&page_id));
+      if (page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a catalog page");
+      }
+      page->Init();
+      if (prev_page == nullptr) {
+        catalog_page_id_ = page_id;
+        auto *header_page = static_cast<HeaderPage *>(bpm_->FetchPage(HEADER_PAGE_ID));
+        header_page->InsertRecord(CATALOG_RECORD_NAME, catalog_page_id_);
+        bpm_->UnpinPage(HEADER_PAGE_ID, true);
+      } else {
+        prev_page->SetNextPageId(page_id);
+      }
+    } else {
+      page = static_cast<CatalogPage *>(bpm_->FetchPage(page_id));
+    }
+
+    auto size = static_cast<uint32_t>(std::min<size_t>(CatalogPage::CAPACITY, data.size() - offset));
+    page->SetPayload(data.data() + offset, size);
+    offset += size;
+
+    if (prev_page != nullptr) {
+      bpm_->UnpinPage(prev_page_id, true);
+    }
+    prev_page = page;
+    prev_page_id = page_id;
+    page_id = page->GetNextPageId();
+  } while (offset < data.size());
+
+  // The catalog may have shrunk; the pages left over from a longer chain are simply dropped.
+  prev_page->SetNextPageId(INVALID_PAGE_ID);
+  bpm_->UnpinPage(prev_page_id, true);
+}
+
+void Catalog::LoadCatalog(const std::string &data) {
+  const char *cursor = data.data();
+
+  next_table_oid_ = ReadUint32(&cursor);
+  auto num_tables = ReadUint32(&cursor);
+  for (uint32_t i = 0; i < num_tables; i++) {
+    auto table_oid = ReadUint32(&cursor);
+    auto table_name = ReadString(&cursor);
+    auto first_page_id = static_cast<page_id_t>(ReadUint32(&cursor));
+    auto format = static_cast<TableFormat>(ReadUint32(&cursor));
+    auto dictionary_page_id = static_cast<page_id_t>(ReadUint32(&cursor));
+    auto num_columns = ReadUint32(&cursor);
+    std::vector<Column> columns;
+    columns.reserve(num_columns);
+    for (uint32_t j = 0; j < num_columns; j++) {
+      auto column_name = ReadString(&cursor);
+      auto type = static_cast<TypeId>(ReadUint32(&cursor));
+      auto variable_length = ReadUint32(&cursor);
+      auto dictionary_encoded = ReadUint32(&cursor) != 0;
+      if (type == TypeId::VARCHAR) {
+        columns.emplace_back(column_name, type, variable_length, dictionary_encoded);
+      } else {
+        columns.emplace_back(column_name, type);
+      }
+    }
+
+    Schema schema(columns);
+    auto table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, first_page_id, format, &schema,
+                                             dictionary_page_id);
+    tables_.emplace(table_oid, std::make_unique<TableInfo>(schema, table_name, std::move(table), table_oid));
+    table_names_.emplace(table_name, table_oid);
+    index_names_.emplace(table_name, std::unordered_map<std::string, index_oid_t>{});
+  }
+
+  next_index_oid_ = ReadUint32(&cursor);
+  auto num_indexes = ReadUint32(&cursor);
+  for (uint32_t i = 0; i < num_indexes; i++) {
+    auto index_oid = ReadUint32(&cursor);
+    auto index_name = ReadString(&cursor);
+    auto table_name = ReadString(&cursor);
+    size_t key_size = ReadUint32(&cursor);
+    auto index_type = static_cast<IndexType>(ReadUint32(&cursor));
+    auto directory_page_id = static_cast<page_id_t>(ReadUint32(&cursor));
+    auto bloom_filter = ReadUint32(&cursor) != 0;
+    auto num_key_attrs = ReadUint32(&cursor);
+    std::vector<uint32_t> key_attrs;
+    key_attrs.reserve(num_key_attrs);
+    for (uint32_t j = 0; j < num_key_attrs; j++) {
+      key_attrs.push_back(ReadUint32(&cursor));
+    }
+
+    const auto &schema = GetTable(table_name)->schema_;
+    auto key_schema = Schema::CopySchema(&schema, key_attrs);
+    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
+    auto index = index_type == IndexType::HASH
+                     ? OpenHashIndex(std::move(meta), bpm_, directory_page_id)
+                     : OpenBPlusTreeIndex(std::move(meta), bpm_, RootRecordName(index_oid), bloom_filter);
+    indexes_.emplace(index_oid, std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid,
+                                                            table_name, key_size, index_type));
+    index_names_[table_name].emplace(index_name, index_oid);
+  }
+}
+
+}  // namespace bustub
@@ -182,6 +182,10 @@ void TableGenerator::GenerateTestTables() {
     }
     Schema schema(cols);
     auto info = exec_ctx_->GetCatalog()->CreateTable(exec_ctx_->GetTransaction(), table_meta.name_, schema);
+    // The table was already generated and persisted by a previous run on the same database file.
+    if (info == Catalog::NULL_TABLE_INFO) {
+      continue;
+    }
     FillTable(info, &table_meta);
   }
 }
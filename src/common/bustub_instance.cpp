@@ -11,6 +11,7 @@
 #include "binder/statement/index_statement.h"
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
+#include "binder/statement/vacuum_statement.h"
 #include "buffer/buffer_pool_manager_instance.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
@@ -53,7 +54,11 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
   // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    auto *bpm = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    // Prefetch the pages that were hot when the database was last closed, and keep that list up to date.
+    bpm->WarmUp(db_file_name + ".warmup");
+    bpm->StartResidentPagesDump(db_file_name + ".warmup");
+    buffer_pool_manager_ = bpm;
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -66,11 +71,19 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   // Checkpoint related.
   checkpoint_manager_ = new CheckpointManager(txn_manager_, log_manager_, buffer_pool_manager_);
 
-  // Catalog.
+  // Catalog. Reopening an existing database file reloads the tables and indexes recorded by the previous run.
   catalog_ = new Catalog(buffer_pool_manager_, lock_manager_, log_manager_);
+  if (buffer_pool_manager_ != nullptr) {
+    catalog_->Bootstrap(disk_manager_->GetNumPages() == 0);
+  }
 
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
+
+  // Give the space of deleted tuples back to the tables of a long running database.
+  if (buffer_pool_manager_ != nullptr) {
+    StartBackgroundVacuum();
+  }
 }
 
 BustubInstance::BustubInstance() {
@@ -100,6 +113,9 @@ BustubInstance::BustubInstance() {
 
   // Catalog.
   catalog_ = new Catalog(buffer_pool_manager_, lock_manager_, log_manager_);
+  if (buffer_pool_manager_ != nullptr) {
+    catalog_->Bootstrap(true);
+  }
 
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
@@ -132,6 +148,7 @@ void BustubInstance::CmdDisplayIndices(ResultWriter &writer) {
   writer.WriteHeaderCell("index_oid");
   writer.WriteHeaderCell("index_name");
   writer.WriteHeaderCell("index_cols");
+  writer.WriteHeaderCell("bloom_filter");
   writer.EndHeader();
   for (const auto &table_name : table_names) {
     for (const auto *index_info : catalog_->GetTableIndexes(table_name)) {
@@ -140,6 +157,8 @@ void BustubInstance::CmdDisplayIndices(ResultWriter &writer) {
       writer.WriteCell(fmt::format("{}", index_info->index_oid_));
       writer.WriteCell(index_info->name_);
       writer.WriteCell(index_info->key_schema_.ToString());
+      auto bloom_filter_stats = index_info->index_->GetBloomFilterStats();
+      writer.WriteCell(bloom_filter_stats.has_value() ? bloom_filter_stats->ToString() : "");
       writer.EndRow();
     }
   }
@@ -212,7 +231,8 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         const auto &create_stmt = dynamic_cast<const CreateStatement &>(*statement);
 
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateTable(txn, create_stmt.table_, Schema(create_stmt.columns_));
+        auto info = catalog_->CreateTable(txn, create_stmt.table_, Schema(create_stmt.columns_), true,
+                                          create_stmt.format_);
         l.unlock();
 
         if (info == nullptr) {
@@ -224,23 +244,18 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       case StatementType::INDEX_STATEMENT: {
         const auto &index_stmt = dynamic_cast<const IndexStatement &>(*statement);
 
+        // The key type of the index is picked by the catalog, from the types and the width of the key columns.
         std::vector<uint32_t> col_ids;
         for (const auto &col : index_stmt.cols_) {
           auto idx = index_stmt.table_->schema_.GetColIdx(col->col_name_.back());
           col_ids.push_back(idx);
-          if (index_stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
-            throw NotImplementedException("only support creating index on integer column");
-          }
-        }
-        if (col_ids.size() != 1) {
-          throw NotImplementedException("only support creating index with exactly one column");
         }
         auto key_schema = Schema::CopySchema(&index_stmt.table_->schema_, col_ids);
 
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-            txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
-            INTEGER_SIZE, IntegerHashFunctionType{});
+        auto info = catalog_->CreateIndex(txn, index_stmt.index_name_, index_stmt.table_->table_,
+                                          index_stmt.table_->schema_, key_schema, col_ids, index_stmt.index_type_,
+                                          index_stmt.bloom_filter_);
         l.unlock();
 
         if (info == nullptr) {
@@ -249,6 +264,20 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         WriteOneCell(fmt::format("Index created with id = {}", info->index_oid_), writer);
         continue;
       }
+      case StatementType::VACUUM_STATEMENT: {
+        const auto &vacuum_stmt = dynamic_cast<const VacuumStatement &>(*statement);
+
+        std::vector<std::string> table_names;
+        if (vacuum_stmt.table_ != nullptr) {
+          table_names.push_back(vacuum_stmt.table_->table_);
+        } else {
+          std::shared_lock<std::shared_mutex> l(catalog_lock_);
+          table_names = catalog_->GetTableNames();
+        }
+        auto num_freed = VacuumTables(table_names, false);
+        WriteOneCell(fmt::format("Vacuum freed {} pages", num_freed), writer);
+        continue;
+      }
       case StatementType::VARIABLE_SHOW_STATEMENT: {
         const auto &show_stmt = dynamic_cast<const VariableShowStatement &>(*statement);
         auto content = GetSessionVariable(show_stmt.variable_);
@@ -288,7 +317,8 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         }
 
         // Print optimizer result.
-        bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
+        bustub::Optimizer optimizer(*catalog_, IsForceStarterRule(),
+                                    txn->GetIsolationLevel() == IsolationLevel::SNAPSHOT_ISOLATION);
         auto optimized_plan = optimizer.Optimize(planner.plan_);
 
         l.unlock();
@@ -315,7 +345,8 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
     planner.PlanQuery(*statement);
 
     // Optimize the query.
-    bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
+    bustub::Optimizer optimizer(*catalog_, IsForceStarterRule(),
+                                txn->GetIsolationLevel() == IsolationLevel::SNAPSHOT_ISOLATION);
     auto optimized_plan = optimizer.Optimize(planner.plan_);
 
     l.unlock();
@@ -387,10 +418,62 @@ void BustubInstance::GenerateMockTable() {
   delete txn;
 }
 
+auto BustubInstance::VacuumTables(const std::vector<std::string> &table_names, bool only_if_needed) -> size_t {
+  std::shared_lock<std::shared_mutex> l(catalog_lock_);
+  size_t num_freed = 0;
+  for (const auto &table_name : table_names) {
+    auto *table_info = catalog_->GetTable(table_name);
+    if (table_info == Catalog::NULL_TABLE_INFO || table_info->table_ == nullptr) {
+      continue;
+    }
+    if (!only_if_needed || table_info->table_->NeedsVacuum()) {
+      num_freed += table_info->table_->Vacuum();
+    }
+  }
+  return num_freed;
+}
+
+void BustubInstance::StartBackgroundVacuum() {
+  BUSTUB_ASSERT(vacuum_thread_ == nullptr, "the background vacuum is already running");
+  enable_vacuum_ = true;
+  vacuum_thread_ = new std::thread(&BustubInstance::RunBackgroundVacuum, this);
+}
+
+void BustubInstance::StopBackgroundVacuum() {
+  if (vacuum_thread_ == nullptr) {
+    return;
+  }
+  enable_vacuum_ = false;
+  vacuum_cv_.notify_all();
+  vacuum_thread_->join();
+  delete vacuum_thread_;
+  vacuum_thread_ = nullptr;
+}
+
+void BustubInstance::RunBackgroundVacuum() {
+  std::unique_lock<std::mutex> lock(vacuum_latch_);
+  while (enable_vacuum_) {
+    if (vacuum_cv_.wait_for(lock, vacuum_interval, [this] { return !enable_vacuum_; })) {
+      break;
+    }
+    std::vector<std::string> table_names;
+    {
+      std::shared_lock<std::shared_mutex> l(catalog_lock_);
+      table_names = catalog_->GetTableNames();
+    }
+    VacuumTables(table_names, true);
+  }
+}
+
 BustubInstance::~BustubInstance() {
+  StopBackgroundVacuum();
   if (enable_logging) {
     log_manager_->StopFlushThread();
   }
+  // Write back every dirty page, so that the catalog and the tables can be reopened by the next run.
+  if (buffer_pool_manager_ != nullptr) {
+    buffer_pool_manager_->FlushAllPages();
+  }
   delete execution_engine_;
   delete catalog_;
   delete checkpoint_manager_;
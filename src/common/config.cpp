@@ -12,6 +12,9 @@
 
 #include "common/config.h"
 
+#include <algorithm>
+#include <thread>  // NOLINT
+
 namespace bustub {
 
 std::atomic<bool> enable_logging(false);
@@ -20,4 +23,20 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::chrono::milliseconds buffer_pool_dump_interval = std::chrono::seconds(30);
+
+std::chrono::milliseconds vacuum_interval = std::chrono::seconds(10);
+
+size_t parallel_scan_threads = std::max(1U, std::thread::hardware_concurrency());
+
+double index_fill_factor = 0.9;
+
+size_t index_sort_threads = std::max(1U, std::thread::hardware_concurrency());
+
+bool index_scan_prefetch = false;
+
+size_t index_join_batch_size = 256;
+
+size_t bloom_filter_bits_per_key = 10;
+
 }  // namespace bustub
@@ -32,6 +32,12 @@ auto TransactionManager::Begin(Transaction *txn, IsolationLevel isolation_level)
     txn = new Transaction(next_txn_id_++, isolation_level);
   }
 
+  {
+    std::scoped_lock lock(ts_latch_);
+    txn->SetReadTs(last_commit_ts_);
+    active_read_ts_.insert(last_commit_ts_);
+  }
+
   if (enable_logging) {
     LogRecord record = LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::BEGIN);
     lsn_t lsn = log_manager_->AppendLogRecord(&record);
@@ -46,21 +52,32 @@ auto TransactionManager::Begin(Transaction *txn, IsolationLevel isolation_level)
 void TransactionManager::Commit(Transaction *txn) {
   txn->SetState(TransactionState::COMMITTED);
 
-  // Perform all deletes before we commit.
+  // Stamp the versions written with the commit timestamp. The deletes are applied by the garbage collection, once no
+  // snapshot sees the deleted tuples.
   auto write_set = txn->GetWriteSet();
-  while (!write_set->empty()) {
-    auto &item = write_set->back();
-    auto *table = item.table_;
-    if (item.wtype_ == WType::DELETE) {
-      // Note that this also releases the lock when holding the page latch.
-      table->ApplyDelete(item.rid_, txn);
+  if (!write_set->empty()) {
+    std::scoped_lock commit_lock(commit_latch_);
+    timestamp_t commit_ts = GetLastCommitTs() + 1;
+    for (const auto &item : *write_set) {
+      item.table_->CommitVersions(item.rid_, txn->GetTransactionId(), commit_ts);
+    }
+    {
+      std::scoped_lock lock(ts_latch_);
+      last_commit_ts_ = commit_ts;
+    }
+    txn->SetCommitTs(commit_ts);
+
+    std::scoped_lock gc_lock(gc_latch_);
+    for (const auto &item : *write_set) {
+      garbage_.push_back({item.table_, item.rid_, commit_ts});
     }
-    write_set->pop_back();
   }
   write_set->clear();
 
   // Release all the locks.
   ReleaseLocks(txn);
+  EndSnapshot(txn);
+  GarbageCollect();
   // Release the global transaction latch.
   global_txn_latch_.RUnlock();
 }
@@ -69,6 +86,14 @@ void TransactionManager::Abort(Transaction *txn) {
   txn->SetState(TransactionState::ABORTED);
   // Rollback before releasing the lock.
   auto table_write_set = txn->GetWriteSet();
+  {
+    // The rollback leaves the older versions of the tuples updated before, which may be collected.
+    std::scoped_lock lock(gc_latch_);
+    timestamp_t ts = GetLastCommitTs();
+    for (const auto &item : *table_write_set) {
+      garbage_.push_back({item.table_, item.rid_, ts});
+    }
+  }
   while (!table_write_set->empty()) {
     auto &item = table_write_set->back();
     auto *table = item.table_;
@@ -111,10 +136,40 @@ void TransactionManager::Abort(Transaction *txn) {
 
   // Release all the locks.
   ReleaseLocks(txn);
+  EndSnapshot(txn);
+  GarbageCollect();
   // Release the global transaction latch.
   global_txn_latch_.RUnlock();
 }
 
+void TransactionManager::GarbageCollect() {
+  timestamp_t watermark = GetWatermark();
+  std::deque<GarbageRecord> ready;
+  {
+    std::scoped_lock lock(gc_latch_);
+    while (!garbage_.empty() && garbage_.front().ts_ <= watermark) {
+      ready.push_back(garbage_.front());
+      garbage_.pop_front();
+    }
+  }
+  for (const auto &record : ready) {
+    record.table_->CollectGarbage(record.rid_, watermark);
+  }
+}
+
+auto TransactionManager::GetWatermark() -> timestamp_t {
+  std::scoped_lock lock(ts_latch_);
+  return active_read_ts_.empty() ? last_commit_ts_ : *active_read_ts_.begin();
+}
+
+void TransactionManager::EndSnapshot(Transaction *txn) {
+  std::scoped_lock lock(ts_latch_);
+  auto it = active_read_ts_.find(txn->GetReadTs());
+  if (it != active_read_ts_.end()) {
+    active_read_ts_.erase(it);
+  }
+}
+
 void TransactionManager::BlockAllTransactions() { global_txn_latch_.WLock(); }
 
 void TransactionManager::ResumeTransactions() { global_txn_latch_.WUnlock(); }
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -24,9 +25,28 @@ namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  //  implement me!
+                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                         page_id_t directory_page_id)
+    : directory_page_id_(directory_page_id),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(std::move(hash_fn)) {
+  if (directory_page_id_ != INVALID_PAGE_ID) {
+    return;
+  }
+  // A new table has global depth 0: a single bucket, which every key maps to.
+  Page *page = buffer_pool_manager_->NewPage(&directory_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate the hash table directory");
+  }
+  auto *dir_page = reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+  dir_page->SetPageId(directory_page_id_);
+  page_id_t bucket_page_id;
+  NewBucketPage(&bucket_page_id);
+  dir_page->SetBucketPageId(0, bucket_page_id);
+  dir_page->SetLocalDepth(0, 0);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
 }
 
 /*****************************************************************************
@@ -45,23 +65,89 @@ auto HASH_TABLE_TYPE::Hash(KeyType key) -> uint32_t {
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t {
-  return 0;
+inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectory *directory) -> uint32_t {
+  return Hash(key) & directory->GetGlobalDepthMask();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t {
-  return 0;
+inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key) -> page_id_t {
+  HashTableDirectory directory(buffer_pool_manager_, directory_page_id_);
+  return directory.GetBucketPageId(KeyToDirectoryIndex(key, &directory));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::FetchDirectoryPage() -> HashTableDirectoryPage * {
-  return nullptr;
+auto HASH_TABLE_TYPE::FetchBucketHead(page_id_t bucket_page_id) -> Page * {
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  if (page == nullptr) {
+    table_latch_.RUnlock();
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch a hash table bucket");
+  }
+  return page;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE * {
-  return nullptr;
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch a hash table bucket");
+  }
+  return reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::NewBucketPage(page_id_t *page_id) -> HASH_TABLE_BUCKET_TYPE * {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a hash table bucket");
+  }
+  auto *bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  bucket->Init();
+  return bucket;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::FindInChain(page_id_t bucket_page_id, const KeyType &key, const ValueType &value,
+                                  page_id_t *free_page_id) -> bool {
+  *free_page_id = INVALID_PAGE_ID;
+  bool found = false;
+  std::vector<ValueType> values;
+  for (page_id_t page_id = bucket_page_id; page_id != INVALID_PAGE_ID && !found;) {
+    auto *bucket = FetchBucketPage(page_id);
+    values.clear();
+    bucket->GetValue(key, comparator_, &values);
+    found = std::find(values.begin(), values.end(), value) != values.end();
+    if (*free_page_id == INVALID_PAGE_ID && !bucket->IsFull()) {
+      *free_page_id = page_id;
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::InsertIntoChain(page_id_t bucket_page_id, const KeyType &key, const ValueType &value) {
+  page_id_t page_id = bucket_page_id;
+  while (true) {
+    auto *bucket = FetchBucketPage(page_id);
+    if (!bucket->IsFull()) {
+      bucket->Insert(key, value, comparator_);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      return;
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      auto *overflow = NewBucketPage(&next_page_id);
+      overflow->Insert(key, value, comparator_);
+      bucket->SetNextPageId(next_page_id);
+      buffer_pool_manager_->UnpinPage(next_page_id, true);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      return;
+    }
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
 }
 
 /*****************************************************************************
@@ -69,35 +155,249 @@ auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BU
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  table_latch_.RLock();
+  page_id_t bucket_page_id = KeyToPageId(key);
+
+  // The latch of the first page of the bucket guards its overflow pages too.
+  Page *page = FetchBucketHead(bucket_page_id);
+  page->RLatch();
+  bool found = false;
+  for (page_id_t page_id = bucket_page_id; page_id != INVALID_PAGE_ID;) {
+    auto *bucket = FetchBucketPage(page_id);
+    found = bucket->GetValue(key, comparator_, result) || found;
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  table_latch_.RUnlock();
+  return found;
 }
 
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
+/*
+ * Insert into the bucket of the key if it has room, sharing the table latch.
+ * A full bucket is split under the exclusive table latch.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.RLock();
+  page_id_t bucket_page_id = KeyToPageId(key);
+
+  Page *page = FetchBucketHead(bucket_page_id);
+  page->WLatch();
+  page_id_t free_page_id;
+  bool found = FindInChain(bucket_page_id, key, value, &free_page_id);
+  bool inserted = false;
+  if (!found && free_page_id != INVALID_PAGE_ID) {
+    FetchBucketPage(free_page_id)->Insert(key, value, comparator_);
+    buffer_pool_manager_->UnpinPage(free_page_id, true);
+    inserted = true;
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  table_latch_.RUnlock();
+
+  if (found) {
+    return false;
+  }
+  return inserted || SplitInsert(transaction, key, value);
 }
 
+/*
+ * Split the bucket of the key until it has room for the pair, or chain an
+ * overflow page to it when it cannot be split. The bucket is looked up again,
+ * as other inserts may have split it or inserted the same pair meanwhile.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.WLock();
+  bool inserted = true;
+  {
+    HashTableDirectory directory(buffer_pool_manager_, directory_page_id_);
+    while (true) {
+      uint32_t bucket_idx = KeyToDirectoryIndex(key, &directory);
+      page_id_t bucket_page_id = directory.GetBucketPageId(bucket_idx);
+      page_id_t free_page_id;
+      if (FindInChain(bucket_page_id, key, value, &free_page_id)) {
+        inserted = false;
+        break;
+      }
+      if (free_page_id != INVALID_PAGE_ID || !SplitBucket(&directory, bucket_idx)) {
+        InsertIntoChain(bucket_page_id, key, value);
+        break;
+      }
+    }
+  }
+  table_latch_.WUnlock();
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::SplitBucket(HashTableDirectory *directory, uint32_t bucket_idx) -> bool {
+  uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+  if (local_depth == directory->GetGlobalDepth() && directory->Size() == HashTableDirectory::MAX_SIZE) {
+    return false;
+  }
+
+  // Take the pairs out of the bucket and its overflow pages.
+  page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+  std::vector<MappingType> pairs;
+  std::vector<page_id_t> overflow_page_ids;
+  for (page_id_t page_id = bucket_page_id; page_id != INVALID_PAGE_ID;) {
+    auto *bucket = FetchBucketPage(page_id);
+    for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE && bucket->IsOccupied(i); i++) {
+      if (bucket->IsReadable(i)) {
+        pairs.emplace_back(bucket->KeyAt(i), bucket->ValueAt(i));
+      }
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    if (page_id != bucket_page_id) {
+      overflow_page_ids.push_back(page_id);
+    }
+    page_id = next_page_id;
+  }
+
+  // Pairs whose hashes agree on every bit a directory index can have stay together however deep the bucket gets.
+  std::vector<uint32_t> hashes;
+  hashes.reserve(pairs.size());
+  for (const auto &pair : pairs) {
+    hashes.push_back(Hash(pair.first));
+  }
+  const uint32_t max_mask = HashTableDirectory::MAX_SIZE - 1;
+  if (std::all_of(hashes.begin(), hashes.end(),
+                  [&](uint32_t hash) { return (hash & max_mask) == (hashes.front() & max_mask); })) {
+    return false;
+  }
+
+  // The indexes of the bucket, those which agree with bucket_idx on its low local_depth bits, with the new high bit
+  // set point to its split image.
+  if (local_depth == directory->GetGlobalDepth()) {
+    directory->IncrGlobalDepth();
+  }
+  page_id_t image_page_id;
+  NewBucketPage(&image_page_id);
+  buffer_pool_manager_->UnpinPage(image_page_id, true);
+  const uint32_t high_bit = 1U << local_depth;
+  for (uint32_t i = bucket_idx & (high_bit - 1); i < directory->Size(); i += high_bit) {
+    directory->SetLocalDepth(i, local_depth + 1);
+    if ((i & high_bit) != 0) {
+      directory->SetBucketPageId(i, image_page_id);
+    }
+  }
+
+  FetchBucketPage(bucket_page_id)->Init();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  for (auto page_id : overflow_page_ids) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  for (size_t i = 0; i < pairs.size(); i++) {
+    InsertIntoChain((hashes[i] & high_bit) != 0 ? image_page_id : bucket_page_id, pairs[i].first, pairs[i].second);
+  }
+  return true;
 }
 
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
+/*
+ * An overflow page left empty is unlinked from the bucket, and a bucket left
+ * empty is merged into its split image.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.RLock();
+  page_id_t bucket_page_id = KeyToPageId(key);
+
+  Page *page = FetchBucketHead(bucket_page_id);
+  page->WLatch();
+  auto *first_bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  bool removed = false;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  for (page_id_t page_id = bucket_page_id; page_id != INVALID_PAGE_ID && !removed;) {
+    auto *bucket = FetchBucketPage(page_id);
+    removed = bucket->Remove(key, value, comparator_);
+    page_id_t next_page_id = bucket->GetNextPageId();
+    bool unlink = removed && page_id != bucket_page_id && bucket->IsEmpty();
+    buffer_pool_manager_->UnpinPage(page_id, removed);
+    if (unlink) {
+      FetchBucketPage(prev_page_id)->SetNextPageId(next_page_id);
+      buffer_pool_manager_->UnpinPage(prev_page_id, true);
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    prev_page_id = page_id;
+    page_id = next_page_id;
+  }
+  bool empty = first_bucket->IsEmpty() && first_bucket->GetNextPageId() == INVALID_PAGE_ID;
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  table_latch_.RUnlock();
+
+  if (removed && empty) {
+    Merge(transaction, key, value);
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
+/*
+ * Merge the bucket of the key with its split image while either is empty and
+ * both have the same local depth, then halve the directory while it can.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {}
+void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  {
+    HashTableDirectory directory(buffer_pool_manager_, directory_page_id_);
+    auto is_empty = [this](page_id_t page_id) {
+      auto *bucket = FetchBucketPage(page_id);
+      bool empty = bucket->IsEmpty() && bucket->GetNextPageId() == INVALID_PAGE_ID;
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      return empty;
+    };
+    while (true) {
+      uint32_t bucket_idx = KeyToDirectoryIndex(key, &directory);
+      uint32_t local_depth = directory.GetLocalDepth(bucket_idx);
+      if (local_depth == 0) {
+        break;
+      }
+      uint32_t image_idx = directory.GetSplitImageIndex(bucket_idx);
+      if (directory.GetLocalDepth(image_idx) != local_depth) {
+        break;
+      }
+      page_id_t bucket_page_id = directory.GetBucketPageId(bucket_idx);
+      page_id_t image_page_id = directory.GetBucketPageId(image_idx);
+      page_id_t drop_page_id;
+      page_id_t keep_page_id;
+      if (is_empty(bucket_page_id)) {
+        drop_page_id = bucket_page_id;
+        keep_page_id = image_page_id;
+      } else if (is_empty(image_page_id)) {
+        drop_page_id = image_page_id;
+        keep_page_id = bucket_page_id;
+      } else {
+        break;
+      }
+      // The indexes of the bucket and of its image agree on their low local_depth - 1 bits.
+      const uint32_t stride = 1U << (local_depth - 1);
+      for (uint32_t i = bucket_idx & (stride - 1); i < directory.Size(); i += stride) {
+        directory.SetBucketPageId(i, keep_page_id);
+        directory.SetLocalDepth(i, local_depth - 1);
+      }
+      buffer_pool_manager_->DeletePage(drop_page_id);
+    }
+    while (directory.CanShrink()) {
+      directory.DecrGlobalDepth();
+    }
+  }
+  table_latch_.WUnlock();
+}
 
 /*****************************************************************************
  * GETGLOBALDEPTH - DO NOT TOUCH
@@ -105,9 +405,7 @@ void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetGlobalDepth() -> uint32_t {
   table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  uint32_t global_depth = dir_page->GetGlobalDepth();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr));
+  uint32_t global_depth = HashTableDirectory(buffer_pool_manager_, directory_page_id_).GetGlobalDepth();
   table_latch_.RUnlock();
   return global_depth;
 }
@@ -118,9 +416,7 @@ auto HASH_TABLE_TYPE::GetGlobalDepth() -> uint32_t {
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::VerifyIntegrity() {
   table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  dir_page->VerifyIntegrity();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr));
+  HashTableDirectory(buffer_pool_manager_, directory_page_id_).VerifyIntegrity();
   table_latch_.RUnlock();
 }
 
@@ -134,5 +430,13 @@ template class DiskExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>
 template class DiskExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
 template class DiskExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
 template class DiskExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+template class DiskExtendibleHashTable<GenericKey<128>, RID, GenericComparator<128>>;
+template class DiskExtendibleHashTable<GenericKey<256>, RID, GenericComparator<256>>;
+template class DiskExtendibleHashTable<GenericKey<4>, RID, IntegerComparator<4, int32_t>>;
+template class DiskExtendibleHashTable<GenericKey<8>, RID, IntegerComparator<8, int64_t>>;
+template class DiskExtendibleHashTable<GenericKey<8>, RID, IntegerColumnsComparator<8>>;
+template class DiskExtendibleHashTable<GenericKey<16>, RID, IntegerColumnsComparator<16>>;
+template class DiskExtendibleHashTable<GenericKey<32>, RID, IntegerColumnsComparator<32>>;
+template class DiskExtendibleHashTable<GenericKey<64>, RID, IntegerColumnsComparator<64>>;
 
 }  // namespace bustub
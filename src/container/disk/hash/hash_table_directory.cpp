@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory.cpp
+//
+// Identification: src/container/disk/hash/hash_table_directory.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "container/disk/hash/hash_table_directory.h"
+
+namespace bustub {
+
+HashTableDirectory::HashTableDirectory(BufferPoolManager *buffer_pool_manager, page_id_t directory_page_id)
+    : buffer_pool_manager_(buffer_pool_manager), directory_page_id_(directory_page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch the hash table directory");
+  }
+  first_page_ = reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+}
+
+HashTableDirectory::~HashTableDirectory() { buffer_pool_manager_->UnpinPage(directory_page_id_, is_dirty_); }
+
+auto HashTableDirectory::FetchSlotPage(uint32_t bucket_idx) -> std::pair<HashTableDirectoryPage *, uint32_t> {
+  if (bucket_idx < DIRECTORY_ARRAY_SIZE) {
+    return {first_page_, bucket_idx};
+  }
+  Page *page = buffer_pool_manager_->FetchPage(first_page_->GetExtensionPageId(bucket_idx / DIRECTORY_ARRAY_SIZE - 1));
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch a hash table directory page");
+  }
+  return {reinterpret_cast<HashTableDirectoryPage *>(page->GetData()), bucket_idx % DIRECTORY_ARRAY_SIZE};
+}
+
+void HashTableDirectory::UnpinSlotPage(HashTableDirectoryPage *page, bool is_dirty) {
+  if (page == first_page_) {
+    is_dirty_ = is_dirty_ || is_dirty;
+    return;
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+}
+
+auto HashTableDirectory::GetBucketPageId(uint32_t bucket_idx) -> page_id_t {
+  auto [page, slot] = FetchSlotPage(bucket_idx);
+  page_id_t bucket_page_id = page->GetBucketPageId(slot);
+  UnpinSlotPage(page, false);
+  return bucket_page_id;
+}
+
+void HashTableDirectory::SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {
+  auto [page, slot] = FetchSlotPage(bucket_idx);
+  page->SetBucketPageId(slot, bucket_page_id);
+  UnpinSlotPage(page, true);
+}
+
+auto HashTableDirectory::GetLocalDepth(uint32_t bucket_idx) -> uint32_t {
+  auto [page, slot] = FetchSlotPage(bucket_idx);
+  uint32_t local_depth = page->GetLocalDepth(slot);
+  UnpinSlotPage(page, false);
+  return local_depth;
+}
+
+void HashTableDirectory::SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth) {
+  auto [page, slot] = FetchSlotPage(bucket_idx);
+  page->SetLocalDepth(slot, local_depth);
+  UnpinSlotPage(page, true);
+}
+
+auto HashTableDirectory::GetSplitImageIndex(uint32_t bucket_idx) -> uint32_t {
+  uint32_t local_depth = GetLocalDepth(bucket_idx);
+  return local_depth == 0 ? bucket_idx : bucket_idx ^ (1U << (local_depth - 1));
+}
+
+/*
+ * Within the first page the page copies its own slots. Past it, each page of
+ * the lower half is copied into a new extension page of the upper half.
+ */
+void HashTableDirectory::IncrGlobalDepth() {
+  uint32_t size = Size();
+  assert(size < MAX_SIZE);
+  for (uint32_t page_idx = 0; page_idx < size / DIRECTORY_ARRAY_SIZE; page_idx++) {
+    auto *source = FetchSlotPage(page_idx * DIRECTORY_ARRAY_SIZE).first;
+    page_id_t copy_page_id;
+    Page *page = buffer_pool_manager_->NewPage(&copy_page_id);
+    if (page == nullptr) {
+      UnpinSlotPage(source, false);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a hash table directory page");
+    }
+    auto *copy = reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+    copy->SetPageId(copy_page_id);
+    for (uint32_t slot = 0; slot < DIRECTORY_ARRAY_SIZE; slot++) {
+      copy->SetBucketPageId(slot, source->GetBucketPageId(slot));
+      copy->SetLocalDepth(slot, source->GetLocalDepth(slot));
+    }
+    first_page_->SetExtensionPageId(size / DIRECTORY_ARRAY_SIZE + page_idx - 1, copy_page_id);
+    buffer_pool_manager_->UnpinPage(copy_page_id, true);
+    UnpinSlotPage(source, false);
+  }
+  first_page_->IncrGlobalDepth();
+  is_dirty_ = true;
+}
+
+void HashTableDirectory::DecrGlobalDepth() {
+  uint32_t size = Size();
+  first_page_->DecrGlobalDepth();
+  is_dirty_ = true;
+  for (uint32_t page_idx = std::max<uint32_t>(size / 2, DIRECTORY_ARRAY_SIZE) / DIRECTORY_ARRAY_SIZE;
+       page_idx < size / DIRECTORY_ARRAY_SIZE; page_idx++) {
+    buffer_pool_manager_->DeletePage(first_page_->GetExtensionPageId(page_idx - 1));
+    first_page_->SetExtensionPageId(page_idx - 1, INVALID_PAGE_ID);
+  }
+}
+
+auto HashTableDirectory::CanShrink() -> bool {
+  uint32_t global_depth = GetGlobalDepth();
+  if (global_depth == 0) {
+    return false;
+  }
+  // Each page is fetched once rather than once per slot.
+  for (uint32_t begin = 0; begin < Size(); begin += DIRECTORY_ARRAY_SIZE) {
+    auto *page = FetchSlotPage(begin).first;
+    bool shrinkable = true;
+    for (uint32_t slot = 0; slot < std::min<uint32_t>(Size() - begin, DIRECTORY_ARRAY_SIZE) && shrinkable; slot++) {
+      shrinkable = page->GetLocalDepth(slot) < global_depth;
+    }
+    UnpinSlotPage(page, false);
+    if (!shrinkable) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HashTableDirectory::VerifyIntegrity() {
+  if (Size() <= DIRECTORY_ARRAY_SIZE) {
+    first_page_->VerifyIntegrity();
+    return;
+  }
+  uint32_t global_depth = GetGlobalDepth();
+  std::unordered_map<page_id_t, uint32_t> page_id_to_count;
+  std::unordered_map<page_id_t, uint32_t> page_id_to_ld;
+  for (uint32_t bucket_idx = 0; bucket_idx < Size(); bucket_idx++) {
+    page_id_t bucket_page_id = GetBucketPageId(bucket_idx);
+    uint32_t local_depth = GetLocalDepth(bucket_idx);
+    assert(local_depth <= global_depth);
+    ++page_id_to_count[bucket_page_id];
+    auto [it, inserted] = page_id_to_ld.emplace(bucket_page_id, local_depth);
+    if (!inserted && it->second != local_depth) {
+      LOG_WARN("Verify Integrity: curr_local_depth: %u, old_local_depth %u, for page_id: %u", local_depth, it->second,
+               bucket_page_id);
+      assert(it->second == local_depth);
+    }
+  }
+  for (const auto &[bucket_page_id, count] : page_id_to_count) {
+    uint32_t required_count = 1U << (global_depth - page_id_to_ld[bucket_page_id]);
+    if (count != required_count) {
+      LOG_WARN("Verify Integrity: curr_count: %u, required_count %u, for page_id: %u", count, required_count,
+               bucket_page_id);
+      assert(count == required_count);
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,177 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// copy_executor.cpp
+//
+// Identification: src/execution/copy_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <fstream>
+#include <optional>
+#include <utility>
+
+#include "common/exception.h"
+#include "execution/executors/copy_executor.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/**
+ * Split a line into fields. A field may be quoted with '"', in which case it may contain the delimiter, and '""'
+ * stands for a quote. An unquoted empty field is NULL.
+ */
+auto SplitLine(const std::string &line, char delimiter) -> std::vector<std::optional<std::string>> {
+  std::vector<std::optional<std::string>> fields;
+  std::string field;
+  bool quoted = false;
+  bool in_quotes = false;
+  for (size_t i = 0; i < line.size(); i++) {
+    char c = line[i];
+    if (in_quotes) {
+      if (c != '"') {
+        field.push_back(c);
+      } else if (i + 1 < line.size() && line[i + 1] == '"') {
+        field.push_back('"');
+        i++;
+      } else {
+        in_quotes = false;
+      }
+    } else if (c == '"') {
+      quoted = in_quotes = true;
+    } else if (c == delimiter) {
+      fields.emplace_back(field.empty() && !quoted ? std::nullopt : std::make_optional(field));
+      field.clear();
+      quoted = false;
+    } else {
+      field.push_back(c);
+    }
+  }
+  fields.emplace_back(field.empty() && !quoted ? std::nullopt : std::make_optional(field));
+  return fields;
+}
+
+}  // namespace
+
+CopyExecutor::CopyExecutor(ExecutorContext *exec_ctx, const CopyPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan), table_info_(exec_ctx_->GetCatalog()->GetTable(plan_->TableOid())) {}
+
+void CopyExecutor::Init() {
+  table_indexes_ = exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_);
+  is_end_ = false;
+}
+
+auto CopyExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
+  if (is_end_) {
+    return false;
+  }
+
+  // The whole file is parsed once before anything is loaded, so that a malformed line fails the copy with the table
+  // and its indexes untouched. The rows are parsed again while loading rather than held, to keep memory flat.
+  ForEachRow([](Tuple && /* row */) {});
+
+  auto *txn = exec_ctx_->GetTransaction();
+  const auto &schema = table_info_->schema_;
+  std::vector<Tuple> batch;
+  std::vector<RID> rids;
+  std::vector<std::pair<Tuple, RID>> index_entries;
+  int loaded_count = 0;
+
+  auto load_batch = [&]() {
+    if (batch.empty()) {
+      return;
+    }
+    rids.clear();
+    if (!table_info_->table_->BulkInsertTuples(batch, &rids, txn)) {
+      throw ExecutionException(fmt::format("copy: failed to load into {}", table_info_->name_));
+    }
+    // Index each batch as it is loaded, so that memory does not grow with the size of the file.
+    for (auto *index_info : table_indexes_) {
+      auto *index = index_info->index_.get();
+      index_entries.clear();
+      for (size_t j = 0; j < batch.size(); j++) {
+        index_entries.emplace_back(batch[j].KeyFromTuple(schema, *index->GetKeySchema(), index->GetKeyAttrs()),
+                                   rids[j]);
+      }
+      index->InsertEntries(index_entries, txn);
+    }
+    loaded_count += static_cast<int>(batch.size());
+    batch.clear();
+  };
+
+  ForEachRow([&](Tuple &&row) {
+    batch.push_back(std::move(row));
+    if (batch.size() >= BATCH_SIZE) {
+      load_batch();
+    }
+  });
+  load_batch();
+
+  std::vector<Value> values{};
+  values.reserve(GetOutputSchema().GetColumnCount());
+  values.emplace_back(TypeId::INTEGER, loaded_count);
+  *tuple = Tuple(values, &GetOutputSchema());
+  is_end_ = true;
+  return true;
+}
+
+void CopyExecutor::ForEachRow(const std::function<void(Tuple &&)> &callback) {
+  std::ifstream file(plan_->FileName());
+  if (!file.is_open()) {
+    throw ExecutionException(fmt::format("copy: cannot open {}", plan_->FileName()));
+  }
+
+  std::string line;
+  size_t line_number = 0;
+  if (plan_->HasHeader() && std::getline(file, line)) {
+    line_number++;
+  }
+  while (std::getline(file, line)) {
+    line_number++;
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.empty()) {
+      continue;
+    }
+    callback(ParseLine(line, line_number));
+  }
+}
+
+auto CopyExecutor::ParseLine(const std::string &line, size_t line_number) -> Tuple {
+  const auto &schema = table_info_->schema_;
+  auto fields = SplitLine(line, plan_->Delimiter());
+  if (fields.size() != schema.GetColumnCount()) {
+    throw ExecutionException(fmt::format("copy: line {} has {} fields, expected {}", line_number, fields.size(),
+                                         schema.GetColumnCount()));
+  }
+
+  std::vector<Value> values;
+  values.reserve(fields.size());
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    auto type = schema.GetColumn(i).GetType();
+    if (!fields[i].has_value()) {
+      values.push_back(ValueFactory::GetNullValueByType(type));
+      continue;
+    }
+    auto value = ValueFactory::GetVarcharValue(*fields[i]);
+    if (type == TypeId::VARCHAR) {
+      values.push_back(std::move(value));
+      continue;
+    }
+    try {
+      values.push_back(value.CastAs(type));
+    } catch (const std::exception &e) {
+      throw ExecutionException(fmt::format("copy: line {}: invalid value '{}' for column {}", line_number, *fields[i],
+                                           schema.GetColumn(i).GetName()));
+    }
+  }
+  return Tuple(values, &schema);
+}
+
+}  // namespace bustub
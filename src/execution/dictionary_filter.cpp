@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// dictionary_filter.cpp
+//
+// Identification: src/execution/dictionary_filter.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/dictionary_filter.h"
+
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+DictionaryFilter::DictionaryFilter(const AbstractExpressionRef &predicate, TableHeap *table_heap)
+    : dictionary_(table_heap->GetDictionary()) {
+  if (predicate != nullptr && dictionary_ != nullptr) {
+    encoded_predicate_ = Rewrite(predicate);
+  }
+}
+
+auto DictionaryFilter::Evaluate(const Tuple &encoded) const -> bool {
+  auto value = encoded_predicate_->Evaluate(&encoded, dictionary_->GetEncodedSchema());
+  return !value.IsNull() && value.GetAs<bool>();
+}
+
+auto DictionaryFilter::IsEncodedColumn(const AbstractExpressionRef &expr) const -> bool {
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get());
+  return column != nullptr && column->GetTupleIdx() == 0 && dictionary_->IsEncoded(column->GetColIdx());
+}
+
+auto DictionaryFilter::Rewrite(const AbstractExpressionRef &expr) const -> AbstractExpressionRef {
+  if (IsEncodedColumn(expr)) {
+    // A string used other than in an equality cannot be replaced by its code.
+    return nullptr;
+  }
+
+  // A comparison of an encoded column with another one, or with a string, compares codes.
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(expr.get());
+  if (comparison != nullptr &&
+      (comparison->comp_type_ == ComparisonType::Equal || comparison->comp_type_ == ComparisonType::NotEqual) &&
+      (IsEncodedColumn(comparison->GetChildAt(0)) || IsEncodedColumn(comparison->GetChildAt(1)))) {
+    std::vector<AbstractExpressionRef> children;
+    for (const auto &child : comparison->GetChildren()) {
+      if (IsEncodedColumn(child)) {
+        auto column_idx = dynamic_cast<const ColumnValueExpression &>(*child).GetColIdx();
+        children.push_back(std::make_shared<ColumnValueExpression>(0, column_idx, TypeId::INTEGER));
+        continue;
+      }
+      const auto *constant = dynamic_cast<const ConstantValueExpression *>(child.get());
+      if (constant == nullptr || constant->val_.GetTypeId() != TypeId::VARCHAR || constant->val_.IsNull()) {
+        return nullptr;
+      }
+      auto code = dictionary_->Lookup(constant->val_.ToString());
+      children.push_back(
+          std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(code.value_or(NO_CODE))));
+    }
+    return expr->CloneWithChildren(std::move(children));
+  }
+
+  std::vector<AbstractExpressionRef> children;
+  for (const auto &child : expr->GetChildren()) {
+    auto rewritten = Rewrite(child);
+    if (rewritten == nullptr) {
+      return nullptr;
+    }
+    children.push_back(std::move(rewritten));
+  }
+  return expr->CloneWithChildren(std::move(children));
+}
+
+}  // namespace bustub
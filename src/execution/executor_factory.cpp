@@ -17,6 +17,7 @@
 
 #include "execution/executors/abstract_executor.h"
 #include "execution/executors/aggregation_executor.h"
+#include "execution/executors/copy_executor.h"
 #include "execution/executors/delete_executor.h"
 #include "execution/executors/filter_executor.h"
 #include "execution/executors/hash_join_executor.h"
@@ -114,6 +115,12 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx,
       return std::make_unique<HashJoinExecutor>(exec_ctx, hash_join_plan, std::move(left), std::move(right));
     }
 
+    // Create a new copy executor
+    case PlanType::Copy: {
+      const auto *copy_plan = dynamic_cast<const CopyPlanNode *>(plan.get());
+      return std::make_unique<CopyExecutor>(exec_ctx, copy_plan);
+    }
+
     // Create a new mock scan executor
     case PlanType::MockScan: {
       const auto *mock_scan_plan = dynamic_cast<const MockScanPlanNode *>(plan.get());
@@ -10,26 +10,121 @@
 //
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
+#include "type/value_factory.h"
 
 namespace bustub {
+
+namespace {
+
+/** Compare the leading columns of a key with a key prefix, which holds no NULL; a NULL column is the least value. */
+template <typename KeyType>
+auto ComparePrefix(const KeyType &key, Schema *key_schema, const std::vector<Value> &prefix) -> int {
+  for (uint32_t i = 0; i < prefix.size(); i++) {
+    auto value = key.ToValue(key_schema, i);
+    if (value.IsNull() || value.CompareLessThan(prefix[i]) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (value.CompareGreaterThan(prefix[i]) == CmpBool::CmpTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/** Whether the bounds of a scan are the same whole key, which a point lookup finds. */
+auto IsWholeKey(const IndexScanPlanNode &plan, const Schema &key_schema) -> bool {
+  const auto &lower_bound = plan.lower_bound_;
+  const auto &upper_bound = plan.upper_bound_;
+  if (lower_bound.size() != key_schema.GetColumnCount() || upper_bound.size() != key_schema.GetColumnCount() ||
+      !plan.lower_inclusive_ || !plan.upper_inclusive_) {
+    return false;
+  }
+  for (size_t i = 0; i < lower_bound.size(); i++) {
+    if (lower_bound[i].CompareEquals(upper_bound[i]) != CmpBool::CmpTrue) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
     : AbstractExecutor(exec_ctx),
       plan_(plan),
       index_info_(exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid())),
-      table_info_(exec_ctx_->GetCatalog()->GetTable(index_info_->index_->GetMetadata()->GetTableName())),
-      tree_(dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info_->index_.get())),
-      index_iter_(tree_->GetBeginIterator()) {}
+      table_info_(exec_ctx_->GetCatalog()->GetTable(index_info_->index_->GetMetadata()->GetTableName())) {}
+
+void IndexScanExecutor::Init() {
+  rids_.clear();
+  next_rid_ = 0;
+  // A whole key is looked up, which consults the Bloom filter of the index if it has one. The planner only scans a
+  // hash index for a whole key.
+  auto *key_schema = index_info_->index_->GetKeySchema();
+  if (IsWholeKey(*plan_, *key_schema)) {
+    index_info_->index_->ScanKey(Tuple(plan_->lower_bound_, key_schema), &rids_, exec_ctx_->GetTransaction());
+    return;
+  }
+  BUSTUB_ASSERT(index_info_->index_type_ == IndexType::BPLUS_TREE, "a hash index is only scanned for a whole key");
+  VisitBPlusTreeIndexTypes(*index_info_->index_->GetKeySchema(), [this](auto types) {
+    using Types = decltype(types);
+    using Tree = BPlusTreeIndex<typename Types::KeyType, typename Types::ValueType, typename Types::KeyComparator>;
+    ScanKeys(dynamic_cast<Tree *>(index_info_->index_.get()));
+  });
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void IndexScanExecutor::ScanKeys(BPlusTreeIndex<KeyType, ValueType, KeyComparator> *tree) {
+  BUSTUB_ASSERT(tree != nullptr, "the index is not a B+ tree of its key schema");
+  auto *key_schema = index_info_->index_->GetKeySchema();
+  const auto &lower_bound = plan_->lower_bound_;
+  const auto &upper_bound = plan_->upper_bound_;
 
-void IndexScanExecutor::Init() { index_iter_ = tree_->GetBeginIterator(); }
+  // Seek to the first key not less than the lower bound, the least key with its prefix: the columns after the prefix
+  // are NULL, which sorts first. Skip the keys with the prefix if the bound is exclusive.
+  auto iterator = tree->GetBeginIterator();
+  if (!lower_bound.empty()) {
+    std::vector<Value> values = lower_bound;
+    for (auto i = static_cast<uint32_t>(values.size()); i < key_schema->GetColumnCount(); i++) {
+      values.push_back(ValueFactory::GetNullValueByType(key_schema->GetColumn(i).GetType()));
+    }
+    KeyType lower_key;
+    lower_key.SetFromKey(Tuple(values, key_schema));
+    iterator = tree->GetBeginIterator(lower_key);
+    while (!plan_->lower_inclusive_ && !iterator.IsEnd() &&
+           ComparePrefix((*iterator).first, key_schema, lower_bound) == 0) {
+      ++iterator;
+    }
+  }
+  for (; !iterator.IsEnd(); ++iterator) {
+    const auto &[key, rid] = *iterator;
+    if (!upper_bound.empty()) {
+      auto cmp = ComparePrefix(key, key_schema, upper_bound);
+      if (cmp > 0 || (cmp == 0 && !plan_->upper_inclusive_)) {
+        break;
+      }
+    }
+    rids_.push_back(rid);
+  }
+}
 
 auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (index_iter_ == tree_->GetEndIterator()) {
-    return false;
+  // A snapshot does not see the tuples inserted after it was taken.
+  const auto &filter_predicate = plan_->filter_predicate_;
+  while (next_rid_ < rids_.size()) {
+    *rid = rids_[next_rid_++];
+    if (!table_info_->table_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction())) {
+      continue;
+    }
+    if (filter_predicate != nullptr) {
+      auto value = filter_predicate->Evaluate(tuple, GetOutputSchema());
+      if (value.IsNull() || !value.GetAs<bool>()) {
+        continue;
+      }
+    }
+    return true;
   }
-  *rid = (*index_iter_).second;
-  table_info_->table_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction());
-  ++index_iter_;
-  return true;
+  return false;
 }
 
 }  // namespace bustub
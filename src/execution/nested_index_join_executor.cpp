@@ -10,6 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
+#include "common/config.h"
+#include "common/exception.h"
 #include "execution/executors/nested_index_join_executor.h"
 
 namespace bustub {
@@ -20,9 +24,7 @@ NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const Ne
       plan_(plan),
       child_executor_(std::move(child_executor)),
       inner_table_info_(exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableOid())),
-      index_info_(exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid())),
-      tree_(dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info_->index_.get())),
-      index_iter_(tree_->GetBeginIterator()) {
+      index_info_(exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid())) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
@@ -31,72 +33,104 @@ NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const Ne
 
 void NestIndexJoinExecutor::Init() {
   child_executor_->Init();
-  // LOG_DEBUG("%s", GetOutputSchema().ToString().c_str());
-  // LOG_DEBUG("%s", child_executor_->GetOutputSchema().ToString().c_str());
-  // LOG_DEBUG("%s", plan_->InnerTableSchema().ToString().c_str());
-  // LOG_DEBUG("%s", plan_->GetIndexName().c_str());
-  // LOG_DEBUG("%s", index_info_->index_->ToString().c_str());
-
-  index_iter_ = tree_->GetBeginIterator();
-  left_status_ = child_executor_->Next(&left_tuple_, &left_rid_);
+  left_tuples_.clear();
+  right_rids_.clear();
+  left_index_ = 0;
+  right_index_ = 0;
   left_find_ = false;
 }
 
-auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  auto filter_expr = plan_->KeyPredicate();
-
-  // LOG_DEBUG("%s", filter_expr->ToString().c_str());
-  while (left_status_) {
-    if (index_iter_ != tree_->GetEndIterator()) {
-      right_rid_ = (*index_iter_).second;
-      inner_table_info_->table_->GetTuple(right_rid_, &right_tuple_, exec_ctx_->GetTransaction());
-      ++index_iter_;
-      auto left_value = filter_expr->Evaluate(&left_tuple_, child_executor_->GetOutputSchema());
-      auto key_right_tuple = right_tuple_.KeyFromTuple(
-          plan_->InnerTableSchema(), *(index_info_->index_->GetKeySchema()), index_info_->index_->GetKeyAttrs());
-      auto right_value = key_right_tuple.GetValue(index_info_->index_->GetKeySchema(), 0);
-
-      if (left_value.CompareEquals(right_value) == bustub::CmpBool::CmpTrue) {
-        left_find_ = true;
-        std::vector<Value> values{};
-        values.reserve(GetOutputSchema().GetColumnCount());
-        for (size_t i = 0; i < child_executor_->GetOutputSchema().GetColumnCount(); i++) {
-          values.push_back(left_tuple_.GetValue(&(child_executor_->GetOutputSchema()), i));
-        }
-        for (size_t i = 0; i < plan_->InnerTableSchema().GetColumnCount(); i++) {
-          values.push_back(right_tuple_.GetValue(&(plan_->InnerTableSchema()), i));
-        }
+auto NestIndexJoinExecutor::NextBatch() -> bool {
+  left_tuples_.clear();
+  left_index_ = 0;
+  right_index_ = 0;
+  left_find_ = false;
+  const auto batch_size = std::max<size_t>(index_join_batch_size, 1);
+  Tuple left_tuple;
+  RID left_rid;
+  while (left_tuples_.size() < batch_size && child_executor_->Next(&left_tuple, &left_rid)) {
+    left_tuples_.push_back(left_tuple);
+  }
+  if (left_tuples_.empty()) {
+    return false;
+  }
 
-        *tuple = Tuple(values, &GetOutputSchema());
-        return true;
-      }
+  // Build the index keys of the outer tuples; a NULL key, or one out of the range of the key type, matches nothing.
+  auto *key_schema = index_info_->index_->GetKeySchema();
+  const auto key_type = key_schema->GetColumn(0).GetType();
+  std::vector<Tuple> keys;
+  std::vector<size_t> key_tuple_indexes;
+  keys.reserve(left_tuples_.size());
+  for (size_t i = 0; i < left_tuples_.size(); i++) {
+    auto value = plan_->KeyPredicate()->Evaluate(&left_tuples_[i], child_executor_->GetOutputSchema());
+    if (value.IsNull()) {
       continue;
     }
+    if (value.GetTypeId() != key_type) {
+      try {
+        value = value.CastAs(key_type);
+      } catch (const Exception &) {
+        continue;
+      }
+    }
+    keys.emplace_back(std::vector<Value>{value}, key_schema);
+    key_tuple_indexes.push_back(i);
+  }
 
-    Tuple temp_tuple = left_tuple_;
+  std::vector<std::vector<RID>> key_rids;
+  if (keys.size() == 1) {
+    key_rids.resize(1);
+    index_info_->index_->ScanKey(keys[0], &key_rids[0], exec_ctx_->GetTransaction());
+  } else {
+    index_info_->index_->ScanKeys(keys, &key_rids, exec_ctx_->GetTransaction());
+  }
+  right_rids_.assign(left_tuples_.size(), {});
+  for (size_t i = 0; i < keys.size(); i++) {
+    right_rids_[key_tuple_indexes[i]] = std::move(key_rids[i]);
+  }
+  return true;
+}
 
-    left_status_ = child_executor_->Next(&left_tuple_, &left_rid_);
-    index_iter_ = tree_->GetBeginIterator();
+auto NestIndexJoinExecutor::JoinTuples(const Tuple &left_tuple, const Tuple *right_tuple) const -> Tuple {
+  std::vector<Value> values{};
+  values.reserve(GetOutputSchema().GetColumnCount());
+  for (size_t i = 0; i < child_executor_->GetOutputSchema().GetColumnCount(); i++) {
+    values.push_back(left_tuple.GetValue(&(child_executor_->GetOutputSchema()), i));
+  }
+  for (size_t i = 0; i < plan_->InnerTableSchema().GetColumnCount(); i++) {
+    values.push_back(right_tuple != nullptr
+                         ? right_tuple->GetValue(&(plan_->InnerTableSchema()), i)
+                         : ValueFactory::GetNullValueByType(plan_->InnerTableSchema().GetColumn(i).GetType()));
+  }
+  return Tuple(values, &GetOutputSchema());
+}
 
-    if (!left_find_ && plan_->GetJoinType() == JoinType::LEFT) {
-      std::vector<Value> values{};
-      values.reserve(GetOutputSchema().GetColumnCount());
-      for (size_t i = 0; i < child_executor_->GetOutputSchema().GetColumnCount(); i++) {
-        values.push_back(temp_tuple.GetValue(&(child_executor_->GetOutputSchema()), i));
-      }
-      for (size_t i = 0; i < plan_->InnerTableSchema().GetColumnCount(); i++) {
-        values.push_back(ValueFactory::GetNullValueByType(plan_->InnerTableSchema().GetColumn(i).GetType()));
+auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    if (left_index_ == left_tuples_.size() && !NextBatch()) {
+      return false;
+    }
+    const auto &left_tuple = left_tuples_[left_index_];
+    const auto &right_rids = right_rids_[left_index_];
+    while (right_index_ < right_rids.size()) {
+      Tuple right_tuple;
+      if (inner_table_info_->table_->GetTuple(right_rids[right_index_++], &right_tuple,
+                                              exec_ctx_->GetTransaction())) {
+        left_find_ = true;
+        *tuple = JoinTuples(left_tuple, &right_tuple);
+        return true;
       }
-
-      *tuple = Tuple(values, &GetOutputSchema());
-      left_find_ = false;
-      return true;
     }
 
+    bool emit_left = !left_find_ && plan_->GetJoinType() == JoinType::LEFT;
+    left_index_++;
+    right_index_ = 0;
     left_find_ = false;
+    if (emit_left) {
+      *tuple = JoinTuples(left_tuple, nullptr);
+      return true;
+    }
   }
-
-  return false;
 }
 
 }  // namespace bustub
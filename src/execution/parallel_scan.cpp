@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_scan.cpp
+//
+// Identification: src/execution/parallel_scan.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/parallel_scan.h"
+
+#include <utility>
+
+namespace bustub {
+
+namespace {
+
+/** The number of morsels a worker may copy ahead of the morsel collected by NextMorsel. */
+constexpr size_t GATHER_AHEAD_PER_WORKER = 2;
+
+}  // namespace
+
+ParallelScan::ParallelScan(TableHeap *table_heap, std::optional<std::vector<uint32_t>> column_ids,
+                           AbstractExpressionRef filter, const Schema *schema, size_t num_workers,
+                           TableScanner::PageFilter page_filter, Transaction *txn)
+    : table_heap_(table_heap),
+      column_ids_(std::move(column_ids)),
+      filter_(std::move(filter)),
+      dictionary_filter_(filter_, table_heap_),
+      schema_(schema),
+      num_workers_(num_workers),
+      page_filter_(std::move(page_filter)),
+      txn_(txn) {}
+
+ParallelScan::~ParallelScan() { Stop(); }
+
+void ParallelScan::ForEach(const std::function<void(size_t, const TupleView &)> &consume) {
+  BUSTUB_ASSERT(workers_.empty(), "The scan was already started.");
+  dispenser_ = std::make_unique<MorselDispenser>(table_heap_, MORSEL_SIZE, txn_);
+  num_running_ = num_workers_;
+  for (size_t worker_idx = 0; worker_idx < num_workers_; worker_idx++) {
+    workers_.emplace_back([this, worker_idx, &consume] {
+      Work([&](const Morsel &morsel) {
+        VisitMorsel(morsel, [&](const TupleView &view) { consume(worker_idx, view); });
+      });
+    });
+  }
+  Join();
+  if (error_ != nullptr) {
+    std::rethrow_exception(error_);
+  }
+}
+
+void ParallelScan::StartGather() {
+  BUSTUB_ASSERT(workers_.empty(), "The scan was already started.");
+  dispenser_ = std::make_unique<MorselDispenser>(table_heap_, MORSEL_SIZE, txn_);
+  num_running_ = num_workers_;
+  for (size_t worker_idx = 0; worker_idx < num_workers_; worker_idx++) {
+    workers_.emplace_back([this] {
+      Work([this](const Morsel &morsel) {
+        {
+          // Morsels are claimed in order, so the worker copying the morsel to collect next never waits here.
+          std::unique_lock lock(latch_);
+          cv_.wait(lock, [&] {
+            return stop_ || morsel.index_ < next_gather_index_ + GATHER_AHEAD_PER_WORKER * num_workers_;
+          });
+          if (stop_) {
+            return;
+          }
+        }
+        std::vector<Tuple> tuples;
+        VisitMorsel(morsel, [&](const TupleView &view) { tuples.push_back(view.ToTuple()); });
+        std::scoped_lock lock(latch_);
+        gathered_.emplace(morsel.index_, std::move(tuples));
+        cv_.notify_all();
+      });
+    });
+  }
+}
+
+auto ParallelScan::NextMorsel(std::vector<Tuple> *tuples) -> bool {
+  std::unique_lock lock(latch_);
+  cv_.wait(lock, [&] { return error_ != nullptr || gathered_.count(next_gather_index_) > 0 || num_running_ == 0; });
+  if (error_ != nullptr) {
+    lock.unlock();
+    Stop();
+    std::rethrow_exception(error_);
+  }
+  // Morsels are numbered without gaps, so once the workers are done a missing morsel is the end of the table.
+  auto it = gathered_.find(next_gather_index_);
+  if (it == gathered_.end()) {
+    return false;
+  }
+  *tuples = std::move(it->second);
+  gathered_.erase(it);
+  next_gather_index_++;
+  cv_.notify_all();
+  return true;
+}
+
+void ParallelScan::Work(const std::function<void(const Morsel &)> &visit) {
+  try {
+    Morsel morsel;
+    while (!stop_ && dispenser_->Next(&morsel)) {
+      visit(morsel);
+    }
+  } catch (...) {
+    std::scoped_lock lock(latch_);
+    if (error_ == nullptr) {
+      error_ = std::current_exception();
+    }
+    stop_ = true;
+  }
+  std::scoped_lock lock(latch_);
+  num_running_--;
+  cv_.notify_all();
+}
+
+void ParallelScan::VisitMorsel(const Morsel &morsel, const TableScanner::Visitor &visitor) {
+  const std::vector<uint32_t> *column_ids = column_ids_.has_value() ? &column_ids_.value() : nullptr;
+  const Morsel *to_visit = &morsel;
+  Morsel filtered{morsel.index_, {}};
+  if (page_filter_ != nullptr) {
+    for (auto page_id : morsel.page_ids_) {
+      if (page_filter_(page_id)) {
+        filtered.page_ids_.push_back(page_id);
+      }
+    }
+    to_visit = &filtered;
+  }
+  if (!dictionary_filter_.IsEmpty()) {
+    dispenser_->VisitMorsel(*to_visit, column_ids, visitor,
+                            [&](const Tuple &encoded) { return dictionary_filter_.Evaluate(encoded); });
+    return;
+  }
+  dispenser_->VisitMorsel(*to_visit, column_ids, [&](const TupleView &view) {
+    if (filter_ != nullptr) {
+      auto value = filter_->Evaluate(&view.AsTuple(), *schema_);
+      if (value.IsNull() || !value.GetAs<bool>()) {
+        return;
+      }
+    }
+    visitor(view);
+  });
+}
+
+void ParallelScan::Stop() {
+  {
+    std::scoped_lock lock(latch_);
+    stop_ = true;
+    cv_.notify_all();
+  }
+  Join();
+}
+
+void ParallelScan::Join() {
+  for (auto &worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+}  // namespace bustub
@@ -1,35 +1,114 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx),
-      plan_(plan),
-      table_info_(exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())),
-      iter_(table_info_->table_->Begin(exec_ctx_->GetTransaction())) {}
-
-void SeqScanExecutor::Init() { iter_ = table_info_->table_->Begin(exec_ctx_->GetTransaction()); }
-
-auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (iter_ == table_info_->table_->End()) {
-    return false;
-  }
-  *tuple = *iter_;
-  *rid = iter_->GetRid();
-  iter_++;
-  return true;
-}
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/seq_scan_executor.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      table_info_(exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())) {
+  if (plan_->sample_.has_value()) {
+    // A rescan reads the same sample.
+    sample_ = plan_->sample_->WithSeed();
+  }
+}
+
+void SeqScanExecutor::Init() {
+  scanner_.reset();
+  parallel_scan_.reset();
+  page_tuples_.clear();
+  page_tuple_idx_ = 0;
+  auto num_workers = GetParallelism();
+  if (num_workers > 1) {
+    parallel_scan_ =
+        std::make_unique<ParallelScan>(table_info_->table_.get(), plan_->column_ids_, plan_->filter_predicate_,
+                                       &GetOutputSchema(), num_workers, MakePageFilter(), exec_ctx_->GetTransaction());
+    parallel_scan_->StartGather();
+  } else {
+    auto encoded_filter = MakeEncodedFilter();
+    has_encoded_filter_ = encoded_filter != nullptr;
+    scanner_ = std::make_unique<TableScanner>(table_info_->table_.get(), plan_->column_ids_, MakePageFilter(),
+                                              std::move(encoded_filter), exec_ctx_->GetTransaction(), sample_);
+  }
+}
+
+auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  // The page is released before the tuples are handed out, as the parent may write to the same table.
+  while (page_tuple_idx_ == page_tuples_.size()) {
+    page_tuples_.clear();
+    page_tuple_idx_ = 0;
+    if (parallel_scan_ != nullptr) {
+      if (!parallel_scan_->NextMorsel(&page_tuples_)) {
+        return false;
+      }
+      continue;
+    }
+    auto filter = has_encoded_filter_ ? nullptr : plan_->filter_predicate_;
+    bool has_page = scanner_->NextPage([&](const TupleView &view) {
+      if (filter != nullptr) {
+        auto value = filter->Evaluate(&view.AsTuple(), GetOutputSchema());
+        if (value.IsNull() || !value.GetAs<bool>()) {
+          return;
+        }
+      }
+      page_tuples_.push_back(view.ToTuple());
+    });
+    if (!has_page) {
+      return false;
+    }
+  }
+  *tuple = std::move(page_tuples_[page_tuple_idx_++]);
+  *rid = tuple->GetRid();
+  return true;
+}
+
+auto SeqScanExecutor::GetParallelism() const -> size_t {
+  if (parallel_scan_threads <= 1 || sample_.has_value()) {
+    return 1;
+  }
+  auto num_pages = table_info_->table_->GetFreeSpaceMap()->Size();
+  if (num_pages < PARALLEL_SCAN_MIN_PAGES) {
+    return 1;
+  }
+  // Every worker pins a page at a time, leave most of the buffer pool to the other executors.
+  auto max_workers = exec_ctx_->GetBufferPoolManager()->GetPoolSize() / 4;
+  return std::max<size_t>(1, std::min({parallel_scan_threads, num_pages / MORSEL_SIZE, max_workers}));
+}
+
+void SeqScanExecutor::ParallelForEach(size_t num_workers,
+                                      const std::function<void(size_t, const TupleView &)> &consume) {
+  ParallelScan scan(table_info_->table_.get(), plan_->column_ids_, plan_->filter_predicate_, &GetOutputSchema(),
+                    num_workers, MakePageFilter(), exec_ctx_->GetTransaction());
+  scan.ForEach(consume);
+}
+
+auto SeqScanExecutor::MakePageFilter() const -> TableScanner::PageFilter {
+  auto zone_filter = std::make_shared<ZoneFilter>(plan_->filter_predicate_, table_info_->table_->GetZoneMap());
+  if (zone_filter->IsEmpty()) {
+    return nullptr;
+  }
+  return [zone_filter](page_id_t page_id) { return zone_filter->MayMatch(page_id); };
+}
+
+auto SeqScanExecutor::MakeEncodedFilter() const -> TableScanner::EncodedFilter {
+  auto dictionary_filter = std::make_shared<DictionaryFilter>(plan_->filter_predicate_, table_info_->table_.get());
+  if (dictionary_filter->IsEmpty()) {
+    return nullptr;
+  }
+  return [dictionary_filter](const Tuple &encoded) { return dictionary_filter->Evaluate(encoded); };
+}
+
+}  // namespace bustub
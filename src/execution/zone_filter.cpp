@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_filter.cpp
+//
+// Identification: src/execution/zone_filter.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/zone_filter.h"
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+
+namespace bustub {
+
+namespace {
+
+auto IsNumeric(TypeId type) -> bool {
+  switch (type) {
+    case TypeId::TINYINT:
+    case TypeId::SMALLINT:
+    case TypeId::INTEGER:
+    case TypeId::BIGINT:
+    case TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/** @return true if a constant is compared with the values of the column without a cast which may fail */
+auto IsComparable(TypeId column_type, const Value &constant) -> bool {
+  if (constant.IsNull()) {
+    return false;
+  }
+  auto constant_type = constant.GetTypeId();
+  return (IsNumeric(column_type) && IsNumeric(constant_type)) ||
+         (column_type == TypeId::TIMESTAMP && constant_type == TypeId::TIMESTAMP);
+}
+
+/** @return the comparison with its operands swapped, e.g. `a > b` for `b < a` */
+auto Flip(ComparisonType comp_type) -> ComparisonType {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+auto IsTrue(CmpBool result) -> bool { return result == CmpBool::CmpTrue; }
+
+}  // namespace
+
+ZoneFilter::ZoneFilter(const AbstractExpressionRef &predicate, ZoneMap *zone_map) : zone_map_(zone_map) {
+  if (predicate != nullptr && zone_map_ != nullptr) {
+    AddBounds(*predicate);
+  }
+}
+
+void ZoneFilter::AddBounds(const AbstractExpression &expr) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(&expr); logic != nullptr) {
+    if (logic->logic_type_ == LogicType::And) {
+      AddBounds(*logic->GetChildAt(0));
+      AddBounds(*logic->GetChildAt(1));
+    }
+    return;
+  }
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(&expr);
+  if (comparison == nullptr) {
+    return;
+  }
+  auto comp_type = comparison->comp_type_;
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0).get());
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1).get());
+  if (column == nullptr || constant == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1).get());
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0).get());
+    comp_type = Flip(comp_type);
+  }
+  if (column == nullptr || constant == nullptr || column->GetTupleIdx() != 0 ||
+      !zone_map_->IsTracked(column->GetColIdx()) || !IsComparable(column->GetReturnType(), constant->val_)) {
+    return;
+  }
+  bounds_.push_back({column->GetColIdx(), comp_type, constant->val_});
+}
+
+auto ZoneFilter::MayMatch(page_id_t page_id) const -> bool {
+  if (bounds_.empty()) {
+    return true;
+  }
+  auto zones = zone_map_->GetZones(page_id);
+  if (!zones.has_value()) {
+    return true;
+  }
+  for (const auto &bound : bounds_) {
+    if (!MayMatch(bound, (*zones)[bound.column_idx_])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto ZoneFilter::MayMatch(const Bound &bound, const ColumnZone &zone) -> bool {
+  // A comparison with NULL is never true, so a page without any other value holds no match.
+  if (zone.min_.IsNull()) {
+    return false;
+  }
+  const auto &value = bound.value_;
+  switch (bound.comp_type_) {
+    case ComparisonType::Equal:
+      return !IsTrue(value.CompareLessThan(zone.min_)) && !IsTrue(value.CompareGreaterThan(zone.max_));
+    case ComparisonType::NotEqual:
+      return !(IsTrue(zone.min_.CompareEquals(value)) && IsTrue(zone.max_.CompareEquals(value)));
+    case ComparisonType::LessThan:
+      return IsTrue(zone.min_.CompareLessThan(value));
+    case ComparisonType::LessThanOrEqual:
+      return IsTrue(zone.min_.CompareLessThanEquals(value));
+    case ComparisonType::GreaterThan:
+      return IsTrue(zone.max_.CompareGreaterThan(value));
+    case ComparisonType::GreaterThanOrEqual:
+      return IsTrue(zone.max_.CompareGreaterThanEquals(value));
+    default:
+      return true;
+  }
+}
+
+}  // namespace bustub
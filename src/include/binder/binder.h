@@ -49,6 +49,7 @@
 #include "nodes/pg_list.hpp"
 #include "pg_definitions.hpp"
 #include "postgres_parser.hpp"
+#include "storage/table/table_sample.h"
 #include "type/type_id.h"
 #include "type/value.h"
 
@@ -63,6 +64,7 @@ struct PGColumnRef;
 struct PGResTarget;
 struct PGAExpr;
 struct PGJoinExpr;
+struct PGSampleOptions;
 }  // namespace duckdb_libpgquery
 
 namespace bustub {
@@ -77,6 +79,8 @@ class BoundExpressionListRef;
 class BoundOrderBy;
 class BoundSubqueryRef;
 class CreateStatement;
+class CopyStatement;
+class VacuumStatement;
 class ExplainStatement;
 class IndexStatement;
 class DeleteStatement;
@@ -161,6 +165,8 @@ class Binder {
 
   auto BindRangeVar(duckdb_libpgquery::PGRangeVar *table_ref) -> std::unique_ptr<BoundTableRef>;
 
+  auto BindTableSample(duckdb_libpgquery::PGSampleOptions *options) -> TableSample;
+
   auto BindTableRef(duckdb_libpgquery::PGNode *node) -> std::unique_ptr<BoundTableRef>;
 
   auto BindJoin(duckdb_libpgquery::PGJoinExpr *root) -> std::unique_ptr<BoundTableRef>;
@@ -198,6 +204,10 @@ class Binder {
 
   auto BindUpdate(duckdb_libpgquery::PGUpdateStmt *stmt) -> std::unique_ptr<UpdateStatement>;
 
+  auto BindCopy(duckdb_libpgquery::PGCopyStmt *stmt) -> std::unique_ptr<CopyStatement>;
+
+  auto BindVacuum(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<VacuumStatement>;
+
   auto BindCTE(duckdb_libpgquery::PGWithClause *node) -> std::vector<std::unique_ptr<BoundSubqueryRef>>;
 
   auto BindVariableSet(duckdb_libpgquery::PGVariableSetStmt *stmt) -> std::unique_ptr<VariableSetStatement>;
@@ -0,0 +1,40 @@
+//===----------------------------------------------------------------------===//
+//                         BusTub
+//
+// binder/copy_statement.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "binder/bound_statement.h"
+#include "binder/table_ref/bound_base_table_ref.h"
+
+namespace bustub {
+
+/**
+ * `COPY table FROM 'file'`, which bulk loads a delimited text file into a table.
+ */
+class CopyStatement : public BoundStatement {
+ public:
+  explicit CopyStatement(std::unique_ptr<BoundBaseTableRef> table, std::string file_name, char delimiter,
+                         bool header);
+
+  std::unique_ptr<BoundBaseTableRef> table_;
+
+  /** The file to load from. */
+  std::string file_name_;
+
+  /** The field separator. */
+  char delimiter_;
+
+  /** Whether the first line of the file is a header to skip. */
+  bool header_;
+
+  auto ToString() const -> std::string override;
+};
+
+}  // namespace bustub
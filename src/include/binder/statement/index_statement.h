@@ -15,13 +15,15 @@
 #include "binder/expressions/bound_column_ref.h"
 #include "binder/table_ref/bound_base_table_ref.h"
 #include "catalog/column.h"
+#include "common/config.h"
 
 namespace bustub {
 
 class IndexStatement : public BoundStatement {
  public:
   explicit IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                          std::vector<std::unique_ptr<BoundColumnRef>> cols);
+                          std::vector<std::unique_ptr<BoundColumnRef>> cols,
+                          IndexType index_type = IndexType::BPLUS_TREE, bool bloom_filter = false);
 
   /** Name of the index */
   std::string index_name_;
@@ -32,6 +34,12 @@ class IndexStatement : public BoundStatement {
   /** Name of the columns */
   std::vector<std::unique_ptr<BoundColumnRef>> cols_;
 
+  /** Structure of the index, `USING HASH` for a hash index */
+  IndexType index_type_;
+
+  /** Whether lookups consult a Bloom filter of the keys first, `WITH (bloom_filter)` */
+  bool bloom_filter_;
+
   auto ToString() const -> std::string override;
 };
 
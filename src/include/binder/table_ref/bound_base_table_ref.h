@@ -7,6 +7,7 @@
 #include "catalog/schema.h"
 #include "concurrency/transaction.h"
 #include "fmt/core.h"
+#include "storage/table/table_sample.h"
 
 namespace bustub {
 
@@ -23,10 +24,14 @@ class BoundBaseTableRef : public BoundTableRef {
         schema_(std::move(schema)) {}
 
   auto ToString() const -> std::string override {
+    std::string sample;
+    if (sample_.has_value()) {
+      sample = fmt::format(", sample={}", sample_->ToString());
+    }
     if (alias_ == std::nullopt) {
-      return fmt::format("BoundBaseTableRef {{ table={}, oid={} }}", table_, oid_);
+      return fmt::format("BoundBaseTableRef {{ table={}, oid={}{} }}", table_, oid_, sample);
     }
-    return fmt::format("BoundBaseTableRef {{ table={}, oid={}, alias={} }}", table_, oid_, *alias_);
+    return fmt::format("BoundBaseTableRef {{ table={}, oid={}, alias={}{} }}", table_, oid_, *alias_, sample);
   }
 
   auto GetBoundTableName() const -> std::string {
@@ -47,5 +52,8 @@ class BoundBaseTableRef : public BoundTableRef {
 
   /** The schema of the table. */
   Schema schema_;
+
+  /** The sample of the table to read, e.g. `FROM t TABLESAMPLE SYSTEM (10)`; std::nullopt to read all of it. */
+  std::optional<TableSample> sample_;
 };
 }  // namespace bustub
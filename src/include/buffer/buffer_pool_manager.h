@@ -15,6 +15,7 @@
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
@@ -84,6 +85,16 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Flush a batch of pages to disk. Pages that are not in the buffer pool are skipped.
+   * @param page_ids ids of the pages to be flushed
+   */
+  virtual void FlushPages(const std::vector<page_id_t> &page_ids) {
+    for (auto page_id : page_ids) {
+      FlushPgImp(page_id);
+    }
+  }
+
   /** @return size of the buffer pool */
   virtual auto GetPoolSize() -> size_t = 0;
 
@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
 #include <list>
 #include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 
 #include "buffer/buffer_pool_manager.h"
@@ -54,6 +57,37 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
+  /**
+   * @brief Flush a batch of pages to disk, writing each run of consecutive resident page ids with a single
+   * DiskManager::WritePages() call. Pages that are not in the buffer pool are skipped.
+   * @param page_ids ids of the pages to be flushed
+   */
+  void FlushPages(const std::vector<page_id_t> &page_ids) override;
+
+  /**
+   * @brief Write the ids of the resident pages to a side file, hottest first according to the LRU-K replacer, so that
+   * a later run can warm its buffer pool up with WarmUp().
+   * @param file_name the side file to (atomically) replace
+   */
+  void DumpResidentPages(const std::string &file_name);
+
+  /**
+   * @brief Prefetch the pages listed by DumpResidentPages() into the free frames. The hottest pages that fit are read
+   * in page id order, as runs of consecutive pages spread over several threads, and registered with the replacer so
+   * that the hottest ones are evicted last.
+   * @param file_name the side file written by DumpResidentPages()
+   * @param num_threads the number of threads reading pages in parallel
+   * @return the number of pages loaded
+   */
+  auto WarmUp(const std::string &file_name, size_t num_threads = 4) -> size_t;
+
+  /**
+   * @brief Dump the resident pages every `buffer_pool_dump_interval` in a background thread, and once more when the
+   * buffer pool is destroyed.
+   * @param file_name the side file to write
+   */
+  void StartResidentPagesDump(const std::string &file_name);
+
  protected:
   /**
    * TODO(P1): Add implementation
@@ -179,5 +213,15 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   }
 
   // TODO(student): You may add additional private members and helper functions
+
+  /** Background loop started by StartResidentPagesDump(). */
+  void RunResidentPagesDump();
+
+  // my variable
+  std::string dump_file_name_;
+  std::atomic<bool> enable_dump_{false};
+  std::thread *dump_thread_{nullptr};
+  std::mutex dump_latch_;
+  std::condition_variable dump_cv_;
 };
 }  // namespace bustub
@@ -134,6 +134,15 @@ class LRUKReplacer {
    */
   auto Size() -> size_t;
 
+  /**
+   * @brief Return every frame with an access history, hottest first: frames with k recorded accesses ordered by
+   * increasing backward k-distance, followed by the frames with +inf backward k-distance ordered by most recent access.
+   * Used to persist the hot set of the buffer pool across restarts.
+   *
+   * @return the frames ordered from the last to the first eviction candidate
+   */
+  auto GetFramesByRecency() -> std::vector<frame_id_t>;
+
  private:
   // TODO(student): implement me! You can replace these member variables as you like.
   // Remove maybe_unused if you start using them.
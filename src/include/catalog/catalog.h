@@ -70,15 +70,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The structure of the index
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPLUS_TREE)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -91,12 +93,18 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The structure of the index; only B+ tree indexes serve range scans and ordered reads */
+  const IndexType index_type_;
 };
 
 /**
- * The Catalog is a non-persistent catalog that is designed for
- * use by executors within the DBMS execution engine. It handles
- * table creation, table lookup, index creation, and index lookup.
+ * The Catalog is designed for use by executors within the DBMS execution engine.
+ * It handles table creation, table lookup, index creation, and index lookup.
+ *
+ * By default the catalog lives in memory only. Once `Bootstrap()` has been called,
+ * table schemas, index metadata and first-page ids are also written to a chain of
+ * catalog pages (whose head is recorded in the header page) on every DDL, so that
+ * reopening the database restores them without touching any table or index data.
  */
 class Catalog {
  public:
@@ -115,16 +123,25 @@ class Catalog {
   Catalog(BufferPoolManager *bpm, LockManager *lock_manager, LogManager *log_manager)
       : bpm_{bpm}, lock_manager_{lock_manager}, log_manager_{log_manager} {}
 
+  /**
+   * Make this catalog persistent. For a new database, the header page is reserved as the first page of the file.
+   * For an existing database, the tables and indexes recorded by a previous run are reloaded from the catalog
+   * pages; only metadata is read, table heaps and B+ trees are reattached through their first / root page ids.
+   * @param is_new_database Whether the database file was empty when it was opened
+   */
+  void Bootstrap(bool is_new_database);
+
   /**
    * Create a new table and return its metadata.
    * @param txn The transaction in which the table is being created
    * @param table_name The name of the new table, note that all tables beginning with `__` are reserved for the system.
    * @param schema The schema of the new table
    * @param create_table_heap whether to create a table heap for the new table
+   * @param format The page layout of the new table
    * @return A (non-owning) pointer to the metadata for the table
    */
   auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema,
-                   bool create_table_heap = true) -> TableInfo * {
+                   bool create_table_heap = true, TableFormat format = TableFormat::ROW) -> TableInfo * {
     if (table_names_.count(table_name) != 0) {
       return NULL_TABLE_INFO;
     }
@@ -136,7 +153,7 @@ class Catalog {
     // When create_table_heap == false, it means that we're running binder tests (where no txn will be provided) or
     // we are running shell without buffer pool. We don't need to create TableHeap in this case.
     if (create_table_heap) {
-      table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, txn);
+      table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, txn, format, &schema);
     }
 
     // Fetch the table OID for the new table
@@ -151,6 +168,10 @@ class Catalog {
     table_names_.emplace(table_name, table_oid);
     index_names_.emplace(table_name, std::unordered_map<std::string, index_oid_t>{});
 
+    if (create_table_heap) {
+      PersistCatalog();
+    }
+
     return tmp;
   }
 
@@ -196,12 +217,15 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
+   * @param index_type The structure of the index
+   * @param bloom_filter Whether lookups of a B+ tree index consult a Bloom filter of its keys first
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
-                   HashFunction<KeyType> hash_function) -> IndexInfo * {
+                   HashFunction<KeyType> hash_function, IndexType index_type = IndexType::BPLUS_TREE,
+                   bool bloom_filter = false) -> IndexInfo * {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
@@ -217,39 +241,81 @@ class Catalog {
       return NULL_INDEX_INFO;
     }
 
+    // Get the next OID for the new index
+    const auto index_oid = next_index_oid_.fetch_add(1);
+
     // Construct index metdata
     auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
 
-    // Construct the index, take ownership of metadata
-    // TODO(Kyle): We should update the API for CreateIndex
-    // to allow specification of the index type itself, not
-    // just the key, value, and comparator types
-
-    // TODO(chi): support both hash index and btree index
-    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
-
-    // Populate the index with all tuples in table heap
+    // Construct the index, take ownership of metadata, and populate it with all tuples in table heap
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+    std::unique_ptr<Index> index;
+    if (index_type == IndexType::HASH) {
+      auto hash_index =
+          std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                       hash_function);
+      for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
+        hash_index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+      }
+      index = std::move(hash_index);
+    } else {
+      // The tuples are sorted and packed into the tree bottom-up. Every (key, rid) pair of the table is held in
+      // memory while that happens; the sort does not spill runs to disk.
+      auto tree_index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(
+          std::move(meta), bpm_, RootRecordName(index_oid));
+      std::vector<std::pair<KeyType, ValueType>> entries;
+      for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
+        auto &[key, rid] = entries.emplace_back();
+        key.SetFromKey(tuple->KeyFromTuple(schema, key_schema, key_attrs));
+        rid = tuple->GetRid();
+      }
+      tree_index->BulkLoad(std::move(entries), txn);
+      if (bloom_filter) {
+        tree_index->EnableBloomFilter();
+      }
+      index = std::move(tree_index);
     }
 
-    // Get the next OID for the new index
-    const auto index_oid = next_index_oid_.fetch_add(1);
-
     // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
     auto *tmp = index_info.get();
 
     // Update internal tracking
     indexes_.emplace(index_oid, std::move(index_info));
     table_indexes.emplace(index_name, index_oid);
 
+    PersistCatalog();
+
     return tmp;
   }
 
+  /**
+   * Create a new index, with the key type and the comparator suited to the key schema, populate existing data of the
+   * table and return its metadata. Integer keys get comparators which do not deserialize Values.
+   * @param txn The transaction in which the table is being created
+   * @param index_name The name of the new index
+   * @param table_name The name of the table
+   * @param schema The schema of the table
+   * @param key_schema The schema of the key
+   * @param key_attrs Key attributes
+   * @param index_type The structure of the index
+   * @param bloom_filter Whether lookups of a B+ tree index consult a Bloom filter of its keys first
+   * @return A (non-owning) pointer to the metadata of the new index
+   */
+  auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
+                   const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
+                   IndexType index_type = IndexType::BPLUS_TREE, bool bloom_filter = false) -> IndexInfo * {
+    return VisitBPlusTreeIndexTypes(key_schema, [&](auto types) {
+      using Types = decltype(types);
+      using KeyType = typename Types::KeyType;
+      return CreateIndex<KeyType, typename Types::ValueType, typename Types::KeyComparator>(
+          txn, index_name, table_name, schema, key_schema, key_attrs, sizeof(KeyType), HashFunction<KeyType>{},
+          index_type, bloom_filter);
+    });
+  }
+
   /**
    * Get the index `index_name` for table `table_name`.
    * @param index_name The name of the index for which to query
@@ -298,7 +364,7 @@ class Catalog {
    * @param index_oid The OID of the index for which to query
    * @return A (non-owning) pointer to the metadata for the index
    */
-  auto GetIndex(index_oid_t index_oid) -> IndexInfo * {
+  auto GetIndex(index_oid_t index_oid) const -> IndexInfo * {
     auto index = indexes_.find(index_oid);
     if (index == indexes_.end()) {
       return NULL_INDEX_INFO;
@@ -342,6 +408,27 @@ class Catalog {
   }
 
  private:
+  /** Name of the header page record that points to the first catalog page. */
+  static constexpr const char *CATALOG_RECORD_NAME = "__catalog";
+
+  /**
+   * Name of the header page record that points to the root of a B+ tree index. It is derived from the index oid, as
+   * index names are only unique per table, may be as long as the records allow, and may be CATALOG_RECORD_NAME.
+   */
+  static auto RootRecordName(index_oid_t index_oid) -> std::string { return "__index_" + std::to_string(index_oid); }
+
+  /** Serialize all tables backed by a table heap, and their indexes, into the catalog pages. */
+  void PersistCatalog();
+
+  /** Deserialize the catalog pages written by `PersistCatalog()` and register their tables and indexes. */
+  void LoadCatalog(const std::string &data);
+
+  /** Whether DDL is written through to the catalog pages, set by `Bootstrap()`. */
+  bool persistent_{false};
+
+  /** The first catalog page, or INVALID_PAGE_ID if the catalog has never been persisted. */
+  page_id_t catalog_page_id_{INVALID_PAGE_ID};
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
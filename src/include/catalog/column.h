@@ -45,13 +45,14 @@ class Column {
    * @param column_name name of the column
    * @param type type of column
    * @param length length of the varlen
-   * @param expr expression used to create this column
+   * @param dictionary_encoded whether the values are stored as codes into the dictionary of the table
    */
-  Column(std::string column_name, TypeId type, uint32_t length)
+  Column(std::string column_name, TypeId type, uint32_t length, bool dictionary_encoded = false)
       : column_name_(std::move(column_name)),
         column_type_(type),
         fixed_length_(TypeSize(type)),
-        variable_length_(length) {
+        variable_length_(length),
+        dictionary_encoded_(dictionary_encoded) {
     BUSTUB_ASSERT(type == TypeId::VARCHAR, "Wrong constructor for non-VARCHAR type.");
   }
 
@@ -65,7 +66,8 @@ class Column {
         column_type_(column.column_type_),
         fixed_length_(column.fixed_length_),
         variable_length_(column.variable_length_),
-        column_offset_(column.column_offset_) {}
+        column_offset_(column.column_offset_),
+        dictionary_encoded_(column.dictionary_encoded_) {}
 
   /** @return column name */
   auto GetName() const -> std::string { return column_name_; }
@@ -93,6 +95,9 @@ class Column {
   /** @return true if column is inlined, false otherwise */
   auto IsInlined() const -> bool { return column_type_ != TypeId::VARCHAR; }
 
+  /** @return true if a table heap stores the values of this column as codes into its dictionary */
+  auto IsDictionaryEncoded() const -> bool { return dictionary_encoded_; }
+
   /** @return a string representation of this column */
   auto ToString(bool simplified = true) const -> std::string;
 
@@ -138,6 +143,9 @@ class Column {
 
   /** Column offset in the tuple. */
   uint32_t column_offset_{0};
+
+  /** For a VARCHAR column, whether the table heap replaces its values with dictionary codes. */
+  bool dictionary_encoded_{false};
 };
 
 }  // namespace bustub
@@ -12,12 +12,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
 #include <iostream>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <shared_mutex>
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -271,7 +275,30 @@ class BustubInstance {
   void CmdDisplayIndices(ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
+
+  /**
+   * Vacuum the table heaps of some tables.
+   * @param table_names the tables to vacuum
+   * @param only_if_needed whether to skip the tables with few deleted tuples
+   * @return the number of pages freed
+   */
+  auto VacuumTables(const std::vector<std::string> &table_names, bool only_if_needed) -> size_t;
+
+  /** Vacuum the tables which need it every `vacuum_interval` in a background thread. */
+  void StartBackgroundVacuum();
+
+  /** Stop the background vacuum thread, if it was started. */
+  void StopBackgroundVacuum();
+
+  /** Background loop started by StartBackgroundVacuum(). */
+  void RunBackgroundVacuum();
+
   std::unordered_map<std::string, std::string> session_variables_;
+
+  std::atomic<bool> enable_vacuum_{false};
+  std::thread *vacuum_thread_{nullptr};
+  std::mutex vacuum_latch_;
+  std::condition_variable vacuum_cv_;
 };
 
 }  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
 
 namespace bustub {
@@ -27,6 +28,30 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** The resident pages of the buffer pool are written to the warm-up file every BUFFER_POOL_DUMP_INTERVAL. */
+extern std::chrono::milliseconds buffer_pool_dump_interval;
+
+/** The background vacuum looks for table heaps with many deleted tuples every VACUUM_INTERVAL. */
+extern std::chrono::milliseconds vacuum_interval;
+
+/** The number of worker threads of a parallel table scan, 1 to scan tables on the calling thread only. */
+extern size_t parallel_scan_threads;
+
+/** The share of the entries a leaf can hold that a bulk load of a B+ tree index fills, between 0 and 1. */
+extern double index_fill_factor;
+
+/** The number of threads sorting the entries of a B+ tree index built by a bulk load. */
+extern size_t index_sort_threads;
+
+/** True if a B+ tree index iterator fetches the next leaf on another thread while it scans the current one. */
+extern bool index_scan_prefetch;
+
+/** The number of outer tuples a nested index join looks up in the index at once, in key order; 1 looks up each one. */
+extern size_t index_join_batch_size;
+
+/** The bits a Bloom filter of index keys takes per key it is sized for; 10 bits give about 1% false positives. */
+extern size_t bloom_filter_bits_per_key;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
@@ -36,14 +61,26 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int LOG_SEGMENT_SIZE = 16 * 1024 * 1024;  // size of a preallocated WAL segment file in byte
+static constexpr size_t MORSEL_SIZE = 16;                  // number of pages of a morsel of a parallel scan
+static constexpr size_t PARALLEL_SCAN_MIN_PAGES = 64;      // tables with fewer pages are scanned by one thread
+static constexpr size_t INDEX_SORT_MIN_RUN = 4096;         // number of entries of the smallest run of an index sort
+static constexpr size_t BLOOM_FILTER_MIN_KEYS = 1024;      // number of keys the smallest index Bloom filter holds
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
 using txn_id_t = int32_t;      // transaction id type
 using lsn_t = int32_t;         // log sequence number type
+using timestamp_t = int64_t;   // commit timestamp type
 using slot_offset_t = size_t;  // slot offset type
 using oid_t = uint16_t;
 
 static constexpr int VARCHAR_DEFAULT_LENGTH = 128;  // default length for varchar when constructing the column
 
+/** Page layout of a table: rows stored one after another in slotted pages, or values grouped by column (PAX). */
+enum class TableFormat { ROW, PAX };
+
+/** Structure of an index: a B+ tree, which serves range scans and ordered reads, or an extendible hash table. */
+enum class IndexType { BPLUS_TREE, HASH };
+
 }  // namespace bustub
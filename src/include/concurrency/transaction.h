@@ -45,9 +45,10 @@ namespace bustub {
 enum class TransactionState { GROWING, SHRINKING, COMMITTED, ABORTED };
 
 /**
- * Transaction isolation level.
+ * Transaction isolation level. A SNAPSHOT_ISOLATION transaction reads the tables as of the time it began, from the
+ * versions kept by the table heaps, without taking any lock.
  */
-enum class IsolationLevel { READ_UNCOMMITTED, REPEATABLE_READ, READ_COMMITTED };
+enum class IsolationLevel { READ_UNCOMMITTED, REPEATABLE_READ, READ_COMMITTED, SNAPSHOT_ISOLATION };
 
 /**
  * Type of write operation.
@@ -323,6 +324,18 @@ class Transaction {
    */
   inline void SetPrevLSN(lsn_t prev_lsn) { prev_lsn_ = prev_lsn; }
 
+  /** @return the timestamp of the last commit visible to the transaction, i.e. of its snapshot */
+  inline auto GetReadTs() const -> timestamp_t { return read_ts_; }
+
+  /** Set the timestamp of the snapshot of the transaction. */
+  inline void SetReadTs(timestamp_t read_ts) { read_ts_ = read_ts; }
+
+  /** @return the commit timestamp of the transaction, 0 until it commits a write */
+  inline auto GetCommitTs() const -> timestamp_t { return commit_ts_; }
+
+  /** Set the commit timestamp of the transaction. */
+  inline void SetCommitTs(timestamp_t commit_ts) { commit_ts_ = commit_ts; }
+
  private:
   /** The current transaction state. */
   TransactionState state_{TransactionState::GROWING};
@@ -339,6 +352,10 @@ class Transaction {
   std::shared_ptr<std::deque<IndexWriteRecord>> index_write_set_;
   /** The LSN of the last record written by the transaction. */
   lsn_t prev_lsn_;
+  /** MVCC: the timestamp of the snapshot read by the transaction. */
+  timestamp_t read_ts_{0};
+  /** MVCC: the timestamp at which the writes of the transaction became visible. */
+  timestamp_t commit_ts_{0};
 
   std::mutex latch_;
 
@@ -13,6 +13,9 @@
 #pragma once
 
 #include <atomic>
+#include <deque>
+#include <mutex>  // NOLINT
+#include <set>
 #include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
@@ -24,9 +27,15 @@
 
 namespace bustub {
 class LockManager;
+class TableHeap;
 
 /**
  * TransactionManager keeps track of all the transactions running in the system.
+ *
+ * It also hands out the timestamps of the versions of the tuples. A transaction reads the snapshot of the last commit
+ * before it began, and its writes are stamped with a new commit timestamp when it commits. The tuples written are
+ * queued for garbage collection, which drops their older versions and removes the deleted ones from their table once
+ * no transaction running reads a snapshot predating the commit.
  */
 class TransactionManager {
  public:
@@ -77,6 +86,18 @@ class TransactionManager {
     return res;
   }
 
+  /** Collect the garbage of the tuples written by the transactions finished before the oldest one running. */
+  void GarbageCollect();
+
+  /** @return the read timestamp of the oldest transaction running, or the last commit timestamp if there is none */
+  auto GetWatermark() -> timestamp_t;
+
+  /** @return the timestamp of the last commit */
+  auto GetLastCommitTs() -> timestamp_t {
+    std::scoped_lock lock(ts_latch_);
+    return last_commit_ts_;
+  }
+
   /** Prevents all transactions from performing operations, used for checkpointing. */
   void BlockAllTransactions();
 
@@ -84,6 +105,16 @@ class TransactionManager {
   void ResumeTransactions();
 
  private:
+  /** A tuple written by a finished transaction, whose garbage can be collected from the given timestamp on. */
+  struct GarbageRecord {
+    TableHeap *table_;
+    RID rid_;
+    timestamp_t ts_;
+  };
+
+  /** Unregister the snapshot of a finished transaction. */
+  void EndSnapshot(Transaction *txn);
+
   /**
    * Releases all the locks held by the given transaction.
    * @param txn the transaction whose locks should be released
@@ -140,6 +171,17 @@ class TransactionManager {
 
   /** The global transaction latch is used for checkpointing. */
   ReaderWriterLatch global_txn_latch_;
+
+  /** Serializes the commits, so that their timestamps are published in order. */
+  std::mutex commit_latch_;
+  /** Protects the last commit timestamp and the read timestamps of the transactions running. */
+  std::mutex ts_latch_;
+  timestamp_t last_commit_ts_{0};
+  std::multiset<timestamp_t> active_read_ts_;
+
+  /** Protects the garbage queue, ordered by timestamp. */
+  std::mutex gc_latch_;
+  std::deque<GarbageRecord> garbage_;
 };
 
 }  // namespace bustub
@@ -18,6 +18,7 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/transaction.h"
+#include "container/disk/hash/hash_table_directory.h"
 #include "container/hash/hash_function.h"
 #include "storage/page/hash_table_bucket_page.h"
 #include "storage/page/hash_table_directory_page.h"
@@ -30,6 +31,16 @@ namespace bustub {
  * Implementation of extendible hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table grows/shrinks dynamically as buckets become full/empty.
+ *
+ * A lookup reads the directory and the bucket page of the key. The directory
+ * spans several pages once it outgrows its first one; once it has
+ * HashTableDirectory::MAX_SIZE slots, or when all the keys of a full bucket
+ * hash alike, the bucket is extended by overflow pages instead of being split,
+ * so that an insert never fails for lack of room.
+ *
+ * Lookups, inserts and removes share the table latch and latch the first page
+ * of the bucket, which guards its overflow pages; splits and merges hold the
+ * table latch exclusively.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class DiskExtendibleHashTable {
@@ -40,9 +51,12 @@ class DiskExtendibleHashTable {
    * @param buffer_pool_manager buffer pool manager to be used
    * @param comparator comparator for keys
    * @param hash_fn the hash function
+   * @param directory_page_id the directory page of a table persisted by a previous run, INVALID_PAGE_ID to create a
+   * new table
    */
   explicit DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                   page_id_t directory_page_id = INVALID_PAGE_ID);
 
   /**
    * Inserts a key-value pair into the hash table.
@@ -79,6 +93,9 @@ class DiskExtendibleHashTable {
    */
   auto GetGlobalDepth() -> uint32_t;
 
+  /** @return the page id of the directory page, which the table can be reopened from */
+  auto GetDirectoryPageId() const -> page_id_t { return directory_page_id_; }
+
   /**
    * Helper function to verify the integrity of the extendible hash table's directory.
    */
@@ -107,26 +124,27 @@ class DiskExtendibleHashTable {
    * representation.
    *
    * @param key the key to use for lookup
-   * @param dir_page to use for lookup of global depth
+   * @param directory to use for lookup of global depth
    * @return the directory index
    */
-  auto KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t;
+  auto KeyToDirectoryIndex(KeyType key, HashTableDirectory *directory) -> uint32_t;
 
   /**
    * Get the bucket page_id corresponding to a key.
    *
    * @param key the key for lookup
-   * @param dir_page a pointer to the hash table's directory page
    * @return the bucket page_id corresponding to the input key
    */
-  auto KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t;
+  auto KeyToPageId(KeyType key) -> page_id_t;
 
   /**
-   * Fetches the directory page from the buffer pool manager.
+   * Fetches the first page of a bucket, which guards the bucket, pinned. Releases the shared table latch and throws if
+   * it cannot be fetched.
    *
-   * @return a pointer to the directory page
+   * @param bucket_page_id the page_id to fetch
+   * @return the first page of the bucket
    */
-  auto FetchDirectoryPage() -> HashTableDirectoryPage *;
+  auto FetchBucketHead(page_id_t bucket_page_id) -> Page *;
 
   /**
    * Fetches the a bucket page from the buffer pool manager using the bucket's page_id.
@@ -161,6 +179,40 @@ class DiskExtendibleHashTable {
    */
   void Merge(Transaction *transaction, const KeyType &key, const ValueType &value);
 
+  /**
+   * Allocates and initializes a bucket page, pinned.
+   *
+   * @param[out] page_id the page id of the new bucket page
+   * @return a pointer to the new bucket page
+   */
+  auto NewBucketPage(page_id_t *page_id) -> HASH_TABLE_BUCKET_TYPE *;
+
+  /**
+   * Looks for a pair in a bucket and its overflow pages.
+   *
+   * @param bucket_page_id the first page of the bucket
+   * @param[out] free_page_id the first page of the bucket with room for another pair, INVALID_PAGE_ID if none has
+   * @return true if the bucket holds the pair
+   */
+  auto FindInChain(page_id_t bucket_page_id, const KeyType &key, const ValueType &value, page_id_t *free_page_id)
+      -> bool;
+
+  /**
+   * Inserts a pair into the first page of a bucket with room for it, appending an overflow page if none has. The
+   * caller makes sure that the pair is not in the bucket yet.
+   *
+   * @param bucket_page_id the first page of the bucket
+   */
+  void InsertIntoChain(page_id_t bucket_page_id, const KeyType &key, const ValueType &value);
+
+  /**
+   * Splits the bucket at a directory index into itself and its split image, doubling the directory if the bucket is
+   * referred to by a single index.
+   *
+   * @return false if the bucket cannot be split, as the directory is full or its keys all hash alike
+   */
+  auto SplitBucket(HashTableDirectory *directory, uint32_t bucket_idx) -> bool;
+
   // member variables
   page_id_t directory_page_id_;
   BufferPoolManager *buffer_pool_manager_;
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory.h
+//
+// Identification: src/include/container/disk/hash/hash_table_directory.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "storage/page/hash_table_directory_page.h"
+
+namespace bustub {
+
+/**
+ * The directory of a disk extendible hash table, which spans several pages once it outgrows its first one.
+ *
+ * The first page holds the global depth and the first DIRECTORY_ARRAY_SIZE slots of the directory, a bucket page id
+ * and a local depth each, along with the page ids of up to DIRECTORY_EXTENSION_SIZE extension pages, which hold the
+ * next DIRECTORY_ARRAY_SIZE slots each. Extension pages are allocated as the directory doubles past its first page,
+ * and deleted as it is halved again.
+ *
+ * The first page stays pinned while the object lives, an extension page while one of its slots is accessed. The caller
+ * holds the table latch, exclusively to change the directory.
+ */
+class HashTableDirectory {
+ public:
+  /** The number of slots the directory can have, over all its pages. */
+  static constexpr uint32_t MAX_SIZE = DIRECTORY_ARRAY_SIZE * (DIRECTORY_EXTENSION_SIZE + 1);
+
+  /** Fetch the first page of the directory; throws if it cannot be fetched. */
+  HashTableDirectory(BufferPoolManager *buffer_pool_manager, page_id_t directory_page_id);
+
+  /** Unpin the first page, dirty if the directory was changed. */
+  ~HashTableDirectory();
+
+  DISALLOW_COPY_AND_MOVE(HashTableDirectory);
+
+  auto GetGlobalDepth() -> uint32_t { return first_page_->GetGlobalDepth(); }
+
+  auto GetGlobalDepthMask() -> uint32_t { return first_page_->GetGlobalDepthMask(); }
+
+  auto Size() -> uint32_t { return first_page_->Size(); }
+
+  auto GetBucketPageId(uint32_t bucket_idx) -> page_id_t;
+
+  void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id);
+
+  auto GetLocalDepth(uint32_t bucket_idx) -> uint32_t;
+
+  void SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth);
+
+  /** @return the directory index of the split image of the bucket at bucket_idx */
+  auto GetSplitImageIndex(uint32_t bucket_idx) -> uint32_t;
+
+  /** Double the directory, its new upper half a copy of the lower half, allocating the extension pages it needs. */
+  void IncrGlobalDepth();
+
+  /** Halve the directory, deleting the extension pages of its upper half. */
+  void DecrGlobalDepth();
+
+  /** @return true if every local depth is below the global depth, so that the directory can be halved */
+  auto CanShrink() -> bool;
+
+  /** Verify the invariants of HashTableDirectoryPage::VerifyIntegrity over the slots of all the pages. */
+  void VerifyIntegrity();
+
+ private:
+  /** @return the page holding the slot at bucket_idx, pinned, and the index of the slot in it */
+  auto FetchSlotPage(uint32_t bucket_idx) -> std::pair<HashTableDirectoryPage *, uint32_t>;
+
+  /** Unpin a page returned by FetchSlotPage. */
+  void UnpinSlotPage(HashTableDirectoryPage *page, bool is_dirty);
+
+  BufferPoolManager *buffer_pool_manager_;
+  page_id_t directory_page_id_;
+  HashTableDirectoryPage *first_page_;
+  bool is_dirty_{false};
+};
+
+}  // namespace bustub
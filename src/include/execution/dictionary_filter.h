@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// dictionary_filter.h
+//
+// Identification: src/include/execution/dictionary_filter.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "execution/expressions/abstract_expression.h"
+#include "storage/table/dictionary.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * DictionaryFilter evaluates a scan predicate on the encoded tuples of a dictionary encoded table, so that only the
+ * tuples which pass are decoded. The predicate is rewritten to compare codes instead of strings: `#0.1 = 'abc'`
+ * becomes `#0.1 = <code of 'abc'>`, and an equality between two encoded columns compares their codes directly, as the
+ * columns of a table share their dictionary. A value which is not in the dictionary gets a code no value has.
+ *
+ * Codes do not follow the order of the strings, so a predicate using an encoded column in any other way, e.g. in a
+ * range comparison, is not rewritten and has to be evaluated on the decoded tuples.
+ */
+class DictionaryFilter {
+ public:
+  /**
+   * @param predicate the filter of a sequential scan, evaluated against the tuples of the table; may be nullptr
+   * @param table_heap the scanned table
+   */
+  DictionaryFilter(const AbstractExpressionRef &predicate, TableHeap *table_heap);
+
+  /** @return true if the predicate cannot be evaluated on the encoded tuples */
+  auto IsEmpty() const -> bool { return encoded_predicate_ == nullptr; }
+
+  /** @return true if an encoded tuple satisfies the predicate */
+  auto Evaluate(const Tuple &encoded) const -> bool;
+
+  /** The code compared with a string which is not in the dictionary. */
+  static constexpr int32_t NO_CODE = -1;
+
+ private:
+  /** @return the expression evaluated on the encoded tuples, nullptr if it cannot be rewritten */
+  auto Rewrite(const AbstractExpressionRef &expr) const -> AbstractExpressionRef;
+
+  /** @return true if the expression reads a dictionary encoded column */
+  auto IsEncodedColumn(const AbstractExpressionRef &expr) const -> bool;
+
+  Dictionary *dictionary_;
+  AbstractExpressionRef encoded_predicate_;
+};
+
+}  // namespace bustub
@@ -21,6 +21,7 @@
 #include "container/hash/hash_function.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/executors/seq_scan_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/aggregation_plan.h"
 #include "storage/table/tuple.h"
@@ -112,6 +113,53 @@ class SimpleAggregationHashTable {
     }
   }
 
+  /**
+   * Merges partial aggregates, computed over other input values, into the aggregation result.
+   * @param[out] result The output aggregate value
+   * @param partial The partial aggregate value
+   */
+  void MergeAggregateValues(AggregateValue *result, const AggregateValue &partial) {
+    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
+      const auto &value = partial.aggregates_[i];
+      auto &merged = result->aggregates_[i];
+      if (value.IsNull()) {
+        continue;
+      }
+      if (merged.IsNull()) {
+        merged = value;
+        continue;
+      }
+      switch (agg_types_[i]) {
+        case AggregationType::CountStarAggregate:
+        case AggregationType::CountAggregate:
+        case AggregationType::SumAggregate:
+          merged = merged.Add(value);
+          break;
+        case AggregationType::MinAggregate:
+          merged = merged.Min(value);
+          break;
+        case AggregationType::MaxAggregate:
+          merged = merged.Max(value);
+          break;
+      }
+    }
+  }
+
+  /**
+   * Merges the aggregations of another hash table, e.g. built by another thread over other tuples, into this one.
+   * @param other The hash table to merge
+   */
+  void Merge(const SimpleAggregationHashTable &other) {
+    for (const auto &[agg_key, agg_val] : other.ht_) {
+      auto it = ht_.find(agg_key);
+      if (it == ht_.end()) {
+        ht_.insert({agg_key, agg_val});
+      } else {
+        MergeAggregateValues(&it->second, agg_val);
+      }
+    }
+  }
+
   /**
    * Inserts a value into the hash table and then combines it with the current aggregation.
    * @param agg_key the key to be inserted
@@ -215,6 +263,9 @@ class AggregationExecutor : public AbstractExecutor {
     return {keys};
   }
 
+  /** Aggregate the tuples of a large table scanned by the child in partial hash tables, one per worker thread. */
+  void ParallelAggregate(SeqScanExecutor *seq_scan, size_t num_workers);
+
   /** @return The tuple as an AggregateValue */
   auto MakeAggregateValue(const Tuple *tuple) -> AggregateValue {
     std::vector<Value> vals;
@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// copy_executor.h
+//
+// Identification: src/include/execution/executors/copy_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/copy_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * CopyExecutor bulk loads a delimited text file into a table.
+ *
+ * The file is first parsed through without loading anything, so that a malformed line leaves the table as it was.
+ * Rows are then parsed again in batches, appended with TableHeap::BulkInsertTuples(), and the keys of each batch
+ * inserted into every index with Index::InsertEntries().
+ */
+class CopyExecutor : public AbstractExecutor {
+ public:
+  /** Number of rows handed to the table heap, and then to each index, at once. */
+  static constexpr size_t BATCH_SIZE = 4096;
+
+  /**
+   * Construct a new CopyExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The copy plan to be executed
+   */
+  CopyExecutor(ExecutorContext *exec_ctx, const CopyPlanNode *plan);
+
+  /** Initialize the copy */
+  void Init() override;
+
+  /**
+   * Yield the number of rows loaded into the table.
+   * @param[out] tuple The integer tuple indicating the number of rows loaded into the table
+   * @param[out] rid The next tuple RID produced by the copy (ignore, not used)
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool override;
+
+  /** @return The output schema for the copy */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
+
+ private:
+  /** Parse each non-empty line of the file after the header, in order, and hand the row to callback. */
+  void ForEachRow(const std::function<void(Tuple &&)> &callback);
+
+  /** Parse one line of the file into a tuple of the table. */
+  auto ParseLine(const std::string &line, size_t line_number) -> Tuple;
+
+  /** The copy plan node to be executed */
+  const CopyPlanNode *plan_;
+  // my variable
+  TableInfo *table_info_;
+  std::vector<IndexInfo *> table_indexes_;
+  bool is_end_;
+};
+
+}  // namespace bustub
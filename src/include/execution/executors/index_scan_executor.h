@@ -18,12 +18,14 @@
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/index_scan_plan.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * IndexScanExecutor executes an index scan over a table.
+ * IndexScanExecutor executes an index scan over a table. Init reads the record ids of the keys in the bounds of the
+ * plan, leaf after leaf, so that no leaf stays latched while the tuples are returned to the executors above.
  */
 
 class IndexScanExecutor : public AbstractExecutor {
@@ -42,12 +44,17 @@ class IndexScanExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Read the record ids of the keys in the bounds of the plan from the tree of the index. */
+  template <typename KeyType, typename ValueType, typename KeyComparator>
+  void ScanKeys(BPlusTreeIndex<KeyType, ValueType, KeyComparator> *tree);
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
   // my variable
   IndexInfo *index_info_;
   TableInfo *table_info_;
-  BPlusTreeIndexForOneIntegerColumn *tree_;
-  BPlusTreeIndexIteratorForOneIntegerColumn index_iter_;
+  // the record ids of the keys in the bounds, in key order, and the next one to return
+  std::vector<RID> rids_;
+  size_t next_rid_{0};
 };
 }  // namespace bustub
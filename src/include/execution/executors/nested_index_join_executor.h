@@ -30,7 +30,8 @@
 namespace bustub {
 
 /**
- * IndexJoinExecutor executes index join operations.
+ * IndexJoinExecutor executes index join operations. The outer tuples are read in batches of index_join_batch_size,
+ * whose join keys are looked up in the index at once, which sorts them so that keys sharing a leaf share a descent.
  */
 class NestIndexJoinExecutor : public AbstractExecutor {
  public:
@@ -50,19 +51,24 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Read the next batch of outer tuples and look their join keys up; false if the outer table is exhausted. */
+  auto NextBatch() -> bool;
+
+  /** @return the output tuple joining an outer tuple with an inner tuple, or with NULLs if right_tuple is nullptr */
+  auto JoinTuples(const Tuple &left_tuple, const Tuple *right_tuple) const -> Tuple;
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
   // my variable
   std::unique_ptr<AbstractExecutor> child_executor_;
   TableInfo *inner_table_info_;
   IndexInfo *index_info_;
-  BPlusTreeIndexForOneIntegerColumn *tree_;
-  BPlusTreeIndexIteratorForOneIntegerColumn index_iter_;
-  Tuple left_tuple_;
-  RID left_rid_;
-  bool left_status_;
-  bool left_find_;
-  Tuple right_tuple_;
-  RID right_rid_;
+  // the current batch of outer tuples and the record ids their keys match in the index
+  std::vector<Tuple> left_tuples_;
+  std::vector<std::vector<RID>> right_rids_;
+  // the outer tuple being joined and its next record id
+  size_t left_index_{0};
+  size_t right_index_{0};
+  bool left_find_{false};
 };
 }  // namespace bustub
@@ -12,17 +12,33 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <optional>
 #include <vector>
 
+#include "execution/dictionary_filter.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/parallel_scan.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/zone_filter.h"
+#include "storage/table/table_scanner.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * The SeqScanExecutor executor executes a sequential table scan.
+ * The SeqScanExecutor executor executes a sequential table scan. The table is read a page at a time: the filter of
+ * the plan, if any, is evaluated on views of the tuples in the page, and only the tuples which pass are copied. The
+ * pages whose zones show they hold no tuple satisfying the filter are skipped, and the filter is evaluated on the
+ * codes of a dictionary encoded table when possible, so that only the tuples which pass are decoded. A
+ * SNAPSHOT_ISOLATION transaction reads the versions of the tuples of its snapshot, without taking any lock. A sampled
+ * scan only reads the pages, or returns the tuples, of its sample, and is never run in parallel.
+ *
+ * A large table is read by the worker threads of a ParallelScan, and its tuples are still produced in table order.
+ * A parent which does not need them one by one, e.g. an aggregation, can run its work on the workers with
+ * ParallelForEach instead.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -47,11 +63,36 @@ class SeqScanExecutor : public AbstractExecutor {
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
+  /** @return the number of worker threads scanning the table, 1 if the table is scanned on the calling thread */
+  auto GetParallelism() const -> size_t;
+
+  /**
+   * Scan the whole table on worker threads, instead of producing the tuples with Next.
+   * @param num_workers the number of worker threads, e.g. GetParallelism()
+   * @param consume called concurrently by the workers with the index of the worker and a view of every tuple which
+   * passes the filter; the view is only valid during the call
+   */
+  void ParallelForEach(size_t num_workers, const std::function<void(size_t, const TupleView &)> &consume);
+
  private:
+  /** @return the filter skipping the pages which cannot hold a tuple satisfying the plan filter, nullptr if none */
+  auto MakePageFilter() const -> TableScanner::PageFilter;
+
+  /** @return the plan filter evaluated on the encoded tuples, nullptr if it cannot be */
+  auto MakeEncodedFilter() const -> TableScanner::EncodedFilter;
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
   // my variable
   TableInfo *table_info_;
-  TableIterator iter_;
+  /** The sample of the plan, with the seed drawn for this executor. */
+  std::optional<TableSample> sample_;
+  std::unique_ptr<TableScanner> scanner_;
+  /** Whether the scanner evaluates the plan filter on the encoded tuples. */
+  bool has_encoded_filter_{false};
+  std::unique_ptr<ParallelScan> parallel_scan_;
+  /** The tuples of the current page, handed out in order. */
+  std::vector<Tuple> page_tuples_;
+  size_t page_tuple_idx_{0};
 };
 }  // namespace bustub
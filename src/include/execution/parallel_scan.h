@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_scan.h
+//
+// Identification: src/include/execution/parallel_scan.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/dictionary_filter.h"
+#include "execution/expressions/abstract_expression.h"
+#include "storage/table/morsel_dispenser.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * ParallelScan scans a table on worker threads. The table is split into morsels by a MorselDispenser; every worker
+ * claims morsels until none is left, and evaluates the filter on views of their tuples. The tuples which pass are
+ * either handed to a consumer on the worker (ForEach), so that e.g. an aggregation runs per worker, or copied and
+ * collected back on the calling thread in table order (StartGather and NextMorsel). The filter of a dictionary
+ * encoded table is evaluated on the codes when possible, see DictionaryFilter.
+ *
+ * An exception thrown on a worker stops the scan, and is rethrown on the calling thread.
+ */
+class ParallelScan {
+ public:
+  /**
+   * @param table_heap the table to scan
+   * @param column_ids the columns needed, see TableHeap::GetTuple
+   * @param filter the predicate the tuples must satisfy, nullptr to keep them all
+   * @param schema the schema of the tuples, to evaluate the filter
+   * @param num_workers the number of worker threads
+   * @param page_filter the pages to visit, nullptr for all of them; the other pages of a morsel are not even fetched
+   * @param txn the transaction performing the scan, see TableScanner
+   */
+  ParallelScan(TableHeap *table_heap, std::optional<std::vector<uint32_t>> column_ids, AbstractExpressionRef filter,
+               const Schema *schema, size_t num_workers, TableScanner::PageFilter page_filter = nullptr,
+               Transaction *txn = nullptr);
+
+  /** Stop the workers and wait for them. */
+  ~ParallelScan();
+
+  DISALLOW_COPY_AND_MOVE(ParallelScan);
+
+  /**
+   * Scan the whole table, and return once it is done.
+   * @param consume called concurrently by the workers with the index of the worker, in [0, num_workers), and a view of
+   * every tuple which passes the filter; the view is only valid during the call
+   */
+  void ForEach(const std::function<void(size_t, const TupleView &)> &consume);
+
+  /** Start the workers copying the tuples of the morsels, to be collected with NextMorsel. */
+  void StartGather();
+
+  /**
+   * Wait for the tuples of the next morsel in table order. At most a few morsels per worker are read ahead.
+   * @param[out] tuples the tuples of the morsel which pass the filter
+   * @return false once every morsel was collected
+   */
+  auto NextMorsel(std::vector<Tuple> *tuples) -> bool;
+
+ private:
+  /** Claim and visit morsels until the table is done or the scan is stopped, on a worker thread. */
+  void Work(const std::function<void(const Morsel &)> &visit);
+
+  /** Visit the tuples of a morsel which pass the filter. */
+  void VisitMorsel(const Morsel &morsel, const TableScanner::Visitor &visitor);
+
+  /** Stop the workers and wait for them. */
+  void Stop();
+
+  /** Wait for the workers. */
+  void Join();
+
+  TableHeap *table_heap_;
+  std::optional<std::vector<uint32_t>> column_ids_;
+  AbstractExpressionRef filter_;
+  DictionaryFilter dictionary_filter_;
+  const Schema *schema_;
+  size_t num_workers_;
+  TableScanner::PageFilter page_filter_;
+  Transaction *txn_;
+  std::unique_ptr<MorselDispenser> dispenser_;
+  std::vector<std::thread> workers_;
+  std::atomic<bool> stop_{false};
+
+  /** Protects the fields below. */
+  std::mutex latch_;
+  std::condition_variable cv_;
+  /** The number of workers which have not finished. */
+  size_t num_running_{0};
+  /** The first exception thrown by a worker. */
+  std::exception_ptr error_;
+  /** The tuples of the morsels copied but not collected yet, by morsel index. */
+  std::map<size_t, std::vector<Tuple>> gathered_;
+  /** The index of the next morsel to collect. */
+  size_t next_gather_index_{0};
+};
+
+}  // namespace bustub
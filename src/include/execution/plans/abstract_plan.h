@@ -47,7 +47,8 @@ enum class PlanType {
   Projection,
   Sort,
   TopN,
-  MockScan
+  MockScan,
+  Copy
 };
 
 class AbstractPlanNode;
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// copy_plan.h
+//
+// Identification: src/include/execution/plans/copy_plan.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "catalog/catalog.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * The CopyPlanNode bulk loads the rows of a delimited text file into a table.
+ *
+ * Unlike insert, the values do not come from a child plan: the file is parsed by the executor, the table is appended
+ * to a full page at a time, and the indexes of the table are built once all rows are loaded.
+ */
+class CopyPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new copy plan node.
+   * @param output the output schema, which holds the number of rows loaded
+   * @param table_oid the identifier of the table that is loaded into
+   * @param file_name the file to load from
+   * @param delimiter the field separator
+   * @param header whether the first line of the file is a header to skip
+   */
+  CopyPlanNode(SchemaRef output, table_oid_t table_oid, std::string file_name, char delimiter, bool header)
+      : AbstractPlanNode(std::move(output), {}),
+        table_oid_(table_oid),
+        file_name_(std::move(file_name)),
+        delimiter_(delimiter),
+        header_(header) {}
+
+  /** @return The type of the plan node */
+  auto GetType() const -> PlanType override { return PlanType::Copy; }
+
+  /** @return The identifier of the table that is loaded into */
+  auto TableOid() const -> table_oid_t { return table_oid_; }
+
+  /** @return The file to load from */
+  auto FileName() const -> const std::string & { return file_name_; }
+
+  /** @return The field separator */
+  auto Delimiter() const -> char { return delimiter_; }
+
+  /** @return Whether the first line of the file is a header */
+  auto HasHeader() const -> bool { return header_; }
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(CopyPlanNode);
+
+  /** The table to be loaded into. */
+  table_oid_t table_oid_;
+
+  /** The file to load from. */
+  std::string file_name_;
+
+  /** The field separator. */
+  char delimiter_;
+
+  /** Whether the first line of the file is a header. */
+  bool header_;
+
+ protected:
+  auto PlanNodeToString() const -> std::string override {
+    return fmt::format("Copy {{ table_oid={}, file={}, delimiter='{}', header={} }}", table_oid_, file_name_,
+                       delimiter_, header_);
+  }
+};
+
+}  // namespace bustub
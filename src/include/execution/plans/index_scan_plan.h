@@ -14,14 +14,18 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "catalog/catalog.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "type/value.h"
 
 namespace bustub {
 /**
- * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
+ * IndexScanPlanNode identifies a table that should be scanned with an optional predicate. The scan reads the keys of
+ * the index in order, from the lower bound on up to the upper bound, and the tuples which the keys point to. The bounds
+ * are key prefixes, values of the leading columns of the key, to which the same leading columns of the keys compare.
  */
 class IndexScanPlanNode : public AbstractPlanNode {
  public:
@@ -43,11 +47,50 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** The key prefix the scan starts at, set by the FilterScanAsIndexScan rule; empty to start at the first key. */
+  std::vector<Value> lower_bound_;
+
+  /** Whether the scan reads the keys whose prefix is equal to the lower bound. */
+  bool lower_inclusive_{true};
+
+  /** The key prefix the scan stops at, set by the FilterScanAsIndexScan rule; empty to read up to the last key. */
+  std::vector<Value> upper_bound_;
+
+  /** Whether the scan reads the keys whose prefix is equal to the upper bound. */
+  bool upper_inclusive_{true};
+
+  /** The predicate the scanned tuples must satisfy, nullptr to return every tuple in the bounds. */
+  AbstractExpressionRef filter_predicate_;
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    std::string range;
+    if (!lower_bound_.empty() || !upper_bound_.empty()) {
+      range = fmt::format(", range={}{}, {}{}", !lower_bound_.empty() && lower_inclusive_ ? "[" : "(",
+                          BoundToString(lower_bound_, "-inf"), BoundToString(upper_bound_, "+inf"),
+                          !upper_bound_.empty() && upper_inclusive_ ? "]" : ")");
+    }
+    if (filter_predicate_) {
+      return fmt::format("IndexScan {{ index_oid={}{}, filter={} }}", index_oid_, range, filter_predicate_);
+    }
+    return fmt::format("IndexScan {{ index_oid={}{} }}", index_oid_, range);
+  }
+
+ private:
+  /** A bound as its value, or its values in parentheses for a prefix of several columns, or unbounded if empty. */
+  static auto BoundToString(const std::vector<Value> &bound, const char *unbounded) -> std::string {
+    if (bound.empty()) {
+      return unbounded;
+    }
+    if (bound.size() == 1) {
+      return bound[0].ToString();
+    }
+    std::vector<std::string> values;
+    values.reserve(bound.size());
+    for (const auto &value : bound) {
+      values.push_back(value.ToString());
+    }
+    return fmt::format("({})", fmt::join(values, ", "));
   }
 };
 
@@ -13,14 +13,17 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "binder/table_ref/bound_base_table_ref.h"
 #include "catalog/catalog.h"
 #include "catalog/schema.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "storage/table/table_sample.h"
 
 namespace bustub {
 
@@ -57,17 +60,33 @@ class SeqScanPlanNode : public AbstractPlanNode {
   /** The table name */
   std::string table_name_;
 
-  /** The predicate to filter in seqscan. It will ALWAYS be nullptr until you enable the MergeFilterScan rule.
-      You don't need to handle it to get a perfect score as of in Fall 2022.
+  /** The predicate to filter in seqscan, set by the MergeFilterScan rule. It is evaluated on the tuples in place, and
+      on the worker threads of a parallel scan.
   */
   AbstractExpressionRef filter_predicate_;
 
+  /** The columns used by the plans above the scan, the other columns of the output tuples may be NULL. It is only set
+      by the ScanColumnPruning rule, and is std::nullopt when every column is read.
+  */
+  std::optional<std::vector<uint32_t>> column_ids_;
+
+  /** The sample of the table to read, from a TABLESAMPLE clause; std::nullopt to read the whole table. */
+  std::optional<TableSample> sample_;
+
  protected:
   auto PlanNodeToString() const -> std::string override {
+    std::string columns;
+    if (column_ids_.has_value()) {
+      columns = fmt::format(", columns=[{}]", fmt::join(*column_ids_, ", "));
+    }
+    std::string sample;
+    if (sample_.has_value()) {
+      sample = fmt::format(", sample={}", sample_->ToString());
+    }
     if (filter_predicate_) {
-      return fmt::format("SeqScan {{ table={}, filter={} }}", table_name_, filter_predicate_);
+      return fmt::format("SeqScan {{ table={}, filter={}{}{} }}", table_name_, filter_predicate_, columns, sample);
     }
-    return fmt::format("SeqScan {{ table={} }}", table_name_);
+    return fmt::format("SeqScan {{ table={}{}{} }}", table_name_, columns, sample);
   }
 };
 
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_filter.h
+//
+// Identification: src/include/execution/zone_filter.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "storage/table/zone_map.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * ZoneFilter decides from the zone map of a table which pages may hold a tuple satisfying a scan predicate. Only the
+ * conjuncts of the predicate comparing a summarized column with a constant, e.g. `#0.1 >= 10 AND 20 > #0.1`, are used;
+ * the rest of the predicate is left to the scan, so a page which is not skipped may still hold no matching tuple.
+ */
+class ZoneFilter {
+ public:
+  /**
+   * @param predicate the filter of a sequential scan, evaluated against the tuples of the table; may be nullptr
+   * @param zone_map the zone map of the table, may be nullptr
+   */
+  ZoneFilter(const AbstractExpressionRef &predicate, ZoneMap *zone_map);
+
+  /** @return true if no page can ever be skipped, i.e. there is no usable conjunct */
+  auto IsEmpty() const -> bool { return bounds_.empty(); }
+
+  /** @return false if no tuple of the page satisfies the predicate; true if the page is not summarized */
+  auto MayMatch(page_id_t page_id) const -> bool;
+
+ private:
+  /** A conjunct `column comp_type value`. */
+  struct Bound {
+    uint32_t column_idx_;
+    ComparisonType comp_type_;
+    Value value_;
+  };
+
+  /** Collect the usable conjuncts of an expression. */
+  void AddBounds(const AbstractExpression &expr);
+
+  /** @return true if a value in the zone may satisfy the bound */
+  static auto MayMatch(const Bound &bound, const ColumnZone &zone) -> bool;
+
+  ZoneMap *zone_map_;
+  std::vector<Bound> bounds_;
+};
+
+}  // namespace bustub
@@ -21,8 +21,12 @@ namespace bustub {
  */
 class Optimizer {
  public:
-  explicit Optimizer(const Catalog &catalog, bool force_starter_rule)
-      : catalog_(catalog), force_starter_rule_(force_starter_rule) {}
+  /**
+   * @param reads_snapshot whether the plan runs in a SNAPSHOT_ISOLATION transaction, which does not read the indexes:
+   * their entries are removed as soon as the tuples are deleted, while the snapshot may still see the tuples
+   */
+  explicit Optimizer(const Catalog &catalog, bool force_starter_rule, bool reads_snapshot = false)
+      : catalog_(catalog), force_starter_rule_(force_starter_rule), reads_snapshot_(reads_snapshot) {}
 
   auto Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
@@ -80,6 +84,12 @@ class Optimizer {
   /** @brief check if the predicate is true::boolean */
   auto IsPredicateTrue(const AbstractExpression &expr) -> bool;
 
+  /**
+   * @brief optimize filter + seq scan as an index scan bounded by the comparisons of an indexed column with constants,
+   * e.g. `WHERE v = 1`, `WHERE v BETWEEN 1 AND 5` or `WHERE v > 1`
+   */
+  auto OptimizeFilterScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /**
    * @brief optimize order by as index scan if there's an index on a table
    */
@@ -95,8 +105,14 @@ class Optimizer {
   auto OptimizeSortLimitAsTopN(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
   /**
-   * @brief get the estimated cardinality for a table based on the table name. Useful when join reordering. BusTub
-   * doesn't support statistics for now, so it's the only way for you to get the table size :(
+   * @brief only read the columns used by a projection or an aggregation (and the filter in between) when scanning a
+   * PAX table
+   */
+  auto OptimizeScanColumnPruning(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief get the estimated cardinality for a table. Useful when join reordering. The size of a table is estimated
+   * from the tuples of a few random pages; the size of a mock table is guessed from the suffix of its name.
    *
    * @param table_name
    * @return std::optional<size_t>
@@ -109,6 +125,8 @@ class Optimizer {
   const Catalog &catalog_;
 
   const bool force_starter_rule_;
+
+  const bool reads_snapshot_;
 };
 
 }  // namespace bustub
@@ -22,6 +22,7 @@ class SelectStatement;
 class DeleteStatement;
 class AbstractPlanNode;
 class InsertStatement;
+class CopyStatement;
 class BoundExpression;
 class BoundTableRef;
 class BoundBinaryOp;
@@ -141,6 +142,8 @@ class Planner {
 
   auto PlanUpdate(const UpdateStatement &statement) -> AbstractPlanNodeRef;
 
+  auto PlanCopy(const CopyStatement &statement) -> AbstractPlanNodeRef;
+
   /** the root plan node of the plan tree */
   AbstractPlanNodeRef plan_;
 
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <fstream>
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
@@ -25,14 +26,28 @@ namespace bustub {
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * The log is stored in fixed-size segment files named `<db>.log.<segment number>`, and is addressed by a logical
+ * offset: each segment starts with a header, followed by the log bytes [n * capacity, (n + 1) * capacity) for segment
+ * n, where the capacity is the segment size less the header. Segments are preallocated when created, so appending
+ * never changes the file size, and segments no longer needed for recovery are recycled by renaming them to the next
+ * segment numbers instead of being deleted. Unused log space always reads as zeros.
  */
 class DiskManager {
  public:
+  /**
+   * The header of a log segment: | Magic (8) | StartOffset (8) |, the log offset of the first byte after the header.
+   * It is written and synced before any log byte of the segment, and zeroed when the segment is recycled, so a
+   * segment is in use iff its header is valid for its segment number.
+   */
+  static constexpr int LOG_SEGMENT_HEADER_SIZE = 16;
+  static constexpr uint64_t LOG_SEGMENT_MAGIC = 0x425553545542574CULL;  // "BUSTUBWL"
+
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, int log_segment_size = LOG_SEGMENT_SIZE);
 
   /** FOR TEST / LEADERBOARD ONLY, used by DiskManagerMemory */
   DiskManager() = default;
@@ -58,6 +73,23 @@ class DiskManager {
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Read consecutive pages from the database file with a single vectored read. Safe to call from several threads at
+   * once; pages past the end of the file read as zeros.
+   * @param first_page_id id of the first page
+   * @param num_pages number of pages to read
+   * @param[out] page_data one output buffer per page
+   */
+  virtual void ReadPages(page_id_t first_page_id, int num_pages, char *page_data[]);
+
+  /**
+   * Write consecutive pages to the database file with a single vectored write.
+   * @param first_page_id id of the first page
+   * @param num_pages number of pages to write
+   * @param page_data one input buffer per page
+   */
+  virtual void WritePages(page_id_t first_page_id, int num_pages, const char *const page_data[]);
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -72,7 +104,23 @@ class DiskManager {
    * @param offset offset of the log entry in the file
    * @return true if the read was successful, false otherwise
    */
-  auto ReadLog(char *log_data, int size, int offset) -> bool;
+  auto ReadLog(char *log_data, int size, int64_t offset) -> bool;
+
+  /**
+   * Recycle the log segments that lie entirely before the given offset, typically the redo point of the last
+   * checkpoint. The segments are zeroed and renamed to become the next segments to be written.
+   * @param redo_offset log offset from which the log is still needed for recovery
+   */
+  void RecycleLogSegments(int64_t redo_offset);
+
+  /** @return the log offset the next WriteLog appends at; after a restart, the start of a fresh segment */
+  auto GetLogEndOffset() -> int64_t;
+
+  /** @return the size of a log segment file, in bytes */
+  auto GetLogSegmentSize() const -> int { return log_segment_size_; }
+
+  /** @return the number of log bytes a segment holds after its header */
+  auto GetLogSegmentCapacity() const -> int { return log_segment_size_ - LOG_SEGMENT_HEADER_SIZE; }
 
   /** @return the number of disk flushes */
   auto GetNumFlushes() const -> int;
@@ -83,6 +131,9 @@ class DiskManager {
   /** @return the number of disk writes */
   auto GetNumWrites() const -> int;
 
+  /** @return the number of pages already stored in the database file, 0 for a new (or in-memory) database */
+  auto GetNumPages() -> int;
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -94,12 +145,35 @@ class DiskManager {
 
  protected:
   auto GetFileSize(const std::string &file_name) -> int;
-  // stream to write log file
-  std::fstream log_io_;
+  /** @return the file name of the given log segment */
+  auto LogSegmentName(int64_t segment) const -> std::string;
+  /** Find the log segments left by a previous run, and where appending should resume. */
+  void ScanLogSegments();
+  /**
+   * Switch appending to the given segment, creating and preallocating its file if it does not exist yet, and write
+   * its header.
+   */
+  void OpenLogSegment(int64_t segment);
+  /** Make the creation, renaming and removal of log segment files durable. */
+  void SyncLogDirectory();
+  // prefix of the log segment file names, and the directory they are in
   std::string log_name_;
+  std::string log_dir_;
+  int log_segment_size_{LOG_SEGMENT_SIZE};
+  // file descriptor and number of the segment being appended to
+  int log_fd_{-1};
+  int64_t log_segment_{-1};
+  // logical offset of the next log write
+  int64_t log_end_offset_{0};
+  // oldest segment still needed, and highest-numbered segment file (recycled segments included)
+  int64_t log_first_segment_{0};
+  int64_t log_last_segment_{-1};
+  std::mutex log_io_latch_;
   // stream to write db file
   std::fstream db_io_;
   std::string file_name_;
+  // descriptor of the database file, for positioned vectored I/O that does not move the db_io_ cursor
+  int db_fd_{-1};
   int num_flushes_{0};
   int num_writes_{0};
   bool flush_log_{false};
@@ -12,6 +12,7 @@
 
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "concurrency/transaction.h"
@@ -32,6 +33,20 @@ namespace bustub {
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * Writers first descend optimistically: they read latch the internal pages and write latch the leaf only, which is
+ * enough for an insert which does not split the leaf or a remove which does not underflow it. Only when the leaf has
+ * to be split or merged does the writer start over, write latching the path from its last safe page down. The tree
+ * latch guards the root page id: optimistic writers hold it shared until they latched the root page, and pessimistic
+ * writers hold it exclusively while the root may change.
+ *
+ * An empty tree can also be bulk loaded: the entries are sorted, packed into leaves from left to right, and the
+ * internal levels are built bottom-up from the first keys of the level below, without a descent or a split.
+ *
+ * Keys other than single integers are prefix compressed in the pages, so the number of entries a page holds depends
+ * on its keys: besides the max sizes, a page splits when the entry to insert does not fit, and it does not underflow
+ * while it is at least half full. The keys a split puts in the internal pages are truncated to as few bytes as tell
+ * the two halves apart. Max sizes above the defaults are cut down to them.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -40,7 +55,8 @@ class BPlusTree {
 
  public:
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LeafPage::DEFAULT_MAX_SIZE,
+                     int internal_max_size = InternalPage::DEFAULT_MAX_SIZE);
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
@@ -48,16 +64,26 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   auto Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr) -> bool;
 
+  // Insert a batch of key-value pairs, building the tree bottom-up with nodes filled to fill_factor if it is empty.
+  void BulkLoad(std::vector<std::pair<KeyType, ValueType>> entries, double fill_factor,
+                Transaction *transaction = nullptr);
+
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
   // return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
 
+  // return the values of keys sorted in ascending order, descending once for the keys which share a leaf
+  auto GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results) -> size_t;
+
   // return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
-  // index iterator
+  // reopen a persisted tree by reading its root page id from the header page
+  auto LoadRootPageId() -> bool;
+
+  // index iterator, Begin(key) starts at the first key not less than key
   auto Begin() -> INDEXITERATOR_TYPE;
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
   auto End() -> INDEXITERATOR_TYPE;
@@ -77,6 +103,26 @@ class BPlusTree {
  private:
   void UpdateRootPageId(int insert_record = 0);
 
+  // descend to the leaf of a key with read latches, return the leaf write latched, nullptr if the tree is empty
+  auto FindLeafForWrite(const KeyType &key) -> Page *;
+
+  // descend to the leaf of a key, or to the leftmost leaf if key is nullptr, return it read latched
+  auto FindLeafForRead(const KeyType *key) -> Page *;
+
+  // stable sort entries by key, in runs sorted by several threads and merged
+  void SortEntries(std::vector<std::pair<KeyType, ValueType>> *entries);
+
+  // sizes of the nodes num_entries are packed into, fill_factor of max_size but the last two, which share the rest
+  static auto PackedNodeSizes(size_t num_entries, int max_size, int min_size, double fill_factor) -> std::vector<int>;
+
+  // sizes of the nodes the sorted entries are packed into, as PackedNodeSizes unless some node would not fit in a page
+  template <typename NodePage, typename Entry>
+  static auto FittingNodeSizes(const std::vector<Entry> &entries, int max_size, int min_size, double fill_factor)
+      -> std::vector<int>;
+
+  // the shortest key, in trailing zero bytes, which separates the keys up to left from the keys from right on
+  auto SeparatorKey(const KeyType &left, const KeyType &right) const -> KeyType;
+
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
 
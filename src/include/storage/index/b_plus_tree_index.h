@@ -14,8 +14,11 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "common/exception.h"
+#include "common/rwlatch.h"
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree.h"
 #include "storage/index/index.h"
@@ -27,33 +30,130 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
  public:
-  BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+  /**
+   * @param root_record_name The header page record of the root page id of the tree, the index name if empty. Index
+   * names are only unique per table, so the catalog names the record after the index oid.
+   */
+  BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                 const std::string &root_record_name = "");
 
   void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
+  void InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) override;
+
+  /** Insert a batch of keys, building the tree bottom-up with leaves filled to index_fill_factor if it is empty. */
+  void BulkLoad(std::vector<std::pair<KeyType, ValueType>> entries, Transaction *transaction);
+
   void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /** Look the keys up in key order, so that the keys which share a leaf share a descent. */
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                Transaction *transaction) override;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
 
   auto GetEndIterator() -> INDEXITERATOR_TYPE;
 
+  /** Reattach to a tree persisted by a previous run; returns false if the header page has no root for it. */
+  auto LoadRootPageId() -> bool { return container_.LoadRootPageId(); }
+
+  /**
+   * Keep a Bloom filter of the keys, built from the tree, so that ScanKey and ScanKeys answer most lookups of keys
+   * not in the index without descending the tree. The filter is not persisted, it is built again when the index is
+   * reopened. Deleted keys stay in the filter until it is rebuilt, as it is when its keys outgrow its capacity.
+   */
+  void EnableBloomFilter();
+
+  auto GetBloomFilterStats() const -> std::optional<BloomFilterStats> override;
+
  protected:
+  /** False if the Bloom filter rules the key out, true if it may be in the tree or there is no filter. */
+  auto MayContain(const KeyType &key) -> bool;
+
+  /** Add a key inserted into the tree to the Bloom filter if there is one, rebuilding it once the keys outgrow it. */
+  void AddToBloomFilter(const KeyType &key);
+
+  /** Build the Bloom filter from the keys of the tree, sized for twice as many; the filter latch is held. */
+  void BuildBloomFilter();
+
   // comparator for key
   KeyComparator comparator_;
   // container
   BPlusTree<KeyType, ValueType, KeyComparator> container_;
+  // hashes the keys for the Bloom filter
+  HashFunction<KeyType> hash_fn_;
+  // guards replacing the Bloom filter; adding and probing keys only share it
+  mutable ReaderWriterLatch bloom_filter_latch_;
+  std::atomic<bool> has_bloom_filter_{false};
+  std::unique_ptr<BloomFilter> bloom_filter_;
+  std::atomic<size_t> bloom_filter_lookups_{0};
+  std::atomic<size_t> bloom_filter_negatives_{0};
+  std::atomic<size_t> bloom_filter_false_positives_{0};
 };
 
+/** The key, value and comparator types of a B+ tree index. */
+template <typename K, typename V, typename C>
+struct BPlusTreeIndexTypes {
+  using KeyType = K;
+  using ValueType = V;
+  using KeyComparator = C;
+};
+
+/**
+ * Call visitor with the BPlusTreeIndexTypes suited to a key schema, and return what it returns. A single INTEGER or
+ * BIGINT column, or several integer columns fitting in 64 bytes, are compared without deserializing Values; other
+ * keys are compared by the GenericComparator of the smallest key they fit in, up to 256 bytes. VARCHAR columns are
+ * stored in the key, so that the key must fit their declared length: a VARCHAR of the default length takes a 256 byte
+ * key, whose bytes shared by the keys of a node the B+ tree pages elide.
+ */
+template <typename Visitor>
+auto VisitBPlusTreeIndexTypes(const Schema &key_schema, Visitor &&visitor) {
+  const bool is_integer = IsIntegerKeySchema(key_schema);
+  const auto length = MaxKeyLength(key_schema);
+  if (key_schema.GetColumnCount() == 1 && key_schema.GetColumn(0).GetType() == TypeId::INTEGER) {
+    return visitor(BPlusTreeIndexTypes<GenericKey<4>, RID, IntegerComparator<4, int32_t>>{});
+  }
+  if (key_schema.GetColumnCount() == 1 && key_schema.GetColumn(0).GetType() == TypeId::BIGINT) {
+    return visitor(BPlusTreeIndexTypes<GenericKey<8>, RID, IntegerComparator<8, int64_t>>{});
+  }
+  if (length <= 4 && !is_integer) {
+    return visitor(BPlusTreeIndexTypes<GenericKey<4>, RID, GenericComparator<4>>{});
+  }
+  if (length <= 8) {
+    return is_integer ? visitor(BPlusTreeIndexTypes<GenericKey<8>, RID, IntegerColumnsComparator<8>>{})
+                      : visitor(BPlusTreeIndexTypes<GenericKey<8>, RID, GenericComparator<8>>{});
+  }
+  if (length <= 16) {
+    return is_integer ? visitor(BPlusTreeIndexTypes<GenericKey<16>, RID, IntegerColumnsComparator<16>>{})
+                      : visitor(BPlusTreeIndexTypes<GenericKey<16>, RID, GenericComparator<16>>{});
+  }
+  if (length <= 32) {
+    return is_integer ? visitor(BPlusTreeIndexTypes<GenericKey<32>, RID, IntegerColumnsComparator<32>>{})
+                      : visitor(BPlusTreeIndexTypes<GenericKey<32>, RID, GenericComparator<32>>{});
+  }
+  if (length <= 64) {
+    return is_integer ? visitor(BPlusTreeIndexTypes<GenericKey<64>, RID, IntegerColumnsComparator<64>>{})
+                      : visitor(BPlusTreeIndexTypes<GenericKey<64>, RID, GenericComparator<64>>{});
+  }
+  if (length <= 128) {
+    return visitor(BPlusTreeIndexTypes<GenericKey<128>, RID, GenericComparator<128>>{});
+  }
+  if (length <= 256) {
+    return visitor(BPlusTreeIndexTypes<GenericKey<256>, RID, GenericComparator<256>>{});
+  }
+  throw Exception(ExceptionType::OUT_OF_RANGE, "index key is too large");
+}
+
 /** We only support index table with one integer key for now in BusTub. Hardcode everything here. */
 
 constexpr static const auto INTEGER_SIZE = 4;
 using IntegerKeyType = GenericKey<INTEGER_SIZE>;
 using IntegerValueType = RID;
-using IntegerComparatorType = GenericComparator<INTEGER_SIZE>;
+using IntegerComparatorType = IntegerComparator<INTEGER_SIZE, int32_t>;
 using BPlusTreeIndexForOneIntegerColumn = BPlusTreeIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using BPlusTreeIndexIteratorForOneIntegerColumn =
     IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
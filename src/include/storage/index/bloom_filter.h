@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.h
+//
+// Identification: src/include/storage/index/bloom_filter.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bustub {
+
+/** What the Bloom filter of an index costs, and how well it answers lookups of keys not in the index. */
+struct BloomFilterStats {
+  /** The keys added to the filter, deleted ones included, and the number of keys it is sized for */
+  size_t num_keys_;
+  size_t capacity_;
+  /** The memory taken by the bits of the filter, in bytes */
+  size_t memory_usage_;
+  /** The false-positive rate expected of a filter with as many keys */
+  double expected_false_positive_rate_;
+  /** The lookups which consulted the filter, those it answered alone, and those it let through for absent keys */
+  size_t lookups_;
+  size_t negatives_;
+  size_t false_positives_;
+
+  /** The share of the lookups of absent keys the filter let through to the index, 0 if there were none. */
+  auto FalsePositiveRate() const -> double {
+    return negatives_ + false_positives_ == 0
+               ? 0
+               : static_cast<double>(false_positives_) / static_cast<double>(negatives_ + false_positives_);
+  }
+
+  auto ToString() const -> std::string;
+};
+
+/**
+ * A Bloom filter over the hashes of keys: MayContain is false for a key which was never added, and true for an added
+ * key. It is true for other keys at a rate which grows with the number of keys, past the capacity the filter is sized
+ * for. Keys cannot be removed. Adding and probing keys is thread safe.
+ */
+class BloomFilter {
+ public:
+  /** A filter of bits_per_key bits for each of capacity keys. */
+  BloomFilter(size_t capacity, size_t bits_per_key);
+
+  void Add(uint64_t hash);
+
+  auto MayContain(uint64_t hash) const -> bool;
+
+  auto GetNumKeys() const -> size_t { return num_keys_.load(std::memory_order_relaxed); }
+
+  auto GetCapacity() const -> size_t { return capacity_; }
+
+  auto GetMemoryUsage() const -> size_t { return words_.size() * sizeof(uint64_t); }
+
+  /** (1 - e^(-kn/m))^k for k hash functions, n keys and m bits. */
+  auto ExpectedFalsePositiveRate() const -> double;
+
+ private:
+  /** The bit the i-th hash function maps a key to, derived from two halves of its hash. */
+  auto BitIndex(uint64_t hash, size_t i) const -> size_t;
+
+  size_t capacity_;
+  size_t num_bits_;
+  size_t num_hashes_;
+  std::vector<std::atomic<uint64_t>> words_;
+  std::atomic<size_t> num_keys_{0};
+};
+
+}  // namespace bustub
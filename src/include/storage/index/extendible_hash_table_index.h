@@ -29,7 +29,7 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 class ExtendibleHashTableIndex : public Index {
  public:
   ExtendibleHashTableIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
-                           const HashFunction<KeyType> &hash_fn);
+                           const HashFunction<KeyType> &hash_fn, page_id_t directory_page_id = INVALID_PAGE_ID);
 
   ~ExtendibleHashTableIndex() override = default;
 
@@ -39,6 +39,9 @@ class ExtendibleHashTableIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /** The directory page of the hash table, from which a later run reopens it. */
+  auto GetDirectoryPageId() const -> page_id_t { return container_.GetDirectoryPageId(); }
+
  protected:
   // comparator for key
   KeyComparator comparator_;
@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <array>
 #include <cstring>
 
+#include "common/exception.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -30,6 +32,9 @@ template <size_t KeySize>
 class GenericKey {
  public:
   inline void SetFromKey(const Tuple &tuple) {
+    if (tuple.GetLength() > KeySize) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "index key is too large");
+    }
     // intialize to 0
     memset(data_, 0, KeySize);
     memcpy(data_, tuple.GetData(), tuple.GetLength());
@@ -83,6 +88,13 @@ class GenericComparator {
       Value lhs_value = (lhs.ToValue(key_schema_, i));
       Value rhs_value = (rhs.ToValue(key_schema_, i));
 
+      // NULL sorts before every value, as the least integer does in integer keys
+      if (lhs_value.IsNull() || rhs_value.IsNull()) {
+        if (lhs_value.IsNull() != rhs_value.IsNull()) {
+          return lhs_value.IsNull() ? -1 : 1;
+        }
+        continue;
+      }
       if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
         return -1;
       }
@@ -96,6 +108,9 @@ class GenericComparator {
 
   GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
 
+  // whether the keys are made of fixed length columns only, which hold no offsets into the key
+  auto IsInlined() const -> bool { return key_schema_->IsInlined(); }
+
   // constructor
   explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
 
@@ -103,4 +118,118 @@ class GenericComparator {
   Schema *key_schema_;
 };
 
+/** @return true if every column of the key schema is an integer column, TINYINT to BIGINT */
+inline auto IsIntegerKeySchema(const Schema &key_schema) -> bool {
+  for (const auto &column : key_schema.GetColumns()) {
+    auto type = column.GetType();
+    if (type != TypeId::TINYINT && type != TypeId::SMALLINT && type != TypeId::INTEGER && type != TypeId::BIGINT) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @return the number of bytes a key of the key schema takes up at most: the fixed length part of its columns, and the
+ * length and the characters of its VARCHAR columns, up to their declared length and a terminating '\0'
+ */
+inline auto MaxKeyLength(const Schema &key_schema) -> uint32_t {
+  uint32_t length = key_schema.GetLength();
+  for (auto i : key_schema.GetUnlinedColumns()) {
+    length += sizeof(uint32_t) + key_schema.GetColumn(i).GetLength() + 1;
+  }
+  return length;
+}
+
+/**
+ * Function object comparing keys made of a single integer column of type IntType, int32_t for an INTEGER key or
+ * int64_t for a BIGINT key. The integers are read straight from the keys, without deserializing Values.
+ */
+template <size_t KeySize, typename IntType>
+class IntegerComparator {
+  static_assert(sizeof(IntType) == KeySize, "the key must be exactly one integer");
+
+ public:
+  inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    IntType lhs_value;
+    IntType rhs_value;
+    memcpy(&lhs_value, lhs.data_, sizeof(IntType));
+    memcpy(&rhs_value, rhs.data_, sizeof(IntType));
+    return static_cast<int>(lhs_value > rhs_value) - static_cast<int>(lhs_value < rhs_value);
+  }
+
+  // constructor, the key schema is known at compile time
+  explicit IntegerComparator(Schema * /*key_schema*/) {}
+};
+
+/** The integer type a comparator compares the keys as, void if it does not compare them as single integers. */
+template <typename KeyComparator>
+struct ComparatorIntegerType {
+  using type = void;
+};
+
+template <size_t KeySize, typename IntType>
+struct ComparatorIntegerType<IntegerComparator<KeySize, IntType>> {
+  using type = IntType;
+};
+
+/**
+ * Function object comparing keys made of several integer columns, of any of the integer types. The offset and the
+ * width of each column are looked up once from the key schema, and the integers are read straight from the keys.
+ */
+template <size_t KeySize>
+class IntegerColumnsComparator {
+ public:
+  inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    for (uint32_t i = 0; i < column_count_; i++) {
+      const auto &[offset, type] = columns_[i];
+      int result;
+      switch (type) {
+        case TypeId::TINYINT:
+          result = Compare<int8_t>(lhs.data_ + offset, rhs.data_ + offset);
+          break;
+        case TypeId::SMALLINT:
+          result = Compare<int16_t>(lhs.data_ + offset, rhs.data_ + offset);
+          break;
+        case TypeId::INTEGER:
+          result = Compare<int32_t>(lhs.data_ + offset, rhs.data_ + offset);
+          break;
+        default:
+          result = Compare<int64_t>(lhs.data_ + offset, rhs.data_ + offset);
+          break;
+      }
+      if (result != 0) {
+        return result;
+      }
+    }
+    // equals
+    return 0;
+  }
+
+  // constructor
+  explicit IntegerColumnsComparator(Schema *key_schema) : column_count_(key_schema->GetColumnCount()) {
+    for (uint32_t i = 0; i < column_count_; i++) {
+      const auto &column = key_schema->GetColumn(i);
+      columns_[i] = {column.GetOffset(), column.GetType()};
+    }
+  }
+
+  // integer columns are all of fixed length
+  auto IsInlined() const -> bool { return true; }
+
+ private:
+  template <typename IntType>
+  static inline auto Compare(const char *lhs, const char *rhs) -> int {
+    IntType lhs_value;
+    IntType rhs_value;
+    memcpy(&lhs_value, lhs, sizeof(IntType));
+    memcpy(&rhs_value, rhs, sizeof(IntType));
+    return static_cast<int>(lhs_value > rhs_value) - static_cast<int>(lhs_value < rhs_value);
+  }
+
+  // offset and type of each column, a column takes at least one byte of the key
+  std::array<std::pair<uint32_t, TypeId>, KeySize> columns_;
+  uint32_t column_count_;
+};
+
 }  // namespace bustub
@@ -13,19 +13,85 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
 
+/**
+ * The thread which fetches the leaves index iterators are about to move to. A single worker, started on first use,
+ * serves the fetches of all iterators in the order they are queued.
+ */
+class LeafPrefetcher {
+ public:
+  /** A fetch of a page, pinned by the worker once it is done. */
+  struct Request {
+    BufferPoolManager *bpm_;
+    page_id_t page_id_;
+    std::promise<Page *> page_;
+    std::future<Page *> future_;
+  };
+
+  ~LeafPrefetcher();
+
+  static auto Instance() -> LeafPrefetcher &;
+
+  /** Queue a fetch of the page; the page is nullptr if it could not be fetched. */
+  auto Fetch(BufferPoolManager *bpm, page_id_t page_id) -> std::shared_ptr<Request>;
+
+  /** Wait for the fetch and return the page. */
+  auto Take(const std::shared_ptr<Request> &request) -> Page *;
+
+  /** Drop the fetch if the worker has not started it, or wait for it; return the page if it was fetched. */
+  auto Cancel(const std::shared_ptr<Request> &request) -> Page *;
+
+ private:
+  LeafPrefetcher();
+
+  void Run();
+
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::deque<std::shared_ptr<Request>> queue_;
+  bool stop_{false};
+  std::thread worker_;
+};
+
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * Iterator over the entries of the leaves of a B+ tree, in key order.
+ *
+ * The iterator keeps the leaf it is on pinned and read latched, so that reading an entry or moving to the next one
+ * within the leaf does not go through the buffer pool. Moving to the next leaf pins it before the current one is
+ * released, and only then read latches it: the iterator never waits for a latch while holding one, as writers merging
+ * leaves latch them from right to left. The leaf is released when the iterator leaves it, reaches the end, is
+ * assigned to or is destroyed. Iterators are move only.
+ *
+ * With index_scan_prefetch set, the next leaf of the chain is fetched by the LeafPrefetcher while the current one is
+ * scanned, so that reading it from disk overlaps with the scan. A fetch still outstanding when the iterator is released
+ * is cancelled, or waited for and its page unpinned.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
  public:
-  // you may define your own constructor based on your member variables
-  IndexIterator(BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                page_id_t page_id = INVALID_PAGE_ID, int index = 0);
-  // IndexIterator();
+  /**
+   * @param leaf the leaf to start from, pinned and read latched, which the iterator takes over; nullptr for the end
+   * @param index the index of the first entry in the leaf, the iterator moves on to the next leaves if it is past the
+   * last entry
+   */
+  IndexIterator(BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator, Page *leaf = nullptr,
+                int index = 0);
+  IndexIterator(IndexIterator &&other) noexcept;
+  IndexIterator(const IndexIterator &) = delete;
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
@@ -47,17 +113,26 @@ class IndexIterator {
   auto GetIndex() const -> int { return index_; }
 
   // p3 add
-  auto operator=(const IndexIterator &itr) -> void {
-    page_id_ = itr.GetPageId();
-    index_ = itr.GetIndex();
-  }
+  auto operator=(IndexIterator &&itr) noexcept -> IndexIterator &;
+  auto operator=(const IndexIterator &) -> IndexIterator & = delete;
 
  private:
-  // add your own private member variables here
+  // move on to the first entry from index_ on, in this leaf or in the next ones
+  void SkipToEntry();
+  // start fetching the next leaf if prefetching
+  void PrefetchNextLeaf();
+  // unlatch and unpin the leaf, and the prefetched next leaf
+  void Release();
+
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
-  page_id_t page_id_;
-  int index_;
+  page_id_t page_id_{INVALID_PAGE_ID};
+  int index_{0};
+  Page *page_{nullptr};
+  LeafPage *leaf_{nullptr};
+  bool prefetch_;
+  // the fetch of the next leaf by the prefetcher, nullptr if none is outstanding
+  std::shared_ptr<LeafPrefetcher::Request> next_request_;
   MappingType temp_;
 };
 
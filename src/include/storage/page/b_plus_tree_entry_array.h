@@ -0,0 +1,239 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_entry_array.h
+//
+// Identification: src/include/storage/page/b_plus_tree_entry_array.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * The keys and the values of a B+ tree page, which take the rest of the page after its header.
+ *
+ * With ELIDE_KEY_BYTES, the leading and the trailing bytes which all the keys of the page share are stored once, in a
+ * key frame, and each key only stores the bytes in between. The keys of a page are close to each other: they mostly
+ * share their leading columns, and the unused bytes at the end of the keys are zero, so the page holds many more
+ * entries than it would at full key width. How many depends on the keys: HasRoomFor tells whether some more fit, and
+ * a key which does not share the elided bytes gets all the keys rewritten with fewer bytes elided.
+ *
+ * Format (size in byte):
+ *  ---------------------------------------------------------------------------------------------
+ * | PrefixSize (2) | SuffixSize (2) | KEY FRAME | KEY(1) | ... | KEY(n) | ... | VALUE(1) | ... | VALUE(n) | ... |
+ *  ---------------------------------------------------------------------------------------------
+ * KEY(i) holds the bytes of the i-th key from PrefixSize up to sizeof(KeyType) - SuffixSize, the key frame holds the
+ * other bytes, which are the same for every key. Without ELIDE_KEY_BYTES the key frame is empty and the keys are
+ * stored whole, as an array of KeyType. Both arrays have room for as many entries as fit at the current key width.
+ */
+template <typename KeyType, typename ValueType, bool ELIDE_KEY_BYTES, int AREA_SIZE>
+class BPlusTreeEntryArray {
+  static constexpr int KEY_SIZE = sizeof(KeyType);
+  static constexpr int VALUE_SIZE = sizeof(ValueType);
+  static constexpr int FRAME_SIZE = ELIDE_KEY_BYTES ? KEY_SIZE : 0;
+  // bytes left for the key and the value arrays
+  static constexpr int ARRAYS_SIZE = AREA_SIZE - 2 * static_cast<int>(sizeof(uint16_t)) - FRAME_SIZE;
+
+ public:
+  using Entry = std::pair<KeyType, ValueType>;
+
+  /** The number of entries which fit when no key byte is elided. */
+  static constexpr int FULL_KEY_CAPACITY = ARRAYS_SIZE / (KEY_SIZE + VALUE_SIZE);
+
+  void Init() {
+    prefix_size_ = 0;
+    suffix_size_ = 0;
+  }
+
+  auto KeyAt(int index) const -> KeyType {
+    KeyType key;
+    if constexpr (ELIDE_KEY_BYTES) {
+      memcpy(static_cast<void *>(&key), Frame(), KEY_SIZE);
+    }
+    memcpy(reinterpret_cast<char *>(&key) + prefix_size_, KeySlot(index), KeyWidth());
+    return key;
+  }
+
+  auto ValueAt(int index) const -> ValueType {
+    ValueType value;
+    memcpy(static_cast<void *>(&value), ValueSlot(index), VALUE_SIZE);
+    return value;
+  }
+
+  void SetValueAt(int index, const ValueType &value) { memcpy(ValueSlot(index), &value, VALUE_SIZE); }
+
+  /** The key array, for pages which store their keys whole. */
+  auto KeyBytes() const -> const char * {
+    static_assert(!ELIDE_KEY_BYTES, "the keys are not stored whole");
+    return data_;
+  }
+
+  /** @return whether num_entries entries fit once key joins the size keys of the page */
+  auto HasRoomFor(int size, int num_entries, const KeyType &key) const -> bool {
+    auto [prefix_size, suffix_size] = ElisionWith(size, key);
+    return num_entries <= Capacity(KEY_SIZE - prefix_size - suffix_size);
+  }
+
+  /** @return whether num_entries entries of the current key width take half the page or more */
+  auto IsHalfFull(int num_entries) const -> bool { return 2 * num_entries * (KeyWidth() + VALUE_SIZE) >= ARRAYS_SIZE; }
+
+  /** @return whether the entries fit in an empty page */
+  static auto HasRoomFor(const Entry *entries, int num_entries) -> bool {
+    auto [prefix_size, suffix_size] = Elision(entries, num_entries);
+    return num_entries <= Capacity(KEY_SIZE - prefix_size - suffix_size);
+  }
+
+  void SetKeyAt(int size, int index, const KeyType &key) {
+    ElideFor(size, key);
+    WriteKey(index, key);
+  }
+
+  void InsertAt(int size, int index, const KeyType &key, const ValueType &value) {
+    ElideFor(size, key);
+    int key_width = KeyWidth();
+    auto num_moved = static_cast<size_t>(std::max(size - index, 0));
+    memmove(KeySlot(index + 1), KeySlot(index), num_moved * key_width);
+    memmove(ValueSlot(index + 1), ValueSlot(index), num_moved * VALUE_SIZE);
+    WriteKey(index, key);
+    SetValueAt(index, value);
+  }
+
+  void RemoveAt(int size, int index) {
+    auto num_moved = static_cast<size_t>(std::max(size - index - 1, 0));
+    memmove(KeySlot(index), KeySlot(index + 1), num_moved * KeyWidth());
+    memmove(ValueSlot(index), ValueSlot(index + 1), num_moved * VALUE_SIZE);
+  }
+
+  /** Replace the entries of the page, eliding as many key bytes as the entries share. */
+  void Assign(const Entry *entries, int num_entries) {
+    auto [prefix_size, suffix_size] = Elision(entries, num_entries);
+    prefix_size_ = prefix_size;
+    suffix_size_ = suffix_size;
+    if constexpr (ELIDE_KEY_BYTES) {
+      if (num_entries > 0) {
+        memcpy(Frame(), &entries[0].first, KEY_SIZE);
+      }
+    }
+    for (int i = 0; i < num_entries; i++) {
+      WriteKey(i, entries[i].first);
+      SetValueAt(i, entries[i].second);
+    }
+  }
+
+ private:
+  static constexpr auto Capacity(int key_width) -> int { return ARRAYS_SIZE / (key_width + VALUE_SIZE); }
+
+  static auto CommonPrefixSize(const char *lhs, const char *rhs, int max_size) -> int {
+    int size = 0;
+    while (size < max_size && lhs[size] == rhs[size]) {
+      size++;
+    }
+    return size;
+  }
+
+  static auto CommonSuffixSize(const char *lhs, const char *rhs, int max_size) -> int {
+    int size = 0;
+    while (size < max_size && lhs[KEY_SIZE - 1 - size] == rhs[KEY_SIZE - 1 - size]) {
+      size++;
+    }
+    return size;
+  }
+
+  /** The sizes of the prefix and of the suffix which the keys of the entries share. */
+  static auto Elision(const Entry *entries, int num_entries) -> std::pair<int, int> {
+    if (!ELIDE_KEY_BYTES || num_entries == 0) {
+      return {0, 0};
+    }
+    auto *first = reinterpret_cast<const char *>(&entries[0].first);
+    int prefix_size = KEY_SIZE;
+    int suffix_size = KEY_SIZE;
+    for (int i = 1; i < num_entries; i++) {
+      auto *key = reinterpret_cast<const char *>(&entries[i].first);
+      prefix_size = CommonPrefixSize(first, key, prefix_size);
+      suffix_size = CommonSuffixSize(first, key, suffix_size);
+    }
+    return {prefix_size, std::min(suffix_size, KEY_SIZE - prefix_size)};
+  }
+
+  /** The sizes of the prefix and of the suffix which the size keys of the page share with key. */
+  auto ElisionWith(int size, const KeyType &key) const -> std::pair<int, int> {
+    if (!ELIDE_KEY_BYTES) {
+      return {0, 0};
+    }
+    if (size == 0) {
+      return {KEY_SIZE, 0};
+    }
+    // keys of width zero are all equal to the frame, which then holds the shared bytes throughout
+    bool whole_frame = KeyWidth() == 0;
+    auto *bytes = reinterpret_cast<const char *>(&key);
+    int prefix_size = CommonPrefixSize(Frame(), bytes, whole_frame ? KEY_SIZE : prefix_size_);
+    int suffix_size = CommonSuffixSize(Frame(), bytes, whole_frame ? KEY_SIZE : suffix_size_);
+    return {prefix_size, std::min(suffix_size, KEY_SIZE - prefix_size)};
+  }
+
+  /** Elide no more bytes than key shares with the size keys of the page, rewriting them if fewer bytes are elided. */
+  void ElideFor(int size, const KeyType &key) {
+    if constexpr (ELIDE_KEY_BYTES) {
+      if (size == 0) {
+        memcpy(Frame(), &key, KEY_SIZE);
+        prefix_size_ = KEY_SIZE;
+        suffix_size_ = 0;
+        return;
+      }
+      auto [prefix_size, suffix_size] = ElisionWith(size, key);
+      if (prefix_size == prefix_size_ && suffix_size == suffix_size_) {
+        return;
+      }
+      std::vector<Entry> entries;
+      entries.reserve(size);
+      for (int i = 0; i < size; i++) {
+        entries.emplace_back(KeyAt(i), ValueAt(i));
+      }
+      prefix_size_ = prefix_size;
+      suffix_size_ = suffix_size;
+      for (int i = 0; i < size; i++) {
+        WriteKey(i, entries[i].first);
+        SetValueAt(i, entries[i].second);
+      }
+    }
+  }
+
+  auto KeyWidth() const -> int { return KEY_SIZE - prefix_size_ - suffix_size_; }
+
+  auto Frame() -> char * { return data_; }
+  auto Frame() const -> const char * { return data_; }
+
+  auto KeySlot(int index) -> char * { return data_ + FRAME_SIZE + index * KeyWidth(); }
+  auto KeySlot(int index) const -> const char * { return data_ + FRAME_SIZE + index * KeyWidth(); }
+
+  auto ValueSlot(int index) -> char * {
+    int key_width = KeyWidth();
+    return data_ + FRAME_SIZE + Capacity(key_width) * key_width + index * VALUE_SIZE;
+  }
+  auto ValueSlot(int index) const -> const char * {
+    int key_width = KeyWidth();
+    return data_ + FRAME_SIZE + Capacity(key_width) * key_width + index * VALUE_SIZE;
+  }
+
+  void WriteKey(int index, const KeyType &key) {
+    memcpy(KeySlot(index), reinterpret_cast<const char *>(&key) + prefix_size_, KeyWidth());
+  }
+
+  uint16_t prefix_size_;
+  uint16_t suffix_size_;
+  // Flexible array member for the key frame, the key array and the value array.
+  char data_[1];
+};
+
+}  // namespace bustub
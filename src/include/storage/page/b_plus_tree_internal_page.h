@@ -11,14 +11,15 @@
 #pragma once
 
 #include <queue>
+#include <type_traits>
 
+#include "storage/page/b_plus_tree_entry_array.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
 #define INTERNAL_PAGE_HEADER_SIZE 24
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -27,16 +28,37 @@ namespace bustub {
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
+ * As in the leaf page, the keys and the child pointers are kept in two
+ * separate arrays, and keys other than single integers are prefix compressed.
+ * The tree truncates the separator keys it puts in internal pages to as few
+ * leading bytes as tell the children apart, and the zeroed bytes they are cut
+ * to are elided along with the shared leading bytes.
+ *
  * Internal page format (keys are stored in increasing order):
- *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
- *  --------------------------------------------------------------------------
+ *  ----------------------------------------------------------------------------------------------
+ * | HEADER | ELIDED SIZES | KEY FRAME | KEY(1) | ... | KEY(n) | ... | PAGE_ID(1) | ... | PAGE_ID(n) |
+ *  ----------------------------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
  public:
+  /** Whether the keys are prefix compressed: all but single integer keys, which are searched with SIMD instead. */
+  static constexpr bool ELIDES_KEY_BYTES = std::is_void_v<typename ComparatorIntegerType<KeyComparator>::type>;
+
+ private:
+  using EntryArray =
+      BPlusTreeEntryArray<KeyType, ValueType, ELIDES_KEY_BYTES, BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE>;
+
+ public:
+  /**
+   * The default max size. With prefix compression it is about twice the entries which fit at full key width: a page
+   * which splits, or which underflows and takes one more entry, holds no more than fit at full key width.
+   */
+  static constexpr int DEFAULT_MAX_SIZE =
+      ELIDES_KEY_BYTES ? 2 * EntryArray::FULL_KEY_CAPACITY - 2 : EntryArray::FULL_KEY_CAPACITY;
+
   // must call initialize method after "create" a new node
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = DEFAULT_MAX_SIZE);
 
   auto KeyAt(int index) const -> KeyType;
   void SetKeyAt(int index, const KeyType &key);
@@ -48,8 +70,18 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   void InsertKeyValueAt(int index, const KeyType &key, const ValueType &value);
   void RemoveKeyValueAt(int index);
 
+  // replace the entries of the page
+  void SetEntries(const MappingType *entries, int num_entries);
+  // whether num_entries entries fit once key joins the keys of the page
+  auto HasRoomFor(int num_entries, const KeyType &key) const -> bool;
+  // whether the entries fit in an empty page
+  static auto HasRoomFor(const MappingType *entries, int num_entries) -> bool;
+  // whether num_entries entries take half the page, for prefix compressed keys whose number per page varies
+  auto IsHalfFull(int num_entries) const -> bool;
+  // whether one more entry fits whatever its key, so that a split of a child cannot split this page
+  auto HasRoomForAnyKey() const -> bool { return GetSize() < EntryArray::FULL_KEY_CAPACITY; }
+
  private:
-  // Flexible array member for page data.
-  MappingType array_[1];
+  EntryArray entries_;
 };
 }  // namespace bustub
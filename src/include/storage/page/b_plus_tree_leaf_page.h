@@ -10,26 +10,34 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "storage/page/b_plus_tree_entry_array.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
 #define LEAF_PAGE_HEADER_SIZE 28
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
  * page. Only support unique key.
  *
+ * The keys and the record ids are kept in two separate arrays, so that a
+ * search only reads the cache lines of the keys. Single integer keys are
+ * searched with SIMD compares. Other keys are prefix compressed: the leading
+ * and trailing bytes all the keys of the page share are stored once (see
+ * BPlusTreeEntryArray), so the page holds more entries than it would at full
+ * key width, up to twice as many by default.
+ *
  * Leaf page format (keys are stored in order):
- *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
- *  ----------------------------------------------------------------------
+ *  -------------------------------------------------------------------------------
+ * | HEADER | ELIDED SIZES | KEY FRAME | KEY(1) | ... | KEY(n) | ... | RID(1) | ... | RID(n)
+ *  -------------------------------------------------------------------------------
  *
  *  Header format (size in byte, 28 bytes in total):
  *  ---------------------------------------------------------------------
@@ -42,9 +50,24 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
  public:
+  /** Whether the keys are prefix compressed: all but single integer keys, which are searched with SIMD instead. */
+  static constexpr bool ELIDES_KEY_BYTES = std::is_void_v<typename ComparatorIntegerType<KeyComparator>::type>;
+
+ private:
+  using EntryArray =
+      BPlusTreeEntryArray<KeyType, ValueType, ELIDES_KEY_BYTES, BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE>;
+
+ public:
+  /**
+   * The default max size. With prefix compression it is twice the entries which fit at full key width: a page which
+   * splits, or which underflows and takes one more entry, holds no more than fit at full key width.
+   */
+  static constexpr int DEFAULT_MAX_SIZE =
+      ELIDES_KEY_BYTES ? 2 * EntryArray::FULL_KEY_CAPACITY : EntryArray::FULL_KEY_CAPACITY;
+
   // After creating a new leaf page from buffer pool, must call initialize
   // method to set default values
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = DEFAULT_MAX_SIZE);
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
@@ -58,9 +81,17 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   void InsertKeyValueAt(int index, const KeyType &key, const ValueType &value);
   void RemoveKeyValueAt(int index);
 
+  // replace the entries of the page
+  void SetEntries(const MappingType *entries, int num_entries);
+  // whether num_entries entries fit once key joins the keys of the page
+  auto HasRoomFor(int num_entries, const KeyType &key) const -> bool;
+  // whether the entries fit in an empty page
+  static auto HasRoomFor(const MappingType *entries, int num_entries) -> bool;
+  // whether num_entries entries take half the page, for prefix compressed keys whose number per page varies
+  auto IsHalfFull(int num_entries) const -> bool;
+
  private:
   page_id_t next_page_id_;
-  // Flexible array member for page data.
-  MappingType array_[1];
+  EntryArray entries_;
 };
 }  // namespace bustub
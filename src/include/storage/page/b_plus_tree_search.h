@@ -0,0 +1,33 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_search.h
+//
+// Identification: src/include/storage/page/b_plus_tree_search.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+namespace bustub {
+
+/**
+ * Lower bound search over the sorted key array of a B+ tree page whose keys are single integers. The search narrows
+ * the range by binary search down to a few cache lines, and counts the keys less than the searched one in what is
+ * left with SIMD compares: AVX2 when the CPU supports it, SSE2 for 32-bit keys otherwise, and a plain loop on other
+ * targets. The keys need not be aligned.
+ *
+ * @param keys the num_keys integers, in increasing order
+ * @param num_keys the number of keys
+ * @param key the key to look for
+ * @return the index of the first key not less than key, num_keys if there is none
+ */
+auto IntegerLowerBound(const char *keys, int num_keys, int32_t key) -> int;
+auto IntegerLowerBound(const char *keys, int num_keys, int64_t key) -> int;
+
+}  // namespace bustub
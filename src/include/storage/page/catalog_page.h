@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// catalog_page.h
+//
+// Identification: src/include/storage/page/catalog_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * The serialized catalog is stored in a chain of catalog pages, the first of which is recorded in the header page.
+ * Each page holds one chunk of the serialized bytes.
+ *
+ * Catalog page format (size in bytes):
+ * ----------------------------------------------------
+ * | NextPageId (4) | DataSize (4) | Data ...         |
+ * ----------------------------------------------------
+ */
+class CatalogPage : public Page {
+ public:
+  /** Maximum number of serialized bytes held by a single catalog page. */
+  static constexpr uint32_t CAPACITY = BUSTUB_PAGE_SIZE - 2 * sizeof(uint32_t);
+
+  void Init() {
+    SetNextPageId(INVALID_PAGE_ID);
+    SetDataSize(0);
+  }
+
+  /** @return the page id of the next catalog page, INVALID_PAGE_ID for the last page */
+  auto GetNextPageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of serialized bytes stored in this page */
+  auto GetDataSize() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_DATA_SIZE); }
+
+  /** @return a pointer to the serialized bytes stored in this page */
+  auto GetPayload() -> char * { return GetData() + OFFSET_PAYLOAD; }
+
+  /**
+   * Overwrite the payload of this page.
+   * @param data the serialized bytes
+   * @param size number of bytes, at most CAPACITY
+   */
+  void SetPayload(const char *data, uint32_t size) {
+    BUSTUB_ASSERT(size <= CAPACITY, "catalog chunk does not fit in a page");
+    memcpy(GetPayload(), data, size);
+    SetDataSize(size);
+  }
+
+ private:
+  void SetDataSize(uint32_t size) { memcpy(GetData() + OFFSET_DATA_SIZE, &size, sizeof(uint32_t)); }
+
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 0;
+  static constexpr size_t OFFSET_DATA_SIZE = 4;
+  static constexpr size_t OFFSET_PAYLOAD = 8;
+};
+
+}  // namespace bustub
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// dictionary_page.h
+//
+// Identification: src/include/storage/page/dictionary_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * Dictionary page format, one link of the chain holding the values of the dictionary of a table:
+ *  ---------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| NextPageId (4)| DataSize (4)| DATA ... |
+ *  ---------------------------------------------------------------
+ *
+ * The payloads of the chain, concatenated, are the values in code order, each as its length (4) followed by its
+ * bytes. A value may span pages; new values are appended to the last page.
+ */
+class DictionaryPage : public Page {
+ public:
+  /** Initialize the DictionaryPage header. */
+  void Init(page_id_t page_id) {
+    page_id_t next_page_id = INVALID_PAGE_ID;
+    memcpy(GetData(), &page_id, sizeof(page_id_t));
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+    SetDataSize(0);
+  }
+
+  /** @return the page ID of the next page of the chain */
+  auto GetNextPageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  /** Set the page ID of the next page of the chain. */
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of bytes of the payload in use */
+  auto GetDataSize() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_DATA_SIZE); }
+
+  /** @return the payload of the page */
+  auto GetPayload() -> char * { return GetData() + SIZE_DICTIONARY_PAGE_HEADER; }
+
+  /**
+   * Append bytes to the payload.
+   * @return the number of bytes appended, less than size if the page is full
+   */
+  auto Append(const char *data, uint32_t size) -> uint32_t {
+    auto used = GetDataSize();
+    auto appended = size < PAYLOAD_SIZE - used ? size : PAYLOAD_SIZE - used;
+    memcpy(GetPayload() + used, data, appended);
+    SetDataSize(used + appended);
+    return appended;
+  }
+
+  static constexpr uint32_t SIZE_DICTIONARY_PAGE_HEADER = 16;
+  static constexpr uint32_t PAYLOAD_SIZE = BUSTUB_PAGE_SIZE - SIZE_DICTIONARY_PAGE_HEADER;
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_DATA_SIZE = 12;
+
+  void SetDataSize(uint32_t size) { memcpy(GetData() + OFFSET_DATA_SIZE, &size, sizeof(uint32_t)); }
+};
+
+}  // namespace bustub
@@ -25,14 +25,17 @@ namespace bustub {
  * non-unique keys.
  *
  * Bucket page format (keys are stored in order):
- *  ----------------------------------------------------------------
- * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
- *  ----------------------------------------------------------------
+ *  ---------------------------------------------------------------------------------
+ * | NextPageId (4) | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ---------------------------------------------------------------------------------
  *
  *  Here '+' means concatenation.
  *  The above format omits the space required for the occupied_ and
  *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
  *
+ *  A bucket which cannot be split any further, as the directory is full or all
+ *  of its keys hash the same, is extended by overflow pages, which are bucket
+ *  pages chained from it through NextPageId.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBucketPage {
@@ -40,12 +43,27 @@ class HashTableBucketPage {
   // Delete all constructor / destructor to ensure memory safety
   HashTableBucketPage() = delete;
 
+  /**
+   * Init method after creating a new bucket page, with no pairs and no overflow page
+   */
+  void Init();
+
+  /**
+   * @return the page id of the next overflow page of the bucket, INVALID_PAGE_ID if there is none
+   */
+  auto GetNextPageId() const -> page_id_t;
+
+  /**
+   * @param next_page_id the page id of the next overflow page of the bucket
+   */
+  void SetNextPageId(page_id_t next_page_id);
+
   /**
    * Scan the bucket and collect values that have the matching key
    *
    * @return true if at least one key matched
    */
-  auto GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool;
+  auto GetValue(const KeyType &key, const KeyComparator &cmp, std::vector<ValueType> *result) -> bool;
 
   /**
    * Attempts to insert a key and value in the bucket.  Uses the occupied_
@@ -55,14 +73,14 @@ class HashTableBucketPage {
    * @param value value to insert
    * @return true if inserted, false if duplicate KV pair or bucket is full
    */
-  auto Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool;
+  auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &cmp) -> bool;
 
   /**
    * Removes a key and value.
    *
    * @return true if removed, false if not found
    */
-  auto Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool;
+  auto Remove(const KeyType &key, const ValueType &value, const KeyComparator &cmp) -> bool;
 
   /**
    * Gets the key at an index in the bucket.
@@ -138,6 +156,7 @@ class HashTableBucketPage {
   void PrintBucket();
 
  private:
+  page_id_t next_page_id_;
   //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
   char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
@@ -27,9 +27,15 @@ namespace bustub {
  * Directory Page for extendible hash table.
  *
  * Directory format (size in byte):
- * --------------------------------------------------------------------------------------------
- * | LSN (4) | PageId(4) | GlobalDepth(4) | LocalDepths(512) | BucketPageIds(2048) | Free(1524)
- * --------------------------------------------------------------------------------------------
+ * --------------------------------------------------------------------------------------------------------------
+ * | LSN (4) | PageId(4) | GlobalDepth(4) | LocalDepths(512) | BucketPageIds(2048) | ExtensionPageIds(1020) |
+ * --------------------------------------------------------------------------------------------------------------
+ * | Free(504)
+ * ------------
+ *
+ * The first page of a directory larger than DIRECTORY_ARRAY_SIZE holds the page ids of its extension pages, which are
+ * directory pages too, holding the next DIRECTORY_ARRAY_SIZE local depths and bucket page ids each; see
+ * HashTableDirectory.
  */
 class HashTableDirectoryPage {
  public:
@@ -73,6 +79,21 @@ class HashTableDirectoryPage {
    */
   void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id);
 
+  /**
+   * @param extension_idx the index of an extension page, the first holding the directory indexes from
+   * DIRECTORY_ARRAY_SIZE on
+   * @return the page id of the extension page
+   */
+  auto GetExtensionPageId(uint32_t extension_idx) -> page_id_t;
+
+  /**
+   * Sets the page id of an extension page
+   *
+   * @param extension_idx the index of the extension page
+   * @param extension_page_id the page id of the extension page
+   */
+  void SetExtensionPageId(uint32_t extension_idx, page_id_t extension_page_id);
+
   /**
    * Gets the split image of an index
    *
@@ -114,7 +135,7 @@ class HashTableDirectoryPage {
   auto GetGlobalDepth() -> uint32_t;
 
   /**
-   * Increment the global depth of the directory
+   * Increment the global depth of the directory, copying the slots of this page into its new upper half if it has one
    */
   void IncrGlobalDepth();
 
@@ -192,6 +213,9 @@ class HashTableDirectoryPage {
   uint32_t global_depth_{0};
   uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
   page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+  page_id_t extension_page_ids_[DIRECTORY_EXTENSION_SIZE];
 };
 
+static_assert(sizeof(HashTableDirectoryPage) <= BUSTUB_PAGE_SIZE);
+
 }  // namespace bustub
@@ -36,15 +36,20 @@
 /**
  * BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in an extendible hash index bucket page.
  * The computation is the same as the above BLOCK_ARRAY_SIZE, but blocks and buckets have different implementations
- * of search, insertion, removal, and helper methods.
+ * of search, insertion, removal, and helper methods. The page id of the next overflow page is taken off the page.
  */
-#define BUCKET_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BUCKET_ARRAY_SIZE (4 * (BUSTUB_PAGE_SIZE - sizeof(page_id_t)) / (4 * sizeof(MappingType) + 1))
 
 /**
  * DIRECTORY_ARRAY_SIZE is the number of page_ids that can fit in the directory page of an extendible hash index.
  * This is 512 because the directory array must grow in powers of 2, and 1024 page_ids leaves zero room for
  * storage of the other member variables: page_id_, lsn_, global_depth_, and the array local_depths_.
- * Extending the directory implementation to span multiple pages would be a meaningful improvement to the
- * implementation.
  */
 #define DIRECTORY_ARRAY_SIZE 512
+
+/**
+ * DIRECTORY_EXTENSION_SIZE is the number of extension pages a directory can span past its first page, each holding
+ * DIRECTORY_ARRAY_SIZE more page_ids. Their page_ids fit in the room left on the first page, and with the first page
+ * they make a power of 2 of pages.
+ */
+#define DIRECTORY_EXTENSION_SIZE 255
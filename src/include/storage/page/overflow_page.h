@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_page.h
+//
+// Identification: src/include/storage/page/overflow_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "storage/page/page.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+/**
+ * Overflow page format, one link of the chain holding a VARCHAR value stored out of line:
+ *  ---------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| NextPageId (4)| DataSize (4)| DATA ... |
+ *  ---------------------------------------------------------------
+ *
+ * The tuple keeps a pointer to the chain in place of the value:
+ *  ----------------------------------------------------------
+ *  | POINTER_MARKER (4)| ValueLength (4)| FirstPageId (4) |
+ *  ----------------------------------------------------------
+ * The marker takes the place of the length of an inline value, which is never that large.
+ */
+class OverflowPage : public Page {
+ public:
+  /** Initialize the OverflowPage header. */
+  void Init(page_id_t page_id) {
+    page_id_t next_page_id = INVALID_PAGE_ID;
+    memcpy(GetData(), &page_id, sizeof(page_id_t));
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+    SetDataSize(0);
+  }
+
+  /** @return the page ID of the next page of the chain */
+  auto GetNextPageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  /** Set the page ID of the next page of the chain. */
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of bytes of the value held by this page */
+  auto GetDataSize() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_DATA_SIZE); }
+
+  /** @return the bytes of the value held by this page */
+  auto GetPayload() -> char * { return GetData() + SIZE_OVERFLOW_PAGE_HEADER; }
+
+  /**
+   * Copy the next piece of a value into the page.
+   * @return the number of bytes copied, at most PAYLOAD_SIZE
+   */
+  auto SetPayload(const char *data, uint32_t size) -> uint32_t {
+    auto copied = size < PAYLOAD_SIZE ? size : PAYLOAD_SIZE;
+    memcpy(GetPayload(), data, copied);
+    SetDataSize(copied);
+    return copied;
+  }
+
+  static constexpr uint32_t SIZE_OVERFLOW_PAGE_HEADER = 16;
+  static constexpr uint32_t PAYLOAD_SIZE = BUSTUB_PAGE_SIZE - SIZE_OVERFLOW_PAGE_HEADER;
+
+  /** The length word of a value stored out of line. */
+  static constexpr uint32_t POINTER_MARKER = BUSTUB_VALUE_NULL - 1;
+  /** The number of bytes a value stored out of line takes in its tuple. */
+  static constexpr uint32_t POINTER_SIZE = 3 * sizeof(uint32_t);
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_DATA_SIZE = 12;
+
+  void SetDataSize(uint32_t size) { memcpy(GetData() + OFFSET_DATA_SIZE, &size, sizeof(uint32_t)); }
+};
+
+}  // namespace bustub
@@ -0,0 +1,195 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.h
+//
+// Identification: src/include/storage/page/pax_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/page/page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * PaxLayout describes how the tuples of a schema are laid out in a PaxPage: every column gets a minipage of
+ * fixed-width entries, one per slot. A VARCHAR entry is as wide as the declared length of its column.
+ */
+class PaxLayout {
+ public:
+  explicit PaxLayout(const Schema &schema);
+
+  /** @return the schema of the tuples stored */
+  auto GetSchema() const -> const Schema & { return schema_; }
+
+  /** @return the number of slots of a page, 0 if a single tuple does not fit in a page */
+  auto GetCapacity() const -> uint32_t { return capacity_; }
+
+  /** @return the number of bytes a tuple takes in the minipages */
+  auto GetTupleWidth() const -> uint32_t { return tuple_width_; }
+
+  /** @return the width of an entry in the minipage of a column */
+  auto GetColumnWidth(uint32_t column_idx) const -> uint32_t { return column_widths_[column_idx]; }
+
+  /** @return the offset of the minipage of a column in the page */
+  auto GetMinipageOffset(uint32_t column_idx) const -> uint32_t { return minipage_offsets_[column_idx]; }
+
+  /** @return true if every value of the tuple fits in its minipage entry */
+  auto Fits(const Tuple &tuple) const -> bool;
+
+ private:
+  Schema schema_;
+  uint32_t capacity_;
+  uint32_t tuple_width_{0};
+  std::vector<uint32_t> column_widths_;
+  std::vector<uint32_t> minipage_offsets_;
+};
+
+/**
+ * PAX (Partition Attributes Across) page format:
+ *  ------------------------------------------------------------------------
+ *  | HEADER | SLOT STATES | MINIPAGE column 0 | ... | MINIPAGE column n-1 |
+ *  ------------------------------------------------------------------------
+ *
+ *  Header format (size in bytes):
+ *  ------------------------------------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| SlotCount (4)| LiveTupleCount (4) |
+ *  ------------------------------------------------------------------------------------------
+ *
+ * The first 16 bytes of the header are laid out as in TablePage, so the table heap walks and links the page chain of
+ * a PAX table through the TablePage accessors. Each slot has a one byte state; SlotCount is the number of slots ever
+ * used, slots below it are reused once their tuple is deleted. A scan that only needs a few columns only touches their
+ * minipages.
+ */
+class PaxPage : public Page {
+ public:
+  /**
+   * Initialize the PaxPage header.
+   * @param page_id the page ID of this page
+   * @param prev_page_id the previous table page ID
+   */
+  void Init(page_id_t page_id, page_id_t prev_page_id);
+
+  /** @return the page ID of this page */
+  auto GetTablePageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /** @return the page ID of the next table page */
+  auto GetNextPageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  /**
+   * Insert a tuple into a free slot.
+   * @param layout the layout of the table
+   * @param tuple tuple to insert, which must fit the layout
+   * @param[out] rid rid of the inserted tuple
+   * @return true if the insert is successful (i.e. there is a free slot)
+   */
+  auto InsertTuple(const PaxLayout &layout, const Tuple &tuple, RID *rid) -> bool;
+
+  /** Mark a tuple as deleted. @return true if the tuple exists */
+  auto MarkDelete(const RID &rid) -> bool;
+
+  /**
+   * Update a tuple in place.
+   * @param layout the layout of the table
+   * @param new_tuple new value of the tuple, which must fit the layout
+   * @param[out] old_tuple old value of the tuple
+   * @param rid rid of the tuple
+   * @return true if the tuple exists
+   */
+  auto UpdateTuple(const PaxLayout &layout, const Tuple &new_tuple, Tuple *old_tuple, const RID &rid) -> bool;
+
+  /** Free the slot of a tuple, either marked as deleted or inserted by an aborted transaction. */
+  void ApplyDelete(const RID &rid);
+
+  /** Reverse a MarkDelete. */
+  void RollbackDelete(const RID &rid);
+
+  /**
+   * Read a tuple, or some of its columns.
+   * @param layout the layout of the table
+   * @param rid rid of the tuple to read
+   * @param[out] tuple the tuple that was read
+   * @param column_ids the columns to read, the other columns are NULL; nullptr to read all of them
+   * @return true if the tuple exists
+   */
+  auto GetTuple(const PaxLayout &layout, const RID &rid, Tuple *tuple,
+                const std::vector<uint32_t> *column_ids = nullptr) -> bool;
+
+  /**
+   * @param[out] first_rid the RID of the first tuple in this page
+   * @return true if the first tuple exists, false otherwise
+   */
+  auto GetFirstTupleRid(RID *first_rid) -> bool;
+
+  /**
+   * @param cur_rid the RID of the current tuple
+   * @param[out] next_rid the RID of the tuple following the current tuple
+   * @return true if the next tuple exists, false otherwise
+   */
+  auto GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool;
+
+  /**
+   * Drop the free slots at the end of the page, so that scans stop before them.
+   * @return the number of slots dropped
+   */
+  auto Compact() -> uint32_t;
+
+  /** @return true if the page holds no tuple, not even one marked as deleted */
+  auto IsEmpty() -> bool { return GetLiveTupleCount() == 0; }
+
+  /** @return the number of bytes available for new tuples, i.e. the free slots */
+  auto GetFreeSpaceRemaining(const PaxLayout &layout) -> uint32_t {
+    return (layout.GetCapacity() - GetLiveTupleCount()) * layout.GetTupleWidth();
+  }
+
+  static constexpr size_t SIZE_PAX_PAGE_HEADER = 24;
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
+  static constexpr size_t OFFSET_SLOT_COUNT = 16;
+  static constexpr size_t OFFSET_LIVE_TUPLE_COUNT = 20;
+
+  static constexpr uint8_t SLOT_FREE = 0;
+  static constexpr uint8_t SLOT_LIVE = 1;
+  static constexpr uint8_t SLOT_DELETED = 2;
+
+  auto GetSlotCount() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_SLOT_COUNT); }
+
+  void SetSlotCount(uint32_t slot_count) { memcpy(GetData() + OFFSET_SLOT_COUNT, &slot_count, sizeof(uint32_t)); }
+
+  auto GetLiveTupleCount() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_LIVE_TUPLE_COUNT); }
+
+  void SetLiveTupleCount(uint32_t count) { memcpy(GetData() + OFFSET_LIVE_TUPLE_COUNT, &count, sizeof(uint32_t)); }
+
+  auto GetSlotState(uint32_t slot_num) -> uint8_t {
+    return *reinterpret_cast<uint8_t *>(GetData() + SIZE_PAX_PAGE_HEADER + slot_num);
+  }
+
+  void SetSlotState(uint32_t slot_num, uint8_t state) {
+    *reinterpret_cast<uint8_t *>(GetData() + SIZE_PAX_PAGE_HEADER + slot_num) = state;
+  }
+
+  /** @return the minipage entry of a column for a slot */
+  auto GetEntry(const PaxLayout &layout, uint32_t column_idx, uint32_t slot_num) -> char * {
+    return GetData() + layout.GetMinipageOffset(column_idx) + layout.GetColumnWidth(column_idx) * slot_num;
+  }
+
+  /** Write the values of a tuple to the minipage entries of a slot. */
+  void WriteTuple(const PaxLayout &layout, const Tuple &tuple, uint32_t slot_num);
+};
+
+}  // namespace bustub
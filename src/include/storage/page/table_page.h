@@ -40,6 +40,8 @@ namespace bustub {
  *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
  *  ----------------------------------------------------------------
  *
+ * Tuples start at 8-byte aligned offsets, so that values read in place, see GetTupleView, are as aligned as in a copy
+ * of the tuple.
  */
 class TablePage : public Page {
  public:
@@ -107,8 +109,11 @@ class TablePage : public Page {
   auto UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, Transaction *txn,
                    LockManager *lock_manager, LogManager *log_manager) -> bool;
 
-  /** To be called on commit or abort. Actually perform the delete or rollback an insert. */
-  void ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
+  /**
+   * To be called on commit or abort. Actually perform the delete or rollback an insert.
+   * @param[out] deleted_tuple if not nullptr, the tuple removed from the page
+   */
+  void ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager, Tuple *deleted_tuple = nullptr);
 
   /** To be called on abort. Rollback a delete, i.e. this reverses a MarkDelete. */
   void RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
@@ -123,6 +128,14 @@ class TablePage : public Page {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) -> bool;
 
+  /**
+   * View a tuple in place, without copying it. The view is valid as long as the page stays pinned and latched.
+   * @param rid rid of the tuple to view
+   * @param[out] view the view of the tuple
+   * @return true if the tuple exists
+   */
+  auto GetTupleView(const RID &rid, TupleView *view) -> bool;
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -138,6 +151,24 @@ class TablePage : public Page {
    */
   auto GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool;
 
+  /** @return the number of free bytes between the slot array and the tuple data */
+  auto GetFreeSpaceRemaining() -> uint32_t {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
+  /**
+   * Give the empty slots at the end of the slot array back to the free space. Tuple data needs no compaction, as
+   * ApplyDelete already keeps it contiguous, and the other empty slots cannot go away without changing RIDs.
+   * @return the number of slots dropped
+   */
+  auto Compact() -> uint32_t;
+
+  /** @return true if the page holds no tuple, not even one marked as deleted */
+  auto IsEmpty() -> bool;
+
+  /** @return the free space InsertTuple needs for the given tuple, i.e. the tuple and its slot */
+  static auto GetSpaceNeeded(const Tuple &tuple) -> uint32_t { return AlignedSize(tuple.GetLength()) + SIZE_TUPLE; }
+
  private:
   static_assert(sizeof(page_id_t) == 4);
 
@@ -149,6 +180,12 @@ class TablePage : public Page {
   static constexpr size_t OFFSET_TUPLE_COUNT = 20;
   static constexpr size_t OFFSET_TUPLE_OFFSET = 24;  // Naming things is hard.
   static constexpr size_t OFFSET_TUPLE_SIZE = 28;
+  static constexpr uint32_t TUPLE_ALIGNMENT = 8;
+
+  /** @return the space taken by a tuple of the given size, padded so that the next tuple is aligned */
+  static auto AlignedSize(uint32_t tuple_size) -> uint32_t {
+    return (tuple_size + TUPLE_ALIGNMENT - 1) / TUPLE_ALIGNMENT * TUPLE_ALIGNMENT;
+  }
 
   /** @return pointer to the end of the current free space, see header comment */
   auto GetFreeSpacePointer() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
@@ -167,10 +204,6 @@ class TablePage : public Page {
   /** Set the number of tuples in this page. */
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  auto GetFreeSpaceRemaining() -> uint32_t {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
-
   /** @return tuple offset at slot slot_num */
   auto GetTupleOffsetAtSlot(uint32_t slot_num) -> uint32_t {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// dictionary.h
+//
+// Identification: src/include/storage/table/dictionary.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * Dictionary is the table-level dictionary of the dictionary encoded VARCHAR columns of a table heap. Every distinct
+ * value gets a code, numbered from 0 in order of first appearance and shared by all the encoded columns of the table,
+ * so that two encoded columns can be compared on their codes. The table heap stores tuples in their encoded form,
+ * where each encoded column is an INTEGER holding the code of its value; this makes a low-cardinality string column
+ * take 4 bytes per row.
+ *
+ * The values are appended to a chain of DictionaryPages as they are first encoded, and are read back when the table
+ * is reopened. Codes are never reused: a value stays in the dictionary after its last row is deleted.
+ */
+class Dictionary {
+ public:
+  /**
+   * Create the dictionary of a new table, or open the dictionary of an existing one.
+   * @param buffer_pool_manager the buffer pool manager
+   * @param schema the schema of the table, with at least one dictionary encoded column
+   * @param first_page_id the first page of the dictionary of an existing table, INVALID_PAGE_ID for a new table
+   */
+  Dictionary(BufferPoolManager *buffer_pool_manager, const Schema &schema, page_id_t first_page_id = INVALID_PAGE_ID);
+
+  /** @return true if the schema has a dictionary encoded column */
+  static auto HasEncodedColumns(const Schema &schema) -> bool;
+
+  /** @return the schema of the encoded tuples, with an INTEGER column in place of every encoded column */
+  auto GetEncodedSchema() const -> const Schema & { return encoded_schema_; }
+
+  /** @return the first page of the chain holding the values */
+  auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
+
+  /** @return true if the values of a column of the table are encoded */
+  auto IsEncoded(uint32_t column_idx) const -> bool { return is_encoded_[column_idx]; }
+
+  /** @return the number of values in the dictionary */
+  auto Size() -> size_t;
+
+  /** @return the code of a value, std::nullopt if the value was never encoded */
+  auto Lookup(const std::string &value) -> std::optional<int32_t>;
+
+  /**
+   * Encode a tuple of the table, adding its new values to the dictionary.
+   * @param tuple the tuple to encode, in the schema of the table
+   * @param[out] encoded the tuple in the encoded schema
+   * @return false if a new value could not be stored, i.e. the buffer pool is full
+   */
+  auto EncodeTuple(const Tuple &tuple, Tuple *encoded) -> bool;
+
+  /**
+   * Decode a tuple read from the table, keeping its RID.
+   * @param[in,out] tuple a tuple in the encoded schema, replaced by the tuple in the schema of the table
+   * @param column_ids the columns to decode, the other encoded columns are NULL; nullptr to decode all of them
+   */
+  void DecodeTuple(Tuple *tuple, const std::vector<uint32_t> *column_ids = nullptr);
+
+ private:
+  /** @return the code of a value, adding it if needed; std::nullopt if it could not be stored */
+  auto Encode(const std::string &value) -> std::optional<int32_t>;
+
+  /** Append bytes to the chain of pages. @return false if a new page could not be allocated */
+  auto AppendToChain(const char *data, uint32_t size) -> bool;
+
+  BufferPoolManager *buffer_pool_manager_;
+  Schema schema_;
+  Schema encoded_schema_;
+  std::vector<bool> is_encoded_;
+  page_id_t first_page_id_{INVALID_PAGE_ID};
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+
+  /** Held shared to read the values, and exclusively to add one. */
+  std::shared_mutex latch_;
+  /** The values by code; a deque, so that adding a value does not move the others. */
+  std::deque<std::string> values_;
+  std::unordered_map<std::string, int32_t> codes_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap tracks the approximate free space of every page of a table heap, so that inserts can go straight to a
+ * page with room instead of walking the page chain.
+ *
+ * The free space of a page is stored as a one-byte category, i.e. the number of free bytes divided by CATEGORY_SIZE and
+ * rounded down, so a page is never reported to have more room than it really has. The categories are kept in a max
+ * segment tree, which finds a page with at least the requested category in O(log n).
+ */
+class FreeSpaceMap {
+ public:
+  /** Number of bytes represented by one free space category. */
+  static constexpr uint32_t CATEGORY_SIZE = BUSTUB_PAGE_SIZE / 256;
+
+  /**
+   * Record the free space of a page, adding the page to the map if it is not tracked yet.
+   * @param page_id the page id
+   * @param free_space the number of free bytes on the page
+   */
+  void Update(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Find a page with at least the requested free space. The search starts at a position derived from the hint and
+   * wraps around, so that callers passing different hints are spread across different pages.
+   * @param needed the number of free bytes needed
+   * @param hint where to start the search, e.g. a per-thread number
+   * @return the id of a page with room, INVALID_PAGE_ID if no tracked page has enough free space
+   */
+  auto FindPage(uint32_t needed, size_t hint = 0) -> page_id_t;
+
+  /**
+   * Stop tracking a page, e.g. because it was freed. The last tracked page takes its position in the tree.
+   * @param page_id the page id
+   */
+  void Remove(page_id_t page_id);
+
+  /** @return the recorded free space of a page rounded down to a category, 0 if the page is not tracked */
+  auto GetFreeSpace(page_id_t page_id) -> uint32_t;
+
+  /** @return the number of pages tracked */
+  auto Size() -> size_t;
+
+  /** @return the ids of the pages tracked, in no particular order */
+  auto GetPageIds() -> std::vector<page_id_t>;
+
+ private:
+  /** Set the category at a position, and update its ancestors. */
+  void SetCategory(size_t pos, uint8_t category);
+
+  /** Find the first position >= from whose category is at least the given one in the subtree of node. */
+  auto FindFrom(size_t node, size_t node_begin, size_t node_end, size_t from, uint8_t category) -> size_t;
+
+  std::mutex latch_;
+  /** Position of each page in the tree. */
+  std::unordered_map<page_id_t, size_t> positions_;
+  /** Page id at each position. */
+  std::vector<page_id_t> page_ids_;
+  /** Max segment tree over the categories, the leaves start at capacity_. */
+  std::vector<uint8_t> tree_;
+  size_t capacity_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_dispenser.h
+//
+// Identification: src/include/storage/table/morsel_dispenser.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/table/table_scanner.h"
+
+namespace bustub {
+
+class TableHeap;
+class Transaction;
+
+/** A morsel is a run of consecutive pages of a table heap, the unit of work of a parallel scan. */
+struct Morsel {
+  /** The position of the morsel in the table, morsels are numbered from 0 in page chain order. */
+  size_t index_{0};
+  /** The pages of the morsel, in page chain order. */
+  std::vector<page_id_t> page_ids_;
+};
+
+/**
+ * MorselDispenser splits the page chain of a TableHeap into morsels and hands them out to the worker threads of a
+ * parallel scan as they ask for them, so that a worker which is done early takes more of the table. Claiming a morsel
+ * only reads the headers of its pages to follow the chain; the tuples are read by the worker with VisitMorsel.
+ *
+ * Like a TableScanner, the dispenser is registered as an open scan of its table heap for as long as it exists, so that
+ * a vacuum does not free the pages of morsels which were handed out.
+ */
+class MorselDispenser {
+ public:
+  /**
+   * @param table_heap the table to scan
+   * @param morsel_size the number of pages of a morsel
+   * @param txn the transaction performing the scan, see TableScanner
+   */
+  MorselDispenser(TableHeap *table_heap, size_t morsel_size, Transaction *txn = nullptr);
+
+  ~MorselDispenser();
+
+  DISALLOW_COPY_AND_MOVE(MorselDispenser);
+
+  /**
+   * Claim the next morsel of the table. Thread safe.
+   * @param[out] morsel the claimed morsel
+   * @return false if every morsel was handed out
+   */
+  auto Next(Morsel *morsel) -> bool;
+
+  /**
+   * Visit the tuples of a morsel, a page at a time, see TableScanner::NextPage. Thread safe.
+   * @param morsel the morsel to visit
+   * @param column_ids the columns needed, see TableHeap::GetTuple; nullptr for all of them
+   * @param visitor called with a view of every tuple of the morsel, in page chain and slot order
+   * @param encoded_filter the tuples to visit of a dictionary encoded table, see TableScanner; nullptr for all of them
+   */
+  void VisitMorsel(const Morsel &morsel, const std::vector<uint32_t> *column_ids, const TableScanner::Visitor &visitor,
+                   const TableScanner::EncodedFilter &encoded_filter = nullptr);
+
+ private:
+  TableHeap *table_heap_;
+  size_t morsel_size_;
+  Transaction *txn_;
+  /** Protects the fields below. */
+  std::mutex latch_;
+  /** The first page of the next morsel, INVALID_PAGE_ID once the whole table was handed out. */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  size_t next_index_{0};
+  bool holds_scan_{false};
+};
+
+}  // namespace bustub
@@ -12,20 +12,56 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <shared_mutex>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
+#include "storage/page/overflow_page.h"
+#include "storage/page/pax_page.h"
 #include "storage/page/table_page.h"
+#include "storage/table/dictionary.h"
+#include "storage/table/free_space_map.h"
 #include "storage/table/table_iterator.h"
+#include "storage/table/table_sample.h"
 #include "storage/table/tuple.h"
+#include "storage/table/version_store.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * A free space map of the pages is kept in memory, so that inserts go straight to a page with room. For a table that
+ * was opened rather than created, it is built by walking the page chain once on the first insert.
+ *
+ * The pages are either slotted pages holding whole rows (TableFormat::ROW), or PAX pages grouping the values of each
+ * column in a minipage (TableFormat::PAX), so that a scan reading a few columns of a wide table touches less memory.
+ *
+ * The long VARCHAR values of a row table are stored out of line in chains of overflow pages, so that a tuple larger
+ * than a page can be stored, and a scan which does not read these columns never touches the overflow pages.
+ *
+ * The dictionary encoded VARCHAR columns of a table are stored as codes into the dictionary of the table. Tuples are
+ * encoded before they are written, and decoded when they are read, so that the callers only ever see the values.
+ *
+ * Deleted tuples leave empty slots and empty pages behind; Vacuum compacts the pages and unlinks the empty ones, so
+ * that scans only visit pages with live tuples.
+ *
+ * The pages hold the newest version of every tuple. The versions replaced by recent writes are kept in the version
+ * store of the table, so that a SNAPSHOT_ISOLATION transaction reads the table as of the time it began without
+ * taking locks, while other transactions write to it. A deleted tuple stays in its page, marked as deleted, until the
+ * TransactionManager collects it once no snapshot sees it any more.
  */
 class TableHeap {
+  friend class MorselDispenser;
   friend class TableIterator;
+  friend class TableScanner;
 
  public:
   ~TableHeap() = default;
@@ -36,9 +72,14 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param first_page_id the id of the first page
+   * @param format the page layout of the table
+   * @param schema the schema of the table, required by the PAX layout, to store values out of line, and to encode
+   * values with a dictionary
+   * @param dictionary_page_id the first page of the dictionary, if the schema has dictionary encoded columns
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            page_id_t first_page_id);
+            page_id_t first_page_id, TableFormat format = TableFormat::ROW, const Schema *schema = nullptr,
+            page_id_t dictionary_page_id = INVALID_PAGE_ID);
 
   /**
    * Create a table heap with a transaction. (create table)
@@ -46,12 +87,16 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param txn the creating transaction
+   * @param format the page layout of the table
+   * @param schema the schema of the table, required by the PAX layout, to store values out of line, and to encode
+   * values with a dictionary
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            Transaction *txn);
+            Transaction *txn, TableFormat format = TableFormat::ROW, const Schema *schema = nullptr);
 
   /**
-   * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * Insert a tuple into the table. The longest VARCHAR values of a large tuple are moved to overflow pages, if the
+   * tuple is still too large (>= page_size), return false.
    * @param tuple tuple to insert
    * @param[out] rid the rid of the inserted tuple
    * @param txn the transaction performing the insert
@@ -59,10 +104,20 @@ class TableHeap {
    */
   auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
 
+  /**
+   * Append a batch of tuples to the end of the table, e.g. for a bulk load. Each page is latched once and filled up
+   * before moving on to a new page, and the pages filled are written out in sequential batches.
+   * @param tuples tuples to insert
+   * @param[out] rids the rids of the inserted tuples, in the same order
+   * @param txn the transaction performing the insert
+   * @return true iff all the tuples are inserted
+   */
+  auto BulkInsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) -> bool;
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param rid resource id of the tuple of delete
-   * @param txn transaction performing the delete
+   * @param txn transaction performing the delete, aborted if another transaction wrote the tuple and did not commit
    * @return true iff the delete is successful (i.e the tuple exists)
    */
   auto MarkDelete(const RID &rid, Transaction *txn) -> bool;  // for delete
@@ -71,7 +126,8 @@ class TableHeap {
    * if the new tuple is too large to fit in the old page, return false (will delete and insert)
    * @param tuple new tuple
    * @param rid rid of the old tuple
-   * @param txn transaction performing the update
+   * @param txn transaction performing the update, aborted if another transaction wrote the tuple and did not commit;
+   * an aborted transaction rolls back its own update
    * @return true is update is successful.
    */
   auto UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) -> bool;
@@ -94,25 +150,235 @@ class TableHeap {
    * Read a tuple from the table.
    * @param rid rid of the tuple to read
    * @param tuple output variable for the tuple
-   * @param txn transaction performing the read
-   * @return true if the read was successful (i.e. the tuple exists)
+   * @param txn transaction performing the read; a SNAPSHOT_ISOLATION transaction reads the version of the tuple of
+   * its snapshot
+   * @param column_ids the columns needed, nullptr for all of them. A PAX table only reads these columns and leaves
+   * the others NULL. A row table returns the whole tuple, but only fetches the values stored out of line for these
+   * columns and leaves the others NULL. An older version of a tuple is returned whole.
+   * @return true if the read was successful (i.e. the tuple exists, or a version of it is visible to the snapshot)
    */
-  auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
+  auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true,
+                const std::vector<uint32_t> *column_ids = nullptr) -> bool;
+
+  /**
+   * Stamp the versions of a tuple written by a committing transaction, see VersionStore::Commit.
+   * @param rid rid of the tuple
+   * @param txn_id the committing transaction
+   * @param commit_ts the commit timestamp of the transaction
+   */
+  void CommitVersions(const RID &rid, txn_id_t txn_id, timestamp_t commit_ts);
+
+  /**
+   * Drop the versions of a tuple no snapshot sees any more, and remove the tuple from its page if it was deleted.
+   * @param rid rid of the tuple
+   * @param watermark the read timestamp of the oldest snapshot in use
+   */
+  void CollectGarbage(const RID &rid, timestamp_t watermark);
 
   /** @return the begin iterator of this table */
   auto Begin(Transaction *txn) -> TableIterator;
 
+  /**
+   * @param txn the transaction performing the scan
+   * @param column_ids the columns needed by the scan, see GetTuple
+   * @return the begin iterator of this table, which only materializes the given columns
+   */
+  auto Begin(Transaction *txn, std::vector<uint32_t> column_ids) -> TableIterator;
+
   /** @return the end iterator of this table */
   auto End() -> TableIterator;
 
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
+  /** @return the free space map of this table */
+  auto GetFreeSpaceMap() -> FreeSpaceMap *;
+
+  /** @return the zone map of this table, nullptr if the table heap was created without a schema */
+  inline auto GetZoneMap() -> ZoneMap * { return zone_map_.get(); }
+
+  /** @return the dictionary of this table, nullptr if no column is dictionary encoded */
+  inline auto GetDictionary() -> Dictionary * { return dictionary_.get(); }
+
+  /** @return the versions of the tuples kept for snapshot readers */
+  inline auto GetVersionStore() -> VersionStore * { return &version_store_; }
+
+  /** @return the page layout of this table */
+  inline auto GetFormat() const -> TableFormat { return format_; }
+
+  /** @return true if reading only some of the columns is cheaper than reading whole tuples, see GetTuple */
+  inline auto SupportsColumnPruning() const -> bool { return pax_layout_ != nullptr || toast_schema_ != nullptr; }
+
+  /**
+   * Compact every page of the table, then unlink and free the empty pages, except the first one, and update the free
+   * space map. Inserts wait until the vacuum is done. Pages are only freed when no iterator is open on the table, as
+   * an iterator may point into any page; otherwise the pages are only compacted.
+   * @return the number of pages freed
+   */
+  auto Vacuum() -> size_t;
+
+  /** @return true if enough tuples were deleted since the last vacuum, i.e. on average one per page */
+  auto NeedsVacuum() -> bool;
+
+  /**
+   * Draw the pages of a block-level sample. The pages are picked from the free space map, without walking the page
+   * chain. The caller must keep the pages from being freed by a vacuum, e.g. as an open scan.
+   * @param sample the sample, with a seed
+   * @return the ids of the pages kept by the sample, in ascending order
+   */
+  auto SamplePages(const TableSample &sample) -> std::vector<page_id_t>;
+
+  /**
+   * Estimate the number of tuples of the table from the tuples of a few random pages, without reading the others.
+   * @param num_pages the number of pages to read on average
+   * @return the estimated number of tuples
+   */
+  auto EstimateTupleCount(size_t num_pages = 32) -> size_t;
+
  private:
+  /**
+   * Set up the layout of the tuples in the pages, shared by both constructors.
+   * @param schema the schema of the table, may be nullptr
+   * @param dictionary_page_id the first page of the dictionary of an existing table, INVALID_PAGE_ID for a new table
+   */
+  void InitLayout(const Schema *schema, page_id_t dictionary_page_id);
+
+  /** Initialize a new page of the table. */
+  void InitPage(TablePage *page, page_id_t page_id, page_id_t prev_page_id, Transaction *txn);
+
+  /** @return true if the transaction reads a snapshot, see IsolationLevel::SNAPSHOT_ISOLATION */
+  static auto ReadsSnapshot(const Transaction *txn) -> bool {
+    return txn != nullptr && txn->GetIsolationLevel() == IsolationLevel::SNAPSHOT_ISOLATION;
+  }
+
+  /** Insert a tuple into a page, which must be latched by the caller. */
+  auto InsertIntoPage(TablePage *page, const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
+
+  /**
+   * Read a tuple as stored in a page, which must be latched by the caller: still encoded, but with the values stored
+   * out of line read back, as kept in the version store.
+   * @return true if the tuple exists
+   */
+  auto ReadStoredTuple(TablePage *page, const RID &rid, Tuple *tuple, Transaction *txn) -> bool;
+
+  /**
+   * Remove a tuple from a page, which must be latched by the caller.
+   * @param[out] deleted_tuple the tuple as stored, whose overflow pages are to be freed; nullptr if not needed
+   */
+  void RemoveFromPage(TablePage *page, const RID &rid, Transaction *txn, Tuple *deleted_tuple);
+
+  /**
+   * Find the first tuple of a page, which must be latched by the caller.
+   * @param txn a snapshot transaction also visits the tuples marked as deleted which have versions; nullptr otherwise
+   */
+  auto GetFirstTupleRid(TablePage *page, RID *first_rid, const Transaction *txn = nullptr) -> bool;
+
+  /** Find the tuple following cur_rid in a page, which must be latched by the caller, see GetFirstTupleRid. */
+  auto GetNextTupleRid(TablePage *page, const RID &cur_rid, RID *next_rid, const Transaction *txn = nullptr) -> bool;
+
+  /** Compact a page, which must be latched by the caller. @return true if the page was modified */
+  auto CompactPage(TablePage *page) -> bool;
+
+  /**
+   * Call visitor on a view of every tuple of a page, which must be latched by the caller, see TableScanner.
+   * @param page the page to visit
+   * @param txn the transaction performing the scan, a snapshot transaction visits the versions it sees
+   * @param column_ids the columns needed, see GetTuple
+   * @param visitor the function to call
+   * @param encoded_filter called on a tuple of a dictionary encoded table before it is decoded, the tuple is skipped
+   * if it returns false; nullptr to visit every tuple
+   * @return the number of tuples visited
+   */
+  auto VisitPage(TablePage *page, Transaction *txn, const std::vector<uint32_t> *column_ids,
+                 const std::function<void(const TupleView &)> &visitor,
+                 const std::function<bool(const Tuple &)> &encoded_filter = nullptr) -> size_t;
+
+  /** @return true if a page holds no tuple, the page must be latched by the caller */
+  auto IsPageEmpty(TablePage *page) -> bool;
+
+  /**
+   * Move the longest VARCHAR values of a large tuple to overflow pages, until the tuple takes at most a quarter of a
+   * page.
+   * @param tuple the tuple to store
+   * @param[out] stored the tuple referring to the overflow pages, if any value was moved
+   * @return the tuple to write to the page, either tuple or stored; nullptr if no overflow page could be allocated
+   */
+  auto ToastTuple(const Tuple &tuple, Tuple *stored) -> const Tuple *;
+
+  /**
+   * Replace the overflow pointers of a tuple read from a page by their values.
+   * @param tuple the tuple read from the page
+   * @param column_ids the columns needed, the values of the others are not fetched and become NULL
+   */
+  void DetoastTuple(Tuple *tuple, const std::vector<uint32_t> *column_ids);
+
+  /**
+   * Replace the values of the dictionary encoded columns of a tuple by their codes.
+   * @param tuple the tuple to store
+   * @param[out] encoded the encoded tuple, if the table has a dictionary
+   * @return the tuple to store, either tuple or encoded; nullptr if a new value could not be added to the dictionary
+   */
+  auto EncodeTuple(const Tuple &tuple, Tuple *encoded) -> const Tuple *;
+
+  /** Free the overflow pages a tuple read from a page refers to. */
+  void FreeOverflowValues(const Tuple &stored);
+
+  /** Write a value to a new chain of overflow pages. @return the first page, INVALID_PAGE_ID if out of pages */
+  auto WriteOverflowValue(const char *data, uint32_t size) -> page_id_t;
+
+  /** Read a value of the given size from a chain of overflow pages. */
+  void ReadOverflowValue(page_id_t first_page_id, uint32_t size, char *data);
+
+  /** Free a chain of overflow pages. */
+  void FreeOverflowChain(page_id_t first_page_id);
+
+  /** @return the first iterator position of the table, an invalid RID if the table is empty */
+  auto FirstTupleRid(const Transaction *txn) -> RID;
+
+  /** Build the free space map from the page chain, and find the last page. */
+  void InitFreeSpaceMap();
+
+  /** Record the current free space of a page, which must be latched by the caller. */
+  void UpdateFreeSpace(TablePage *page);
+
+  /**
+   * Insert into the last page, or into a new page appended to the chain when the last page is full.
+   * @return true iff the insert is successful
+   */
+  auto AppendTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  TableFormat format_;
+  /** The dictionary of the encoded columns, nullptr if there is none. */
+  std::unique_ptr<Dictionary> dictionary_;
+  /** How tuples are laid out in the pages of a PAX table, nullptr for a row table. */
+  std::unique_ptr<PaxLayout> pax_layout_;
+  /**
+   * The schema of the stored tuples of a row table with VARCHAR columns, whose values may be stored out of line;
+   * nullptr otherwise.
+   */
+  std::unique_ptr<Schema> toast_schema_;
+  /** The value ranges of the pages created by this table heap, nullptr if there is no schema. */
+  std::unique_ptr<ZoneMap> zone_map_;
+  /** The older versions of the tuples written recently. */
+  VersionStore version_store_;
+
+  FreeSpaceMap free_space_map_;
+  std::once_flag free_space_map_init_;
+  /** The last page of the chain, protected by append_latch_. */
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  /** Serializes appending new pages to the chain. */
+  std::mutex append_latch_;
+
+  /** Held shared by inserters and while creating an iterator, and exclusively by Vacuum. */
+  std::shared_mutex vacuum_latch_;
+  /** The number of open scans: iterators and scanners which have not reached the end, and morsel dispensers. */
+  std::atomic<size_t> num_scans_{0};
+  /** The number of tuples deleted since the last vacuum. */
+  std::atomic<size_t> num_deleted_{0};
 };
 
 }  // namespace bustub
@@ -13,6 +13,9 @@
 #pragma once
 
 #include <cassert>
+#include <optional>
+#include <utility>
+#include <vector>
 
 #include "common/rid.h"
 #include "concurrency/transaction.h"
@@ -23,7 +26,9 @@ namespace bustub {
 class TableHeap;
 
 /**
- * TableIterator enables the sequential scan of a TableHeap.
+ * TableIterator enables the sequential scan of a TableHeap. A projecting iterator only materializes the columns it
+ * was created with, see TableHeap::GetTuple. An iterator which has not reached the end is registered as an open scan
+ * of its table heap, so that a vacuum does not free the pages it is about to walk.
  */
 class TableIterator {
   friend class Cursor;
@@ -31,10 +36,11 @@ class TableIterator {
  public:
   TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
 
-  TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, std::vector<uint32_t> column_ids);
 
-  ~TableIterator() { delete tuple_; }
+  TableIterator(const TableIterator &other);
+
+  ~TableIterator();
 
   inline auto operator==(const TableIterator &itr) const -> bool {
     return tuple_->rid_.Get() == itr.tuple_->rid_.Get();
@@ -50,17 +56,25 @@ class TableIterator {
 
   auto operator++(int) -> TableIterator;
 
-  auto operator=(const TableIterator &other) -> TableIterator & {
-    table_heap_ = other.table_heap_;
-    *tuple_ = *other.tuple_;
-    txn_ = other.txn_;
-    return *this;
-  }
+  auto operator=(const TableIterator &other) -> TableIterator &;
 
  private:
+  /** @return the columns to read, nullptr for all of them */
+  auto GetColumnIds() const -> const std::vector<uint32_t> * {
+    return column_ids_.has_value() ? &column_ids_.value() : nullptr;
+  }
+
+  /** Register the iterator as an open scan of the table heap if it has not reached the end. */
+  void AcquireScan();
+
+  /** Unregister the iterator as an open scan of the table heap. */
+  void ReleaseScan();
+
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  std::optional<std::vector<uint32_t>> column_ids_;
+  bool holds_scan_{false};
 };
 
 }  // namespace bustub
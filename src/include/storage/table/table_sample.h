@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_sample.h
+//
+// Identification: src/include/storage/table/table_sample.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "common/config.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/**
+ * TableSample describes a random sample of the tuples of a table, e.g. `SELECT * FROM t TABLESAMPLE SYSTEM (10)`.
+ *
+ * A SYSTEM sample is block-level: every page is kept with the given probability, with all of its tuples, and the
+ * other pages are not read at all. A BERNOULLI sample is row-level: every tuple is kept with the given probability,
+ * which gives a less clustered sample but reads the whole table. Whether a page or a tuple is kept only depends on
+ * a hash of its id and of the seed, so that a sample is repeatable and can be drawn by many threads at once.
+ */
+struct TableSample {
+  enum class Method { SYSTEM, BERNOULLI };
+
+  Method method_{Method::SYSTEM};
+  /** The percentage of the pages or tuples to keep, between 0 and 100. */
+  double percentage_{100};
+  /** The seed of a REPEATABLE sample, std::nullopt to draw a different sample every time. */
+  std::optional<uint64_t> seed_;
+
+  /** @return a copy of this sample with a seed, a random one if it has none */
+  auto WithSeed() const -> TableSample;
+
+  /** @return true if the page is part of the sample, always true for a BERNOULLI sample */
+  auto KeepsPage(page_id_t page_id) const -> bool;
+
+  /** @return true if the tuple is part of the sample, always true for a SYSTEM sample */
+  auto KeepsTuple(const RID &rid) const -> bool;
+
+  auto ToString() const -> std::string;
+
+ private:
+  /** @return true with the sample probability, for the given id */
+  auto Keeps(uint64_t id) const -> bool;
+};
+
+}  // namespace bustub
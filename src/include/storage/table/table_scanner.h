@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_scanner.h
+//
+// Identification: src/include/storage/table/table_scanner.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/table/table_sample.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+class TableHeap;
+class Transaction;
+
+/**
+ * TableScanner scans a TableHeap one page at a time. The tuples of a page are handed out as views into the page while
+ * it is pinned and read latched, so a scan only copies the tuples it keeps, instead of materializing every tuple as
+ * TableIterator does.
+ *
+ * The visitor runs under the page latch: it must not keep the views, and must not access the pages of the same table.
+ * A PAX page, or a row holding values stored out of line, has no row to point to; such a tuple is assembled and the
+ * view points to the copy. Like an iterator, a scanner which has not reached the end is registered as an open scan of
+ * its table heap, so that a vacuum does not free the pages it is about to walk. A page filter, e.g. built from the
+ * zone map of the table, lets the scanner skip the pages which hold no tuple of interest. The tuples of a dictionary
+ * encoded table can also be filtered on their codes, so that only the tuples which pass are decoded. The scan of a
+ * SNAPSHOT_ISOLATION transaction visits the versions of the tuples of its snapshot.
+ *
+ * A scanner may also visit a random sample of the table. The pages of a block-level sample are drawn when the scanner
+ * is created, and are visited in page id order without walking the rest of the page chain.
+ */
+class TableScanner {
+ public:
+  using Visitor = std::function<void(const TupleView &)>;
+  /** Returns false for a page whose tuples need not be visited. */
+  using PageFilter = std::function<bool(page_id_t)>;
+  /** Returns false for a tuple of a dictionary encoded table, in its encoded form, which need not be visited. */
+  using EncodedFilter = std::function<bool(const Tuple &)>;
+
+  /**
+   * @param table_heap the table to scan
+   * @param column_ids the columns needed by the scan, see TableHeap::GetTuple; std::nullopt for all of them
+   * @param page_filter the pages to visit, nullptr for all of them
+   * @param encoded_filter the tuples to visit of a dictionary encoded table, nullptr for all of them
+   * @param txn the transaction performing the scan, nullptr to visit the newest version of every tuple
+   * @param sample the sample of the tuples to visit, with a seed; std::nullopt for all of them
+   */
+  explicit TableScanner(TableHeap *table_heap, std::optional<std::vector<uint32_t>> column_ids = std::nullopt,
+                        PageFilter page_filter = nullptr, EncodedFilter encoded_filter = nullptr,
+                        Transaction *txn = nullptr, std::optional<TableSample> sample = std::nullopt);
+
+  ~TableScanner();
+
+  DISALLOW_COPY_AND_MOVE(TableScanner);
+
+  /**
+   * Visit the tuples of the next page holding any tuple and accepted by the page filter.
+   * @param visitor called with a view of every tuple of the page, in slot order
+   * @return false if the end of the table was reached, without visiting any tuple
+   */
+  auto NextPage(const Visitor &visitor) -> bool;
+
+ private:
+  /** Unregister the scanner as an open scan of the table heap. */
+  void ReleaseScan();
+
+  TableHeap *table_heap_;
+  std::optional<std::vector<uint32_t>> column_ids_;
+  PageFilter page_filter_;
+  EncodedFilter encoded_filter_;
+  Transaction *txn_;
+  std::optional<TableSample> sample_;
+  /** The pages of a block-level sample, visited instead of the page chain. */
+  std::optional<std::vector<page_id_t>> sample_page_ids_;
+  size_t sample_page_idx_{0};
+  /** The next page to visit, INVALID_PAGE_ID at the end of the table. */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  bool holds_scan_{false};
+};
+
+}  // namespace bustub
@@ -28,9 +28,12 @@ namespace bustub {
  * ---------------------------------------------------------------------
  */
 class Tuple {
+  friend class Dictionary;
   friend class TablePage;
+  friend class PaxPage;
   friend class TableHeap;
   friend class TableIterator;
+  friend class TupleView;
 
  public:
   // Default constructor (to create a dummy tuple)
@@ -48,6 +51,12 @@ class Tuple {
   // assign operator, deep copy
   auto operator=(const Tuple &other) -> Tuple &;
 
+  // move constructor, takes over the data of other, which is left empty
+  Tuple(Tuple &&other) noexcept;
+
+  // move assign operator, takes over the data of other, which is left empty
+  auto operator=(Tuple &&other) noexcept -> Tuple &;
+
   ~Tuple() {
     if (allocated_) {
       delete[] data_;
@@ -82,7 +91,7 @@ class Tuple {
     Value value = GetValue(schema, column_idx);
     return value.IsNull();
   }
-  inline auto IsAllocated() -> bool { return allocated_; }
+  inline auto IsAllocated() const -> bool { return allocated_; }
 
   auto ToString(const Schema *schema) const -> std::string;
 
@@ -96,4 +105,52 @@ class Tuple {
   char *data_{nullptr};
 };
 
+/**
+ * TupleView is a read-only view of a tuple stored elsewhere, typically in a page which is pinned and latched while the
+ * view is used. Nothing is copied: the view is only valid as long as the memory it points to, use ToTuple to keep the
+ * tuple.
+ */
+class TupleView {
+ public:
+  TupleView() = default;
+
+  /** View the tuple serialized at data. */
+  TupleView(const char *data, uint32_t size, RID rid);
+
+  /** View the data of a tuple. */
+  explicit TupleView(const Tuple &tuple) : TupleView(tuple.GetData(), tuple.GetLength(), tuple.GetRid()) {}
+
+  /** @return the RID of the viewed tuple */
+  inline auto GetRid() const -> RID { return tuple_.GetRid(); }
+
+  /** @return the serialized tuple */
+  inline auto GetData() const -> const char * { return tuple_.GetData(); }
+
+  /** @return the length of the serialized tuple */
+  inline auto GetLength() const -> uint32_t { return tuple_.GetLength(); }
+
+  /** @return the value of a column */
+  inline auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value {
+    return tuple_.GetValue(schema, column_idx);
+  }
+
+  /** @return true if the value of a column is NULL */
+  inline auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool {
+    return tuple_.IsNull(schema, column_idx);
+  }
+
+  /**
+   * @return a tuple sharing the memory of the view, e.g. to evaluate an expression on it. Copies of it share the same
+   * memory, and are only valid as long as the view.
+   */
+  inline auto AsTuple() const -> const Tuple & { return tuple_; }
+
+  /** @return a copy of the viewed tuple, which owns its data */
+  auto ToTuple() const -> Tuple;
+
+ private:
+  /** A tuple which does not own its data. */
+  Tuple tuple_;
+};
+
 }  // namespace bustub
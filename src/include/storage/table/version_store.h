@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// version_store.h
+//
+// Identification: src/include/storage/table/version_store.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rid.h"
+#include "concurrency/transaction.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * VersionStore keeps the versions of the tuples of a table heap that snapshot readers may still need. The newest
+ * version of a tuple is the one in its page; for a tuple written recently, the store records the timestamp of that
+ * version, whether it is a deleted tuple, and the older versions it replaced, with their timestamps. A tuple without
+ * an entry was written before any snapshot in use was taken, and is visible to every transaction.
+ *
+ * The timestamps are the commit timestamps handed out by the TransactionManager. A version written by a transaction
+ * which has not committed yet is stamped with the id of the transaction and UNCOMMITTED_FLAG, and stamped again with
+ * the commit timestamp when the transaction commits. A transaction sees its own versions and the versions committed
+ * at or before its read timestamp.
+ *
+ * The older versions are copies of the tuples as stored, i.e. still dictionary encoded but with their values stored
+ * out of line read back. The entries are dropped by garbage collection once no snapshot in use needs them. Writers
+ * and readers hold the latch of the page of the tuple, so that the entries of a page do not change while it is read
+ * latched, except for the timestamps set on commit.
+ */
+class VersionStore {
+ public:
+  /** Set on the timestamp of a version written by a transaction which has not committed. */
+  static constexpr timestamp_t UNCOMMITTED_FLAG = timestamp_t{1} << 62;
+
+  /** Where to read the version of a tuple visible to a transaction. */
+  enum class Visibility { IN_PAGE, OLDER, NONE };
+
+  /** @return true if a version stamped with ts is visible to the transaction */
+  static auto IsVisible(timestamp_t ts, const Transaction *txn) -> bool;
+
+  /**
+   * A transaction may not overwrite a version another transaction has not committed, and a snapshot transaction may
+   * not overwrite a version committed after its snapshot was taken.
+   * @return true if the transaction may update or delete the tuple
+   */
+  auto CanWrite(const RID &rid, const Transaction *txn) -> bool;
+
+  /** Record a tuple inserted by a transaction. */
+  void AddInsert(const RID &rid, const Transaction *txn);
+
+  /**
+   * Record an update or a delete of a tuple by a transaction.
+   * @param rid the rid of the tuple
+   * @param old_tuple the version replaced, as stored
+   * @param is_delete true if the tuple was marked as deleted
+   * @param txn the writing transaction
+   */
+  void AddVersion(const RID &rid, const Tuple &old_tuple, bool is_delete, const Transaction *txn);
+
+  /** Undo the last AddVersion of a tuple, when its update or delete is rolled back. */
+  void Undo(const RID &rid);
+
+  /** Forget a tuple removed from its page. */
+  void Remove(const RID &rid);
+
+  /** Stamp the versions of a tuple written by a transaction with its commit timestamp. */
+  void Commit(const RID &rid, txn_id_t txn_id, timestamp_t commit_ts);
+
+  /**
+   * Drop the versions of a tuple that no snapshot can see any more.
+   * @param rid the rid of the tuple
+   * @param watermark the read timestamp of the oldest snapshot in use
+   * @return true if the tuple is deleted and no snapshot sees it, in which case it must be removed from its page
+   */
+  auto Collect(const RID &rid, timestamp_t watermark) -> bool;
+
+  /**
+   * Find the version of a tuple visible to a transaction.
+   * @param rid the rid of the tuple
+   * @param txn the reading transaction
+   * @param[out] tuple a copy of the visible version, if it is an older one
+   * @return IN_PAGE if the version in the page is visible, OLDER if tuple holds it, NONE if no version is visible
+   */
+  auto GetVisibleVersion(const RID &rid, const Transaction *txn, Tuple *tuple) -> Visibility;
+
+  /** @return true if any tuple of the page has an entry */
+  auto HasVersions(page_id_t page_id) -> bool;
+
+  /** @return the first slot from slot_num on holding a tuple marked as deleted with an entry, if any */
+  auto NextDeletedSlot(page_id_t page_id, uint32_t slot_num) -> std::optional<uint32_t>;
+
+  /** @return true if the tuple has an entry */
+  auto Contains(const RID &rid) -> bool;
+
+  /** @return the number of tuples with an entry */
+  auto Size() -> size_t;
+
+ private:
+  /** A version of a tuple replaced by a newer one. */
+  struct OlderVersion {
+    timestamp_t ts_;
+    Tuple tuple_;
+  };
+
+  /** The versions of a tuple. */
+  struct TupleVersions {
+    /** The timestamp of the version in the page. */
+    timestamp_t ts_{0};
+    /** Whether the version in the page is a deleted tuple. */
+    bool is_deleted_{false};
+    /** The older versions, oldest first. */
+    std::vector<OlderVersion> older_;
+  };
+
+  /** @return the timestamp of the versions a transaction writes until it commits */
+  static auto UncommittedTs(txn_id_t txn_id) -> timestamp_t { return UNCOMMITTED_FLAG | txn_id; }
+
+  /** @return true if the version stamped with ts is committed and no snapshot in use predates it */
+  static auto IsSettled(timestamp_t ts, timestamp_t watermark) -> bool {
+    return (ts & UNCOMMITTED_FLAG) == 0 && ts <= watermark;
+  }
+
+  /** @return the entry of a tuple, nullptr if there is none; the latch must be held */
+  auto Find(const RID &rid) -> TupleVersions *;
+
+  /** Erase the entry of a tuple; the latch must be held exclusively. */
+  void Erase(const RID &rid);
+
+  std::shared_mutex latch_;
+  /** The entries of the tuples, by page and slot. */
+  std::unordered_map<page_id_t, std::map<uint32_t, TupleVersions>> pages_;
+  size_t size_{0};
+};
+
+}  // namespace bustub
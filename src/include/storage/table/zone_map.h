@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.h
+//
+// Identification: src/include/storage/table/zone_map.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** The summary of the values of a column in a page. */
+struct ColumnZone {
+  /** The smallest non-NULL value, NULL if there is none. */
+  Value min_;
+  /** The largest non-NULL value, NULL if there is none. */
+  Value max_;
+  /** The number of NULL values. */
+  uint32_t null_count_{0};
+};
+
+/**
+ * ZoneMap keeps, for every page of a table heap, the minimum, maximum and number of NULLs of each fixed-width numeric
+ * or timestamp column, so that a scan can skip the pages which cannot hold a tuple satisfying its predicate.
+ *
+ * The zones are widened as tuples are inserted and updated, and are not narrowed when tuples are deleted, so they
+ * always cover the tuples of the page, including the ones marked as deleted which may be rolled back. Only the pages
+ * created through this map are summarized; the pages of a table opened from disk are not, and are never skipped.
+ */
+class ZoneMap {
+ public:
+  /** @param schema the schema of the tuples of the table */
+  explicit ZoneMap(const Schema &schema);
+
+  /** @return true if the values of the column are summarized */
+  auto IsTracked(uint32_t column_idx) const -> bool { return tracked_[column_idx]; }
+
+  /** Start summarizing a new, empty page. */
+  void AddPage(page_id_t page_id);
+
+  /** Widen the zones of a page with the values of a tuple stored in it; nothing is done for an untracked page. */
+  void Update(page_id_t page_id, const Tuple &tuple);
+
+  /** Reset the zones of a page which holds no tuple any more. */
+  void Clear(page_id_t page_id);
+
+  /** Stop summarizing a page, e.g. because it was freed. */
+  void Remove(page_id_t page_id);
+
+  /**
+   * @return the zones of every column of a page, the zones of untracked columns are meaningless; std::nullopt if the
+   * page is not summarized
+   */
+  auto GetZones(page_id_t page_id) -> std::optional<std::vector<ColumnZone>>;
+
+ private:
+  /** @return the zones of an empty page */
+  auto EmptyZones() const -> std::vector<ColumnZone>;
+
+  Schema schema_;
+  std::vector<bool> tracked_;
+  std::mutex latch_;
+  std::unordered_map<page_id_t, std::vector<ColumnZone>> zones_;
+};
+
+}  // namespace bustub
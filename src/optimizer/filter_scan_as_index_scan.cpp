@@ -0,0 +1,235 @@
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** A conjunct of a filter which compares a column with a constant, as `column comp_type value`. */
+struct ColumnBound {
+  uint32_t col_idx_;
+  ComparisonType comp_type_;
+  Value value_;
+};
+
+/** The comparison which holds with its sides swapped, `a < b` being `b > a`. */
+auto SwapComparison(ComparisonType comp_type) -> ComparisonType {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+/** Collect the comparisons of a column with a constant which are conjuncts of expr. */
+void CollectColumnBounds(const AbstractExpression &expr, std::vector<ColumnBound> *bounds) {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(&expr); logic_expr != nullptr) {
+    if (logic_expr->logic_type_ == LogicType::And) {
+      CollectColumnBounds(*logic_expr->GetChildAt(0), bounds);
+      CollectColumnBounds(*logic_expr->GetChildAt(1), bounds);
+    }
+    return;
+  }
+  const auto *comparison_expr = dynamic_cast<const ComparisonExpression *>(&expr);
+  if (comparison_expr == nullptr || comparison_expr->comp_type_ == ComparisonType::NotEqual) {
+    return;
+  }
+  auto comp_type = comparison_expr->comp_type_;
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(comparison_expr->GetChildAt(0).get());
+  const auto *constant_expr = dynamic_cast<const ConstantValueExpression *>(comparison_expr->GetChildAt(1).get());
+  if (column_expr == nullptr && constant_expr == nullptr) {
+    column_expr = dynamic_cast<const ColumnValueExpression *>(comparison_expr->GetChildAt(1).get());
+    constant_expr = dynamic_cast<const ConstantValueExpression *>(comparison_expr->GetChildAt(0).get());
+    comp_type = SwapComparison(comp_type);
+  }
+  if (column_expr == nullptr || constant_expr == nullptr || column_expr->GetTupleIdx() != 0 ||
+      constant_expr->val_.IsNull()) {
+    return;
+  }
+  bounds->push_back({column_expr->GetColIdx(), comp_type, constant_expr->val_});
+}
+
+auto IsIntegerType(TypeId type) -> bool {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+}
+
+/**
+ * The value of a bound as a value of the type of a key column, which compares to the keys as it compares to the
+ * column; std::nullopt if there is none, as for a string too long to fit in the key or a number out of range.
+ */
+auto KeyValue(const Value &value, const Column &column) -> std::optional<Value> {
+  if (value.GetTypeId() == column.GetType()) {
+    if (!column.IsInlined() && value.GetLength() > column.GetLength() + 1) {
+      return std::nullopt;
+    }
+    return value;
+  }
+  if (!IsIntegerType(value.GetTypeId()) || !IsIntegerType(column.GetType())) {
+    return std::nullopt;
+  }
+  try {
+    return value.CastAs(column.GetType());
+  } catch (const Exception &) {
+    return std::nullopt;
+  }
+}
+
+/** The range of keys of an index a scan reads: keys equal to a prefix, and in a range on the next key column. */
+struct KeyRange {
+  std::vector<Value> prefix_;
+  std::optional<Value> lower_;
+  bool lower_inclusive_{true};
+  std::optional<Value> upper_;
+  bool upper_inclusive_{true};
+
+  /** How selective the range likely is: each column compared for equality more than a range on the next one. */
+  auto Score() const -> size_t { return 2 * prefix_.size() + (lower_.has_value() || upper_.has_value() ? 1 : 0); }
+
+  void NarrowLower(const Value &value, bool inclusive) {
+    if (!lower_.has_value() || value.CompareGreaterThan(*lower_) == CmpBool::CmpTrue ||
+        (value.CompareEquals(*lower_) == CmpBool::CmpTrue && !inclusive)) {
+      lower_ = value;
+      lower_inclusive_ = inclusive;
+    }
+  }
+
+  void NarrowUpper(const Value &value, bool inclusive) {
+    if (!upper_.has_value() || value.CompareLessThan(*upper_) == CmpBool::CmpTrue ||
+        (value.CompareEquals(*upper_) == CmpBool::CmpTrue && !inclusive)) {
+      upper_ = value;
+      upper_inclusive_ = inclusive;
+    }
+  }
+};
+
+/**
+ * The keys of an index the bounds restrict a scan to: the leading key columns compared for equality, and the bounds
+ * on the column after them, narrowed down to the tightest ones.
+ */
+auto MatchKeyRange(const Index &index, const std::vector<ColumnBound> &bounds) -> KeyRange {
+  KeyRange range;
+  const auto &key_attrs = index.GetKeyAttrs();
+  const auto *key_schema = index.GetKeySchema();
+  for (uint32_t i = 0; i < key_attrs.size(); i++) {
+    const auto &column = key_schema->GetColumn(i);
+    std::optional<Value> equal;
+    KeyRange column_range;
+    for (const auto &bound : bounds) {
+      if (bound.col_idx_ != key_attrs[i]) {
+        continue;
+      }
+      auto value = KeyValue(bound.value_, column);
+      if (!value.has_value()) {
+        continue;
+      }
+      switch (bound.comp_type_) {
+        case ComparisonType::Equal:
+          equal = std::move(value);
+          break;
+        case ComparisonType::GreaterThan:
+        case ComparisonType::GreaterThanOrEqual:
+          column_range.NarrowLower(*value, bound.comp_type_ == ComparisonType::GreaterThanOrEqual);
+          break;
+        case ComparisonType::LessThan:
+        case ComparisonType::LessThanOrEqual:
+          column_range.NarrowUpper(*value, bound.comp_type_ == ComparisonType::LessThanOrEqual);
+          break;
+        default:
+          break;
+      }
+    }
+    if (equal.has_value()) {
+      range.prefix_.push_back(std::move(*equal));
+      continue;
+    }
+    range.lower_ = std::move(column_range.lower_);
+    range.lower_inclusive_ = column_range.lower_inclusive_;
+    range.upper_ = std::move(column_range.upper_);
+    range.upper_inclusive_ = column_range.upper_inclusive_;
+    break;
+  }
+  return range;
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeFilterScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeFilterScanAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::Filter) {
+    return optimized_plan;
+  }
+  const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+  BUSTUB_ASSERT(optimized_plan->children_.size() == 1, "must have exactly one children");
+  const auto &child_plan = *optimized_plan->children_[0];
+  if (child_plan.GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+  const auto &seq_scan_plan = dynamic_cast<const SeqScanPlanNode &>(child_plan);
+  if (seq_scan_plan.filter_predicate_ != nullptr || seq_scan_plan.sample_.has_value()) {
+    return optimized_plan;
+  }
+
+  // Scan the index whose leading key columns the bounds restrict the most. A hash index only finds the keys equal to
+  // a whole key, in fewer page reads than a B+ tree; it is preferred to a B+ tree restricted as much.
+  std::vector<ColumnBound> bounds;
+  CollectColumnBounds(*filter_plan.GetPredicate(), &bounds);
+  std::optional<KeyRange> chosen_range;
+  std::optional<index_oid_t> index_oid;
+  for (const auto *index_info : catalog_.GetTableIndexes(seq_scan_plan.table_name_)) {
+    auto range = MatchKeyRange(*index_info->index_, bounds);
+    const bool is_hash = index_info->index_type_ == IndexType::HASH;
+    if (is_hash && range.prefix_.size() < index_info->index_->GetKeyAttrs().size()) {
+      continue;
+    }
+    if (range.Score() > 0 && (!chosen_range.has_value() || range.Score() > chosen_range->Score() ||
+                              (range.Score() == chosen_range->Score() && is_hash))) {
+      chosen_range = std::move(range);
+      index_oid = index_info->index_oid_;
+    }
+  }
+  if (!index_oid.has_value()) {
+    return optimized_plan;
+  }
+
+  // The bounds are the equal prefix, followed by the bounds of the range on the next column if it has them.
+  auto index_scan = std::make_shared<IndexScanPlanNode>(filter_plan.output_schema_, *index_oid);
+  index_scan->lower_bound_ = chosen_range->prefix_;
+  index_scan->upper_bound_ = chosen_range->prefix_;
+  if (chosen_range->lower_.has_value()) {
+    index_scan->lower_bound_.push_back(*chosen_range->lower_);
+    index_scan->lower_inclusive_ = chosen_range->lower_inclusive_;
+  }
+  if (chosen_range->upper_.has_value()) {
+    index_scan->upper_bound_.push_back(*chosen_range->upper_);
+    index_scan->upper_inclusive_ = chosen_range->upper_inclusive_;
+  }
+  // The bounds only restrict which keys are read, the whole predicate is checked on the tuples.
+  index_scan->filter_predicate_ = filter_plan.GetPredicate();
+  return index_scan;
+}
+
+}  // namespace bustub
@@ -11,8 +11,10 @@ auto Optimizer::Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef
     auto p = plan;
     p = OptimizeMergeProjection(p);
     p = OptimizeMergeFilterNLJ(p);
-    p = OptimizeNLJAsIndexJoin(p);
-    p = OptimizeOrderByAsIndexScan(p);
+    if (!reads_snapshot_) {
+      p = OptimizeNLJAsIndexJoin(p);
+      p = OptimizeOrderByAsIndexScan(p);
+    }
     p = OptimizeSortLimitAsTopN(p);
     return p;
   }
@@ -21,6 +23,12 @@ auto Optimizer::Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef
 }
 
 auto Optimizer::EstimatedCardinality(const std::string &table_name) -> std::optional<size_t> {
+  // A table which exists is estimated from a sample of its pages.
+  const auto *table_info = catalog_.GetTable(table_name);
+  if (table_info != Catalog::NULL_TABLE_INFO && table_info->table_ != nullptr &&
+      !StringUtil::StartsWith(table_name, "__")) {
+    return std::make_optional(table_info->table_->EstimateTupleCount());
+  }
   if (StringUtil::EndsWith(table_name, "_1m")) {
     return std::make_optional(1000000);
   }
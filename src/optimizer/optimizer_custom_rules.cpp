@@ -11,10 +11,16 @@ auto Optimizer::OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanN
   auto p = plan;
   p = OptimizeMergeProjection(p);
   p = OptimizeMergeFilterNLJ(p);
-  p = OptimizeNLJAsIndexJoin(p);
   // p = OptimizeNLJAsHashJoin(p);  // Enable this rule after you have implemented hash join.
-  p = OptimizeOrderByAsIndexScan(p);
+  // A snapshot reads the tables only, the indexes do not keep the entries of the tuples it may still see.
+  if (!reads_snapshot_) {
+    p = OptimizeNLJAsIndexJoin(p);
+    p = OptimizeFilterScanAsIndexScan(p);
+    p = OptimizeOrderByAsIndexScan(p);
+  }
   p = OptimizeSortLimitAsTopN(p);
+  p = OptimizeMergeFilterScan(p);
+  p = OptimizeScanColumnPruning(p);
   return p;
 }
 
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** Collect the indexes of the columns referenced by an expression. */
+void CollectColumns(const AbstractExpressionRef &expr, std::vector<uint32_t> *column_ids) {
+  if (const auto *column_value = dynamic_cast<const ColumnValueExpression *>(expr.get()); column_value != nullptr) {
+    column_ids->push_back(column_value->GetColIdx());
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, column_ids);
+  }
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeScanColumnPruning(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeScanColumnPruning(child));
+  }
+
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // Only a projection or an aggregation knows which columns its input needs; other plans, e.g. delete and update, need
+  // whole tuples.
+  std::vector<uint32_t> column_ids;
+  if (optimized_plan->GetType() == PlanType::Projection) {
+    const auto &projection_plan = dynamic_cast<const ProjectionPlanNode &>(*optimized_plan);
+    for (const auto &expr : projection_plan.GetExpressions()) {
+      CollectColumns(expr, &column_ids);
+    }
+  } else if (optimized_plan->GetType() == PlanType::Aggregation) {
+    const auto &aggregation_plan = dynamic_cast<const AggregationPlanNode &>(*optimized_plan);
+    for (const auto &expr : aggregation_plan.GetGroupBys()) {
+      CollectColumns(expr, &column_ids);
+    }
+    for (const auto &expr : aggregation_plan.GetAggregates()) {
+      CollectColumns(expr, &column_ids);
+    }
+  } else {
+    return optimized_plan;
+  }
+
+  BUSTUB_ASSERT(optimized_plan->children_.size() == 1, "must have exactly one children");
+  auto child_plan = optimized_plan->children_[0];
+  const FilterPlanNode *filter_plan = nullptr;
+  if (child_plan->GetType() == PlanType::Filter) {
+    filter_plan = dynamic_cast<const FilterPlanNode *>(child_plan.get());
+    CollectColumns(filter_plan->GetPredicate(), &column_ids);
+    child_plan = filter_plan->GetChildPlan();
+  }
+  if (child_plan->GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+
+  // Only a PAX table, or a row table which may store values out of line, saves work by skipping columns.
+  const auto &seq_scan_plan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
+  const auto *table_info = catalog_.GetTable(seq_scan_plan.GetTableOid());
+  if (table_info == Catalog::NULL_TABLE_INFO || table_info->table_ == nullptr ||
+      !table_info->table_->SupportsColumnPruning() || seq_scan_plan.column_ids_.has_value()) {
+    return optimized_plan;
+  }
+  if (seq_scan_plan.filter_predicate_ != nullptr) {
+    CollectColumns(seq_scan_plan.filter_predicate_, &column_ids);
+  }
+  std::sort(column_ids.begin(), column_ids.end());
+  column_ids.erase(std::unique(column_ids.begin(), column_ids.end()), column_ids.end());
+
+  auto pruned_scan = std::make_shared<SeqScanPlanNode>(seq_scan_plan);
+  pruned_scan->column_ids_ = std::move(column_ids);
+  AbstractPlanNodeRef new_child = pruned_scan;
+  if (filter_plan != nullptr) {
+    new_child = filter_plan->CloneWithChildren({new_child});
+  }
+  return optimized_plan->CloneWithChildren({new_child});
+}
+
+}  // namespace bustub
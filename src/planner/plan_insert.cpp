@@ -3,6 +3,7 @@
 #include <unordered_map>
 
 #include "binder/bound_expression.h"
+#include "binder/statement/copy_statement.h"
 #include "binder/statement/delete_statement.h"
 #include "binder/statement/insert_statement.h"
 #include "binder/statement/select_statement.h"
@@ -14,6 +15,7 @@
 #include "execution/expressions/abstract_expression.h"
 #include "execution/expressions/column_value_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/plans/copy_plan.h"
 #include "execution/plans/delete_plan.h"
 #include "execution/plans/filter_plan.h"
 #include "execution/plans/insert_plan.h"
@@ -78,4 +80,11 @@ auto Planner::PlanUpdate(const UpdateStatement &statement) -> AbstractPlanNodeRe
                                           std::move(target_exprs));
 }
 
+auto Planner::PlanCopy(const CopyStatement &statement) -> AbstractPlanNodeRef {
+  auto copy_schema = std::make_shared<Schema>(std::vector{Column("__bustub_internal.copy_rows", TypeId::INTEGER)});
+
+  return std::make_shared<CopyPlanNode>(std::move(copy_schema), statement.table_->oid_, statement.file_name_,
+                                        statement.delimiter_, statement.header_);
+}
+
 }  // namespace bustub
@@ -100,14 +100,19 @@ auto Planner::PlanBaseTableRef(const BoundBaseTableRef &table_ref) -> AbstractPl
   if (StringUtil::StartsWith(table->name_, "__")) {
     // Plan as MockScanExecutor if it is a mock table.
     if (StringUtil::StartsWith(table->name_, "__mock")) {
+      if (table_ref.sample_.has_value()) {
+        throw NotImplementedException("TABLESAMPLE is not supported on mock tables");
+      }
       return std::make_shared<MockScanPlanNode>(std::make_shared<Schema>(SeqScanPlanNode::InferScanSchema(table_ref)),
                                                 table->name_);
     }
     throw bustub::Exception(fmt::format("unsupported internal table: {}", table->name_));
   }
   // Otherwise, plan as normal SeqScan.
-  return std::make_shared<SeqScanPlanNode>(std::make_shared<Schema>(SeqScanPlanNode::InferScanSchema(table_ref)),
-                                           table->oid_, table->name_);
+  auto scan = std::make_shared<SeqScanPlanNode>(std::make_shared<Schema>(SeqScanPlanNode::InferScanSchema(table_ref)),
+                                                table->oid_, table->name_);
+  scan->sample_ = table_ref.sample_;
+  return scan;
 }
 
 auto Planner::PlanCrossProductRef(const BoundCrossProductRef &table_ref) -> AbstractPlanNodeRef {
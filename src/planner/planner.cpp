@@ -4,6 +4,7 @@
 #include "binder/bound_expression.h"
 #include "binder/bound_statement.h"
 #include "binder/bound_table_ref.h"
+#include "binder/statement/copy_statement.h"
 #include "binder/statement/delete_statement.h"
 #include "binder/statement/insert_statement.h"
 #include "binder/statement/select_statement.h"
@@ -41,6 +42,10 @@ void Planner::PlanQuery(const BoundStatement &statement) {
       plan_ = PlanUpdate(dynamic_cast<const UpdateStatement &>(statement));
       return;
     }
+    case StatementType::COPY_STATEMENT: {
+      plan_ = PlanCopy(dynamic_cast<const CopyStatement &>(statement));
+      return;
+    }
     default:
       throw Exception(fmt::format("the statement {} is not supported in planner yet", statement.type_));
   }
@@ -10,16 +10,25 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <climits>
 #include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <mutex>  // NOLINT
 #include <string>
 #include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "fmt/format.h"
 #include "storage/disk/disk_manager.h"
 
 namespace bustub {
@@ -27,27 +36,20 @@ namespace bustub {
 static char *buffer_used;
 
 /**
- * Constructor: open/create a single database file & log file
+ * Constructor: open/create a single database file, and find the log segments of the database
  * @input db_file: database file name
+ * @input log_segment_size: size of a log segment file
  */
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, int log_segment_size)
+    : log_segment_size_(log_segment_size), file_name_(db_file) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
     return;
   }
   log_name_ = file_name_.substr(0, n) + ".log";
-
-  log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
-  // directory or file does not exist
-  if (!log_io_.is_open()) {
-    log_io_.clear();
-    // create a new file
-    log_io_.open(log_name_, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!log_io_.is_open()) {
-      throw Exception("can't open dblog file");
-    }
-  }
+  std::filesystem::path log_path(log_name_);
+  log_dir_ = log_path.has_parent_path() ? log_path.parent_path().string() : ".";
 
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
   db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
@@ -60,7 +62,11 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
       throw Exception("can't open db file");
     }
   }
+  db_fd_ = open(db_file.c_str(), O_RDWR);
   buffer_used = nullptr;
+
+  // segment files are created lazily, on the first log write
+  ScanLogSegments();
 }
 
 /**
@@ -70,8 +76,17 @@ void DiskManager::ShutDown() {
   {
     std::scoped_lock scoped_db_io_latch(db_io_latch_);
     db_io_.close();
+    if (db_fd_ != -1) {
+      close(db_fd_);
+      db_fd_ = -1;
+    }
+  }
+  std::scoped_lock scoped_log_io_latch(log_io_latch_);
+  if (log_fd_ != -1) {
+    close(log_fd_);
+    log_fd_ = -1;
+    log_segment_ = -1;
   }
-  log_io_.close();
 }
 
 /**
@@ -122,6 +137,72 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   }
 }
 
+/**
+ * Read a run of consecutive pages straight into their buffers with preadv
+ */
+void DiskManager::ReadPages(page_id_t first_page_id, int num_pages, char *page_data[]) {
+  if (db_fd_ == -1) {
+    for (int i = 0; i < num_pages; i++) {
+      ReadPage(first_page_id + i, page_data[i]);
+    }
+    return;
+  }
+
+  std::vector<struct iovec> iov(std::min(num_pages, IOV_MAX));
+  int done = 0;
+  while (done < num_pages) {
+    int count = std::min(num_pages - done, IOV_MAX);
+    for (int i = 0; i < count; i++) {
+      iov[i].iov_base = page_data[done + i];
+      iov[i].iov_len = BUSTUB_PAGE_SIZE;
+    }
+    off_t offset = static_cast<off_t>(first_page_id + done) * BUSTUB_PAGE_SIZE;
+    ssize_t rc = preadv(db_fd_, iov.data(), count, offset);
+    if (rc < 0) {
+      LOG_DEBUG("I/O error while reading");
+      rc = 0;
+    }
+    // if file ends before reading all the pages
+    if (rc < static_cast<ssize_t>(count) * BUSTUB_PAGE_SIZE) {
+      for (int i = rc / BUSTUB_PAGE_SIZE; i < count; i++) {
+        int read_count = i == rc / BUSTUB_PAGE_SIZE ? rc % BUSTUB_PAGE_SIZE : 0;
+        memset(page_data[done + i] + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+      }
+    }
+    done += count;
+  }
+}
+
+/**
+ * Write consecutive pages with a single vectored write per IOV_MAX pages
+ */
+void DiskManager::WritePages(page_id_t first_page_id, int num_pages, const char *const page_data[]) {
+  if (db_fd_ == -1) {
+    for (int i = 0; i < num_pages; i++) {
+      WritePage(first_page_id + i, page_data[i]);
+    }
+    return;
+  }
+
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  std::vector<struct iovec> iov(std::min(num_pages, IOV_MAX));
+  int done = 0;
+  while (done < num_pages) {
+    int count = std::min(num_pages - done, IOV_MAX);
+    for (int i = 0; i < count; i++) {
+      iov[i].iov_base = const_cast<char *>(page_data[done + i]);
+      iov[i].iov_len = BUSTUB_PAGE_SIZE;
+    }
+    off_t offset = static_cast<off_t>(first_page_id + done) * BUSTUB_PAGE_SIZE;
+    num_writes_ += count;
+    if (pwritev(db_fd_, iov.data(), count, offset) != static_cast<ssize_t>(count) * BUSTUB_PAGE_SIZE) {
+      LOG_DEBUG("I/O error while writing");
+      return;
+    }
+    done += count;
+  }
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
@@ -143,16 +224,34 @@ void DiskManager::WriteLog(char *log_data, int size) {
   }
 
   num_flushes_ += 1;
-  // sequence write
-  log_io_.write(log_data, size);
-
-  // check for I/O error
-  if (log_io_.bad()) {
-    LOG_DEBUG("I/O error while writing log");
+  if (log_name_.empty()) {
+    // no log file for an in-memory database
+    flush_log_ = false;
     return;
   }
-  // needs to flush to keep disk file in sync
-  log_io_.flush();
+
+  std::scoped_lock scoped_log_io_latch(log_io_latch_);
+  // sequence write, which may cross into the next segment
+  const int capacity = GetLogSegmentCapacity();
+  int written = 0;
+  while (written < size) {
+    int64_t segment = log_end_offset_ / capacity;
+    if (segment != log_segment_) {
+      OpenLogSegment(segment);
+    }
+    int segment_offset = static_cast<int>(log_end_offset_ % capacity);
+    int count = std::min(size - written, capacity - segment_offset);
+    ssize_t rc = pwrite(log_fd_, log_data + written, count, LOG_SEGMENT_HEADER_SIZE + segment_offset);
+    // check for I/O error
+    if (rc <= 0) {
+      LOG_DEBUG("I/O error while writing log");
+      return;
+    }
+    written += rc;
+    log_end_offset_ += rc;
+  }
+  // the segment is preallocated, so syncing the data does not need to sync any file metadata
+  fdatasync(log_fd_);
   flush_log_ = false;
 }
 
@@ -161,29 +260,175 @@ void DiskManager::WriteLog(char *log_data, int size) {
  * Always read from the beginning and perform sequence read
  * @return: false means already reach the end
  */
-auto DiskManager::ReadLog(char *log_data, int size, int offset) -> bool {
-  if (offset >= GetFileSize(log_name_)) {
+auto DiskManager::ReadLog(char *log_data, int size, int64_t offset) -> bool {
+  std::scoped_lock scoped_log_io_latch(log_io_latch_);
+  const int capacity = GetLogSegmentCapacity();
+  if (offset < log_first_segment_ * capacity || offset >= log_end_offset_) {
     // LOG_DEBUG("end of log file");
-    // LOG_DEBUG("file size is %d", GetFileSize(log_name_));
     return false;
   }
-  log_io_.seekp(offset);
-  log_io_.read(log_data, size);
 
-  if (log_io_.bad()) {
-    LOG_DEBUG("I/O error while reading log");
-    return false;
-  }
-  // if log file ends before reading "size"
-  int read_count = log_io_.gcount();
-  if (read_count < size) {
-    log_io_.clear();
-    memset(log_data + read_count, 0, size - read_count);
+  // if the log ends before reading "size", the rest reads as zeros
+  memset(log_data, 0, size);
+  int read_count = 0;
+  while (read_count < size && offset + read_count < log_end_offset_) {
+    int64_t segment = (offset + read_count) / capacity;
+    int segment_offset = static_cast<int>((offset + read_count) % capacity);
+    int count = std::min(size - read_count, capacity - segment_offset);
+    int fd = segment == log_segment_ ? log_fd_ : open(LogSegmentName(segment).c_str(), O_RDONLY);
+    if (fd == -1) {
+      LOG_DEBUG("I/O error while reading log");
+      return false;
+    }
+    ssize_t rc = pread(fd, log_data + read_count, count, LOG_SEGMENT_HEADER_SIZE + segment_offset);
+    if (fd != log_fd_) {
+      close(fd);
+    }
+    if (rc < 0) {
+      LOG_DEBUG("I/O error while reading log");
+      return false;
+    }
+    read_count += count;
   }
 
   return true;
 }
 
+/**
+ * Zero and rename every segment before the redo point, so that it becomes one of the next segments to be appended to.
+ * Segments keep their preallocated blocks, and the log never takes more space than the log written between two
+ * checkpoints.
+ */
+void DiskManager::RecycleLogSegments(int64_t redo_offset) {
+  std::scoped_lock scoped_log_io_latch(log_io_latch_);
+  int64_t redo_segment = std::min(redo_offset, log_end_offset_) / GetLogSegmentCapacity();
+  bool renamed = false;
+  static char zeros[BUSTUB_PAGE_SIZE] = {0};
+  for (; log_first_segment_ < redo_segment; log_first_segment_++) {
+    std::string segment_name = LogSegmentName(log_first_segment_);
+    int fd = open(segment_name.c_str(), O_WRONLY);
+    if (fd == -1) {
+      // the segment was never written
+      continue;
+    }
+    for (int offset = 0; offset < log_segment_size_; offset += BUSTUB_PAGE_SIZE) {
+      if (pwrite(fd, zeros, std::min(BUSTUB_PAGE_SIZE, log_segment_size_ - offset), offset) < 0) {
+        LOG_DEBUG("I/O error while recycling log segment");
+        break;
+      }
+    }
+    fdatasync(fd);
+    close(fd);
+    if (rename(segment_name.c_str(), LogSegmentName(log_last_segment_ + 1).c_str()) != 0) {
+      LOG_DEBUG("cannot rename recycled log segment");
+      continue;
+    }
+    log_last_segment_++;
+    renamed = true;
+  }
+  if (renamed) {
+    SyncLogDirectory();
+  }
+}
+
+/**
+ * Returns the log offset the next WriteLog call appends at
+ */
+auto DiskManager::GetLogEndOffset() -> int64_t {
+  std::scoped_lock scoped_log_io_latch(log_io_latch_);
+  return log_end_offset_;
+}
+
+auto DiskManager::LogSegmentName(int64_t segment) const -> std::string {
+  return fmt::format("{}.{:06}", log_name_, segment);
+}
+
+/**
+ * A segment is in use if its header is valid for its number, since recycled segments are zeroed and the header is
+ * durable before any log byte of the segment. Appending resumes at the start of the segment following the last one in
+ * use; the tail of that last segment is left as zeros.
+ */
+void DiskManager::ScanLogSegments() {
+  std::string prefix = std::filesystem::path(log_name_).filename().string() + ".";
+
+  int64_t first_segment = -1;
+  int64_t last_used_segment = -1;
+  std::error_code ec;
+  for (const auto &entry : std::filesystem::directory_iterator(log_dir_, ec)) {
+    std::string name = entry.path().filename().string();
+    if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+        !std::all_of(name.begin() + prefix.size(), name.end(), ::isdigit)) {
+      continue;
+    }
+    int64_t segment = std::stoll(name.substr(prefix.size()));
+    first_segment = first_segment == -1 ? segment : std::min(first_segment, segment);
+    log_last_segment_ = std::max(log_last_segment_, segment);
+
+    uint64_t header[2] = {0, 0};
+    int fd = open(entry.path().c_str(), O_RDONLY);
+    if (fd != -1) {
+      if (pread(fd, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+        header[0] = 0;
+      }
+      close(fd);
+    }
+    if (header[0] == LOG_SEGMENT_MAGIC && header[1] == static_cast<uint64_t>(segment * GetLogSegmentCapacity())) {
+      last_used_segment = std::max(last_used_segment, segment);
+    }
+  }
+
+  if (first_segment == -1) {
+    return;
+  }
+  log_first_segment_ = first_segment;
+  log_end_offset_ = std::max(first_segment, last_used_segment + 1) * GetLogSegmentCapacity();
+}
+
+void DiskManager::OpenLogSegment(int64_t segment) {
+  if (log_fd_ != -1) {
+    fdatasync(log_fd_);
+    close(log_fd_);
+  }
+  std::string segment_name = LogSegmentName(segment);
+  log_fd_ = open(segment_name.c_str(), O_RDWR | O_CREAT, 0644);
+  if (log_fd_ == -1) {
+    throw Exception("can't open log segment file");
+  }
+  log_segment_ = segment;
+
+  // a recycled segment is already allocated; a new one gets all its blocks up front, and its size and directory entry
+  // are made durable once
+  if (segment > log_last_segment_) {
+    int rc = -1;
+#ifdef __linux__
+    rc = fallocate(log_fd_, 0, 0, log_segment_size_);
+#endif
+    if (rc != 0 && ftruncate(log_fd_, log_segment_size_) != 0) {
+      LOG_DEBUG("I/O error while preallocating log segment");
+    }
+    fsync(log_fd_);
+    SyncLogDirectory();
+    log_last_segment_ = segment;
+  }
+
+  // the header must be durable before the log bytes after it, which are synced on their own
+  uint64_t header[2] = {LOG_SEGMENT_MAGIC, static_cast<uint64_t>(segment * GetLogSegmentCapacity())};
+  if (pwrite(log_fd_, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+    LOG_DEBUG("I/O error while writing log segment header");
+  }
+  fdatasync(log_fd_);
+}
+
+void DiskManager::SyncLogDirectory() {
+  int fd = open(log_dir_.c_str(), O_RDONLY | O_DIRECTORY);
+  if (fd == -1) {
+    LOG_DEBUG("cannot open log directory");
+    return;
+  }
+  fsync(fd);
+  close(fd);
+}
+
 /**
  * Returns number of flushes made so far
  */
@@ -199,6 +444,20 @@ auto DiskManager::GetNumWrites() const -> int { return num_writes_; }
  */
 auto DiskManager::GetFlushState() const -> bool { return flush_log_; }
 
+/**
+ * Returns the number of pages in the database file, so that page allocation can resume where the last run stopped
+ */
+auto DiskManager::GetNumPages() -> int {
+  if (file_name_.empty()) {
+    return 0;
+  }
+  int file_size = GetFileSize(file_name_);
+  if (file_size < 0) {
+    return 0;
+  }
+  return (file_size + BUSTUB_PAGE_SIZE - 1) / BUSTUB_PAGE_SIZE;
+}
+
 /**
  * Private helper function to get disk file size
  */
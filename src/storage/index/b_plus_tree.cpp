@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <cmath>
 #include <string>
+#include <thread>  // NOLINT
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -14,8 +17,8 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manag
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
-      leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      leaf_max_size_(std::min(leaf_max_size, LeafPage::DEFAULT_MAX_SIZE)),
+      internal_max_size_(std::min(internal_max_size, InternalPage::DEFAULT_MAX_SIZE)) {}
 
 /*
  * Helper function to decide whether current b+tree is empty
@@ -92,6 +95,50 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   return false;
 }
 
+/*
+ * Look up a batch of keys sorted in ascending order. The leaf of a key stays
+ * read latched for the next keys as long as they are not past its last key,
+ * so that keys close to each other share one descent.
+ * @return : the number of keys found
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results)
+    -> size_t {
+  results->assign(keys.size(), {});
+  size_t num_found = 0;
+  Page *leaf_original_page = nullptr;
+  LeafPage *cur_leaf_page = nullptr;
+  auto release_leaf = [&]() {
+    leaf_original_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf_original_page->GetPageId(), false);
+    leaf_original_page = nullptr;
+    cur_leaf_page = nullptr;
+  };
+  for (size_t i = 0; i < keys.size(); i++) {
+    // key比当前叶子的所有key都大时，它可能在右边的叶子里，从根结点重新下降
+    if (cur_leaf_page != nullptr && (cur_leaf_page->GetSize() == 0 ||
+                                     comparator_(keys[i], cur_leaf_page->KeyAt(cur_leaf_page->GetSize() - 1)) > 0)) {
+      release_leaf();
+    }
+    if (cur_leaf_page == nullptr) {
+      leaf_original_page = FindLeafForRead(&keys[i]);
+      if (leaf_original_page == nullptr) {
+        return 0;
+      }
+      cur_leaf_page = reinterpret_cast<LeafPage *>(leaf_original_page->GetData());
+    }
+    int index;
+    if (cur_leaf_page->FindKeyIndex(&index, keys[i], comparator_)) {
+      (*results)[i].emplace_back(cur_leaf_page->ValueAt(index));
+      num_found++;
+    }
+  }
+  if (cur_leaf_page != nullptr) {
+    release_leaf();
+  }
+  return num_found;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -104,6 +151,23 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
+  // Optimistic descent: most inserts do not split the leaf, and only need to write latch it.
+  if (auto leaf_original_page = FindLeafForWrite(key); leaf_original_page != nullptr) {
+    auto leaf_page = reinterpret_cast<LeafPage *>(leaf_original_page->GetData());
+    int index;
+    bool exists = leaf_page->FindKeyIndex(&index, key, comparator_);
+    bool is_safe = !exists && leaf_page->GetSize() + 1 < leaf_max_size_ &&
+                   leaf_page->HasRoomFor(leaf_page->GetSize() + 1, key);
+    if (is_safe) {
+      leaf_page->InsertKeyValueAt(index, key, value);
+    }
+    leaf_original_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), is_safe);
+    if (exists || is_safe) {
+      return is_safe;
+    }
+  }
+
   // 树空，新建结点
   latch_.WLock();
   bool get_root = true;
@@ -133,7 +197,7 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   while (!cur_page->IsLeafPage()) {
     auto cur_internal_page = reinterpret_cast<InternalPage *>(cur_page);
     // 如果当前结点发生插入键值对也不会导致分裂，说明当前结点是安全的，则可以将其所有祖先节点解W锁并UnpinPage
-    if (cur_internal_page->GetSize() < internal_max_size_) {
+    if (cur_internal_page->GetSize() < internal_max_size_ && cur_internal_page->HasRoomForAnyKey()) {
       while (transaction->GetPageSet()->size() > 1) {
         original_page = transaction->GetPageSet()->front();
         transaction->GetPageSet()->pop_front();
@@ -173,10 +237,10 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   // 找到叶子结点后，如果叶子节点不存在key，可以插入
   original_page = transaction->GetPageSet()->back();
   // LOG_INFO("$ %d $ %d $", cur_leaf_page->GetPageId(), index);
-  cur_leaf_page->InsertKeyValueAt(index, key, value);
 
-  // 如果插入键值对后叶子结点的键值对个数没到leaf_max_size_，可以结束了
-  if (cur_leaf_page->GetSize() < leaf_max_size_) {
+  // 如果插入键值对后叶子结点的键值对个数没到leaf_max_size_，且页里放得下，可以结束了
+  if (cur_leaf_page->GetSize() + 1 < leaf_max_size_ && cur_leaf_page->HasRoomFor(cur_leaf_page->GetSize() + 1, key)) {
+    cur_leaf_page->InsertKeyValueAt(index, key, value);
     while (transaction->GetPageSet()->size() > 1) {
       original_page = transaction->GetPageSet()->front();
       transaction->GetPageSet()->pop_front();
@@ -194,7 +258,16 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
     return true;
   }
 
-  // 如果插入键值对后叶子结点的键值对个数到leaf_max_size_，需要分裂，先处理叶结点的分裂
+  // 否则需要分裂，先处理叶结点的分裂：两半各自重新压缩，分隔键截短到能区分两半为止
+  std::vector<std::pair<KeyType, ValueType>> leaf_entries;
+  leaf_entries.reserve(cur_leaf_page->GetSize() + 1);
+  for (int i = 0; i < cur_leaf_page->GetSize(); i++) {
+    leaf_entries.emplace_back(cur_leaf_page->KeyAt(i), cur_leaf_page->ValueAt(i));
+  }
+  leaf_entries.emplace(leaf_entries.begin() + index, key, value);
+  int leaf_split = static_cast<int>(leaf_entries.size()) / 2;
+  KeyType insert_key = SeparatorKey(leaf_entries[leaf_split - 1].first, leaf_entries[leaf_split].first);
+
   auto cur_original_page = transaction->GetPageSet()->back();
   transaction->GetPageSet()->pop_back();
   page_id_t new_leaf_page_id;  // 新建结点，上W锁
@@ -207,8 +280,8 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
     parent_original_page->WLatch();
     parent_internal_page = reinterpret_cast<InternalPage *>(parent_original_page->GetData());
     parent_internal_page->Init(root_page_id_, INVALID_PAGE_ID, internal_max_size_);
-    parent_internal_page->SetValueAt(0, cur_leaf_page->GetPageId());
-    parent_internal_page->SetSize(1);
+    std::pair<KeyType, page_id_t> first_entry{insert_key, cur_leaf_page->GetPageId()};
+    parent_internal_page->SetEntries(&first_entry, 1);
     UpdateRootPageId(1);
   } else {
     parent_original_page = transaction->GetPageSet()->back();
@@ -226,13 +299,9 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   // LOG_INFO("@ %d @ %d @ %d @", cur_leaf_page->GetPageId(), new_leaf_page->GetPageId(),
   // parent_internal_page->GetPageId());
 
-  for (int i = leaf_max_size_ / 2; i < leaf_max_size_; i++) {
-    new_leaf_page->InsertKeyValueAt(i - leaf_max_size_ / 2, cur_leaf_page->KeyAt(i), cur_leaf_page->ValueAt(i));
-  }
-  cur_leaf_page->SetSize(leaf_max_size_ / 2);
-  new_leaf_page->SetSize(leaf_max_size_ - leaf_max_size_ / 2);
+  new_leaf_page->SetEntries(leaf_entries.data() + leaf_split, static_cast<int>(leaf_entries.size()) - leaf_split);
+  cur_leaf_page->SetEntries(leaf_entries.data(), leaf_split);
 
-  KeyType insert_key = new_leaf_page->KeyAt(0);
   page_id_t insert_value = new_leaf_page_id;
 
   cur_original_page->WUnlatch();
@@ -241,9 +310,22 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   buffer_pool_manager_->UnpinPage(new_leaf_page->GetPageId(), true);
 
   // 处理内部节点的（多重）分裂
-  while (parent_internal_page->GetSize() == internal_max_size_) {
+  while (parent_internal_page->GetSize() >= internal_max_size_ ||
+         !parent_internal_page->HasRoomFor(parent_internal_page->GetSize() + 1, insert_key)) {
     cur_original_page = parent_original_page;
     auto cur_internal_page = parent_internal_page;
+    std::vector<std::pair<KeyType, page_id_t>> internal_entries;
+    internal_entries.reserve(cur_internal_page->GetSize() + 1);
+    for (int i = 0; i < cur_internal_page->GetSize(); i++) {
+      internal_entries.emplace_back(cur_internal_page->KeyAt(i), cur_internal_page->ValueAt(i));
+    }
+    int insert_index;
+    cur_internal_page->FindKeyIndex(&insert_index, insert_key, comparator_);
+    internal_entries.emplace(internal_entries.begin() + insert_index + 1, insert_key, insert_value);
+    // 中间的键上移到父结点，同时作为新结点被忽略的第一个键
+    int internal_split = static_cast<int>(internal_entries.size()) / 2;
+    insert_key = internal_entries[internal_split].first;
+
     page_id_t new_internal_page_id;
     new_original_page = buffer_pool_manager_->NewPage(&new_internal_page_id);
     new_original_page->WLatch();
@@ -253,8 +335,8 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
       parent_internal_page = reinterpret_cast<InternalPage *>(parent_original_page->GetData());
       parent_internal_page->Init(root_page_id_, INVALID_PAGE_ID, internal_max_size_);
       // LOG_INFO("# %d %d", root_page_id_, cur_internal_page->GetPageId());
-      parent_internal_page->SetValueAt(0, cur_internal_page->GetPageId());
-      parent_internal_page->SetSize(1);
+      std::pair<KeyType, page_id_t> first_entry{insert_key, cur_internal_page->GetPageId()};
+      parent_internal_page->SetEntries(&first_entry, 1);
       UpdateRootPageId(1);
     } else {
       parent_original_page = transaction->GetPageSet()->back();
@@ -269,23 +351,9 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
     // LOG_INFO("@ %d @ %d @ %d @", cur_internal_page->GetPageId(), new_internal_page->GetPageId(),
     // parent_internal_page->GetPageId());
 
-    if (comparator_(cur_internal_page->KeyAt(internal_max_size_ - 1), insert_key) < 0) {
-      new_internal_page->InsertKeyValueAt(internal_max_size_ / 2, insert_key, insert_value);
-    } else {
-      new_internal_page->InsertKeyValueAt(internal_max_size_ / 2, cur_internal_page->KeyAt(internal_max_size_ - 1),
-                                          cur_internal_page->ValueAt(internal_max_size_ - 1));
-      int index;
-      cur_internal_page->FindKeyIndex(&index, insert_key, comparator_);
-      cur_internal_page->InsertKeyValueAt(index + 1, insert_key, insert_value);
-    }
-    new_internal_page->SetValueAt(0, cur_internal_page->ValueAt((internal_max_size_ + 1) / 2));
-    new_internal_page->SetSize(1);
-    for (int i = 1; i < internal_max_size_ / 2; i++) {
-      new_internal_page->InsertKeyValueAt(i, cur_internal_page->KeyAt((internal_max_size_ + 1) / 2 + i),
-                                          cur_internal_page->ValueAt((internal_max_size_ + 1) / 2 + i));
-    }
-    cur_internal_page->SetSize((internal_max_size_ + 1) / 2);
-    new_internal_page->SetSize(internal_max_size_ / 2 + 1);
+    new_internal_page->SetEntries(internal_entries.data() + internal_split,
+                                  static_cast<int>(internal_entries.size()) - internal_split);
+    cur_internal_page->SetEntries(internal_entries.data(), internal_split);
 
     for (int i = 0; i < new_internal_page->GetSize(); i++) {
       auto child_original_page = buffer_pool_manager_->FetchPage(new_internal_page->ValueAt(i));
@@ -296,7 +364,6 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
       buffer_pool_manager_->UnpinPage(child_page->GetPageId(), true);
     }
 
-    insert_key = cur_internal_page->KeyAt((internal_max_size_ + 1) / 2);
     insert_value = new_internal_page_id;
 
     cur_original_page->WUnlatch();
@@ -311,6 +378,13 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   // LOG_INFO("PageId: %d, Size: %d", parent_internal_page->GetPageId(), parent_internal_page->GetSize());
   parent_original_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(parent_internal_page->GetPageId(), true);
+  // 父结点可能因为键的长短未知而没有提前判为安全，其祖先结点仍上着锁
+  while (!transaction->GetPageSet()->empty()) {
+    original_page = transaction->GetPageSet()->front();
+    transaction->GetPageSet()->pop_front();
+    original_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(original_page->GetPageId(), false);
+  }
   if (get_root) {
     get_root = false;
     latch_.WUnlock();
@@ -318,6 +392,278 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   return true;
 }
 
+/*
+ * Insert a batch of key & value pairs. An empty tree is built bottom-up:
+ * the entries are sorted, packed into leaves from left to right, and each
+ * internal level is built from the first keys of the nodes of the level
+ * below, until a level fits in the root. The keys between leaves are
+ * truncated to separators. A node holds fill_factor of the entries it can
+ * hold without splitting, rounded up and no fewer than its minimum, but the
+ * last two nodes of a level, which share what is left, and the nodes which
+ * would not fit in a page otherwise. A tree which is not empty
+ * gets the entries inserted one by one, in key order.
+ * Of several entries with the same key, the first one is kept, as Insert does.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoad(std::vector<std::pair<KeyType, ValueType>> entries, double fill_factor,
+                              Transaction *transaction) {
+  SortEntries(&entries);
+  auto last = std::unique(entries.begin(), entries.end(),
+                          [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) == 0; });
+  entries.erase(last, entries.end());
+
+  latch_.WLock();
+  if (!IsEmpty() || entries.empty()) {
+    latch_.WUnlock();
+    for (const auto &[key, value] : entries) {
+      Insert(key, value, transaction);
+    }
+    return;
+  }
+
+  // The pages are not reachable until the root page id is set, so they need no latches.
+  // first key and page id of every node of the level built last, the keys between leaves truncated to separators
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  size_t next_entry = 0;
+  LeafPage *prev_leaf_page = nullptr;
+  for (int size : FittingNodeSizes<LeafPage>(entries, leaf_max_size_ - 1, leaf_max_size_ / 2, fill_factor)) {
+    page_id_t leaf_page_id;
+    auto leaf_page = reinterpret_cast<LeafPage *>(buffer_pool_manager_->NewPage(&leaf_page_id)->GetData());
+    leaf_page->Init(leaf_page_id, INVALID_PAGE_ID, leaf_max_size_);
+    leaf_page->SetEntries(entries.data() + next_entry, size);
+    level.emplace_back(next_entry == 0 ? entries[0].first
+                                       : SeparatorKey(entries[next_entry - 1].first, entries[next_entry].first),
+                       leaf_page_id);
+    next_entry += size;
+    if (prev_leaf_page != nullptr) {
+      prev_leaf_page->SetNextPageId(leaf_page_id);
+      buffer_pool_manager_->UnpinPage(prev_leaf_page->GetPageId(), true);
+    }
+    prev_leaf_page = leaf_page;
+  }
+  buffer_pool_manager_->UnpinPage(prev_leaf_page->GetPageId(), true);
+
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> parent_level;
+    size_t next_child = 0;
+    for (int size :
+         FittingNodeSizes<InternalPage>(level, internal_max_size_, (internal_max_size_ + 1) / 2, fill_factor)) {
+      page_id_t internal_page_id;
+      auto internal_page =
+          reinterpret_cast<InternalPage *>(buffer_pool_manager_->NewPage(&internal_page_id)->GetData());
+      internal_page->Init(internal_page_id, INVALID_PAGE_ID, internal_max_size_);
+      internal_page->SetEntries(level.data() + next_child, size);
+      for (int i = 0; i < size; i++, next_child++) {
+        auto child_page =
+            reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(level[next_child].second)->GetData());
+        child_page->SetParentPageId(internal_page_id);
+        buffer_pool_manager_->UnpinPage(child_page->GetPageId(), true);
+      }
+      parent_level.emplace_back(internal_page->KeyAt(0), internal_page_id);
+      buffer_pool_manager_->UnpinPage(internal_page_id, true);
+    }
+    level = std::move(parent_level);
+  }
+
+  root_page_id_ = level.front().second;
+  UpdateRootPageId(1);
+  latch_.WUnlock();
+}
+
+/*
+ * Stable sort the entries by key. Large batches are cut into runs sorted
+ * by threads of their own, and neighbouring runs are merged in rounds,
+ * the merges of a round running in parallel too.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SortEntries(std::vector<std::pair<KeyType, ValueType>> *entries) {
+  auto less = [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) < 0; };
+  auto at = [entries](size_t i) { return entries->begin() + static_cast<std::ptrdiff_t>(i); };
+  size_t num_runs = std::max<size_t>(1, std::min(index_sort_threads, entries->size() / INDEX_SORT_MIN_RUN));
+  std::vector<size_t> bounds(num_runs + 1);
+  for (size_t i = 0; i <= num_runs; i++) {
+    bounds[i] = entries->size() * i / num_runs;
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_runs; i++) {
+    threads.emplace_back([&, i] { std::stable_sort(at(bounds[i]), at(bounds[i + 1]), less); });
+  }
+  std::stable_sort(at(bounds[0]), at(bounds[1]), less);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (size_t width = 1; width < num_runs; width *= 2) {
+    threads.clear();
+    for (size_t i = 0; i + width < num_runs; i += 2 * width) {
+      size_t first = bounds[i];
+      size_t middle = bounds[i + width];
+      size_t end = bounds[std::min(i + 2 * width, num_runs)];
+      threads.emplace_back([&, first, middle, end] { std::inplace_merge(at(first), at(middle), at(end), less); });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+}
+
+/*
+ * Cut num_entries entries into nodes of ceil(fill_factor * max_size)
+ * entries, but no fewer than min_size. What is left for the last node may
+ * be fewer than min_size: the last two nodes then share it evenly if that
+ * leaves both at min_size or more, and are merged into one otherwise, which
+ * fits as min_size is at most half of max_size + 1.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::PackedNodeSizes(size_t num_entries, int max_size, int min_size, double fill_factor)
+    -> std::vector<int> {
+  int target = static_cast<int>(std::ceil(fill_factor * max_size));
+  target = std::clamp(target, std::min(std::max(min_size, 1), max_size), max_size);
+  size_t num_nodes = (num_entries + target - 1) / target;
+  std::vector<int> sizes(num_nodes, target);
+  sizes.back() = static_cast<int>(num_entries - (num_nodes - 1) * target);
+  if (num_nodes > 1 && sizes.back() < min_size) {
+    int tail = sizes[num_nodes - 2] + sizes.back();
+    if (tail >= 2 * min_size) {
+      sizes[num_nodes - 2] = tail - tail / 2;
+      sizes.back() = tail / 2;
+    } else {
+      sizes[num_nodes - 2] = tail;
+      sizes.pop_back();
+    }
+  }
+  return sizes;
+}
+
+/*
+ * Cut the sorted entries into nodes as PackedNodeSizes does, as long as
+ * every node fits in a page. Prefix compressed keys which share fewer bytes
+ * than expected may not: the nodes are then filled from left to right with
+ * as many entries as fit, up to the packed size, and the last two nodes
+ * share what is left if the last one would underflow.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+template <typename NodePage, typename Entry>
+auto BPLUSTREE_TYPE::FittingNodeSizes(const std::vector<Entry> &entries, int max_size, int min_size,
+                                      double fill_factor) -> std::vector<int> {
+  auto sizes = PackedNodeSizes(entries.size(), max_size, min_size, fill_factor);
+  auto fits = [&entries](size_t first, int size) { return NodePage::HasRoomFor(entries.data() + first, size); };
+  size_t first = 0;
+  bool all_fit = true;
+  for (int size : sizes) {
+    all_fit = all_fit && fits(first, size);
+    first += size;
+  }
+  if (all_fit) {
+    return sizes;
+  }
+
+  // the more entries, the fewer key bytes they share, so the entries which fit are found by binary search
+  int target = *std::max_element(sizes.begin(), sizes.end());
+  sizes.clear();
+  for (first = 0; first < entries.size();) {
+    int left_size = 1;
+    int right_size = static_cast<int>(std::min<size_t>(target, entries.size() - first));
+    while (left_size < right_size) {
+      int middle_size = (left_size + right_size + 1) >> 1;
+      if (fits(first, middle_size)) {
+        left_size = middle_size;
+      } else {
+        right_size = middle_size - 1;
+      }
+    }
+    sizes.push_back(left_size);
+    first += left_size;
+  }
+  if (sizes.size() > 1 && sizes.back() < min_size) {
+    int shared = sizes[sizes.size() - 2] + sizes.back();
+    size_t shared_first = entries.size() - shared;
+    if (fits(shared_first, shared / 2) && fits(shared_first + shared / 2, shared - shared / 2)) {
+      sizes[sizes.size() - 2] = shared / 2;
+      sizes.back() = shared - shared / 2;
+    }
+  }
+  return sizes;
+}
+
+/*
+ * The key separating two neighbouring nodes, whose keys are up to left and
+ * from right on: right with as many of its trailing bytes zeroed as still
+ * compare greater than left. The zeroed bytes are elided from the internal
+ * pages along with the trailing bytes the other keys share. Keys are not
+ * truncated when they are not prefix compressed, or when they hold
+ * variable length columns, whose bytes point into the key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::SeparatorKey(const KeyType &left, const KeyType &right) const -> KeyType {
+  if constexpr (!InternalPage::ELIDES_KEY_BYTES) {
+    return right;
+  } else {
+    if (!comparator_.IsInlined()) {
+      return right;
+    }
+    KeyType separator = right;
+    auto *bytes = reinterpret_cast<char *>(&separator);
+    for (int i = static_cast<int>(sizeof(KeyType)) - 1; i >= 0; i--) {
+      if (bytes[i] == 0) {
+        continue;
+      }
+      char byte = bytes[i];
+      bytes[i] = 0;
+      if (comparator_(left, separator) >= 0 || comparator_(separator, right) > 0) {
+        bytes[i] = byte;
+        break;
+      }
+    }
+    return separator;
+  }
+}
+
+/*
+ * Descend to the leaf which holds or would hold a key, read latching one page at a time, and write latch the leaf.
+ * The leaf is found read latched first, and latched again for writing while its parent is still read latched: it
+ * cannot be split or merged meanwhile, as a writer changing its structure write latches the parent.
+ * @return : the write latched and pinned leaf, nullptr if the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafForWrite(const KeyType &key) -> Page * {
+  latch_.RLock();
+  if (IsEmpty()) {
+    latch_.RUnlock();
+    return nullptr;
+  }
+  // The parent of the current page is the tree latch until the root page is left.
+  Page *parent_original_page = nullptr;
+  auto release_parent = [&]() {
+    if (parent_original_page == nullptr) {
+      latch_.RUnlock();
+      return;
+    }
+    parent_original_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(parent_original_page->GetPageId(), false);
+  };
+
+  auto original_page = buffer_pool_manager_->FetchPage(root_page_id_);
+  original_page->RLatch();
+  while (true) {
+    auto cur_page = reinterpret_cast<BPlusTreePage *>(original_page->GetData());
+    if (cur_page->IsLeafPage()) {
+      original_page->RUnlatch();
+      original_page->WLatch();
+      release_parent();
+      return original_page;
+    }
+    release_parent();
+    int index;
+    auto cur_internal_page = reinterpret_cast<InternalPage *>(cur_page);
+    cur_internal_page->FindKeyIndex(&index, key, comparator_);
+    parent_original_page = original_page;
+    original_page = buffer_pool_manager_->FetchPage(cur_internal_page->ValueAt(index));
+    original_page->RLatch();
+  }
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -330,6 +676,26 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  // Optimistic descent: most removes leave the leaf at least half full, and only need to write latch it.
+  auto leaf_original_page = FindLeafForWrite(key);
+  if (leaf_original_page == nullptr) {
+    return;
+  }
+  auto leaf_page = reinterpret_cast<LeafPage *>(leaf_original_page->GetData());
+  int leaf_index;
+  bool exists = leaf_page->FindKeyIndex(&leaf_index, key, comparator_);
+  bool is_safe = exists && (leaf_page->IsRootPage() ? leaf_page->GetSize() > 1
+                                                    : leaf_page->GetSize() - 1 >= leaf_max_size_ / 2 ||
+                                                          leaf_page->IsHalfFull(leaf_page->GetSize() - 1));
+  if (is_safe) {
+    leaf_page->RemoveKeyValueAt(leaf_index);
+  }
+  leaf_original_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), is_safe);
+  if (!exists || is_safe) {
+    return;
+  }
+
   // 树空，无需删除，直接返回
   latch_.WLock();
   bool get_root = true;
@@ -349,7 +715,8 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
   while (!cur_page->IsLeafPage()) {
     auto cur_internal_page = reinterpret_cast<InternalPage *>(cur_page);
     // 如果当前结点发生删除键值对也不会导致借数据或合并，说明当前结点是安全的，则可以将其所有祖先节点解W锁并UnpinPage
-    if (cur_internal_page->GetSize() > (internal_max_size_ + 1) / 2) {
+    if (cur_internal_page->GetSize() > (internal_max_size_ + 1) / 2 ||
+        cur_internal_page->IsHalfFull(cur_internal_page->GetSize() - 1)) {
       while (transaction->GetPageSet()->size() > 1) {
         original_page = transaction->GetPageSet()->front();
         transaction->GetPageSet()->pop_front();
@@ -398,7 +765,7 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
     buffer_pool_manager_->UnpinPage(cur_leaf_page->GetPageId(), true);
     buffer_pool_manager_->DeletePage(cur_leaf_page->GetPageId());
     root_page_id_ = INVALID_PAGE_ID;
-    // UpdateRootPageId(1);
+    UpdateRootPageId(0);
     if (get_root) {
       get_root = false;
       latch_.WUnlock();
@@ -407,7 +774,8 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
   }
 
   // 如果删除键值对后叶子结点为根结点且非空，或不是根结点但键值对个数大于等于leaf_max_size_/2，可以结束了
-  if (cur_leaf_page->IsRootPage() || cur_leaf_page->GetSize() >= leaf_max_size_ / 2) {
+  if (cur_leaf_page->IsRootPage() || cur_leaf_page->GetSize() >= leaf_max_size_ / 2 ||
+      cur_leaf_page->IsHalfFull(cur_leaf_page->GetSize())) {
     while (transaction->GetPageSet()->size() > 1) {
       original_page = transaction->GetPageSet()->front();
       transaction->GetPageSet()->pop_front();
@@ -426,17 +794,40 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
   }
 
   // 如果删除键值键值对后叶子结点的键值对小于leaf_max_size_/2，需要向兄弟节点借数据，或者和兄弟节点合并，先处理叶结点的借数据或合并
+  // 解锁剩下的祖先结点，结束删除
+  auto release_ancestors = [&]() {
+    while (!transaction->GetPageSet()->empty()) {
+      original_page = transaction->GetPageSet()->front();
+      transaction->GetPageSet()->pop_front();
+      original_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(original_page->GetPageId(), false);
+    }
+    if (get_root) {
+      get_root = false;
+      latch_.WUnlock();
+    }
+  };
   original_page = transaction->GetPageSet()->back();
   transaction->GetPageSet()->pop_back();
   auto parent_original_page = transaction->GetPageSet()->back();
   transaction->GetPageSet()->pop_back();
   auto parent_internal_page = reinterpret_cast<InternalPage *>(parent_original_page->GetData());
+  // 父结点只剩这一个孩子时没有兄弟结点，叶子结点只能保持不满
+  if (parent_internal_page->GetSize() == 1) {
+    original_page->WUnlatch();
+    parent_original_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(cur_leaf_page->GetPageId(), true);
+    buffer_pool_manager_->UnpinPage(parent_internal_page->GetPageId(), false);
+    release_ancestors();
+    return;
+  }
   parent_internal_page->FindKeyIndex(&index, key, comparator_);
+  bool cur_is_left = index < parent_internal_page->GetSize() - 1;
   Page *left_original_page = nullptr;
   Page *right_original_page = nullptr;
   LeafPage *left_leaf_page = nullptr;
   LeafPage *right_leaf_page = nullptr;
-  if (index < parent_internal_page->GetSize() - 1) {
+  if (cur_is_left) {
     left_original_page = original_page;
     left_leaf_page = cur_leaf_page;
     right_original_page = buffer_pool_manager_->FetchPage(parent_internal_page->ValueAt(index + 1));
@@ -451,51 +842,53 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
     right_leaf_page = cur_leaf_page;
   }
 
-  // 如果删完后，和兄弟节点的键值对个数之和大于等于最大允许结点数，则借完数据，更新完父节点就可以结束了
+  std::vector<std::pair<KeyType, ValueType>> leaf_entries;
+  leaf_entries.reserve(left_leaf_page->GetSize() + right_leaf_page->GetSize());
+  for (int i = 0; i < left_leaf_page->GetSize(); i++) {
+    leaf_entries.emplace_back(left_leaf_page->KeyAt(i), left_leaf_page->ValueAt(i));
+  }
+  for (int i = 0; i < right_leaf_page->GetSize(); i++) {
+    leaf_entries.emplace_back(right_leaf_page->KeyAt(i), right_leaf_page->ValueAt(i));
+  }
+  int num_leaf_entries = static_cast<int>(leaf_entries.size());
+  bool can_merge = num_leaf_entries < leaf_max_size_ && LeafPage::HasRoomFor(leaf_entries.data(), num_leaf_entries);
+
+  // 如果删完后，和兄弟节点的键值对个数之和大于等于最大允许结点数，或合并后一页放不下，则借完数据，更新完父节点就可以结束了
   // LOG_INFO("$ %d $ %d $ %d $", left_leaf_page->GetPageId(), right_leaf_page->GetPageId(),
   // parent_internal_page->GetPageId()); LOG_INFO("# %d # %d # %d #", left_leaf_page->GetSize(),
   // right_leaf_page->GetSize(), parent_internal_page->GetSize());
-  if (left_leaf_page->GetSize() + right_leaf_page->GetSize() >= leaf_max_size_) {
-    if (left_leaf_page->GetSize() < leaf_max_size_ / 2) {
-      int insert_index = left_leaf_page->GetSize();
-      left_leaf_page->InsertKeyValueAt(insert_index, right_leaf_page->KeyAt(0), right_leaf_page->ValueAt(0));
-      right_leaf_page->RemoveKeyValueAt(0);
-    } else {
-      int delete_index = left_leaf_page->GetSize() - 1;
-      right_leaf_page->InsertKeyValueAt(0, left_leaf_page->KeyAt(delete_index), left_leaf_page->ValueAt(delete_index));
-      left_leaf_page->RemoveKeyValueAt(delete_index);
+  if (!can_merge) {
+    // 借一个键值对，新的分隔键要能放进父结点
+    int left_size = cur_is_left ? left_leaf_page->GetSize() + 1 : left_leaf_page->GetSize() - 1;
+    bool can_borrow = left_size > 0 && left_size < num_leaf_entries;
+    KeyType separator_key = leaf_entries[0].first;
+    if (can_borrow) {
+      separator_key = SeparatorKey(leaf_entries[left_size - 1].first, leaf_entries[left_size].first);
+      can_borrow = parent_internal_page->HasRoomFor(parent_internal_page->GetSize(), separator_key);
+    }
+    if (can_borrow) {
+      left_leaf_page->SetEntries(leaf_entries.data(), left_size);
+      right_leaf_page->SetEntries(leaf_entries.data() + left_size, num_leaf_entries - left_size);
+      parent_internal_page->SetKeyAt(index, separator_key);
     }
-
-    parent_internal_page->SetKeyAt(index, right_leaf_page->KeyAt(0));
 
     // LOG_INFO("$ %d $ %d $ %d $", left_leaf_page->GetPageId(), right_leaf_page->GetPageId(),
     // parent_internal_page->GetPageId()); LOG_INFO("# %d # %d # %d #", left_leaf_page->GetSize(),
     // right_leaf_page->GetSize(), parent_internal_page->GetSize());
 
+    // 借不了也合并不了时，叶子结点只能保持不满
     left_original_page->WUnlatch();
     right_original_page->WUnlatch();
     parent_original_page->WUnlatch();
     buffer_pool_manager_->UnpinPage(left_leaf_page->GetPageId(), true);
     buffer_pool_manager_->UnpinPage(right_leaf_page->GetPageId(), true);
-    buffer_pool_manager_->UnpinPage(parent_internal_page->GetPageId(), true);
-    while (!transaction->GetPageSet()->empty()) {
-      original_page = transaction->GetPageSet()->front();
-      transaction->GetPageSet()->pop_front();
-      original_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(original_page->GetPageId(), false);
-    }
-
-    if (get_root) {
-      get_root = false;
-      latch_.WUnlock();
-    }
+    buffer_pool_manager_->UnpinPage(parent_internal_page->GetPageId(), can_borrow);
+    release_ancestors();
     return;
   }
 
   // 如果删完后，和兄弟节点的键值对个数之和小于最大允许结点数，需要合并，后续删除父节点对应的键值对，可能引发多重借数据和合并
-  for (int i = 0; i < right_leaf_page->GetSize(); i++) {
-    left_leaf_page->InsertKeyValueAt(left_leaf_page->GetSize(), right_leaf_page->KeyAt(i), right_leaf_page->ValueAt(i));
-  }
+  left_leaf_page->SetEntries(leaf_entries.data(), num_leaf_entries);
   left_leaf_page->SetNextPageId(right_leaf_page->GetNextPageId());
   left_original_page->WUnlatch();
   right_original_page->WUnlatch();
@@ -509,17 +902,27 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
 
   // 处理内部节点的（多重）借数据和合并
   // LOG_INFO("-----------");
-  while (!parent_internal_page->IsRootPage() && parent_internal_page->GetSize() < (internal_max_size_ + 1) / 2) {
+  while (!parent_internal_page->IsRootPage() && parent_internal_page->GetSize() < (internal_max_size_ + 1) / 2 &&
+         !parent_internal_page->IsHalfFull(parent_internal_page->GetSize())) {
     // LOG_INFO("$ %d $ %d #", parent_internal_page->GetPageId(), parent_internal_page->GetSize());
     Page *before_original_page = parent_original_page;
     InternalPage *before_internal_page = parent_internal_page;
     parent_original_page = transaction->GetPageSet()->back();
     transaction->GetPageSet()->pop_back();
     parent_internal_page = reinterpret_cast<InternalPage *>(parent_original_page->GetData());
+    if (parent_internal_page->GetSize() == 1) {
+      before_original_page->WUnlatch();
+      parent_original_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(before_internal_page->GetPageId(), true);
+      buffer_pool_manager_->UnpinPage(parent_internal_page->GetPageId(), false);
+      release_ancestors();
+      return;
+    }
     parent_internal_page->FindKeyIndex(&index, delete_key, comparator_);
+    cur_is_left = index < parent_internal_page->GetSize() - 1;
     InternalPage *left_internal_page = nullptr;
     InternalPage *right_internal_page = nullptr;
-    if (index < parent_internal_page->GetSize() - 1) {
+    if (cur_is_left) {
       left_original_page = before_original_page;
       left_internal_page = before_internal_page;
       right_original_page = buffer_pool_manager_->FetchPage(parent_internal_page->ValueAt(index + 1));
@@ -534,49 +937,65 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
       right_internal_page = before_internal_page;
     }
 
-    // 删完后，和兄弟节点的键值对个数之和大于最大允许结点数，则借完数据，更新完父节点就可以结束了
+    // 合并后的键值对，右结点被忽略的第一个键换成父结点中的分隔键
+    std::vector<std::pair<KeyType, page_id_t>> internal_entries;
+    internal_entries.reserve(left_internal_page->GetSize() + right_internal_page->GetSize());
+    for (int i = 0; i < left_internal_page->GetSize(); i++) {
+      internal_entries.emplace_back(left_internal_page->KeyAt(i), left_internal_page->ValueAt(i));
+    }
+    internal_entries.emplace_back(parent_internal_page->KeyAt(index), right_internal_page->ValueAt(0));
+    for (int i = 1; i < right_internal_page->GetSize(); i++) {
+      internal_entries.emplace_back(right_internal_page->KeyAt(i), right_internal_page->ValueAt(i));
+    }
+    int num_internal_entries = static_cast<int>(internal_entries.size());
+    can_merge = num_internal_entries <= internal_max_size_ &&
+                InternalPage::HasRoomFor(internal_entries.data(), num_internal_entries);
+
+    // 删完后，和兄弟节点的键值对个数之和大于最大允许结点数，或合并后一页放不下，则借完数据，更新完父节点就可以结束了
     // LOG_INFO("-$ %d $ %d $ %d $-", left_internal_page->GetPageId(), right_internal_page->GetPageId(),
     // parent_internal_page->GetPageId()); LOG_INFO("-# %d # %d # %d #-", left_internal_page->GetSize(),
     // right_internal_page->GetSize(), parent_internal_page->GetSize());
-    if (left_internal_page->GetSize() + right_internal_page->GetSize() > internal_max_size_) {
-      if (left_internal_page->GetSize() < (internal_max_size_ + 1) / 2) {
-        left_internal_page->InsertKeyValueAt(left_internal_page->GetSize(), parent_internal_page->KeyAt(index),
-                                             right_internal_page->ValueAt(0));
-        parent_internal_page->SetKeyAt(index, right_internal_page->KeyAt(1));
-        right_internal_page->RemoveKeyValueAt(0);
-        auto child_page = reinterpret_cast<BPlusTreePage *>(
-            buffer_pool_manager_->FetchPage(left_internal_page->ValueAt(left_internal_page->GetSize() - 1))->GetData());
-        child_page->SetParentPageId(left_internal_page->GetPageId());
-        buffer_pool_manager_->UnpinPage(child_page->GetPageId(), true);
+    if (!can_merge) {
+      bool can_borrow = false;
+      if (cur_is_left) {
+        can_borrow = right_internal_page->GetSize() > 1 &&
+                     parent_internal_page->HasRoomFor(parent_internal_page->GetSize(), right_internal_page->KeyAt(1));
+        if (can_borrow) {
+          left_internal_page->InsertKeyValueAt(left_internal_page->GetSize(), parent_internal_page->KeyAt(index),
+                                               right_internal_page->ValueAt(0));
+          parent_internal_page->SetKeyAt(index, right_internal_page->KeyAt(1));
+          right_internal_page->RemoveKeyValueAt(0);
+          auto child_page = reinterpret_cast<BPlusTreePage *>(
+              buffer_pool_manager_->FetchPage(left_internal_page->ValueAt(left_internal_page->GetSize() - 1))
+                  ->GetData());
+          child_page->SetParentPageId(left_internal_page->GetPageId());
+          buffer_pool_manager_->UnpinPage(child_page->GetPageId(), true);
+        }
       } else {
-        right_internal_page->SetKeyAt(0, parent_internal_page->KeyAt(index));
-        right_internal_page->InsertKeyValueAt(0, left_internal_page->KeyAt(left_internal_page->GetSize() - 1),
-                                              left_internal_page->ValueAt(left_internal_page->GetSize() - 1));
-        parent_internal_page->SetKeyAt(index, left_internal_page->KeyAt(left_internal_page->GetSize() - 1));
-        left_internal_page->RemoveKeyValueAt(left_internal_page->GetSize() - 1);
-        auto child_page = reinterpret_cast<BPlusTreePage *>(
-            buffer_pool_manager_->FetchPage(right_internal_page->ValueAt(0))->GetData());
-        child_page->SetParentPageId(right_internal_page->GetPageId());
-        buffer_pool_manager_->UnpinPage(child_page->GetPageId(), true);
+        int last_index = left_internal_page->GetSize() - 1;
+        can_borrow = last_index > 0 && parent_internal_page->HasRoomFor(parent_internal_page->GetSize(),
+                                                                        left_internal_page->KeyAt(last_index));
+        if (can_borrow) {
+          right_internal_page->SetKeyAt(0, parent_internal_page->KeyAt(index));
+          right_internal_page->InsertKeyValueAt(0, left_internal_page->KeyAt(last_index),
+                                                left_internal_page->ValueAt(last_index));
+          parent_internal_page->SetKeyAt(index, left_internal_page->KeyAt(last_index));
+          left_internal_page->RemoveKeyValueAt(last_index);
+          auto child_page = reinterpret_cast<BPlusTreePage *>(
+              buffer_pool_manager_->FetchPage(right_internal_page->ValueAt(0))->GetData());
+          child_page->SetParentPageId(right_internal_page->GetPageId());
+          buffer_pool_manager_->UnpinPage(child_page->GetPageId(), true);
+        }
       }
 
+      // 借不了也合并不了时，内部结点只能保持不满
       left_original_page->WUnlatch();
       right_original_page->WUnlatch();
       parent_original_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(left_internal_page->GetPageId(), true);
       buffer_pool_manager_->UnpinPage(right_internal_page->GetPageId(), true);
-      buffer_pool_manager_->UnpinPage(parent_internal_page->GetPageId(), true);
-      while (!transaction->GetPageSet()->empty()) {
-        original_page = transaction->GetPageSet()->front();
-        transaction->GetPageSet()->pop_front();
-        original_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(original_page->GetPageId(), false);
-      }
-
-      if (get_root) {
-        get_root = false;
-        latch_.WUnlock();
-      }
+      buffer_pool_manager_->UnpinPage(parent_internal_page->GetPageId(), can_borrow);
+      release_ancestors();
       return;
     }
 
@@ -584,22 +1003,14 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
     // LOG_INFO("$ %d $ %d $ %d $", left_internal_page->GetPageId(), right_internal_page->GetPageId(),
     // parent_internal_page->GetPageId()); LOG_INFO("# %d # %d # %d #", left_internal_page->GetSize(),
     // right_internal_page->GetSize(), parent_internal_page->GetSize());
-    right_internal_page->SetKeyAt(0, parent_internal_page->KeyAt(index));
-    for (int i = 0; i < right_internal_page->GetSize(); i++) {
-      int insert_index = left_internal_page->GetSize();
-      left_internal_page->InsertKeyValueAt(insert_index, right_internal_page->KeyAt(i),
-                                           right_internal_page->ValueAt(i));
+    int first_moved = left_internal_page->GetSize();
+    left_internal_page->SetEntries(internal_entries.data(), num_internal_entries);
+    for (int i = first_moved; i < num_internal_entries; i++) {
       auto child_page = reinterpret_cast<BPlusTreePage *>(
-          buffer_pool_manager_->FetchPage(left_internal_page->ValueAt(insert_index))->GetData());
+          buffer_pool_manager_->FetchPage(left_internal_page->ValueAt(i))->GetData());
       child_page->SetParentPageId(left_internal_page->GetPageId());
       buffer_pool_manager_->UnpinPage(child_page->GetPageId(), true);
-      // LOG_INFO("$ %d $ %d $ %d $", left_internal_page->GetPageId(), right_internal_page->GetPageId(),
-      // parent_internal_page->GetPageId()); LOG_INFO("# %d # %d # %d #", left_internal_page->GetSize(),
-      // right_internal_page->GetSize(), parent_internal_page->GetSize());
     }
-    // LOG_INFO("$ %d $ %d $ %d $", left_internal_page->GetPageId(), right_internal_page->GetPageId(),
-    // parent_internal_page->GetPageId()); LOG_INFO("# %d # %d # %d #", left_internal_page->GetSize(),
-    // right_internal_page->GetSize(), parent_internal_page->GetSize());
     left_original_page->WUnlatch();
     right_original_page->WUnlatch();
     buffer_pool_manager_->UnpinPage(left_internal_page->GetPageId(), true);
@@ -609,7 +1020,6 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
     delete_key = parent_internal_page->KeyAt(index);
     parent_internal_page->RemoveKeyValueAt(index);
   }
-
   if (parent_internal_page->IsRootPage() && parent_internal_page->GetSize() == 1) {
     // LOG_INFO("%d %d", parent_internal_page->GetPageId(), parent_internal_page->GetSize());
     auto child_original_page = buffer_pool_manager_->FetchPage(parent_internal_page->ValueAt(0));
@@ -648,55 +1058,57 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
-  if (IsEmpty()) {
-    return INDEXITERATOR_TYPE(buffer_pool_manager_, comparator_);
-  }
-
-  auto cur_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
-  while (!cur_page->IsLeafPage()) {
-    auto cur_internal_page = reinterpret_cast<InternalPage *>(cur_page);
-    cur_page =
-        reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(cur_internal_page->ValueAt(0))->GetData());
-    buffer_pool_manager_->UnpinPage(cur_internal_page->GetPageId(), false);
-  }
-
-  page_id_t page_id = cur_page->GetPageId();
-  int index = 0;
-  buffer_pool_manager_->UnpinPage(cur_page->GetPageId(), false);
-
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, comparator_, page_id, index);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, comparator_, FindLeafForRead(nullptr), 0);
 }
 
 /*
- * Input parameter is low key, find the leaf page that contains the input key
- * first, then construct index iterator
+ * Input parameter is low key, find the leaf page that would contain the input
+ * key first, then construct index iterator at the first key not less than it
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
-  if (IsEmpty()) {
+  auto leaf_original_page = FindLeafForRead(&key);
+  if (leaf_original_page == nullptr) {
     return INDEXITERATOR_TYPE(buffer_pool_manager_, comparator_);
   }
-
-  auto cur_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
+  auto cur_leaf_page = reinterpret_cast<LeafPage *>(leaf_original_page->GetData());
+  // 没有找到key时，index是第一个比key大的位置，可能已经超出当前叶子
   int index;
+  cur_leaf_page->FindKeyIndex(&index, key, comparator_);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, comparator_, leaf_original_page, index);
+}
+
+/*
+ * Descend to the leaf which holds or would hold a key, or to the leftmost
+ * leaf if key is nullptr, read latching one page at a time.
+ * @return : the read latched and pinned leaf, nullptr if the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafForRead(const KeyType *key) -> Page * {
+  latch_.RLock();
+  if (IsEmpty()) {
+    latch_.RUnlock();
+    return nullptr;
+  }
+  auto original_page = buffer_pool_manager_->FetchPage(root_page_id_);
+  original_page->RLatch();
+  latch_.RUnlock();
+  auto cur_page = reinterpret_cast<BPlusTreePage *>(original_page->GetData());
   while (!cur_page->IsLeafPage()) {
     auto cur_internal_page = reinterpret_cast<InternalPage *>(cur_page);
-    cur_internal_page->FindKeyIndex(&index, key, comparator_);
-    cur_page = reinterpret_cast<BPlusTreePage *>(
-        buffer_pool_manager_->FetchPage(cur_internal_page->ValueAt(index))->GetData());
+    int index = 0;
+    if (key != nullptr) {
+      cur_internal_page->FindKeyIndex(&index, *key, comparator_);
+    }
+    auto child_original_page = buffer_pool_manager_->FetchPage(cur_internal_page->ValueAt(index));
+    child_original_page->RLatch();
+    original_page->RUnlatch();
     buffer_pool_manager_->UnpinPage(cur_internal_page->GetPageId(), false);
+    original_page = child_original_page;
+    cur_page = reinterpret_cast<BPlusTreePage *>(original_page->GetData());
   }
-
-  auto cur_leaf_page = reinterpret_cast<LeafPage *>(cur_page);
-  if (cur_leaf_page->FindKeyIndex(&index, key, comparator_)) {
-    page_id_t page_id = cur_page->GetPageId();
-    buffer_pool_manager_->UnpinPage(cur_leaf_page->GetPageId(), false);
-    return INDEXITERATOR_TYPE(buffer_pool_manager_, comparator_, page_id, index);
-  }
-  buffer_pool_manager_->UnpinPage(cur_leaf_page->GetPageId(), false);
-
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, comparator_);
+  return original_page;
 }
 
 /*
@@ -727,16 +1139,38 @@ auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return root_page_id_; }
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
   auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  // 记录可能已存在（根分裂）或尚不存在（第一次插入），插入失败时改为更新，反之亦然
   if (insert_record != 0) {
     // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
+    if (!header_page->InsertRecord(index_name_, root_page_id_)) {
+      header_page->UpdateRecord(index_name_, root_page_id_);
+    }
   } else {
     // update root_page_id in header_page
-    header_page->UpdateRecord(index_name_, root_page_id_);
+    if (!header_page->UpdateRecord(index_name_, root_page_id_) && root_page_id_ != INVALID_PAGE_ID) {
+      header_page->InsertRecord(index_name_, root_page_id_);
+    }
   }
   buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
 }
 
+/*
+ * Read the root page id recorded in the header page by a previous run, so
+ * that a persisted index can be reopened without rebuilding it.
+ * @return : false if the header page has no record for this index
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::LoadRootPageId() -> bool {
+  auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  page_id_t root_page_id;
+  bool found = header_page->GetRootId(index_name_, &root_page_id);
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, false);
+  if (found) {
+    root_page_id_ = root_page_id;
+  }
+  return found;
+}
+
 /*
  * This method is used for test only
  * Read data from file and insert one by one
@@ -931,5 +1365,13 @@ template class BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTree<GenericKey<128>, RID, GenericComparator<128>>;
+template class BPlusTree<GenericKey<256>, RID, GenericComparator<256>>;
+template class BPlusTree<GenericKey<4>, RID, IntegerComparator<4, int32_t>>;
+template class BPlusTree<GenericKey<8>, RID, IntegerComparator<8, int64_t>>;
+template class BPlusTree<GenericKey<8>, RID, IntegerColumnsComparator<8>>;
+template class BPlusTree<GenericKey<16>, RID, IntegerColumnsComparator<16>>;
+template class BPlusTree<GenericKey<32>, RID, IntegerColumnsComparator<32>>;
+template class BPlusTree<GenericKey<64>, RID, IntegerColumnsComparator<64>>;
 
 }  // namespace bustub
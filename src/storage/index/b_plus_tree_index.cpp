@@ -9,6 +9,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
 #include "storage/index/b_plus_tree_index.h"
 
 namespace bustub {
@@ -16,10 +18,12 @@ namespace bustub {
  * Constructor
  */
 INDEX_TEMPLATE_ARGUMENTS
-BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
+BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                                     const std::string &root_record_name)
     : Index(std::move(metadata)),
       comparator_(GetMetadata()->GetKeySchema()),
-      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_) {}
+      container_(root_record_name.empty() ? GetMetadata()->GetName() : root_record_name, buffer_pool_manager,
+                 comparator_) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
@@ -28,6 +32,34 @@ void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *t
   index_key.SetFromKey(key);
 
   container_.Insert(index_key, rid, transaction);
+  AddToBloomFilter(index_key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) {
+  // the tree sorts the batch, and builds itself bottom-up if it is empty or inserts the entries in key order, so
+  // that consecutive inserts land in the same leaf and only the rightmost leaf splits
+  std::vector<std::pair<KeyType, RID>> index_entries(entries.size());
+  for (size_t i = 0; i < entries.size(); i++) {
+    index_entries[i].first.SetFromKey(entries[i].first);
+    index_entries[i].second = entries[i].second;
+  }
+  BulkLoad(std::move(index_entries), transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::BulkLoad(std::vector<std::pair<KeyType, ValueType>> entries, Transaction *transaction) {
+  std::vector<KeyType> keys;
+  if (has_bloom_filter_) {
+    keys.reserve(entries.size());
+    for (const auto &entry : entries) {
+      keys.push_back(entry.first);
+    }
+  }
+  container_.BulkLoad(std::move(entries), index_fill_factor, transaction);
+  for (const auto &key : keys) {
+    AddToBloomFilter(key);
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -44,8 +76,127 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   // construct scan index key
   KeyType index_key;
   index_key.SetFromKey(key);
+  if (!MayContain(index_key)) {
+    return;
+  }
 
+  auto num_results = result->size();
   container_.GetValue(index_key, result, transaction);
+  if (has_bloom_filter_ && result->size() == num_results) {
+    bloom_filter_false_positives_++;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                                    Transaction *transaction) {
+  // sort the keys the Bloom filter does not rule out, remembering where each one came from
+  std::vector<std::pair<KeyType, size_t>> index_keys;
+  index_keys.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    KeyType index_key;
+    index_key.SetFromKey(keys[i]);
+    if (MayContain(index_key)) {
+      index_keys.emplace_back(index_key, i);
+    }
+  }
+  std::sort(index_keys.begin(), index_keys.end(),
+            [this](const auto &lhs, const auto &rhs) { return comparator_(lhs.first, rhs.first) < 0; });
+  std::vector<KeyType> sorted_keys(index_keys.size());
+  for (size_t i = 0; i < index_keys.size(); i++) {
+    sorted_keys[i] = index_keys[i].first;
+  }
+
+  std::vector<std::vector<RID>> sorted_results;
+  container_.GetValues(sorted_keys, &sorted_results);
+  results->assign(keys.size(), {});
+  for (size_t i = 0; i < index_keys.size(); i++) {
+    if (has_bloom_filter_ && sorted_results[i].empty()) {
+      bloom_filter_false_positives_++;
+    }
+    (*results)[index_keys[i].second] = std::move(sorted_results[i]);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::EnableBloomFilter() {
+  bloom_filter_latch_.WLock();
+  BuildBloomFilter();
+  has_bloom_filter_ = true;
+  bloom_filter_latch_.WUnlock();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetBloomFilterStats() const -> std::optional<BloomFilterStats> {
+  if (!has_bloom_filter_) {
+    return std::nullopt;
+  }
+  bloom_filter_latch_.RLock();
+  BloomFilterStats stats{bloom_filter_->GetNumKeys(),
+                         bloom_filter_->GetCapacity(),
+                         bloom_filter_->GetMemoryUsage(),
+                         bloom_filter_->ExpectedFalsePositiveRate(),
+                         bloom_filter_lookups_.load(),
+                         bloom_filter_negatives_.load(),
+                         bloom_filter_false_positives_.load()};
+  bloom_filter_latch_.RUnlock();
+  return stats;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::MayContain(const KeyType &key) -> bool {
+  if (!has_bloom_filter_) {
+    return true;
+  }
+  auto hash = hash_fn_.GetHash(key);
+  bloom_filter_latch_.RLock();
+  bool may_contain = bloom_filter_->MayContain(hash);
+  bloom_filter_latch_.RUnlock();
+  bloom_filter_lookups_++;
+  if (!may_contain) {
+    bloom_filter_negatives_++;
+  }
+  return may_contain;
+}
+
+/*
+ * The key is added once it is in the tree: a lookup between the two may miss
+ * it, as it may miss an insert still descending the tree. A rebuild scans the
+ * tree under the exclusive filter latch, so that it sees the keys added before
+ * it, and the keys inserted during it are added to the new filter.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::AddToBloomFilter(const KeyType &key) {
+  if (!has_bloom_filter_) {
+    return;
+  }
+  auto hash = hash_fn_.GetHash(key);
+  bloom_filter_latch_.RLock();
+  bloom_filter_->Add(hash);
+  bool outgrown = bloom_filter_->GetNumKeys() > bloom_filter_->GetCapacity();
+  bloom_filter_latch_.RUnlock();
+  if (outgrown) {
+    bloom_filter_latch_.WLock();
+    // another insert may have rebuilt it meanwhile
+    if (bloom_filter_->GetNumKeys() > bloom_filter_->GetCapacity()) {
+      BuildBloomFilter();
+    }
+    bloom_filter_latch_.WUnlock();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::BuildBloomFilter() {
+  std::vector<uint64_t> hashes;
+  for (auto iterator = container_.Begin(); !iterator.IsEnd(); ++iterator) {
+    hashes.push_back(hash_fn_.GetHash((*iterator).first));
+  }
+  auto filter =
+      std::make_unique<BloomFilter>(std::max(2 * hashes.size(), BLOOM_FILTER_MIN_KEYS), bloom_filter_bits_per_key);
+  for (auto hash : hashes) {
+    filter->Add(hash);
+  }
+  bloom_filter_ = std::move(filter);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -62,5 +213,13 @@ template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeIndex<GenericKey<128>, RID, GenericComparator<128>>;
+template class BPlusTreeIndex<GenericKey<256>, RID, GenericComparator<256>>;
+template class BPlusTreeIndex<GenericKey<4>, RID, IntegerComparator<4, int32_t>>;
+template class BPlusTreeIndex<GenericKey<8>, RID, IntegerComparator<8, int64_t>>;
+template class BPlusTreeIndex<GenericKey<8>, RID, IntegerColumnsComparator<8>>;
+template class BPlusTreeIndex<GenericKey<16>, RID, IntegerColumnsComparator<16>>;
+template class BPlusTreeIndex<GenericKey<32>, RID, IntegerColumnsComparator<32>>;
+template class BPlusTreeIndex<GenericKey<64>, RID, IntegerColumnsComparator<64>>;
 
 }  // namespace bustub
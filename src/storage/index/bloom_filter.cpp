@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.cpp
+//
+// Identification: src/storage/index/bloom_filter.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/bloom_filter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "fmt/format.h"
+
+namespace bustub {
+
+auto BloomFilterStats::ToString() const -> std::string {
+  return fmt::format("keys={}/{}, memory={}B, expected_fpr={:.4f}, fpr={:.4f} ({} of {} absent keys)", num_keys_,
+                     capacity_, memory_usage_, expected_false_positive_rate_, FalsePositiveRate(), false_positives_,
+                     negatives_ + false_positives_);
+}
+
+BloomFilter::BloomFilter(size_t capacity, size_t bits_per_key)
+    : capacity_(capacity),
+      // ln 2 hash functions per bit of a key give the fewest false positives
+      num_hashes_(std::clamp<size_t>(std::lround(static_cast<double>(bits_per_key) * std::log(2.0)), 1, 30)),
+      words_((std::max<size_t>(capacity * bits_per_key, 64) + 63) / 64) {
+  num_bits_ = words_.size() * 64;
+}
+
+auto BloomFilter::BitIndex(uint64_t hash, size_t i) const -> size_t {
+  auto h1 = static_cast<uint32_t>(hash);
+  auto h2 = static_cast<uint32_t>(hash >> 32) | 1;
+  return (h1 + i * static_cast<uint64_t>(h2)) % num_bits_;
+}
+
+void BloomFilter::Add(uint64_t hash) {
+  for (size_t i = 0; i < num_hashes_; i++) {
+    auto bit = BitIndex(hash, i);
+    words_[bit / 64].fetch_or(uint64_t{1} << (bit % 64), std::memory_order_relaxed);
+  }
+  num_keys_.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto BloomFilter::MayContain(uint64_t hash) const -> bool {
+  for (size_t i = 0; i < num_hashes_; i++) {
+    auto bit = BitIndex(hash, i);
+    if ((words_[bit / 64].load(std::memory_order_relaxed) & (uint64_t{1} << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto BloomFilter::ExpectedFalsePositiveRate() const -> double {
+  auto k = static_cast<double>(num_hashes_);
+  auto n = static_cast<double>(GetNumKeys());
+  auto m = static_cast<double>(num_bits_);
+  return std::pow(1 - std::exp(-k * n / m), k);
+}
+
+}  // namespace bustub
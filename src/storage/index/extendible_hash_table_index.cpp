@@ -9,10 +9,10 @@ namespace bustub {
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_INDEX_TYPE::ExtendibleHashTableIndex(std::unique_ptr<IndexMetadata> &&metadata,
                                                 BufferPoolManager *buffer_pool_manager,
-                                                const HashFunction<KeyType> &hash_fn)
+                                                const HashFunction<KeyType> &hash_fn, page_id_t directory_page_id)
     : Index(std::move(metadata)),
       comparator_(GetMetadata()->GetKeySchema()),
-      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_, hash_fn) {}
+      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_, hash_fn, directory_page_id) {}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
@@ -45,5 +45,13 @@ template class ExtendibleHashTableIndex<GenericKey<8>, RID, GenericComparator<8>
 template class ExtendibleHashTableIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class ExtendibleHashTableIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class ExtendibleHashTableIndex<GenericKey<64>, RID, GenericComparator<64>>;
+template class ExtendibleHashTableIndex<GenericKey<128>, RID, GenericComparator<128>>;
+template class ExtendibleHashTableIndex<GenericKey<256>, RID, GenericComparator<256>>;
+template class ExtendibleHashTableIndex<GenericKey<4>, RID, IntegerComparator<4, int32_t>>;
+template class ExtendibleHashTableIndex<GenericKey<8>, RID, IntegerComparator<8, int64_t>>;
+template class ExtendibleHashTableIndex<GenericKey<8>, RID, IntegerColumnsComparator<8>>;
+template class ExtendibleHashTableIndex<GenericKey<16>, RID, IntegerColumnsComparator<16>>;
+template class ExtendibleHashTableIndex<GenericKey<32>, RID, IntegerColumnsComparator<32>>;
+template class ExtendibleHashTableIndex<GenericKey<64>, RID, IntegerColumnsComparator<64>>;
 
 }  // namespace bustub
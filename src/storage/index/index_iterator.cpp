@@ -1,51 +1,203 @@
 /**
  * index_iterator.cpp
  */
+#include <algorithm>
 #include <cassert>
+#include <utility>
 
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
 
+LeafPrefetcher::LeafPrefetcher() : worker_(&LeafPrefetcher::Run, this) {}
+
+LeafPrefetcher::~LeafPrefetcher() {
+  {
+    std::scoped_lock lock(latch_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  worker_.join();
+}
+
+auto LeafPrefetcher::Instance() -> LeafPrefetcher & {
+  static LeafPrefetcher prefetcher;
+  return prefetcher;
+}
+
+auto LeafPrefetcher::Fetch(BufferPoolManager *bpm, page_id_t page_id) -> std::shared_ptr<Request> {
+  auto request = std::make_shared<Request>();
+  request->bpm_ = bpm;
+  request->page_id_ = page_id;
+  request->future_ = request->page_.get_future();
+  {
+    std::scoped_lock lock(latch_);
+    queue_.push_back(request);
+  }
+  cv_.notify_one();
+  return request;
+}
+
+auto LeafPrefetcher::Take(const std::shared_ptr<Request> &request) -> Page * { return request->future_.get(); }
+
+auto LeafPrefetcher::Cancel(const std::shared_ptr<Request> &request) -> Page * {
+  {
+    std::scoped_lock lock(latch_);
+    if (auto it = std::find(queue_.begin(), queue_.end(), request); it != queue_.end()) {
+      queue_.erase(it);
+      return nullptr;
+    }
+  }
+  return request->future_.get();
+}
+
+void LeafPrefetcher::Run() {
+  std::unique_lock lock(latch_);
+  while (true) {
+    cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    auto request = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    request->page_.set_value(request->bpm_->FetchPage(request->page_id_));
+    lock.lock();
+  }
+}
+
 /*
  * NOTE: you can change the destructor/constructor method here
  * set your own input parameters
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                                  page_id_t page_id, int index)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator) {
-  page_id_ = page_id;
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator, Page *leaf,
+                                  int index)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), prefetch_(index_scan_prefetch) {
+  if (leaf == nullptr) {
+    return;
+  }
+  page_ = leaf;
+  leaf_ = reinterpret_cast<LeafPage *>(leaf->GetData());
+  page_id_ = leaf->GetPageId();
   index_ = index;
+  PrefetchNextLeaf();
+  SkipToEntry();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : buffer_pool_manager_(other.buffer_pool_manager_),
+      comparator_(other.comparator_),
+      page_id_(std::exchange(other.page_id_, INVALID_PAGE_ID)),
+      index_(std::exchange(other.index_, 0)),
+      page_(std::exchange(other.page_, nullptr)),
+      leaf_(std::exchange(other.leaf_, nullptr)),
+      prefetch_(other.prefetch_),
+      next_request_(std::move(other.next_request_)) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::~IndexIterator() { Release(); }  // NOLINT
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator=(IndexIterator &&itr) noexcept -> IndexIterator & {
+  if (this != &itr) {
+    Release();
+    buffer_pool_manager_ = itr.buffer_pool_manager_;
+    page_id_ = std::exchange(itr.page_id_, INVALID_PAGE_ID);
+    index_ = std::exchange(itr.index_, 0);
+    page_ = std::exchange(itr.page_, nullptr);
+    leaf_ = std::exchange(itr.leaf_, nullptr);
+    prefetch_ = itr.prefetch_;
+    next_request_ = std::move(itr.next_request_);
+  }
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::IsEnd() -> bool { return page_id_ == INVALID_PAGE_ID; }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
-  auto leaf_page = reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(
-      buffer_pool_manager_->FetchPage(page_id_)->GetData());
-  temp_.first = leaf_page->KeyAt(index_);
-  temp_.second = leaf_page->ValueAt(index_);
-  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+  assert(leaf_ != nullptr);
+  temp_.first = leaf_->KeyAt(index_);
+  temp_.second = leaf_->ValueAt(index_);
   return temp_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
-  auto leaf_page = reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(
-      buffer_pool_manager_->FetchPage(page_id_)->GetData());
+  assert(leaf_ != nullptr);
   index_++;
-  if (index_ == leaf_page->GetSize()) {
-    page_id_ = leaf_page->GetNextPageId();
+  SkipToEntry();
+  return *this;
+}
+
+/*
+ * Hand the iterator over to the next leaf while it is past the last entry of
+ * its leaf. The next leaf is pinned, by the prefetch or here, before the
+ * current one is released, so that it stays in the buffer pool; it is read
+ * latched once the iterator holds no latch.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipToEntry() {
+  while (index_ >= leaf_->GetSize()) {
+    page_id_t next_page_id = leaf_->GetNextPageId();
+    Page *next_page = nullptr;
+    if (next_request_ != nullptr) {
+      next_page = LeafPrefetcher::Instance().Take(next_request_);
+      next_request_ = nullptr;
+      // the leaf split since the prefetch, its next leaf is a new one
+      if (next_page != nullptr && next_page->GetPageId() != next_page_id) {
+        buffer_pool_manager_->UnpinPage(next_page->GetPageId(), false);
+        next_page = nullptr;
+      }
+    }
+    if (next_page == nullptr && next_page_id != INVALID_PAGE_ID) {
+      next_page = buffer_pool_manager_->FetchPage(next_page_id);
+    }
+    page_->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id_, false);
+    page_ = nullptr;
+    leaf_ = nullptr;
     index_ = 0;
+    page_id_ = INVALID_PAGE_ID;
+    if (next_page == nullptr) {
+      return;
+    }
+    next_page->RLatch();
+    page_ = next_page;
+    leaf_ = reinterpret_cast<LeafPage *>(next_page->GetData());
+    page_id_ = next_page_id;
+    PrefetchNextLeaf();
   }
-  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
-  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::PrefetchNextLeaf() {
+  page_id_t next_page_id = leaf_->GetNextPageId();
+  if (!prefetch_ || next_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  next_request_ = LeafPrefetcher::Instance().Fetch(buffer_pool_manager_, next_page_id);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Release() {
+  if (next_request_ != nullptr) {
+    if (auto next_page = LeafPrefetcher::Instance().Cancel(next_request_); next_page != nullptr) {
+      buffer_pool_manager_->UnpinPage(next_page->GetPageId(), false);
+    }
+    next_request_ = nullptr;
+  }
+  if (page_ != nullptr) {
+    page_->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id_, false);
+    page_ = nullptr;
+    leaf_ = nullptr;
+  }
+  page_id_ = INVALID_PAGE_ID;
+  index_ = 0;
 }
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
@@ -58,4 +210,20 @@ template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class IndexIterator<GenericKey<128>, RID, GenericComparator<128>>;
+
+template class IndexIterator<GenericKey<256>, RID, GenericComparator<256>>;
+
+template class IndexIterator<GenericKey<4>, RID, IntegerComparator<4, int32_t>>;
+
+template class IndexIterator<GenericKey<8>, RID, IntegerComparator<8, int64_t>>;
+
+template class IndexIterator<GenericKey<8>, RID, IntegerColumnsComparator<8>>;
+
+template class IndexIterator<GenericKey<16>, RID, IntegerColumnsComparator<16>>;
+
+template class IndexIterator<GenericKey<32>, RID, IntegerColumnsComparator<32>>;
+
+template class IndexIterator<GenericKey<64>, RID, IntegerColumnsComparator<64>>;
+
 }  // namespace bustub
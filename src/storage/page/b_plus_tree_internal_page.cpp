@@ -9,11 +9,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <sstream>
+#include <type_traits>
 
 #include "common/exception.h"
 #include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_search.h"
 
 namespace bustub {
 /*****************************************************************************
@@ -31,35 +36,57 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id
   SetMaxSize(max_size);
   SetParentPageId(parent_id);
   SetPageId(page_id);
+  entries_.Init();
 }
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType { return entries_.KeyAt(index); }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
+  entries_.SetKeyAt(GetSize(), index, key);
+}
 
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return entries_.ValueAt(index); }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { array_[index].second = value; }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  entries_.SetValueAt(index, value);
+}
 
+/*
+ * Find the index of the child whose subtree holds the given key, i.e. of the
+ * last key not greater than it, the first key counting as the smallest one
+ * @return : true means the key is at that index
+ */
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::FindKeyIndex(int *index, const KeyType &key, const KeyComparator &comparator) const
     -> bool {
+  using IntType = typename ComparatorIntegerType<KeyComparator>::type;
+  if constexpr (!std::is_void_v<IntType>) {
+    // the number of keys from the second one on which are not greater than the key
+    IntType int_key;
+    memcpy(&int_key, &key, sizeof(IntType));
+    *index = int_key == std::numeric_limits<IntType>::max()
+                 ? GetSize() - 1
+                 : IntegerLowerBound(entries_.KeyBytes() + sizeof(KeyType), GetSize() - 1,
+                                     static_cast<IntType>(int_key + 1));
+    return *index > 0 && comparator(KeyAt(*index), key) == 0;
+  }
+
   int left_index = 0;
   int right_index = GetSize() - 1;
   while (left_index < right_index) {
     int middle_index = (left_index + right_index + 1) >> 1;
-    if (comparator(array_[middle_index].first, key) <= 0) {
+    if (comparator(KeyAt(middle_index), key) <= 0) {
       left_index = middle_index;
     } else {
       right_index = middle_index - 1;
@@ -67,31 +94,58 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::FindKeyIndex(int *index, const KeyType &key
   }
 
   *index = left_index;
-  return left_index > 0 && comparator(array_[left_index].first, key) == 0;
+  return left_index > 0 && comparator(KeyAt(left_index), key) == 0;
 }
 
+/*
+ * Insert a key & child pointer pair at index, the caller checks with
+ * HasRoomFor that it fits
+ */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertKeyValueAt(int index, const KeyType &key, const ValueType &value) {
-  for (int i = GetSize(); i > index; i--) {
-    array_[i] = array_[i - 1];
-  }
-  array_[index].first = key;
-  array_[index].second = value;
+  entries_.InsertAt(GetSize(), index, key, value);
   IncreaseSize(1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveKeyValueAt(int index) {
-  for (int i = index; i < GetSize() - 1; i++) {
-    array_[i] = array_[i + 1];
-  }
+  entries_.RemoveAt(GetSize(), index);
   IncreaseSize(-1);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetEntries(const MappingType *entries, int num_entries) {
+  entries_.Assign(entries, num_entries);
+  SetSize(num_entries);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomFor(int num_entries, const KeyType &key) const -> bool {
+  return entries_.HasRoomFor(GetSize(), num_entries, key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomFor(const MappingType *entries, int num_entries) -> bool {
+  return EntryArray::HasRoomFor(entries, num_entries);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsHalfFull(int num_entries) const -> bool {
+  return ELIDES_KEY_BYTES && entries_.IsHalfFull(num_entries);
+}
+
 // valuetype for internalNode should be page id_t
 template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
 template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
 template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
 template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+template class BPlusTreeInternalPage<GenericKey<128>, page_id_t, GenericComparator<128>>;
+template class BPlusTreeInternalPage<GenericKey<256>, page_id_t, GenericComparator<256>>;
+template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, IntegerComparator<4, int32_t>>;
+template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, IntegerComparator<8, int64_t>>;
+template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, IntegerColumnsComparator<8>>;
+template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, IntegerColumnsComparator<16>>;
+template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, IntegerColumnsComparator<32>>;
+template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, IntegerColumnsComparator<64>>;
 }  // namespace bustub
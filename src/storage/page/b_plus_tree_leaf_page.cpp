@@ -9,11 +9,15 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
+#include <type_traits>
 
 #include "common/exception.h"
 #include "common/rid.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_search.h"
 
 namespace bustub {
 
@@ -34,6 +38,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, in
   SetParentPageId(parent_id);
   SetPageId(page_id);
   next_page_id_ = INVALID_PAGE_ID;
+  entries_.Init();
 }
 
 /**
@@ -50,25 +55,37 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_pa
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType { return entries_.KeyAt(index); }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { entries_.SetKeyAt(GetSize(), index, key); }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return entries_.ValueAt(index); }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { array_[index].second = value; }
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { entries_.SetValueAt(index, value); }
 
+/*
+ * Find the index of the first key not less than the given key
+ * @return : true means the key is at that index
+ */
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::FindKeyIndex(int *index, const KeyType &key, const KeyComparator &comparator) const
     -> bool {
+  using IntType = typename ComparatorIntegerType<KeyComparator>::type;
+  if constexpr (!std::is_void_v<IntType>) {
+    IntType int_key;
+    memcpy(&int_key, &key, sizeof(IntType));
+    *index = IntegerLowerBound(entries_.KeyBytes(), GetSize(), int_key);
+    return *index < GetSize() && comparator(KeyAt(*index), key) == 0;
+  }
+
   int left_index = 0;
   int right_index = GetSize();
   while (left_index < right_index) {
     int middle_index = (left_index + right_index) >> 1;
-    if (comparator(array_[middle_index].first, key) >= 0) {
+    if (comparator(KeyAt(middle_index), key) >= 0) {
       right_index = middle_index;
     } else {
       left_index = middle_index + 1;
@@ -76,30 +93,57 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::FindKeyIndex(int *index, const KeyType &key, co
   }
 
   *index = left_index;
-  return left_index < GetSize() && comparator(array_[left_index].first, key) == 0;
+  return left_index < GetSize() && comparator(KeyAt(left_index), key) == 0;
 }
 
+/*
+ * Insert a key & value pair at index, the caller checks with HasRoomFor that
+ * it fits
+ */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertKeyValueAt(int index, const KeyType &key, const ValueType &value) {
-  for (int i = GetSize(); i > index; i--) {
-    array_[i] = array_[i - 1];
-  }
-  array_[index].first = key;
-  array_[index].second = value;
+  entries_.InsertAt(GetSize(), index, key, value);
   IncreaseSize(1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveKeyValueAt(int index) {
-  for (int i = index; i < GetSize() - 1; i++) {
-    array_[i] = array_[i + 1];
-  }
+  entries_.RemoveAt(GetSize(), index);
   IncreaseSize(-1);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetEntries(const MappingType *entries, int num_entries) {
+  entries_.Assign(entries, num_entries);
+  SetSize(num_entries);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomFor(int num_entries, const KeyType &key) const -> bool {
+  return entries_.HasRoomFor(GetSize(), num_entries, key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomFor(const MappingType *entries, int num_entries) -> bool {
+  return EntryArray::HasRoomFor(entries, num_entries);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsHalfFull(int num_entries) const -> bool {
+  return ELIDES_KEY_BYTES && entries_.IsHalfFull(num_entries);
+}
+
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeLeafPage<GenericKey<128>, RID, GenericComparator<128>>;
+template class BPlusTreeLeafPage<GenericKey<256>, RID, GenericComparator<256>>;
+template class BPlusTreeLeafPage<GenericKey<4>, RID, IntegerComparator<4, int32_t>>;
+template class BPlusTreeLeafPage<GenericKey<8>, RID, IntegerComparator<8, int64_t>>;
+template class BPlusTreeLeafPage<GenericKey<8>, RID, IntegerColumnsComparator<8>>;
+template class BPlusTreeLeafPage<GenericKey<16>, RID, IntegerColumnsComparator<16>>;
+template class BPlusTreeLeafPage<GenericKey<32>, RID, IntegerColumnsComparator<32>>;
+template class BPlusTreeLeafPage<GenericKey<64>, RID, IntegerColumnsComparator<64>>;
 }  // namespace bustub
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_search.cpp
+//
+// Identification: src/storage/page/b_plus_tree_search.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_search.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define BUSTUB_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace bustub {
+
+namespace {
+
+/** Binary search stops once this many bytes of keys are left, and they are scanned instead. */
+constexpr int SCAN_BYTES = 128;
+
+template <typename IntType>
+inline auto LoadKey(const char *keys, int index) -> IntType {
+  IntType key;
+  memcpy(&key, keys + static_cast<size_t>(index) * sizeof(IntType), sizeof(IntType));
+  return key;
+}
+
+template <typename IntType>
+auto CountLessScalar(const char *keys, int num_keys, IntType key) -> int {
+  int count = 0;
+  for (int i = 0; i < num_keys; i++) {
+    count += static_cast<int>(LoadKey<IntType>(keys, i) < key);
+  }
+  return count;
+}
+
+#ifdef BUSTUB_X86_SIMD
+
+auto HasAvx2() -> bool {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2") != 0;
+  return has_avx2;
+}
+
+__attribute__((target("avx2"))) auto CountLessAvx2(const char *keys, int num_keys, int32_t key) -> int {
+  const __m256i key_vector = _mm256_set1_epi32(key);
+  int count = 0;
+  int i = 0;
+  for (; i + 8 <= num_keys; i += 8) {
+    auto keys_vector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i * sizeof(int32_t)));
+    auto less = _mm256_cmpgt_epi32(key_vector, keys_vector);
+    count += __builtin_popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(less))));
+  }
+  return count + CountLessScalar<int32_t>(keys + i * sizeof(int32_t), num_keys - i, key);
+}
+
+__attribute__((target("avx2"))) auto CountLessAvx2(const char *keys, int num_keys, int64_t key) -> int {
+  const __m256i key_vector = _mm256_set1_epi64x(key);
+  int count = 0;
+  int i = 0;
+  for (; i + 4 <= num_keys; i += 4) {
+    auto keys_vector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i * sizeof(int64_t)));
+    auto less = _mm256_cmpgt_epi64(key_vector, keys_vector);
+    count += __builtin_popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(less))));
+  }
+  return count + CountLessScalar<int64_t>(keys + i * sizeof(int64_t), num_keys - i, key);
+}
+
+auto CountLessSse2(const char *keys, int num_keys, int32_t key) -> int {
+  const __m128i key_vector = _mm_set1_epi32(key);
+  int count = 0;
+  int i = 0;
+  for (; i + 4 <= num_keys; i += 4) {
+    auto keys_vector = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i * sizeof(int32_t)));
+    auto less = _mm_cmpgt_epi32(key_vector, keys_vector);
+    count += __builtin_popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(less))));
+  }
+  return count + CountLessScalar<int32_t>(keys + i * sizeof(int32_t), num_keys - i, key);
+}
+
+#endif
+
+auto CountLess(const char *keys, int num_keys, int32_t key) -> int {
+#ifdef BUSTUB_X86_SIMD
+  return HasAvx2() ? CountLessAvx2(keys, num_keys, key) : CountLessSse2(keys, num_keys, key);
+#else
+  return CountLessScalar(keys, num_keys, key);
+#endif
+}
+
+auto CountLess(const char *keys, int num_keys, int64_t key) -> int {
+#ifdef BUSTUB_X86_SIMD
+  if (HasAvx2()) {
+    return CountLessAvx2(keys, num_keys, key);
+  }
+#endif
+  return CountLessScalar(keys, num_keys, key);
+}
+
+template <typename IntType>
+auto LowerBound(const char *keys, int num_keys, IntType key) -> int {
+  constexpr int scan_keys = SCAN_BYTES / sizeof(IntType);
+  int left_index = 0;
+  int right_index = num_keys;
+  while (right_index - left_index > scan_keys) {
+    int middle_index = (left_index + right_index) >> 1;
+    if (LoadKey<IntType>(keys, middle_index) < key) {
+      left_index = middle_index + 1;
+    } else {
+      right_index = middle_index;
+    }
+  }
+  return left_index + CountLess(keys + left_index * sizeof(IntType), right_index - left_index, key);
+}
+
+}  // namespace
+
+auto IntegerLowerBound(const char *keys, int num_keys, int32_t key) -> int { return LowerBound(keys, num_keys, key); }
+
+auto IntegerLowerBound(const char *keys, int num_keys, int64_t key) -> int { return LowerBound(keys, num_keys, key); }
+
+}  // namespace bustub
@@ -0,0 +1,201 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.cpp
+//
+// Identification: src/storage/page/pax_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/pax_page.h"
+
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** Minipages start at aligned offsets, so that values are read and written at aligned addresses. */
+constexpr uint32_t PAX_ALIGNMENT = 8;
+
+auto AlignUp(uint32_t size, uint32_t alignment) -> uint32_t { return (size + alignment - 1) / alignment * alignment; }
+
+}  // namespace
+
+PaxLayout::PaxLayout(const Schema &schema) : schema_(schema) {
+  for (const auto &column : schema_.GetColumns()) {
+    // Fixed-length values are naturally aligned. A VARCHAR value is serialized as its length followed by the string and
+    // its terminating '\0', the entry is padded so that the next length is aligned.
+    auto width = column.IsInlined()
+                     ? column.GetFixedLength()
+                     : AlignUp(sizeof(uint32_t) + column.GetVariableLength() + 1, sizeof(uint32_t));
+    column_widths_.push_back(width);
+    tuple_width_ += width;
+  }
+
+  // Every slot takes one byte for its state and one entry in every minipage, and each minipage may need padding.
+  uint32_t reserved = PaxPage::SIZE_PAX_PAGE_HEADER + PAX_ALIGNMENT * static_cast<uint32_t>(column_widths_.size());
+  capacity_ = reserved < BUSTUB_PAGE_SIZE ? (BUSTUB_PAGE_SIZE - reserved) / (1 + tuple_width_) : 0;
+  uint32_t offset = PaxPage::SIZE_PAX_PAGE_HEADER + capacity_;
+  for (auto width : column_widths_) {
+    offset = AlignUp(offset, PAX_ALIGNMENT);
+    minipage_offsets_.push_back(offset);
+    offset += width * capacity_;
+  }
+}
+
+auto PaxLayout::Fits(const Tuple &tuple) const -> bool {
+  for (uint32_t i = 0; i < schema_.GetColumnCount(); i++) {
+    if (schema_.GetColumn(i).IsInlined()) {
+      continue;
+    }
+    auto value = tuple.GetValue(&schema_, i);
+    if (!value.IsNull() && sizeof(uint32_t) + value.GetLength() > column_widths_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PaxPage::Init(page_id_t page_id, page_id_t prev_page_id) {
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
+  memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  SetSlotCount(0);
+  SetLiveTupleCount(0);
+}
+
+auto PaxPage::InsertTuple(const PaxLayout &layout, const Tuple &tuple, RID *rid) -> bool {
+  if (GetLiveTupleCount() >= layout.GetCapacity()) {
+    return false;
+  }
+
+  // Reuse a freed slot, or claim a new one. Slots of tuples marked as deleted are kept for a rollback.
+  uint32_t slot_num;
+  for (slot_num = 0; slot_num < GetSlotCount(); slot_num++) {
+    if (GetSlotState(slot_num) == SLOT_FREE) {
+      break;
+    }
+  }
+  if (slot_num == GetSlotCount()) {
+    if (slot_num == layout.GetCapacity()) {
+      return false;
+    }
+    SetSlotCount(slot_num + 1);
+  }
+
+  WriteTuple(layout, tuple, slot_num);
+  SetSlotState(slot_num, SLOT_LIVE);
+  SetLiveTupleCount(GetLiveTupleCount() + 1);
+  rid->Set(GetTablePageId(), slot_num);
+  return true;
+}
+
+auto PaxPage::MarkDelete(const RID &rid) -> bool {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetSlotCount() || GetSlotState(slot_num) != SLOT_LIVE) {
+    return false;
+  }
+  SetSlotState(slot_num, SLOT_DELETED);
+  return true;
+}
+
+auto PaxPage::UpdateTuple(const PaxLayout &layout, const Tuple &new_tuple, Tuple *old_tuple, const RID &rid) -> bool {
+  if (!GetTuple(layout, rid, old_tuple)) {
+    return false;
+  }
+  WriteTuple(layout, new_tuple, rid.GetSlotNum());
+  return true;
+}
+
+void PaxPage::ApplyDelete(const RID &rid) {
+  uint32_t slot_num = rid.GetSlotNum();
+  BUSTUB_ASSERT(slot_num < GetSlotCount(), "Cannot have more slots than tuples.");
+  BUSTUB_ASSERT(GetSlotState(slot_num) != SLOT_FREE, "The tuple must exist.");
+  SetSlotState(slot_num, SLOT_FREE);
+  SetLiveTupleCount(GetLiveTupleCount() - 1);
+}
+
+void PaxPage::RollbackDelete(const RID &rid) {
+  uint32_t slot_num = rid.GetSlotNum();
+  BUSTUB_ASSERT(slot_num < GetSlotCount(), "We can't have more slots than tuples.");
+  if (GetSlotState(slot_num) == SLOT_DELETED) {
+    SetSlotState(slot_num, SLOT_LIVE);
+  }
+}
+
+auto PaxPage::GetTuple(const PaxLayout &layout, const RID &rid, Tuple *tuple,
+                       const std::vector<uint32_t> *column_ids) -> bool {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetSlotCount() || GetSlotState(slot_num) != SLOT_LIVE) {
+    return false;
+  }
+
+  const auto &schema = layout.GetSchema();
+  std::vector<Value> values;
+  values.reserve(schema.GetColumnCount());
+  if (column_ids == nullptr) {
+    for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+      values.push_back(Value::DeserializeFrom(GetEntry(layout, i, slot_num), schema.GetColumn(i).GetType()));
+    }
+  } else {
+    for (const auto &column : schema.GetColumns()) {
+      values.push_back(ValueFactory::GetNullValueByType(column.GetType()));
+    }
+    for (auto column_idx : *column_ids) {
+      values[column_idx] =
+          Value::DeserializeFrom(GetEntry(layout, column_idx, slot_num), schema.GetColumn(column_idx).GetType());
+    }
+  }
+  // rid may be the rid of the output tuple itself, e.g. when called by TableIterator.
+  RID tuple_rid = rid;
+  *tuple = Tuple(std::move(values), &schema);
+  tuple->rid_ = tuple_rid;
+  return true;
+}
+
+auto PaxPage::Compact() -> uint32_t {
+  uint32_t slot_count = GetSlotCount();
+  uint32_t new_slot_count = slot_count;
+  while (new_slot_count > 0 && GetSlotState(new_slot_count - 1) == SLOT_FREE) {
+    new_slot_count--;
+  }
+  SetSlotCount(new_slot_count);
+  return slot_count - new_slot_count;
+}
+
+auto PaxPage::GetFirstTupleRid(RID *first_rid) -> bool {
+  for (uint32_t i = 0; i < GetSlotCount(); i++) {
+    if (GetSlotState(i) == SLOT_LIVE) {
+      first_rid->Set(GetTablePageId(), i);
+      return true;
+    }
+  }
+  first_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+auto PaxPage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool {
+  BUSTUB_ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
+  for (auto i = cur_rid.GetSlotNum() + 1; i < GetSlotCount(); i++) {
+    if (GetSlotState(i) == SLOT_LIVE) {
+      next_rid->Set(GetTablePageId(), i);
+      return true;
+    }
+  }
+  next_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+void PaxPage::WriteTuple(const PaxLayout &layout, const Tuple &tuple, uint32_t slot_num) {
+  const auto &schema = layout.GetSchema();
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    tuple.GetValue(&schema, i).SerializeTo(GetEntry(layout, i, slot_num));
+  }
+}
+
+}  // namespace bustub
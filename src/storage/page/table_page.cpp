@@ -39,7 +39,8 @@ auto TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, Lock
                             LogManager *log_manager) -> bool {
   BUSTUB_ASSERT(tuple.size_ > 0, "Cannot have empty tuples.");
   // If there is not enough space, then return false.
-  if (GetFreeSpaceRemaining() < tuple.size_ + SIZE_TUPLE) {
+  uint32_t tuple_space = AlignedSize(tuple.size_);
+  if (GetFreeSpaceRemaining() < tuple_space + SIZE_TUPLE) {
     return false;
   }
 
@@ -54,12 +55,12 @@ auto TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, Lock
   }
 
   // If there was no free slot left, and we cannot claim it from the free space, then we give up.
-  if (i == GetTupleCount() && GetFreeSpaceRemaining() < tuple.size_ + SIZE_TUPLE) {
+  if (i == GetTupleCount() && GetFreeSpaceRemaining() < tuple_space + SIZE_TUPLE) {
     return false;
   }
 
   // Otherwise we claim available free space..
-  SetFreeSpacePointer(GetFreeSpacePointer() - tuple.size_);
+  SetFreeSpacePointer(GetFreeSpacePointer() - tuple_space);
   memcpy(GetData() + GetFreeSpacePointer(), tuple.data_, tuple.size_);
 
   // Set the tuple.
@@ -156,7 +157,9 @@ auto TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
     return false;
   }
   // If there is not enuogh space to update, we need to update via delete followed by an insert (not enough space).
-  if (GetFreeSpaceRemaining() + tuple_size < new_tuple.size_) {
+  uint32_t old_space = AlignedSize(tuple_size);
+  uint32_t new_space = AlignedSize(new_tuple.size_);
+  if (GetFreeSpaceRemaining() + old_space < new_space) {
     return false;
   }
 
@@ -192,23 +195,23 @@ auto TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
   uint32_t free_space_pointer = GetFreeSpacePointer();
   BUSTUB_ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
 
-  memmove(GetData() + free_space_pointer + tuple_size - new_tuple.size_, GetData() + free_space_pointer,
+  memmove(GetData() + free_space_pointer + old_space - new_space, GetData() + free_space_pointer,
           tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size - new_tuple.size_);
-  memcpy(GetData() + tuple_offset + tuple_size - new_tuple.size_, new_tuple.data_, new_tuple.size_);
+  SetFreeSpacePointer(free_space_pointer + old_space - new_space);
+  memcpy(GetData() + tuple_offset + old_space - new_space, new_tuple.data_, new_tuple.size_);
   SetTupleSize(slot_num, new_tuple.size_);
 
   // Update all tuple offsets.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
     uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
     if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + tuple_size) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - new_tuple.size_);
+      SetTupleOffsetAtSlot(i, tuple_offset_i + old_space - new_space);
     }
   }
   return true;
 }
 
-void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager) {
+void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager, Tuple *deleted_tuple) {
   uint32_t slot_num = rid.GetSlotNum();
   BUSTUB_ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
 
@@ -227,6 +230,9 @@ void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_ma
   memcpy(delete_tuple.data_, GetData() + tuple_offset, delete_tuple.size_);
   delete_tuple.rid_ = rid;
   delete_tuple.allocated_ = true;
+  if (deleted_tuple != nullptr) {
+    *deleted_tuple = delete_tuple;
+  }
 
   /**
    * Removed to support new lock manager API for p4 (multilevel locking); Big hack energy
@@ -244,9 +250,10 @@ void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_ma
   uint32_t free_space_pointer = GetFreeSpacePointer();
   BUSTUB_ASSERT(tuple_offset >= free_space_pointer, "Free space appears before tuples.");
 
-  memmove(GetData() + free_space_pointer + tuple_size, GetData() + free_space_pointer,
+  uint32_t tuple_space = AlignedSize(tuple_size);
+  memmove(GetData() + free_space_pointer + tuple_space, GetData() + free_space_pointer,
           tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size);
+  SetFreeSpacePointer(free_space_pointer + tuple_space);
   SetTupleSize(slot_num, 0);
   SetTupleOffsetAtSlot(slot_num, 0);
 
@@ -254,7 +261,7 @@ void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_ma
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
     uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
     if (GetTupleSize(i) != 0 && tuple_offset_i < tuple_offset) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size);
+      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_space);
     }
   }
 }
@@ -326,6 +333,38 @@ auto TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
   return true;
 }
 
+auto TablePage::GetTupleView(const RID &rid, TupleView *view) -> bool {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return false;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  if (IsDeleted(tuple_size)) {
+    return false;
+  }
+  *view = TupleView(GetData() + GetTupleOffsetAtSlot(slot_num), tuple_size, rid);
+  return true;
+}
+
+auto TablePage::Compact() -> uint32_t {
+  uint32_t tuple_count = GetTupleCount();
+  uint32_t new_tuple_count = tuple_count;
+  while (new_tuple_count > 0 && GetTupleSize(new_tuple_count - 1) == 0) {
+    new_tuple_count--;
+  }
+  SetTupleCount(new_tuple_count);
+  return tuple_count - new_tuple_count;
+}
+
+auto TablePage::IsEmpty() -> bool {
+  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
+    if (GetTupleSize(i) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 auto TablePage::GetFirstTupleRid(RID *first_rid) -> bool {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
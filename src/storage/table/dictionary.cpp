@@ -0,0 +1,207 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// dictionary.cpp
+//
+// Identification: src/storage/table/dictionary.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/dictionary.h"
+
+#include <algorithm>
+#include <mutex>  // NOLINT
+
+#include "storage/page/dictionary_page.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the schema of the encoded tuples, where the codes of an encoded column are INTEGERs */
+auto MakeEncodedSchema(const Schema &schema) -> Schema {
+  std::vector<Column> columns;
+  columns.reserve(schema.GetColumnCount());
+  for (const auto &column : schema.GetColumns()) {
+    if (column.IsDictionaryEncoded()) {
+      columns.emplace_back(column.GetName(), TypeId::INTEGER);
+    } else {
+      columns.emplace_back(column.GetName(), column);
+    }
+  }
+  return Schema(columns);
+}
+
+}  // namespace
+
+Dictionary::Dictionary(BufferPoolManager *buffer_pool_manager, const Schema &schema, page_id_t first_page_id)
+    : buffer_pool_manager_(buffer_pool_manager),
+      schema_(schema),
+      encoded_schema_(MakeEncodedSchema(schema)),
+      first_page_id_(first_page_id) {
+  for (const auto &column : schema_.GetColumns()) {
+    is_encoded_.push_back(column.IsDictionaryEncoded());
+  }
+
+  if (first_page_id_ == INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<DictionaryPage *>(buffer_pool_manager_->NewPage(&first_page_id_));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't create a page for the dictionary.");
+    page->Init(first_page_id_);
+    buffer_pool_manager_->UnpinPage(first_page_id_, true);
+    last_page_id_ = first_page_id_;
+    return;
+  }
+
+  // Read the values back in code order.
+  std::string data;
+  for (auto page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<DictionaryPage *>(buffer_pool_manager_->FetchPage(page_id));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch a page of the dictionary.");
+    data.append(page->GetPayload(), page->GetDataSize());
+    auto next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    last_page_id_ = page_id;
+    page_id = next_page_id;
+  }
+  size_t offset = 0;
+  while (offset < data.size()) {
+    uint32_t len;
+    memcpy(&len, data.data() + offset, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    codes_.emplace(data.substr(offset, len), static_cast<int32_t>(values_.size()));
+    values_.emplace_back(data.substr(offset, len));
+    offset += len;
+  }
+}
+
+auto Dictionary::HasEncodedColumns(const Schema &schema) -> bool {
+  const auto &columns = schema.GetColumns();
+  return std::any_of(columns.begin(), columns.end(), [](const Column &column) { return column.IsDictionaryEncoded(); });
+}
+
+auto Dictionary::Size() -> size_t {
+  std::shared_lock lock(latch_);
+  return values_.size();
+}
+
+auto Dictionary::Lookup(const std::string &value) -> std::optional<int32_t> {
+  std::shared_lock lock(latch_);
+  auto it = codes_.find(value);
+  if (it == codes_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+auto Dictionary::EncodeTuple(const Tuple &tuple, Tuple *encoded) -> bool {
+  std::vector<Value> values;
+  values.reserve(schema_.GetColumnCount());
+  for (uint32_t i = 0; i < schema_.GetColumnCount(); i++) {
+    auto value = tuple.GetValue(&schema_, i);
+    if (!is_encoded_[i]) {
+      values.push_back(std::move(value));
+    } else if (value.IsNull()) {
+      values.push_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+    } else {
+      auto code = Encode(value.ToString());
+      if (!code.has_value()) {
+        return false;
+      }
+      values.push_back(ValueFactory::GetIntegerValue(*code));
+    }
+  }
+  RID rid = tuple.GetRid();
+  *encoded = Tuple(std::move(values), &encoded_schema_);
+  encoded->rid_ = rid;
+  return true;
+}
+
+void Dictionary::DecodeTuple(Tuple *tuple, const std::vector<uint32_t> *column_ids) {
+  std::vector<Value> values;
+  values.reserve(schema_.GetColumnCount());
+  {
+    std::shared_lock lock(latch_);
+    for (uint32_t i = 0; i < schema_.GetColumnCount(); i++) {
+      auto value = tuple->GetValue(&encoded_schema_, i);
+      if (!is_encoded_[i]) {
+        values.push_back(std::move(value));
+      } else if (value.IsNull() ||
+                 (column_ids != nullptr && std::find(column_ids->begin(), column_ids->end(), i) == column_ids->end())) {
+        values.push_back(ValueFactory::GetNullValueByType(TypeId::VARCHAR));
+      } else {
+        values.push_back(ValueFactory::GetVarcharValue(values_[value.GetAs<int32_t>()]));
+      }
+    }
+  }
+  RID rid = tuple->GetRid();
+  *tuple = Tuple(std::move(values), &schema_);
+  tuple->rid_ = rid;
+}
+
+auto Dictionary::Encode(const std::string &value) -> std::optional<int32_t> {
+  if (auto code = Lookup(value); code.has_value()) {
+    return code;
+  }
+  std::unique_lock lock(latch_);
+  // Another thread may have added the value while we did not hold the latch.
+  if (auto it = codes_.find(value); it != codes_.end()) {
+    return it->second;
+  }
+  auto len = static_cast<uint32_t>(value.size());
+  std::string entry(reinterpret_cast<const char *>(&len), sizeof(uint32_t));
+  entry += value;
+  if (!AppendToChain(entry.data(), static_cast<uint32_t>(entry.size()))) {
+    return std::nullopt;
+  }
+  auto code = static_cast<int32_t>(values_.size());
+  values_.push_back(value);
+  codes_.emplace(value, code);
+  return code;
+}
+
+auto Dictionary::AppendToChain(const char *data, uint32_t size) -> bool {
+  auto last_page = reinterpret_cast<DictionaryPage *>(buffer_pool_manager_->FetchPage(last_page_id_));
+  if (last_page == nullptr) {
+    return false;
+  }
+  // Allocate the new pages first, so that a failure does not leave a partial value at the end of the chain.
+  std::vector<page_id_t> new_page_ids;
+  for (auto room = DictionaryPage::PAYLOAD_SIZE - last_page->GetDataSize(); room < size;
+       room += DictionaryPage::PAYLOAD_SIZE) {
+    page_id_t page_id;
+    auto page = reinterpret_cast<DictionaryPage *>(buffer_pool_manager_->NewPage(&page_id));
+    if (page == nullptr) {
+      buffer_pool_manager_->UnpinPage(last_page_id_, false);
+      for (auto new_page_id : new_page_ids) {
+        buffer_pool_manager_->DeletePage(new_page_id);
+      }
+      return false;
+    }
+    page->Init(page_id);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    new_page_ids.push_back(page_id);
+  }
+
+  auto appended = last_page->Append(data, size);
+  if (!new_page_ids.empty()) {
+    last_page->SetNextPageId(new_page_ids.front());
+  }
+  buffer_pool_manager_->UnpinPage(last_page_id_, true);
+  for (size_t i = 0; i < new_page_ids.size(); i++) {
+    auto page = reinterpret_cast<DictionaryPage *>(buffer_pool_manager_->FetchPage(new_page_ids[i]));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch a page of the dictionary.");
+    appended += page->Append(data + appended, size - appended);
+    if (i + 1 < new_page_ids.size()) {
+      page->SetNextPageId(new_page_ids[i + 1]);
+    }
+    buffer_pool_manager_->UnpinPage(new_page_ids[i], true);
+    last_page_id_ = new_page_ids[i];
+  }
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+namespace {
+
+constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+/** Round down, so that a page in a category has at least category * CATEGORY_SIZE free bytes. */
+auto ToCategory(uint32_t free_space) -> uint8_t {
+  return static_cast<uint8_t>(std::min<uint32_t>(free_space / FreeSpaceMap::CATEGORY_SIZE, UINT8_MAX));
+}
+
+}  // namespace
+
+void FreeSpaceMap::Update(page_id_t page_id, uint32_t free_space) {
+  std::scoped_lock lock(latch_);
+  auto it = positions_.find(page_id);
+  size_t pos;
+  if (it != positions_.end()) {
+    pos = it->second;
+  } else {
+    pos = page_ids_.size();
+    if (pos == capacity_) {
+      // Double the tree and rebuild the inner nodes from the leaves.
+      size_t new_capacity = std::max<size_t>(1, capacity_ * 2);
+      std::vector<uint8_t> new_tree(2 * new_capacity, 0);
+      std::copy(tree_.begin() + capacity_, tree_.begin() + 2 * capacity_, new_tree.begin() + new_capacity);
+      for (size_t node = new_capacity - 1; node > 0; node--) {
+        new_tree[node] = std::max(new_tree[2 * node], new_tree[2 * node + 1]);
+      }
+      tree_ = std::move(new_tree);
+      capacity_ = new_capacity;
+    }
+    positions_.emplace(page_id, pos);
+    page_ids_.push_back(page_id);
+  }
+
+  SetCategory(pos, ToCategory(free_space));
+}
+
+void FreeSpaceMap::Remove(page_id_t page_id) {
+  std::scoped_lock lock(latch_);
+  auto it = positions_.find(page_id);
+  if (it == positions_.end()) {
+    return;
+  }
+  size_t pos = it->second;
+  positions_.erase(it);
+
+  // Move the last page into the hole, so that the tracked pages stay at the first positions.
+  size_t last_pos = page_ids_.size() - 1;
+  if (pos != last_pos) {
+    page_id_t last_page_id = page_ids_[last_pos];
+    page_ids_[pos] = last_page_id;
+    positions_[last_page_id] = pos;
+    SetCategory(pos, tree_[capacity_ + last_pos]);
+  }
+  page_ids_.pop_back();
+  SetCategory(last_pos, 0);
+}
+
+auto FreeSpaceMap::FindPage(uint32_t needed, size_t hint) -> page_id_t {
+  // Round up, so that any page in the category found is guaranteed to have room.
+  uint32_t category = (needed + CATEGORY_SIZE - 1) / CATEGORY_SIZE;
+  std::scoped_lock lock(latch_);
+  if (page_ids_.empty() || category > UINT8_MAX || tree_[1] < category) {
+    return INVALID_PAGE_ID;
+  }
+  auto wanted = static_cast<uint8_t>(category);
+  size_t pos = FindFrom(1, 0, capacity_, hint % page_ids_.size(), wanted);
+  if (pos == NOT_FOUND) {
+    pos = FindFrom(1, 0, capacity_, 0, wanted);
+  }
+  return page_ids_[pos];
+}
+
+auto FreeSpaceMap::GetFreeSpace(page_id_t page_id) -> uint32_t {
+  std::scoped_lock lock(latch_);
+  auto it = positions_.find(page_id);
+  if (it == positions_.end()) {
+    return 0;
+  }
+  return tree_[capacity_ + it->second] * CATEGORY_SIZE;
+}
+
+auto FreeSpaceMap::Size() -> size_t {
+  std::scoped_lock lock(latch_);
+  return page_ids_.size();
+}
+
+auto FreeSpaceMap::GetPageIds() -> std::vector<page_id_t> {
+  std::scoped_lock lock(latch_);
+  return page_ids_;
+}
+
+void FreeSpaceMap::SetCategory(size_t pos, uint8_t category) {
+  size_t node = capacity_ + pos;
+  tree_[node] = category;
+  for (node /= 2; node > 0; node /= 2) {
+    tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
+  }
+}
+
+auto FreeSpaceMap::FindFrom(size_t node, size_t node_begin, size_t node_end, size_t from, uint8_t category)
+    -> size_t {
+  if (node_end <= from || tree_[node] < category) {
+    return NOT_FOUND;
+  }
+  if (node_end - node_begin == 1) {
+    return node_begin;
+  }
+  size_t mid = node_begin + (node_end - node_begin) / 2;
+  size_t pos = FindFrom(2 * node, node_begin, mid, from, category);
+  if (pos != NOT_FOUND) {
+    return pos;
+  }
+  return FindFrom(2 * node + 1, mid, node_end, from, category);
+}
+
+}  // namespace bustub
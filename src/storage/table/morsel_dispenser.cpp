@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_dispenser.cpp
+//
+// Identification: src/storage/table/morsel_dispenser.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/morsel_dispenser.h"
+
+#include <shared_mutex>
+
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+MorselDispenser::MorselDispenser(TableHeap *table_heap, size_t morsel_size, Transaction *txn)
+    : table_heap_(table_heap), morsel_size_(morsel_size), txn_(txn) {
+  BUSTUB_ASSERT(morsel_size_ > 0, "A morsel holds at least one page.");
+  std::shared_lock vacuum_lock(table_heap_->vacuum_latch_);
+  next_page_id_ = table_heap_->first_page_id_;
+  if (next_page_id_ != INVALID_PAGE_ID) {
+    table_heap_->num_scans_++;
+    holds_scan_ = true;
+  }
+}
+
+MorselDispenser::~MorselDispenser() {
+  // The workers may still be visiting the morsels they claimed until the dispenser goes away.
+  if (holds_scan_) {
+    table_heap_->num_scans_--;
+  }
+}
+
+auto MorselDispenser::Next(Morsel *morsel) -> bool {
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  std::scoped_lock lock(latch_);
+  if (next_page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  morsel->index_ = next_index_++;
+  morsel->page_ids_.clear();
+  while (next_page_id_ != INVALID_PAGE_ID && morsel->page_ids_.size() < morsel_size_) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(next_page_id_));
+    BUSTUB_ENSURE(page != nullptr, "BPM full");  // all pages are pinned
+    page->RLatch();
+    morsel->page_ids_.push_back(next_page_id_);
+    next_page_id_ = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager->UnpinPage(page->GetTablePageId(), false);
+  }
+  return true;
+}
+
+void MorselDispenser::VisitMorsel(const Morsel &morsel, const std::vector<uint32_t> *column_ids,
+                                  const TableScanner::Visitor &visitor,
+                                  const TableScanner::EncodedFilter &encoded_filter) {
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  for (auto page_id : morsel.page_ids_) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(page_id));
+    BUSTUB_ENSURE(page != nullptr, "BPM full");  // all pages are pinned
+    page->RLatch();
+    table_heap_->VisitPage(page, txn_, column_ids, visitor, encoded_filter);
+    page->RUnlatch();
+    buffer_pool_manager->UnpinPage(page_id, false);
+  }
+}
+
+}  // namespace bustub
@@ -10,89 +10,265 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <utility>
 
 #include "common/logger.h"
 #include "fmt/format.h"
 #include "storage/table/table_heap.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
+namespace {
+
+/** Number of pages filled by a bulk insert that are written out together. */
+constexpr size_t BULK_INSERT_FLUSH_PAGES = 64;
+
+/** A tuple larger than this has its longest VARCHAR values moved to overflow pages. */
+constexpr uint32_t TOAST_TUPLE_THRESHOLD = BUSTUB_PAGE_SIZE / 4;
+
+/** Read a word of a serialized VARCHAR value or overflow pointer, which need not be aligned. */
+auto ReadWord(const char *value, size_t word_idx) -> uint32_t {
+  uint32_t word;
+  memcpy(&word, value + word_idx * sizeof(uint32_t), sizeof(uint32_t));
+  return word;
+}
+
+/** Each inserting thread starts its free space search at a different page, so that concurrent inserters spread out. */
+auto InsertHint() -> size_t {
+  static std::atomic<size_t> next_hint{0};
+  thread_local size_t hint = next_hint++;
+  return hint;
+}
+
+}  // namespace
+
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     page_id_t first_page_id)
+                     page_id_t first_page_id, TableFormat format, const Schema *schema, page_id_t dictionary_page_id)
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id),
+      format_(format) {
+  BUSTUB_ASSERT(schema == nullptr || !Dictionary::HasEncodedColumns(*schema) || dictionary_page_id != INVALID_PAGE_ID,
+                "A dictionary encoded table heap needs its dictionary.");
+  InitLayout(schema, dictionary_page_id);
+}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     Transaction *txn)
-    : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {
+                     Transaction *txn, TableFormat format, const Schema *schema)
+    : buffer_pool_manager_(buffer_pool_manager),
+      lock_manager_(lock_manager),
+      log_manager_(log_manager),
+      format_(format) {
+  InitLayout(schema, INVALID_PAGE_ID);
   // Initialize the first table page.
   auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
   BUSTUB_ASSERT(first_page != nullptr,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
-  first_page->Init(first_page_id_, BUSTUB_PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  InitPage(first_page, first_page_id_, INVALID_PAGE_ID, txn);
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  std::call_once(free_space_map_init_, &TableHeap::InitFreeSpaceMap, this);
+}
+
+void TableHeap::InitLayout(const Schema *schema, page_id_t dictionary_page_id) {
+  if (schema != nullptr && Dictionary::HasEncodedColumns(*schema)) {
+    // The pages hold encoded tuples, so everything below is laid out for the encoded schema.
+    dictionary_ = std::make_unique<Dictionary>(buffer_pool_manager_, *schema, dictionary_page_id);
+    schema = &dictionary_->GetEncodedSchema();
+  }
+  if (format_ == TableFormat::PAX) {
+    BUSTUB_ASSERT(schema != nullptr, "A PAX table heap needs the schema of the table.");
+    pax_layout_ = std::make_unique<PaxLayout>(*schema);
+  } else if (schema != nullptr && !schema->GetUnlinedColumns().empty()) {
+    toast_schema_ = std::make_unique<Schema>(*schema);
+  }
+  if (schema != nullptr) {
+    zone_map_ = std::make_unique<ZoneMap>(*schema);
+  }
 }
 
 auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
-  if (tuple.size_ + 32 > BUSTUB_PAGE_SIZE) {  // larger than one page size
+  Tuple encoded_tuple;
+  const auto *to_encode = EncodeTuple(tuple, &encoded_tuple);
+  if (to_encode == nullptr) {  // out of dictionary pages
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  Tuple stored_tuple;
+  const auto *to_store = ToastTuple(*to_encode, &stored_tuple);
+  if (to_store == nullptr) {  // out of overflow pages
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  const auto &to_insert = *to_store;
+  if (to_insert.size_ + 32 > BUSTUB_PAGE_SIZE) {  // larger than one page size
+    FreeOverflowValues(to_insert);
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  if (pax_layout_ != nullptr && !pax_layout_->Fits(to_insert)) {  // a value is longer than its column
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  if (cur_page == nullptr) {
+  std::call_once(free_space_map_init_, &TableHeap::InitFreeSpaceMap, this);
+  std::shared_lock vacuum_lock(vacuum_latch_);
+
+  // Insert into a page which the free space map says has room. The map may be stale when another inserter got there
+  // first, in which case the real free space of the page is recorded and the next candidate is tried.
+  auto needed = pax_layout_ != nullptr ? pax_layout_->GetTupleWidth() : TablePage::GetSpaceNeeded(to_insert);
+  auto hint = InsertHint();
+  page_id_t page_id;
+  while ((page_id = free_space_map_.FindPage(needed, hint)) != INVALID_PAGE_ID) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      FreeOverflowValues(to_insert);
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    page->WLatch();
+    bool is_inserted = InsertIntoPage(page, to_insert, rid, txn);
+    UpdateFreeSpace(page);
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, is_inserted);
+    if (is_inserted) {
+      // Update the transaction's write set.
+      txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+      return true;
+    }
+  }
+
+  // No page has enough space, so the tuple goes to the end of the chain.
+  if (!AppendTuple(to_insert, rid, txn)) {
+    FreeOverflowValues(to_insert);
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
+  // Update the transaction's write set.
+  txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+  return true;
+}
 
+auto TableHeap::AppendTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
+  std::scoped_lock lock(append_latch_);
+  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id_));
+  if (cur_page == nullptr) {
+    return false;
+  }
   cur_page->WLatch();
+  // Another inserter may have freed space in the last page, or appended a new one while we waited for the latch.
+  if (InsertIntoPage(cur_page, tuple, rid, txn)) {
+    UpdateFreeSpace(cur_page);
+    cur_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+    return true;
+  }
 
-  // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
-  // INVARIANT: cur_page is WLatched if you leave the loop normally.
-  while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
-    auto next_page_id = cur_page->GetNextPageId();
-    // If the next page is a valid page,
-    if (next_page_id != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
-      next_page->WLatch();
-      // Unlatch and unpin the current page.
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
-    } else {
-      // Otherwise we have run out of valid pages. We need to create a new page.
+  page_id_t next_page_id;
+  auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
+  // If we could not create a new page, then life sucks and we abort the transaction.
+  if (new_page == nullptr) {
+    cur_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
+    return false;
+  }
+  // Otherwise we were able to create a new page. We initialize it now and link it after the last page.
+  new_page->WLatch();
+  cur_page->SetNextPageId(next_page_id);
+  InitPage(new_page, next_page_id, cur_page->GetTablePageId(), txn);
+  cur_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+
+  bool is_inserted = InsertIntoPage(new_page, tuple, rid, txn);
+  UpdateFreeSpace(new_page);
+  last_page_id_ = next_page_id;
+  new_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(next_page_id, true);
+  return is_inserted;
+}
+
+auto TableHeap::BulkInsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn)
+    -> bool {
+  std::vector<Tuple> encoded_tuples(tuples.size());
+  std::vector<Tuple> stored_tuples(tuples.size());
+  std::vector<const Tuple *> to_insert;
+  to_insert.reserve(tuples.size());
+  for (size_t i = 0; i < tuples.size(); i++) {
+    const auto *encoded = EncodeTuple(tuples[i], &encoded_tuples[i]);
+    const auto *tuple = encoded == nullptr ? nullptr : ToastTuple(*encoded, &stored_tuples[i]);
+    if (tuple == nullptr || tuple->size_ + 32 > BUSTUB_PAGE_SIZE ||
+        (pax_layout_ != nullptr && !pax_layout_->Fits(*tuple))) {
+      for (size_t j = 0; j <= i; j++) {
+        FreeOverflowValues(stored_tuples[j]);
+      }
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    to_insert.push_back(tuple);
+  }
+
+  std::call_once(free_space_map_init_, &TableHeap::InitFreeSpaceMap, this);
+
+  std::shared_lock vacuum_lock(vacuum_latch_);
+  std::scoped_lock lock(append_latch_);
+  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id_));
+  if (cur_page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  cur_page->WLatch();
+
+  // Fill the last page, then append new pages one after the other.
+  // INVARIANT: cur_page is the last page of the chain, and is WLatched.
+  std::vector<page_id_t> full_pages;
+  bool is_successful = true;
+  for (const auto *tuple : to_insert) {
+    RID rid;
+    while (!InsertIntoPage(cur_page, *tuple, &rid, txn)) {
+      page_id_t next_page_id;
       auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
-      // If we could not create a new page,
       if (new_page == nullptr) {
-        // Then life sucks and we abort the transaction.
-        cur_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-        txn->SetState(TransactionState::ABORTED);
-        return false;
+        is_successful = false;
+        break;
       }
-      // Otherwise we were able to create a new page. We initialize it now.
       new_page->WLatch();
       cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, BUSTUB_PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+      InitPage(new_page, next_page_id, cur_page->GetTablePageId(), txn);
+      UpdateFreeSpace(cur_page);
+      full_pages.push_back(cur_page->GetTablePageId());
       cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+      buffer_pool_manager_->UnpinPage(full_pages.back(), true);
+      if (full_pages.size() >= BULK_INSERT_FLUSH_PAGES) {
+        buffer_pool_manager_->FlushPages(full_pages);
+        full_pages.clear();
+      }
       cur_page = new_page;
+      last_page_id_ = next_page_id;
+    }
+    if (!is_successful) {
+      break;
     }
+    rids->push_back(rid);
+    // Update the transaction's write set.
+    txn->GetWriteSet()->emplace_back(rid, WType::INSERT, Tuple{}, this);
   }
-  // This line has caused most of us to double-take and "whoa double unlatch".
-  // We are not, in fact, double unlatching. See the invariant above.
+
+  UpdateFreeSpace(cur_page);
   cur_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-  // Update the transaction's write set.
-  txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
-  return true;
+  buffer_pool_manager_->FlushPages(full_pages);
+  if (!is_successful) {
+    txn->SetState(TransactionState::ABORTED);
+  }
+  return is_successful;
 }
 
 auto TableHeap::MarkDelete(const RID &rid, Transaction *txn) -> bool {
-  // TODO(Amadou): remove empty page
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   // If the page could not be found, then abort the transaction.
@@ -100,30 +276,97 @@ auto TableHeap::MarkDelete(const RID &rid, Transaction *txn) -> bool {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
-  // Otherwise, mark the tuple as deleted.
+  // Otherwise, mark the tuple as deleted, unless another transaction is writing it.
   page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  if (!version_store_.CanWrite(rid, txn)) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  // The tuple as it was is kept for the snapshots which do not see the delete.
+  Tuple old_tuple;
+  bool is_marked = ReadStoredTuple(page, rid, &old_tuple, txn);
+  if (is_marked) {
+    is_marked = pax_layout_ != nullptr ? reinterpret_cast<PaxPage *>(page)->MarkDelete(rid)
+                                       : page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  }
+  if (is_marked) {
+    version_store_.AddVersion(rid, old_tuple, true, txn);
+  }
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_marked);
+  if (!is_marked) {
+    return false;
+  }
   // Update the transaction's write set.
   txn->GetWriteSet()->emplace_back(rid, WType::DELETE, Tuple{}, this);
   return true;
 }
 
 auto TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) -> bool {
+  Tuple encoded_tuple;
+  const auto *to_encode = EncodeTuple(tuple, &encoded_tuple);
+  if (to_encode == nullptr) {  // out of dictionary pages
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  if (pax_layout_ != nullptr && !pax_layout_->Fits(*to_encode)) {
+    return false;
+  }
+  Tuple stored_tuple;
+  const auto *to_store = ToastTuple(*to_encode, &stored_tuple);
+  if (to_store == nullptr) {  // out of overflow pages
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  const auto &to_update = *to_store;
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   // If the page could not be found, then abort the transaction.
   if (page == nullptr) {
+    FreeOverflowValues(to_update);
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
   // Update the tuple; but first save the old value for rollbacks.
   Tuple old_tuple;
+  Tuple old_stored_tuple;
   page->WLatch();
-  bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  // An aborted transaction writes back the tuple it updated.
+  bool is_rollback = txn->GetState() == TransactionState::ABORTED;
+  if (!is_rollback && !version_store_.CanWrite(rid, txn)) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+    FreeOverflowValues(to_update);
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  bool is_updated = pax_layout_ != nullptr
+                        ? reinterpret_cast<PaxPage *>(page)->UpdateTuple(*pax_layout_, to_update, &old_tuple, rid)
+                        : page->UpdateTuple(to_update, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  if (is_updated && toast_schema_ != nullptr) {
+    // A rollback writes the old tuple back, so it must not refer to the overflow pages freed below.
+    old_stored_tuple = old_tuple;
+    DetoastTuple(&old_tuple, nullptr);
+  }
+  if (is_updated && is_rollback) {
+    version_store_.Undo(rid);
+  } else if (is_updated) {
+    version_store_.AddVersion(rid, old_tuple, false, txn);
+  }
+  if (is_updated && dictionary_ != nullptr) {
+    dictionary_->DecodeTuple(&old_tuple);
+  }
+  if (is_updated) {
+    UpdateFreeSpace(page);
+    if (zone_map_ != nullptr) {
+      zone_map_->Update(rid.GetPageId(), to_update);
+    }
+  }
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
+  FreeOverflowValues(is_updated ? old_stored_tuple : to_update);
   // Update the transaction's write set.
   if (is_updated && txn->GetState() != TransactionState::ABORTED) {
     txn->GetWriteSet()->emplace_back(rid, WType::UPDATE, old_tuple, this);
@@ -136,13 +379,17 @@ void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
   // Delete the tuple from the page.
+  Tuple deleted_tuple;
   page->WLatch();
-  page->ApplyDelete(rid, txn, log_manager_);
+  version_store_.Remove(rid);
+  RemoveFromPage(page, rid, txn, &deleted_tuple);
   /** Commented out to make compatible with p4; This is called only on commit or delete, which consequently unlocks the
    * tuple; so should be fine */
   // lock_manager_->Unlock(txn, rid);
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  // No one refers to the overflow pages of the tuple any more.
+  FreeOverflowValues(deleted_tuple);
 }
 
 void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
@@ -151,12 +398,18 @@ void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
   BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
   // Rollback the delete.
   page->WLatch();
-  page->RollbackDelete(rid, txn, log_manager_);
+  if (pax_layout_ != nullptr) {
+    reinterpret_cast<PaxPage *>(page)->RollbackDelete(rid);
+  } else {
+    page->RollbackDelete(rid, txn, log_manager_);
+  }
+  version_store_.Undo(rid);
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
 }
 
-auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock) -> bool {
+auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock,
+                         const std::vector<uint32_t> *column_ids) -> bool {
   // Find the page which contains the tuple.
   auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   // If the page could not be found, then abort the transaction.
@@ -168,7 +421,21 @@ auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool ac
   if (acquire_read_lock) {
     page->RLatch();
   }
-  bool res = page->GetTuple(rid, tuple, txn, lock_manager_);
+  // A snapshot may see an older version of the tuple, or none.
+  auto visibility = ReadsSnapshot(txn) ? version_store_.GetVisibleVersion(rid, txn, tuple)
+                                       : VersionStore::Visibility::IN_PAGE;
+  bool res = visibility == VersionStore::Visibility::OLDER;
+  if (visibility == VersionStore::Visibility::IN_PAGE) {
+    res = pax_layout_ != nullptr ? reinterpret_cast<PaxPage *>(page)->GetTuple(*pax_layout_, rid, tuple, column_ids)
+                                 : page->GetTuple(rid, tuple, txn, lock_manager_);
+    // The overflow pages are read under the page latch, as they are freed once the tuple is deleted.
+    if (res && toast_schema_ != nullptr) {
+      DetoastTuple(tuple, column_ids);
+    }
+  }
+  if (res && dictionary_ != nullptr) {
+    dictionary_->DecodeTuple(tuple, column_ids);
+  }
   if (acquire_read_lock) {
     page->RUnlatch();
   }
@@ -177,6 +444,39 @@ auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool ac
 }
 
 auto TableHeap::Begin(Transaction *txn) -> TableIterator {
+  // The iterator is registered before a vacuum can free the page of its first tuple.
+  std::shared_lock vacuum_lock(vacuum_latch_);
+  return {this, FirstTupleRid(txn), txn};
+}
+
+auto TableHeap::Begin(Transaction *txn, std::vector<uint32_t> column_ids) -> TableIterator {
+  std::shared_lock vacuum_lock(vacuum_latch_);
+  return {this, FirstTupleRid(txn), txn, std::move(column_ids)};
+}
+
+void TableHeap::CommitVersions(const RID &rid, txn_id_t txn_id, timestamp_t commit_ts) {
+  version_store_.Commit(rid, txn_id, commit_ts);
+}
+
+void TableHeap::CollectGarbage(const RID &rid, timestamp_t watermark) {
+  // A tuple with versions is still in its page, so the page was not freed.
+  if (!version_store_.Contains(rid)) {
+    return;
+  }
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
+  Tuple deleted_tuple;
+  page->WLatch();
+  bool is_deleted = version_store_.Collect(rid, watermark);
+  if (is_deleted) {
+    RemoveFromPage(page, rid, nullptr, &deleted_tuple);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), is_deleted);
+  FreeOverflowValues(deleted_tuple);
+}
+
+auto TableHeap::FirstTupleRid(const Transaction *txn) -> RID {
   // Start an iterator from the first page.
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
   RID rid;
@@ -185,7 +485,7 @@ auto TableHeap::Begin(Transaction *txn) -> TableIterator {
     auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
     page->RLatch();
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
-    auto found_tuple = page->GetFirstTupleRid(&rid);
+    auto found_tuple = GetFirstTupleRid(page, &rid, txn);
     page->RUnlatch();
     buffer_pool_manager_->UnpinPage(page_id, false);
     if (found_tuple) {
@@ -193,9 +493,447 @@ auto TableHeap::Begin(Transaction *txn) -> TableIterator {
     }
     page_id = page->GetNextPageId();
   }
-  return {this, rid, txn};
+  return rid;
 }
 
 auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
 
+auto TableHeap::GetFreeSpaceMap() -> FreeSpaceMap * {
+  std::call_once(free_space_map_init_, &TableHeap::InitFreeSpaceMap, this);
+  return &free_space_map_;
+}
+
+auto TableHeap::Vacuum() -> size_t {
+  std::call_once(free_space_map_init_, &TableHeap::InitFreeSpaceMap, this);
+  std::unique_lock vacuum_lock(vacuum_latch_);
+  std::scoped_lock append_lock(append_latch_);
+  // No new iterator can be created while we hold the vacuum latch, so the check holds until we are done.
+  bool can_free_pages = num_scans_ == 0;
+  num_deleted_ = 0;
+
+  size_t num_freed = 0;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch a page of the table heap.");
+    page->WLatch();
+    bool is_dirty = CompactPage(page);
+    auto next_page_id = page->GetNextPageId();
+
+    if (!can_free_pages || page_id == first_page_id_ || !IsPageEmpty(page)) {
+      UpdateFreeSpace(page);
+      if (zone_map_ != nullptr && IsPageEmpty(page)) {
+        zone_map_->Clear(page_id);
+      }
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, is_dirty);
+      prev_page_id = page_id;
+      page_id = next_page_id;
+      continue;
+    }
+
+    // Unlink the empty page. The other writers only touch pages with tuples, so no one else is linking pages now.
+    auto prev_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(prev_page_id));
+    BUSTUB_ASSERT(prev_page != nullptr, "Couldn't fetch a page of the table heap.");
+    prev_page->WLatch();
+    prev_page->SetNextPageId(next_page_id);
+    prev_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(prev_page_id, true);
+    if (next_page_id != INVALID_PAGE_ID) {
+      auto next_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+      BUSTUB_ASSERT(next_page != nullptr, "Couldn't fetch a page of the table heap.");
+      next_page->WLatch();
+      next_page->SetPrevPageId(prev_page_id);
+      next_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(next_page_id, true);
+    } else {
+      last_page_id_ = prev_page_id;
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    free_space_map_.Remove(page_id);
+    if (zone_map_ != nullptr) {
+      zone_map_->Remove(page_id);
+    }
+    // A reader holding a stale RID may still have the page pinned, in which case the page is simply not reused.
+    buffer_pool_manager_->DeletePage(page_id);
+    num_freed++;
+    page_id = next_page_id;
+  }
+  return num_freed;
+}
+
+auto TableHeap::SamplePages(const TableSample &sample) -> std::vector<page_id_t> {
+  std::vector<page_id_t> page_ids;
+  for (auto page_id : GetFreeSpaceMap()->GetPageIds()) {
+    if (sample.KeepsPage(page_id)) {
+      page_ids.push_back(page_id);
+    }
+  }
+  std::sort(page_ids.begin(), page_ids.end());
+  return page_ids;
+}
+
+auto TableHeap::EstimateTupleCount(size_t num_pages) -> size_t {
+  auto total_pages = GetFreeSpaceMap()->Size();
+  if (total_pages == 0) {
+    return 0;
+  }
+  TableSample sample{TableSample::Method::SYSTEM, std::min(100.0, 100.0 * num_pages / total_pages), std::nullopt};
+  // A vacuum does not free any page while we read the sample.
+  std::shared_lock vacuum_lock(vacuum_latch_);
+  auto page_ids = SamplePages(sample.WithSeed());
+  if (page_ids.empty()) {
+    page_ids.push_back(first_page_id_);
+  }
+  size_t num_tuples = 0;
+  for (auto page_id : page_ids) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    BUSTUB_ENSURE(page != nullptr, "BPM full");
+    page->RLatch();
+    RID rid;
+    bool found = GetFirstTupleRid(page, &rid);
+    while (found) {
+      num_tuples++;
+      RID next_rid;
+      found = GetNextTupleRid(page, rid, &next_rid);
+      rid = next_rid;
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+  return num_tuples * total_pages / page_ids.size();
+}
+
+auto TableHeap::NeedsVacuum() -> bool { return num_deleted_ > 0 && num_deleted_ >= GetFreeSpaceMap()->Size(); }
+
+void TableHeap::InitFreeSpaceMap() {
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch a page of the table heap.");
+    page->RLatch();
+    UpdateFreeSpace(page);
+    auto next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    last_page_id_ = page_id;
+    page_id = next_page_id;
+  }
+}
+
+void TableHeap::UpdateFreeSpace(TablePage *page) {
+  auto free_space = pax_layout_ != nullptr ? reinterpret_cast<PaxPage *>(page)->GetFreeSpaceRemaining(*pax_layout_)
+                                           : page->GetFreeSpaceRemaining();
+  free_space_map_.Update(page->GetTablePageId(), free_space);
+}
+
+void TableHeap::InitPage(TablePage *page, page_id_t page_id, page_id_t prev_page_id, Transaction *txn) {
+  if (pax_layout_ != nullptr) {
+    reinterpret_cast<PaxPage *>(page)->Init(page_id, prev_page_id);
+  } else {
+    page->Init(page_id, BUSTUB_PAGE_SIZE, prev_page_id, log_manager_, txn);
+  }
+  if (zone_map_ != nullptr) {
+    zone_map_->AddPage(page_id);
+  }
+}
+
+auto TableHeap::InsertIntoPage(TablePage *page, const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
+  bool is_inserted = pax_layout_ != nullptr
+                         ? reinterpret_cast<PaxPage *>(page)->InsertTuple(*pax_layout_, tuple, rid)
+                         : page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_);
+  if (is_inserted && zone_map_ != nullptr) {
+    zone_map_->Update(page->GetTablePageId(), tuple);
+  }
+  if (is_inserted) {
+    version_store_.AddInsert(*rid, txn);
+  }
+  return is_inserted;
+}
+
+auto TableHeap::ReadStoredTuple(TablePage *page, const RID &rid, Tuple *tuple, Transaction *txn) -> bool {
+  if (pax_layout_ != nullptr) {
+    return reinterpret_cast<PaxPage *>(page)->GetTuple(*pax_layout_, rid, tuple);
+  }
+  if (!page->GetTuple(rid, tuple, txn, lock_manager_)) {
+    return false;
+  }
+  if (toast_schema_ != nullptr) {
+    DetoastTuple(tuple, nullptr);
+  }
+  return true;
+}
+
+void TableHeap::RemoveFromPage(TablePage *page, const RID &rid, Transaction *txn, Tuple *deleted_tuple) {
+  if (pax_layout_ != nullptr) {
+    reinterpret_cast<PaxPage *>(page)->ApplyDelete(rid);
+  } else {
+    page->ApplyDelete(rid, txn, log_manager_, toast_schema_ != nullptr ? deleted_tuple : nullptr);
+  }
+  UpdateFreeSpace(page);
+  num_deleted_++;
+}
+
+auto TableHeap::EncodeTuple(const Tuple &tuple, Tuple *encoded) -> const Tuple * {
+  if (dictionary_ == nullptr) {
+    return &tuple;
+  }
+  return dictionary_->EncodeTuple(tuple, encoded) ? encoded : nullptr;
+}
+
+auto TableHeap::ToastTuple(const Tuple &tuple, Tuple *stored) -> const Tuple * {
+  if (toast_schema_ == nullptr || tuple.size_ <= TOAST_TUPLE_THRESHOLD) {
+    return &tuple;
+  }
+  const auto &schema = *toast_schema_;
+
+  // Move the longest values first, until the tuple is small enough.
+  std::vector<std::pair<uint32_t, uint32_t>> lengths;
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    auto len = ReadWord(tuple.GetDataPtr(&schema, column_idx), 0);
+    if (len != BUSTUB_VALUE_NULL && sizeof(uint32_t) + len > OverflowPage::POINTER_SIZE) {
+      lengths.emplace_back(len, column_idx);
+    }
+  }
+  std::sort(lengths.begin(), lengths.end(), std::greater<>());
+  std::vector<bool> is_toasted(schema.GetColumnCount(), false);
+  uint32_t stored_size = tuple.size_;
+  for (const auto &[len, column_idx] : lengths) {
+    if (stored_size <= TOAST_TUPLE_THRESHOLD) {
+      break;
+    }
+    is_toasted[column_idx] = true;
+    stored_size -= sizeof(uint32_t) + len - OverflowPage::POINTER_SIZE;
+  }
+  if (stored_size + 32 > BUSTUB_PAGE_SIZE) {  // the insert fails anyway
+    return &tuple;
+  }
+
+  // Lay out the stored tuple as the Tuple constructor does, with pointers in place of the values moved.
+  std::vector<page_id_t> chains;
+  std::vector<char> data(tuple.data_, tuple.data_ + schema.GetLength());
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    const char *value = tuple.GetDataPtr(&schema, column_idx);
+    auto len = ReadWord(value, 0);
+    auto offset = static_cast<uint32_t>(data.size());
+    memcpy(data.data() + schema.GetColumn(column_idx).GetOffset(), &offset, sizeof(uint32_t));
+    if (!is_toasted[column_idx]) {
+      auto size = sizeof(uint32_t) + (len == BUSTUB_VALUE_NULL ? 0 : len);
+      data.insert(data.end(), value, value + size);
+      continue;
+    }
+    auto first_page_id = WriteOverflowValue(value + sizeof(uint32_t), len);
+    if (first_page_id == INVALID_PAGE_ID) {
+      for (auto chain : chains) {
+        FreeOverflowChain(chain);
+      }
+      return nullptr;
+    }
+    chains.push_back(first_page_id);
+    std::array<uint32_t, 3> pointer{OverflowPage::POINTER_MARKER, len, static_cast<uint32_t>(first_page_id)};
+    const auto *pointer_data = reinterpret_cast<const char *>(pointer.data());
+    data.insert(data.end(), pointer_data, pointer_data + OverflowPage::POINTER_SIZE);
+  }
+
+  if (stored->allocated_) {
+    delete[] stored->data_;
+  }
+  stored->size_ = data.size();
+  stored->data_ = new char[stored->size_];
+  memcpy(stored->data_, data.data(), stored->size_);
+  stored->allocated_ = true;
+  return stored;
+}
+
+void TableHeap::DetoastTuple(Tuple *tuple, const std::vector<uint32_t> *column_ids) {
+  const auto &schema = *toast_schema_;
+  auto is_pointer = [&](uint32_t column_idx) {
+    return ReadWord(tuple->GetDataPtr(&schema, column_idx), 0) == OverflowPage::POINTER_MARKER;
+  };
+  const auto &uninlined_columns = schema.GetUnlinedColumns();
+  if (std::none_of(uninlined_columns.begin(), uninlined_columns.end(), is_pointer)) {
+    return;
+  }
+
+  std::vector<Value> values;
+  values.reserve(schema.GetColumnCount());
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    auto type = schema.GetColumn(i).GetType();
+    if (schema.GetColumn(i).IsInlined() || !is_pointer(i)) {
+      values.push_back(tuple->GetValue(&schema, i));
+    } else if (column_ids != nullptr && std::find(column_ids->begin(), column_ids->end(), i) == column_ids->end()) {
+      values.push_back(ValueFactory::GetNullValueByType(type));
+    } else {
+      // The pointer is the marker, the length of the value and the first page of its chain.
+      const char *pointer = tuple->GetDataPtr(&schema, i);
+      uint32_t len = ReadWord(pointer, 1);
+      auto first_page_id = static_cast<page_id_t>(ReadWord(pointer, 2));
+      std::vector<char> data(len);
+      ReadOverflowValue(first_page_id, len, data.data());
+      values.emplace_back(type, data.data(), len, true);
+    }
+  }
+  RID rid = tuple->rid_;
+  *tuple = Tuple(std::move(values), &schema);
+  tuple->rid_ = rid;
+}
+
+void TableHeap::FreeOverflowValues(const Tuple &stored) {
+  if (toast_schema_ == nullptr || stored.size_ == 0) {
+    return;
+  }
+  for (auto column_idx : toast_schema_->GetUnlinedColumns()) {
+    const char *pointer = stored.GetDataPtr(toast_schema_.get(), column_idx);
+    if (ReadWord(pointer, 0) == OverflowPage::POINTER_MARKER) {
+      FreeOverflowChain(static_cast<page_id_t>(ReadWord(pointer, 2)));
+    }
+  }
+}
+
+auto TableHeap::WriteOverflowValue(const char *data, uint32_t size) -> page_id_t {
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  OverflowPage *prev_page = nullptr;
+  uint32_t written = 0;
+  while (written < size) {
+    page_id_t page_id;
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->NewPage(&page_id));
+    if (page == nullptr) {
+      if (prev_page != nullptr) {
+        buffer_pool_manager_->UnpinPage(prev_page->GetPageId(), true);
+        FreeOverflowChain(first_page_id);
+      }
+      return INVALID_PAGE_ID;
+    }
+    page->Init(page_id);
+    written += page->SetPayload(data + written, size - written);
+    if (prev_page == nullptr) {
+      first_page_id = page_id;
+    } else {
+      prev_page->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_page->GetPageId(), true);
+    }
+    prev_page = page;
+  }
+  if (prev_page != nullptr) {
+    buffer_pool_manager_->UnpinPage(prev_page->GetPageId(), true);
+  }
+  return first_page_id;
+}
+
+void TableHeap::ReadOverflowValue(page_id_t first_page_id, uint32_t size, char *data) {
+  uint32_t read = 0;
+  auto page_id = first_page_id;
+  while (read < size && page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch an overflow page.");
+    memcpy(data + read, page->GetPayload(), page->GetDataSize());
+    read += page->GetDataSize();
+    auto next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  BUSTUB_ASSERT(read == size, "The overflow chain is shorter than the value.");
+}
+
+void TableHeap::FreeOverflowChain(page_id_t first_page_id) {
+  auto page_id = first_page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch an overflow page.");
+    auto next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+auto TableHeap::GetFirstTupleRid(TablePage *page, RID *first_rid, const Transaction *txn) -> bool {
+  bool found = pax_layout_ != nullptr ? reinterpret_cast<PaxPage *>(page)->GetFirstTupleRid(first_rid)
+                                      : page->GetFirstTupleRid(first_rid);
+  if (!ReadsSnapshot(txn)) {
+    return found;
+  }
+  // The deleted tuples a snapshot may still see are marked in the page, which skips them.
+  auto deleted_slot = version_store_.NextDeletedSlot(page->GetTablePageId(), 0);
+  if (deleted_slot.has_value() && (!found || *deleted_slot < first_rid->GetSlotNum())) {
+    first_rid->Set(page->GetTablePageId(), *deleted_slot);
+    return true;
+  }
+  return found;
+}
+
+auto TableHeap::CompactPage(TablePage *page) -> bool {
+  if (pax_layout_ != nullptr) {
+    return reinterpret_cast<PaxPage *>(page)->Compact() > 0;
+  }
+  return page->Compact() > 0;
+}
+
+auto TableHeap::VisitPage(TablePage *page, Transaction *txn, const std::vector<uint32_t> *column_ids,
+                          const std::function<void(const TupleView &)> &visitor,
+                          const std::function<bool(const Tuple &)> &encoded_filter) -> size_t {
+  // The versions of the tuples of a page only change under its write latch, except for their timestamps, so a page
+  // without versions is read as it is.
+  const Transaction *snapshot_txn =
+      ReadsSnapshot(txn) && version_store_.HasVersions(page->GetTablePageId()) ? txn : nullptr;
+  size_t num_visited = 0;
+  RID rid;
+  bool found = GetFirstTupleRid(page, &rid, snapshot_txn);
+  while (found) {
+    Tuple tuple;
+    auto visibility = snapshot_txn != nullptr ? version_store_.GetVisibleVersion(rid, snapshot_txn, &tuple)
+                                              : VersionStore::Visibility::IN_PAGE;
+    if (visibility == VersionStore::Visibility::IN_PAGE && pax_layout_ != nullptr) {
+      // The values of a PAX tuple are spread over the minipages, so it is assembled.
+      reinterpret_cast<PaxPage *>(page)->GetTuple(*pax_layout_, rid, &tuple, column_ids);
+    } else if (visibility == VersionStore::Visibility::IN_PAGE) {
+      TupleView view;
+      page->GetTupleView(rid, &view);
+      // The tuple shares the page memory, unless a value stored out of line has to be fetched.
+      tuple = view.AsTuple();
+      if (toast_schema_ != nullptr) {
+        DetoastTuple(&tuple, column_ids);
+      }
+    }
+    // An older version is a copy, visited as an assembled tuple is. An encoded tuple is only decoded if it passes the
+    // filter on its codes.
+    if (visibility != VersionStore::Visibility::NONE) {
+      if (dictionary_ == nullptr) {
+        visitor(TupleView(tuple));
+      } else if (encoded_filter == nullptr || encoded_filter(tuple)) {
+        dictionary_->DecodeTuple(&tuple, column_ids);
+        visitor(TupleView(tuple));
+      }
+      num_visited++;
+    }
+    RID next_rid;
+    found = GetNextTupleRid(page, rid, &next_rid, snapshot_txn);
+    rid = next_rid;
+  }
+  return num_visited;
+}
+
+auto TableHeap::IsPageEmpty(TablePage *page) -> bool {
+  if (pax_layout_ != nullptr) {
+    return reinterpret_cast<PaxPage *>(page)->IsEmpty();
+  }
+  return page->IsEmpty();
+}
+
+auto TableHeap::GetNextTupleRid(TablePage *page, const RID &cur_rid, RID *next_rid, const Transaction *txn) -> bool {
+  bool found = pax_layout_ != nullptr ? reinterpret_cast<PaxPage *>(page)->GetNextTupleRid(cur_rid, next_rid)
+                                      : page->GetNextTupleRid(cur_rid, next_rid);
+  if (!ReadsSnapshot(txn)) {
+    return found;
+  }
+  auto deleted_slot = version_store_.NextDeletedSlot(page->GetTablePageId(), cur_rid.GetSlotNum() + 1);
+  if (deleted_slot.has_value() && (!found || *deleted_slot < next_rid->GetSlotNum())) {
+    next_rid->Set(page->GetTablePageId(), *deleted_slot);
+    return true;
+  }
+  return found;
+}
+
 }  // namespace bustub
@@ -20,10 +20,61 @@ namespace bustub {
 
 TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
     : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
-  if (rid.GetPageId() != INVALID_PAGE_ID) {
-    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_)) {
+  AcquireScan();
+  if (rid.GetPageId() != INVALID_PAGE_ID && !table_heap_->GetTuple(tuple_->rid_, tuple_, txn_)) {
+    // A snapshot may not see the first tuple.
+    if (!TableHeap::ReadsSnapshot(txn_)) {
       throw bustub::Exception("read non-existing tuple");
     }
+    ++(*this);
+  }
+}
+
+TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, std::vector<uint32_t> column_ids)
+    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn), column_ids_(std::move(column_ids)) {
+  AcquireScan();
+  if (rid.GetPageId() != INVALID_PAGE_ID && !table_heap_->GetTuple(tuple_->rid_, tuple_, txn_, true, GetColumnIds())) {
+    if (!TableHeap::ReadsSnapshot(txn_)) {
+      throw bustub::Exception("read non-existing tuple");
+    }
+    ++(*this);
+  }
+}
+
+TableIterator::TableIterator(const TableIterator &other)
+    : table_heap_(other.table_heap_),
+      tuple_(new Tuple(*other.tuple_)),
+      txn_(other.txn_),
+      column_ids_(other.column_ids_) {
+  AcquireScan();
+}
+
+TableIterator::~TableIterator() {
+  ReleaseScan();
+  delete tuple_;
+}
+
+auto TableIterator::operator=(const TableIterator &other) -> TableIterator & {
+  ReleaseScan();
+  table_heap_ = other.table_heap_;
+  *tuple_ = *other.tuple_;
+  txn_ = other.txn_;
+  column_ids_ = other.column_ids_;
+  AcquireScan();
+  return *this;
+}
+
+void TableIterator::AcquireScan() {
+  if (tuple_->rid_.GetPageId() != INVALID_PAGE_ID) {
+    table_heap_->num_scans_++;
+    holds_scan_ = true;
+  }
+}
+
+void TableIterator::ReleaseScan() {
+  if (holds_scan_) {
+    table_heap_->num_scans_--;
+    holds_scan_ = false;
   }
 }
 
@@ -43,26 +94,32 @@ auto TableIterator::operator++() -> TableIterator & {
   BUSTUB_ENSURE(cur_page != nullptr, "BPM full");  // all pages are pinned
 
   cur_page->RLatch();
-  RID next_tuple_rid;
-  if (!cur_page->GetNextTupleRid(tuple_->rid_,
-                                 &next_tuple_rid)) {  // end of this page
-    while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
-      cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
-      cur_page->RLatch();
-      if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
-        break;
+  // A snapshot also walks the deleted tuples it may see, and skips the tuples it does not see.
+  bool is_visible = false;
+  while (!is_visible) {
+    RID next_tuple_rid;
+    if (!table_heap_->GetNextTupleRid(cur_page, tuple_->rid_, &next_tuple_rid, txn_)) {  // end of this page
+      while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
+        auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
+        cur_page->RUnlatch();
+        buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
+        cur_page = next_page;
+        cur_page->RLatch();
+        if (table_heap_->GetFirstTupleRid(cur_page, &next_tuple_rid, txn_)) {
+          break;
+        }
       }
     }
-  }
-  tuple_->rid_ = next_tuple_rid;
+    tuple_->rid_ = next_tuple_rid;
+    if (next_tuple_rid.GetPageId() == INVALID_PAGE_ID) {
+      ReleaseScan();
+      break;
+    }
 
-  if (*this != table_heap_->End()) {
     // DO NOT ACQUIRE READ LOCK twice in a single thread otherwise it may deadlock.
     // See https://users.rust-lang.org/t/how-bad-is-the-potential-deadlock-mentioned-in-rwlocks-document/67234
-    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_, false)) {
+    is_visible = table_heap_->GetTuple(tuple_->rid_, tuple_, txn_, false, GetColumnIds());
+    if (!is_visible && !TableHeap::ReadsSnapshot(txn_)) {
       cur_page->RUnlatch();
       buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
       throw bustub::Exception("read non-existing tuple");
@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_sample.cpp
+//
+// Identification: src/storage/table/table_sample.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/table_sample.h"
+
+#include <random>
+
+#include "fmt/format.h"
+
+namespace bustub {
+
+auto TableSample::WithSeed() const -> TableSample {
+  TableSample sample = *this;
+  if (!sample.seed_.has_value()) {
+    std::random_device rd;
+    sample.seed_ = (static_cast<uint64_t>(rd()) << 32) | rd();
+  }
+  return sample;
+}
+
+auto TableSample::KeepsPage(page_id_t page_id) const -> bool {
+  return method_ != Method::SYSTEM || Keeps(static_cast<uint64_t>(page_id));
+}
+
+auto TableSample::KeepsTuple(const RID &rid) const -> bool {
+  return method_ != Method::BERNOULLI || Keeps(static_cast<uint64_t>(rid.Get()));
+}
+
+auto TableSample::ToString() const -> std::string {
+  auto method = method_ == Method::SYSTEM ? "SYSTEM" : "BERNOULLI";
+  if (seed_.has_value()) {
+    return fmt::format("{}({}) REPEATABLE({})", method, percentage_, *seed_);
+  }
+  return fmt::format("{}({})", method, percentage_);
+}
+
+auto TableSample::Keeps(uint64_t id) const -> bool {
+  // The finalizer of splitmix64, which spreads consecutive ids over the whole range.
+  uint64_t x = id + seed_.value_or(0) * 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  // The top 53 bits as a uniform number in [0, 1).
+  return static_cast<double>(x >> 11) * 0x1.0p-53 * 100 < percentage_;
+}
+
+}  // namespace bustub
@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_scanner.cpp
+//
+// Identification: src/storage/table/table_scanner.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/table_scanner.h"
+
+#include <shared_mutex>
+#include <utility>
+
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+TableScanner::TableScanner(TableHeap *table_heap, std::optional<std::vector<uint32_t>> column_ids,
+                           PageFilter page_filter, EncodedFilter encoded_filter, Transaction *txn,
+                           std::optional<TableSample> sample)
+    : table_heap_(table_heap),
+      column_ids_(std::move(column_ids)),
+      page_filter_(std::move(page_filter)),
+      encoded_filter_(std::move(encoded_filter)),
+      txn_(txn),
+      sample_(std::move(sample)) {
+  // The scanner is registered before a vacuum can free its first page.
+  std::shared_lock vacuum_lock(table_heap_->vacuum_latch_);
+  next_page_id_ = table_heap_->first_page_id_;
+  if (sample_.has_value() && sample_->method_ == TableSample::Method::SYSTEM) {
+    sample_page_ids_ = table_heap_->SamplePages(*sample_);
+    next_page_id_ = sample_page_ids_->empty() ? INVALID_PAGE_ID : sample_page_ids_->front();
+    sample_page_idx_ = 1;
+  }
+  if (next_page_id_ != INVALID_PAGE_ID) {
+    table_heap_->num_scans_++;
+    holds_scan_ = true;
+  }
+}
+
+TableScanner::~TableScanner() { ReleaseScan(); }
+
+void TableScanner::ReleaseScan() {
+  if (holds_scan_) {
+    table_heap_->num_scans_--;
+    holds_scan_ = false;
+  }
+}
+
+auto TableScanner::NextPage(const Visitor &visitor) -> bool {
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  const std::vector<uint32_t> *column_ids = column_ids_.has_value() ? &column_ids_.value() : nullptr;
+  while (next_page_id_ != INVALID_PAGE_ID) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(next_page_id_));
+    BUSTUB_ENSURE(page != nullptr, "BPM full");  // all pages are pinned
+    page->RLatch();
+    // A skipped page is still read for the link to the next one, but its tuples are not decoded.
+    size_t num_visited = 0;
+    if (page_filter_ == nullptr || page_filter_(next_page_id_)) {
+      if (sample_.has_value() && sample_->method_ == TableSample::Method::BERNOULLI) {
+        num_visited = table_heap_->VisitPage(
+            page, txn_, column_ids,
+            [&](const TupleView &view) {
+              if (sample_->KeepsTuple(view.GetRid())) {
+                visitor(view);
+              }
+            },
+            encoded_filter_);
+      } else {
+        num_visited = table_heap_->VisitPage(page, txn_, column_ids, visitor, encoded_filter_);
+      }
+    }
+    if (sample_page_ids_.has_value()) {
+      next_page_id_ = sample_page_idx_ < sample_page_ids_->size() ? (*sample_page_ids_)[sample_page_idx_++]
+                                                                  : INVALID_PAGE_ID;
+    } else {
+      next_page_id_ = page->GetNextPageId();
+    }
+    page->RUnlatch();
+    buffer_pool_manager->UnpinPage(page->GetTablePageId(), false);
+    if (num_visited > 0) {
+      return true;
+    }
+  }
+  ReleaseScan();
+  return false;
+}
+
+}  // namespace bustub
@@ -95,6 +95,30 @@ auto Tuple::operator=(const Tuple &other) -> Tuple & {
   return *this;
 }
 
+Tuple::Tuple(Tuple &&other) noexcept
+    : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_), data_(other.data_) {
+  other.allocated_ = false;
+  other.size_ = 0;
+  other.data_ = nullptr;
+}
+
+auto Tuple::operator=(Tuple &&other) noexcept -> Tuple & {
+  if (this == &other) {
+    return *this;
+  }
+  if (allocated_) {
+    delete[] data_;
+  }
+  allocated_ = other.allocated_;
+  rid_ = other.rid_;
+  size_ = other.size_;
+  data_ = other.data_;
+  other.allocated_ = false;
+  other.size_ = 0;
+  other.data_ = nullptr;
+  return *this;
+}
+
 auto Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
   assert(schema);
   assert(data_);
@@ -171,4 +195,20 @@ void Tuple::DeserializeFrom(const char *storage) {
   this->allocated_ = true;
 }
 
+TupleView::TupleView(const char *data, uint32_t size, RID rid) {
+  // The tuple is not allocated, so it never frees or writes the viewed memory.
+  tuple_.data_ = const_cast<char *>(data);  // NOLINT
+  tuple_.size_ = size;
+  tuple_.rid_ = rid;
+}
+
+auto TupleView::ToTuple() const -> Tuple {
+  Tuple tuple(tuple_.rid_);
+  tuple.size_ = tuple_.size_;
+  tuple.data_ = new char[tuple.size_];
+  memcpy(tuple.data_, tuple_.data_, tuple.size_);
+  tuple.allocated_ = true;
+  return tuple;
+}
+
 }  // namespace bustub
@@ -0,0 +1,179 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// version_store.cpp
+//
+// Identification: src/storage/table/version_store.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/version_store.h"
+
+#include <mutex>  // NOLINT
+
+namespace bustub {
+
+auto VersionStore::IsVisible(timestamp_t ts, const Transaction *txn) -> bool {
+  if ((ts & UNCOMMITTED_FLAG) != 0) {
+    return ts == UncommittedTs(txn->GetTransactionId());
+  }
+  return ts <= txn->GetReadTs();
+}
+
+auto VersionStore::CanWrite(const RID &rid, const Transaction *txn) -> bool {
+  std::shared_lock lock(latch_);
+  auto *versions = Find(rid);
+  if (versions == nullptr || versions->ts_ == UncommittedTs(txn->GetTransactionId())) {
+    return true;
+  }
+  if ((versions->ts_ & UNCOMMITTED_FLAG) != 0) {
+    return false;
+  }
+  return txn->GetIsolationLevel() != IsolationLevel::SNAPSHOT_ISOLATION || versions->ts_ <= txn->GetReadTs();
+}
+
+void VersionStore::AddInsert(const RID &rid, const Transaction *txn) {
+  std::unique_lock lock(latch_);
+  auto [it, is_new] = pages_[rid.GetPageId()].insert_or_assign(rid.GetSlotNum(), TupleVersions{});
+  it->second.ts_ = UncommittedTs(txn->GetTransactionId());
+  size_ += is_new ? 1 : 0;
+}
+
+void VersionStore::AddVersion(const RID &rid, const Tuple &old_tuple, bool is_delete, const Transaction *txn) {
+  std::unique_lock lock(latch_);
+  // A tuple without an entry was visible to everyone, as if it was inserted at timestamp 0.
+  auto [it, is_new] = pages_[rid.GetPageId()].try_emplace(rid.GetSlotNum());
+  size_ += is_new ? 1 : 0;
+  auto &versions = it->second;
+  versions.older_.push_back({versions.ts_, old_tuple});
+  versions.ts_ = UncommittedTs(txn->GetTransactionId());
+  versions.is_deleted_ = is_delete;
+}
+
+void VersionStore::Undo(const RID &rid) {
+  std::unique_lock lock(latch_);
+  auto *versions = Find(rid);
+  if (versions == nullptr || versions->older_.empty()) {
+    return;
+  }
+  versions->ts_ = versions->older_.back().ts_;
+  versions->is_deleted_ = false;
+  versions->older_.pop_back();
+}
+
+void VersionStore::Remove(const RID &rid) {
+  std::unique_lock lock(latch_);
+  Erase(rid);
+}
+
+void VersionStore::Commit(const RID &rid, txn_id_t txn_id, timestamp_t commit_ts) {
+  std::unique_lock lock(latch_);
+  auto *versions = Find(rid);
+  if (versions == nullptr) {
+    return;
+  }
+  auto uncommitted_ts = UncommittedTs(txn_id);
+  if (versions->ts_ == uncommitted_ts) {
+    versions->ts_ = commit_ts;
+  }
+  for (auto &older : versions->older_) {
+    if (older.ts_ == uncommitted_ts) {
+      older.ts_ = commit_ts;
+    }
+  }
+}
+
+auto VersionStore::Collect(const RID &rid, timestamp_t watermark) -> bool {
+  std::unique_lock lock(latch_);
+  auto *versions = Find(rid);
+  if (versions == nullptr) {
+    return false;
+  }
+  // Every snapshot in use sees the version in the page, so the tuple needs no entry.
+  if (IsSettled(versions->ts_, watermark)) {
+    bool is_deleted = versions->is_deleted_;
+    Erase(rid);
+    return is_deleted;
+  }
+  // The oldest snapshot sees the newest settled version, and no snapshot sees the versions older than that one.
+  auto &older = versions->older_;
+  for (auto i = older.size(); i > 0; i--) {
+    if (IsSettled(older[i - 1].ts_, watermark)) {
+      older.erase(older.begin(), older.begin() + static_cast<std::ptrdiff_t>(i - 1));
+      break;
+    }
+  }
+  return false;
+}
+
+auto VersionStore::GetVisibleVersion(const RID &rid, const Transaction *txn, Tuple *tuple) -> Visibility {
+  std::shared_lock lock(latch_);
+  auto *versions = Find(rid);
+  if (versions == nullptr) {
+    return Visibility::IN_PAGE;
+  }
+  if (IsVisible(versions->ts_, txn)) {
+    return versions->is_deleted_ ? Visibility::NONE : Visibility::IN_PAGE;
+  }
+  for (auto it = versions->older_.rbegin(); it != versions->older_.rend(); ++it) {
+    if (IsVisible(it->ts_, txn)) {
+      *tuple = it->tuple_;
+      return Visibility::OLDER;
+    }
+  }
+  return Visibility::NONE;
+}
+
+auto VersionStore::HasVersions(page_id_t page_id) -> bool {
+  std::shared_lock lock(latch_);
+  return pages_.count(page_id) > 0;
+}
+
+auto VersionStore::NextDeletedSlot(page_id_t page_id, uint32_t slot_num) -> std::optional<uint32_t> {
+  std::shared_lock lock(latch_);
+  auto page = pages_.find(page_id);
+  if (page == pages_.end()) {
+    return std::nullopt;
+  }
+  for (auto it = page->second.lower_bound(slot_num); it != page->second.end(); ++it) {
+    if (it->second.is_deleted_) {
+      return it->first;
+    }
+  }
+  return std::nullopt;
+}
+
+auto VersionStore::Contains(const RID &rid) -> bool {
+  std::shared_lock lock(latch_);
+  return Find(rid) != nullptr;
+}
+
+auto VersionStore::Size() -> size_t {
+  std::shared_lock lock(latch_);
+  return size_;
+}
+
+auto VersionStore::Find(const RID &rid) -> TupleVersions * {
+  auto page = pages_.find(rid.GetPageId());
+  if (page == pages_.end()) {
+    return nullptr;
+  }
+  auto it = page->second.find(rid.GetSlotNum());
+  return it == page->second.end() ? nullptr : &it->second;
+}
+
+void VersionStore::Erase(const RID &rid) {
+  auto page = pages_.find(rid.GetPageId());
+  if (page == pages_.end() || page->second.erase(rid.GetSlotNum()) == 0) {
+    return;
+  }
+  size_--;
+  if (page->second.empty()) {
+    pages_.erase(page);
+  }
+}
+
+}  // namespace bustub
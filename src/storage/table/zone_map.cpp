@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.cpp
+//
+// Identification: src/storage/table/zone_map.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/zone_map.h"
+
+#include "type/value_factory.h"
+
+namespace bustub {
+
+ZoneMap::ZoneMap(const Schema &schema) : schema_(schema) {
+  for (const auto &column : schema_.GetColumns()) {
+    switch (column.GetType()) {
+      case TypeId::TINYINT:
+      case TypeId::SMALLINT:
+      case TypeId::INTEGER:
+      case TypeId::BIGINT:
+      case TypeId::DECIMAL:
+      case TypeId::TIMESTAMP:
+        tracked_.push_back(true);
+        break;
+      default:
+        tracked_.push_back(false);
+        break;
+    }
+  }
+}
+
+void ZoneMap::AddPage(page_id_t page_id) {
+  std::scoped_lock lock(latch_);
+  zones_[page_id] = EmptyZones();
+}
+
+void ZoneMap::Update(page_id_t page_id, const Tuple &tuple) {
+  std::scoped_lock lock(latch_);
+  auto it = zones_.find(page_id);
+  if (it == zones_.end()) {
+    return;
+  }
+  for (uint32_t i = 0; i < schema_.GetColumnCount(); i++) {
+    if (!tracked_[i]) {
+      continue;
+    }
+    auto &zone = it->second[i];
+    auto value = tuple.GetValue(&schema_, i);
+    if (value.IsNull()) {
+      zone.null_count_++;
+      continue;
+    }
+    if (zone.min_.IsNull() || value.CompareLessThan(zone.min_) == CmpBool::CmpTrue) {
+      zone.min_ = value;
+    }
+    if (zone.max_.IsNull() || value.CompareGreaterThan(zone.max_) == CmpBool::CmpTrue) {
+      zone.max_ = value;
+    }
+  }
+}
+
+void ZoneMap::Clear(page_id_t page_id) {
+  std::scoped_lock lock(latch_);
+  auto it = zones_.find(page_id);
+  if (it != zones_.end()) {
+    it->second = EmptyZones();
+  }
+}
+
+void ZoneMap::Remove(page_id_t page_id) {
+  std::scoped_lock lock(latch_);
+  zones_.erase(page_id);
+}
+
+auto ZoneMap::GetZones(page_id_t page_id) -> std::optional<std::vector<ColumnZone>> {
+  std::scoped_lock lock(latch_);
+  auto it = zones_.find(page_id);
+  if (it == zones_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+auto ZoneMap::EmptyZones() const -> std::vector<ColumnZone> {
+  std::vector<ColumnZone> zones;
+  zones.reserve(schema_.GetColumnCount());
+  for (const auto &column : schema_.GetColumns()) {
+    auto null_value = ValueFactory::GetNullValueByType(column.GetType());
+    zones.push_back({null_value, null_value, 0});
+  }
+  return zones;
+}
+
+}  // namespace bustub
@@ -173,6 +173,11 @@ TEST(BinderTest, BindBinaryOp) {
   PrintStatements(statements);
 }
 
+TEST(BinderTest, BindCopy) {
+  auto statements = TryBind("copy a from 'a.csv' (delimiter '|', header)");
+  PrintStatements(statements);
+}
+
 // TODO(chi): subquery is not supported yet
 TEST(BinderTest, DISABLED_BindUncorrelatedSubquery) {
   auto statements = TryBind("select * from (select * from a) INNER JOIN (select * from b) ON a.x = b.y");
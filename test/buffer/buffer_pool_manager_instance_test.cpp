@@ -17,6 +17,7 @@
 #include <string>
 
 #include "buffer/buffer_pool_manager.h"
+#include "fmt/format.h"
 #include "gtest/gtest.h"
 
 namespace bustub {
@@ -145,4 +146,82 @@ TEST(BufferPoolManagerInstanceTest, SampleTest) {
   delete disk_manager;
 }
 
+/** Counts the pages read one at a time, i.e. the buffer pool misses. */
+class CountingDiskManager : public DiskManager {
+ public:
+  explicit CountingDiskManager(const std::string &db_file) : DiskManager(db_file) {}
+
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    num_page_reads_++;
+    DiskManager::ReadPage(page_id, page_data);
+  }
+
+  int num_page_reads_{0};
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, WarmUpTest) {
+  const std::string db_name = "test.db";
+  const std::string warmup_name = "test.db.warmup";
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+  remove(db_name.c_str());
+  remove(warmup_name.c_str());
+
+  {
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+    page_id_t page_id_temp;
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+    bpm->FlushAllPages();
+
+    // Scenario: pages {3, 5, 7} are the hot set.
+    for (int round = 0; round < 2; ++round) {
+      for (page_id_t page_id : {7, 5, 3}) {
+        ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+      }
+    }
+    bpm->DumpResidentPages(warmup_name);
+
+    disk_manager->ShutDown();
+    delete bpm;
+    delete disk_manager;
+  }
+
+  // Scenario: a smaller buffer pool is warmed up with the hottest pages only, so fetching them reads nothing.
+  auto *disk_manager = new CountingDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(3, disk_manager, k);
+  EXPECT_EQ(3, bpm->WarmUp(warmup_name));
+  for (page_id_t page_id : {3, 5, 7}) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), fmt::format("page {}", page_id).c_str()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(0, disk_manager->num_page_reads_);
+
+  // Scenario: the other pages still have to be read.
+  auto *page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "page 0"));
+  EXPECT_EQ(1, disk_manager->num_page_reads_);
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  // Scenario: a missing warm-up file loads nothing.
+  EXPECT_EQ(0, bpm->WarmUp("nonexistent.warmup"));
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(warmup_name.c_str());
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
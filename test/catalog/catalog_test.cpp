@@ -688,4 +688,137 @@ TEST(CatalogTest, DISABLED_IndexInteraction3) {
   remove("catalog_test.log");
 }
 
+// Tables and indexes created through a persistent catalog should survive reopening the database file
+TEST(CatalogTest, ReopenPersistentCatalog) {
+  remove("catalog_test.db");
+  const std::string table_name{"foobar"};
+  const std::string index_name{"index1"};
+  const int num_tuples = 500;
+
+  std::vector<Column> columns{};
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 16);
+  Schema schema{columns};
+  std::vector<uint32_t> key_attrs{0};
+  Schema key_schema = Schema::CopySchema(&schema, key_attrs);
+  std::vector<uint32_t> hash_key_attrs{1};
+  Schema hash_key_schema = Schema::CopySchema(&schema, hash_key_attrs);
+
+  {
+    auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+    auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+    catalog->Bootstrap(disk_manager->GetNumPages() == 0);
+    Transaction txn(0);
+
+    auto *table_info = catalog->CreateTable(&txn, table_name, schema);
+    ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+    EXPECT_NE(HEADER_PAGE_ID, table_info->table_->GetFirstPageId());
+    for (int i = 0; i < num_tuples; i++) {
+      Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::to_string(i))}, &schema);
+      RID rid;
+      ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, &txn));
+    }
+    ASSERT_NE(Catalog::NULL_INDEX_INFO,
+              (catalog->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+                  &txn, index_name, table_name, schema, key_schema, key_attrs, INTEGER_SIZE, IntegerHashFunctionType{},
+                  IndexType::BPLUS_TREE, true)));
+    auto *hash_index_info =
+        catalog->CreateIndex(&txn, "index2", table_name, schema, hash_key_schema, hash_key_attrs, IndexType::HASH);
+    ASSERT_NE(Catalog::NULL_INDEX_INFO, hash_index_info);
+
+    // Index names are only unique per table, and do not name the records of the roots in the header page
+    auto *other_table_info = catalog->CreateTable(&txn, "foobaz", schema);
+    ASSERT_NE(Catalog::NULL_TABLE_INFO, other_table_info);
+    for (int i = 0; i < num_tuples; i++) {
+      Tuple tuple({ValueFactory::GetIntegerValue(num_tuples + i), ValueFactory::GetVarcharValue("")}, &schema);
+      RID rid;
+      ASSERT_TRUE(other_table_info->table_->InsertTuple(tuple, &rid, &txn));
+    }
+    ASSERT_NE(Catalog::NULL_INDEX_INFO,
+              catalog->CreateIndex(&txn, index_name, "foobaz", schema, key_schema, key_attrs));
+    ASSERT_NE(Catalog::NULL_INDEX_INFO,
+              catalog->CreateIndex(&txn, "__catalog", "foobaz", schema, key_schema, key_attrs));
+    ASSERT_NE(Catalog::NULL_INDEX_INFO, catalog->CreateIndex(&txn, "an_index_whose_name_is_longer_than_a_header_record",
+                                                             "foobaz", schema, key_schema, key_attrs));
+
+    catalog.reset();
+    bpm->FlushAllPages();
+    disk_manager->ShutDown();
+  }
+
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  const auto num_pages = disk_manager->GetNumPages();
+  ASSERT_NE(0, num_pages);
+  catalog->Bootstrap(false);
+  Transaction txn(1);
+
+  // Schema and data of the table are restored
+  auto *table_info = catalog->GetTable(table_name);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  EXPECT_EQ(schema.ToString(), table_info->schema_.ToString());
+  int count = 0;
+  for (auto iter = table_info->table_->Begin(&txn); iter != table_info->table_->End(); ++iter) {
+    EXPECT_EQ(count, iter->GetValue(&schema, 0).GetAs<int32_t>());
+    EXPECT_EQ(std::to_string(count), iter->GetValue(&schema, 1).ToString());
+    count++;
+  }
+  EXPECT_EQ(num_tuples, count);
+
+  // The index is reattached to its B+ tree without being rebuilt, and its Bloom filter is built again
+  auto *index_info = catalog->GetIndex(index_name, table_name);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, index_info);
+  EXPECT_EQ(key_attrs, index_info->index_->GetKeyAttrs());
+  auto bloom_filter_stats = index_info->index_->GetBloomFilterStats();
+  ASSERT_TRUE(bloom_filter_stats.has_value());
+  EXPECT_EQ(num_tuples, bloom_filter_stats->num_keys_);
+  for (int i = 0; i < num_tuples; i += 37) {
+    std::vector<RID> result;
+    index_info->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(i)}, &key_schema), &result, &txn);
+    ASSERT_EQ(1, result.size());
+    Tuple tuple;
+    ASSERT_TRUE(table_info->table_->GetTuple(result[0], &tuple, &txn));
+    EXPECT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+  }
+
+  // The hash index is reopened from its directory page
+  auto *hash_index_info = catalog->GetIndex("index2", table_name);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, hash_index_info);
+  EXPECT_EQ(IndexType::HASH, hash_index_info->index_type_);
+  for (int i = 0; i < num_tuples; i += 37) {
+    std::vector<RID> result;
+    Tuple key({ValueFactory::GetVarcharValue(std::to_string(i))}, &hash_key_schema);
+    hash_index_info->index_->ScanKey(key, &result, &txn);
+    ASSERT_EQ(1, result.size());
+    Tuple tuple;
+    ASSERT_TRUE(table_info->table_->GetTuple(result[0], &tuple, &txn));
+    EXPECT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+  }
+
+  // The indexes of the other table find its own tuples
+  auto *other_table_info = catalog->GetTable("foobaz");
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, other_table_info);
+  auto other_indexes = catalog->GetTableIndexes("foobaz");
+  ASSERT_EQ(3, other_indexes.size());
+  for (auto *other_index_info : other_indexes) {
+    for (int i = 0; i < 2 * num_tuples; i += 37) {
+      std::vector<RID> result;
+      other_index_info->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(i)}, &key_schema), &result, &txn);
+      ASSERT_EQ(i < num_tuples ? 0 : 1, result.size());
+    }
+  }
+
+  // New pages must not overwrite the ones written by the previous run
+  auto *other_info = catalog->CreateTable(&txn, "other", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, other_info);
+  EXPECT_GE(other_info->table_->GetFirstPageId(), num_pages);
+  EXPECT_NE(table_info->oid_, other_info->oid_);
+
+  disk_manager->ShutDown();
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
 }  // namespace bustub
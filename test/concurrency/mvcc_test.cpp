@@ -0,0 +1,224 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// mvcc_test.cpp
+//
+// Identification: test/concurrency/mvcc_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/bustub_instance.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/table_scanner.h"
+#include "storage/table/tuple.h"
+#include "table_heap_test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class MvccTest : public TableHeapTestBase {
+ protected:
+  MvccTest() : TableHeapTestBase(50, {{"a", TypeId::INTEGER}, {"b", TypeId::VARCHAR, 20}}) {}
+
+  void SetUp() override {
+    TableHeapTestBase::SetUp();
+    lock_manager_ = std::make_unique<LockManager>();
+    txn_mgr_ = std::make_unique<TransactionManager>(lock_manager_.get());
+  }
+
+  void TearDown() override {
+    txn_mgr_.reset();
+    lock_manager_.reset();
+    TableHeapTestBase::TearDown();
+  }
+
+  auto Begin() -> Transaction * { return txn_mgr_->Begin(nullptr, IsolationLevel::SNAPSHOT_ISOLATION); }
+
+  /** @return the first column of the tuples the transaction sees, read by the iterator and by the scanner */
+  auto Scan(TableHeap *table, Transaction *txn) -> std::vector<int> {
+    std::vector<int> values;
+    for (auto it = table->Begin(txn); it != table->End(); ++it) {
+      values.push_back(it->GetValue(schema_.get(), 0).GetAs<int32_t>());
+    }
+    std::vector<int> scanned;
+    TableScanner scanner(table, std::nullopt, nullptr, nullptr, txn);
+    while (scanner.NextPage(
+        [&](const TupleView &view) { scanned.push_back(view.GetValue(schema_.get(), 0).GetAs<int32_t>()); })) {
+    }
+    EXPECT_EQ(values, scanned);
+    return values;
+  }
+
+  std::unique_ptr<LockManager> lock_manager_;
+  std::unique_ptr<TransactionManager> txn_mgr_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(MvccTest, SnapshotReadTest) {
+  auto *txn = Begin();
+  TableHeap table(bpm_.get(), nullptr, nullptr, txn, TableFormat::ROW, schema_.get());
+  std::vector<RID> rids;
+  for (int i = 0; i < 5; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(i), &rid, txn));
+    rids.push_back(rid);
+  }
+  txn_mgr_->Commit(txn);
+  delete txn;
+  // No transaction is running, so the committed tuples need no versions.
+  EXPECT_EQ(0, table.GetVersionStore()->Size());
+
+  auto *reader = Begin();
+  auto *writer = Begin();
+  RID rid;
+  ASSERT_TRUE(table.InsertTuple(MakeTuple(5), &rid, writer));
+  ASSERT_TRUE(table.MarkDelete(rids[1], writer));
+  ASSERT_TRUE(table.UpdateTuple(MakeTuple(20), rids[2], writer));
+  ASSERT_TRUE(table.UpdateTuple(MakeTuple(30), rids[3], writer));
+  ASSERT_TRUE(table.MarkDelete(rids[3], writer));
+
+  // The writer sees its own writes, the reader does not see them even once they are committed.
+  EXPECT_EQ((std::vector<int>{0, 20, 4, 5}), Scan(&table, writer));
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), Scan(&table, reader));
+  txn_mgr_->Commit(writer);
+  delete writer;
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), Scan(&table, reader));
+  Tuple tuple;
+  ASSERT_TRUE(table.GetTuple(rids[2], &tuple, reader));
+  EXPECT_EQ(2, tuple.GetValue(schema_.get(), 0).GetAs<int32_t>());
+  EXPECT_EQ("value-2", tuple.GetValue(schema_.get(), 1).ToString());
+  EXPECT_FALSE(table.GetTuple(rid, &tuple, reader));
+
+  // A later snapshot sees the commit.
+  auto *late_reader = Begin();
+  EXPECT_EQ((std::vector<int>{0, 20, 4, 5}), Scan(&table, late_reader));
+  ASSERT_TRUE(table.GetTuple(rids[2], &tuple, late_reader));
+  EXPECT_EQ("value-20", tuple.GetValue(schema_.get(), 1).ToString());
+
+  // The deleted tuples stay in their pages until the oldest snapshot ends.
+  EXPECT_EQ(4, table.GetVersionStore()->Size());
+  txn_mgr_->Commit(reader);
+  delete reader;
+  txn_mgr_->Commit(late_reader);
+  delete late_reader;
+  EXPECT_EQ(0, table.GetVersionStore()->Size());
+  // The slots of the deleted tuples are free again.
+  auto *txn2 = Begin();
+  ASSERT_TRUE(table.InsertTuple(MakeTuple(6), &rid, txn2));
+  EXPECT_EQ(rids[1], rid);
+  txn_mgr_->Commit(txn2);
+  delete txn2;
+}
+
+// NOLINTNEXTLINE
+TEST_F(MvccTest, WriteConflictTest) {
+  auto *txn = Begin();
+  TableHeap table(bpm_.get(), nullptr, nullptr, txn, TableFormat::PAX, schema_.get());
+  RID rid;
+  ASSERT_TRUE(table.InsertTuple(MakeTuple(0), &rid, txn));
+  txn_mgr_->Commit(txn);
+  delete txn;
+
+  // The first writer wins, the second one aborts.
+  auto *first = Begin();
+  auto *second = Begin();
+  ASSERT_TRUE(table.UpdateTuple(MakeTuple(1), rid, first));
+  EXPECT_FALSE(table.UpdateTuple(MakeTuple(2), rid, second));
+  EXPECT_EQ(TransactionState::ABORTED, second->GetState());
+  txn_mgr_->Abort(second);
+  delete second;
+  txn_mgr_->Commit(first);
+  delete first;
+
+  // A snapshot may not overwrite a version committed after it was taken.
+  auto *old_snapshot = Begin();
+  auto *writer = Begin();
+  ASSERT_TRUE(table.UpdateTuple(MakeTuple(3), rid, writer));
+  txn_mgr_->Commit(writer);
+  delete writer;
+  EXPECT_FALSE(table.MarkDelete(rid, old_snapshot));
+  EXPECT_EQ(TransactionState::ABORTED, old_snapshot->GetState());
+  txn_mgr_->Abort(old_snapshot);
+  delete old_snapshot;
+
+  // A rolled back update restores the version committed before.
+  auto *reader = Begin();
+  auto *aborted = Begin();
+  ASSERT_TRUE(table.UpdateTuple(MakeTuple(4), rid, aborted));
+  txn_mgr_->Abort(aborted);
+  delete aborted;
+  EXPECT_EQ((std::vector<int>{3}), Scan(&table, reader));
+  txn_mgr_->Commit(reader);
+  delete reader;
+  EXPECT_EQ(0, table.GetVersionStore()->Size());
+}
+
+// NOLINTNEXTLINE
+TEST(MvccSqlTest, SnapshotTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  NoopWriter noop;
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE TABLE t (a INTEGER, b VARCHAR(16));", noop));
+  ASSERT_TRUE(bustub->ExecuteSql("INSERT INTO t VALUES (1, 'a'), (2, 'b'), (3, 'c');", noop));
+
+  auto *reader = bustub->txn_manager_->Begin(nullptr, IsolationLevel::SNAPSHOT_ISOLATION);
+  ASSERT_TRUE(bustub->ExecuteSql("DELETE FROM t WHERE a = 2;", noop));
+  ASSERT_TRUE(bustub->ExecuteSql("INSERT INTO t VALUES (4, 'd');", noop));
+
+  std::stringstream result;
+  SimpleStreamWriter writer(result, true, ",");
+  ASSERT_TRUE(bustub->ExecuteSqlTxn("SELECT * FROM t;", writer, reader));
+  EXPECT_EQ("1,a,\n2,b,\n3,c,\n", result.str());
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSqlTxn("SELECT SUM(a) FROM t WHERE a > 1;", writer, reader));
+  EXPECT_EQ("5,\n", result.str());
+  bustub->txn_manager_->Commit(reader);
+  delete reader;
+
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT * FROM t;", writer));
+  EXPECT_EQ("1,a,\n3,c,\n4,d,\n", result.str());
+}
+
+// NOLINTNEXTLINE
+TEST(MvccSqlTest, SnapshotIndexTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  NoopWriter noop;
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE TABLE t (a INTEGER, b VARCHAR(16));", noop));
+  ASSERT_TRUE(bustub->ExecuteSql("INSERT INTO t VALUES (1, 'a'), (2, 'b'), (3, 'c');", noop));
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE INDEX t_a ON t(a);", noop));
+
+  // The delete removes the index entry at once, so a snapshot which still sees the tuple scans the table instead.
+  auto *reader = bustub->txn_manager_->Begin(nullptr, IsolationLevel::SNAPSHOT_ISOLATION);
+  ASSERT_TRUE(bustub->ExecuteSql("DELETE FROM t WHERE a = 2;", noop));
+
+  std::stringstream result;
+  SimpleStreamWriter writer(result, true, ",");
+  ASSERT_TRUE(bustub->ExecuteSqlTxn("SELECT * FROM t WHERE a = 2;", writer, reader));
+  EXPECT_EQ("2,b,\n", result.str());
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSqlTxn("EXPLAIN (o) SELECT * FROM t WHERE a = 2;", writer, reader));
+  EXPECT_EQ(std::string::npos, result.str().find("IndexScan"));
+  bustub->txn_manager_->Commit(reader);
+  delete reader;
+
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("EXPLAIN (o) SELECT * FROM t WHERE a = 2;", writer));
+  EXPECT_NE(std::string::npos, result.str().find("IndexScan"));
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT * FROM t WHERE a = 2;", writer));
+  EXPECT_EQ("", result.str());
+}
+
+}  // namespace bustub
@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_test_util.h
+//
+// Identification: test/include/table_heap_test_util.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/schema.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/**
+ * A fixture for tests of table heaps: a buffer pool over a fresh test.db, removed again after the test, and the schema
+ * of the tuples, by default (a INTEGER, b VARCHAR(20), c INTEGER).
+ */
+class TableHeapTestBase : public ::testing::Test {
+ protected:
+  explicit TableHeapTestBase(size_t pool_size = 10,
+                             std::vector<Column> columns = {{"a", TypeId::INTEGER},
+                                                            {"b", TypeId::VARCHAR, 20},
+                                                            {"c", TypeId::INTEGER}})
+      : pool_size_(pool_size), schema_(std::make_unique<Schema>(std::move(columns))) {}
+
+  void SetUp() override {
+    remove("test.db");
+    disk_manager_ = std::make_unique<DiskManager>("test.db");
+    bpm_ = std::make_unique<BufferPoolManagerInstance>(pool_size_, disk_manager_.get());
+  }
+
+  void TearDown() override {
+    bpm_.reset();
+    disk_manager_->ShutDown();
+    remove("test.db");
+  }
+
+  /** The tuple of schema_ whose n-th INTEGER column is i * n and whose VARCHAR columns are "value-i". */
+  auto MakeTuple(int i) -> Tuple {
+    std::vector<Value> values;
+    int n = 0;
+    for (const auto &column : schema_->GetColumns()) {
+      if (column.GetType() == TypeId::VARCHAR) {
+        values.push_back(ValueFactory::GetVarcharValue("value-" + std::to_string(i)));
+      } else {
+        values.push_back(ValueFactory::GetIntegerValue(i * ++n));
+      }
+    }
+    return Tuple{values, schema_.get()};
+  }
+
+  size_t pool_size_;
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManagerInstance> bpm_;
+  std::unique_ptr<Schema> schema_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,177 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_load_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bulk_load_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using InternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+
+/** Check that every node below the root holds at least its minimum and less than its maximum, and list leaf sizes. */
+void CheckNode(BufferPoolManager *bpm, page_id_t page_id, page_id_t parent_page_id, std::vector<int> *leaf_sizes) {
+  auto *page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  EXPECT_EQ(parent_page_id, page->GetParentPageId());
+  if (page->IsLeafPage()) {
+    EXPECT_LT(page->GetSize(), page->GetMaxSize());
+    EXPECT_TRUE(page->IsRootPage() || page->GetSize() >= page->GetMinSize());
+    leaf_sizes->push_back(page->GetSize());
+  } else {
+    auto *internal_page = reinterpret_cast<InternalPage *>(page);
+    EXPECT_LE(page->GetSize(), page->GetMaxSize());
+    EXPECT_TRUE(page->IsRootPage() ? page->GetSize() >= 2 : page->GetSize() >= (page->GetMaxSize() + 1) / 2);
+    for (int i = 0; i < page->GetSize(); i++) {
+      CheckNode(bpm, internal_page->ValueAt(i), page_id, leaf_sizes);
+    }
+  }
+  bpm->UnpinPage(page_id, false);
+}
+
+/** @return the keys of the tree, in the order of the iterator */
+auto ScanKeys(Tree *tree) -> std::vector<int64_t> {
+  std::vector<int64_t> keys;
+  for (auto it = tree->Begin(); it != tree->End(); ++it) {
+    keys.push_back((*it).second.GetSlotNum());
+  }
+  return keys;
+}
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  for (auto [leaf_max_size, internal_max_size, fill_factor] :
+       std::vector<std::tuple<int, int, double>>{{2, 3, 1.0}, {4, 5, 0.5}, {5, 4, 0.9}, {32, 32, 0.7}}) {
+    for (int num_keys : {1, 2, 7, 100, 1000}) {
+      auto *disk_manager = new DiskManager("test.db");
+      BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+      page_id_t page_id;
+      bpm->NewPage(&page_id);
+      Tree tree("foo_pk", bpm, comparator, leaf_max_size, internal_max_size);
+      auto *transaction = new Transaction(0);
+
+      // The keys come in random order, each one twice with a different rid; the first one is kept.
+      std::vector<int64_t> keys(num_keys);
+      std::iota(keys.begin(), keys.end(), 1);
+      std::shuffle(keys.begin(), keys.end(), std::mt19937(num_keys));
+      std::vector<std::pair<GenericKey<8>, RID>> entries;
+      for (int copy = 0; copy < 2; copy++) {
+        for (auto key : keys) {
+          auto &[index_key, rid] = entries.emplace_back();
+          index_key.SetFromInteger(key);
+          rid.Set(copy, static_cast<uint32_t>(key));
+        }
+      }
+      tree.BulkLoad(entries, fill_factor, transaction);
+
+      // The leaves hold fill_factor of the keys they can hold without splitting, but the last two, which share the
+      // rest evenly or are merged so that neither underflows.
+      std::vector<int> leaf_sizes;
+      CheckNode(bpm, tree.GetRootPageId(), INVALID_PAGE_ID, &leaf_sizes);
+      int leaf_size = std::max(static_cast<int>(std::ceil(fill_factor * (leaf_max_size - 1))), leaf_max_size / 2);
+      int num_leaves = static_cast<int>(leaf_sizes.size());
+      EXPECT_EQ(num_keys, std::accumulate(leaf_sizes.begin(), leaf_sizes.end(), 0));
+      EXPECT_LE(num_leaves, (num_keys + leaf_size - 1) / leaf_size);
+      EXPECT_GE(num_leaves, (num_keys + leaf_size - 1) / leaf_size - 1);
+      for (int i = 0; i + 2 < num_leaves; i++) {
+        EXPECT_EQ(leaf_size, leaf_sizes[i]);
+      }
+      std::sort(keys.begin(), keys.end());
+      EXPECT_EQ(keys, ScanKeys(&tree));
+      for (auto key : keys) {
+        GenericKey<8> index_key;
+        index_key.SetFromInteger(key);
+        std::vector<RID> result;
+        ASSERT_TRUE(tree.GetValue(index_key, &result));
+        EXPECT_EQ(RID(0, static_cast<uint32_t>(key)), result[0]);
+      }
+
+      // The tree takes inserts and removes as usual, and further batches are inserted one by one.
+      std::set<int64_t> expected(keys.begin(), keys.end());
+      for (auto key : keys) {
+        GenericKey<8> index_key;
+        if (key % 2 == 0) {
+          index_key.SetFromInteger(key);
+          tree.Remove(index_key, transaction);
+          expected.erase(key);
+        } else {
+          index_key.SetFromInteger(key + num_keys);
+          tree.Insert(index_key, RID(0, static_cast<uint32_t>(key + num_keys)), transaction);
+          expected.insert(key + num_keys);
+        }
+      }
+      std::vector<std::pair<GenericKey<8>, RID>> more(1);
+      more[0].first.SetFromInteger(2);
+      more[0].second.Set(0, 2);
+      tree.BulkLoad(more, fill_factor, transaction);
+      expected.insert(2);
+      EXPECT_EQ(std::vector<int64_t>(expected.begin(), expected.end()), ScanKeys(&tree));
+
+      bpm->UnpinPage(HEADER_PAGE_ID, true);
+      delete transaction;
+      delete disk_manager;
+      delete bpm;
+      remove("test.db");
+      remove("test.log");
+    }
+  }
+}
+
+TEST(BPlusTreeTests, BulkLoadParallelSortTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Tree tree("foo_pk", bpm, comparator);
+
+  // Enough keys for several sorted runs, some of them merged with a run of another round.
+  auto sort_threads = index_sort_threads;
+  index_sort_threads = 5;
+  std::vector<int64_t> keys(INDEX_SORT_MIN_RUN * 5);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  std::vector<std::pair<GenericKey<8>, RID>> entries(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    entries[i].first.SetFromInteger(keys[i]);
+    entries[i].second.Set(0, static_cast<uint32_t>(keys[i]));
+  }
+  tree.BulkLoad(entries, index_fill_factor);
+  index_sort_threads = sort_threads;
+
+  std::vector<int> leaf_sizes;
+  CheckNode(bpm, tree.GetRootPageId(), INVALID_PAGE_ID, &leaf_sizes);
+  std::sort(keys.begin(), keys.end());
+  EXPECT_EQ(keys, ScanKeys(&tree));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -460,4 +460,68 @@ TEST(BPlusTreeConcurrentTest, DeleteTest3) {
   remove("test.log");
 }
 
+TEST(BPlusTreeConcurrentTest, MixTest2) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree, with small pages so that both the optimistic and the pessimistic writes run
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // every thread inserts its own keys, and removes the odd ones as it goes
+  const int num_threads = 4;
+  const int64_t scale_factor = 2000;
+  auto insert_remove = [&](uint64_t thread_itr) {
+    GenericKey<8> index_key;
+    RID rid;
+    auto *transaction = new Transaction(static_cast<txn_id_t>(thread_itr));
+    for (int64_t key = 1; key < scale_factor; key++) {
+      if (static_cast<uint64_t>(key) % num_threads != thread_itr) {
+        continue;
+      }
+      rid.Set(0, key);
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+      EXPECT_FALSE(tree.Insert(index_key, rid, transaction));
+      if (key % 2 == 1 && key > 2 * num_threads) {
+        index_key.SetFromInteger(key - 2 * num_threads);
+        tree.Remove(index_key, transaction);
+      }
+    }
+    delete transaction;
+  };
+  LaunchParallelTest(num_threads, insert_remove);
+
+  std::vector<RID> rids;
+  GenericKey<8> index_key;
+  for (int64_t key = 1; key < scale_factor; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    bool is_removed = key % 2 == 1 && key + 2 * num_threads < scale_factor;
+    EXPECT_EQ(!is_removed, tree.GetValue(index_key, &rids)) << key;
+  }
+
+  int64_t size = 0;
+  int64_t prev_key = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    auto slot = static_cast<int64_t>((*iterator).second.GetSlotNum());
+    EXPECT_LT(prev_key, slot);
+    prev_key = slot;
+    size = size + 1;
+  }
+  EXPECT_EQ((scale_factor - 1) / 2 + num_threads, size);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
@@ -19,7 +20,6 @@
 #include "test_util.h"  // NOLINT
 
 // #include <numeric>
-// #include <random>
 // #include <string>
 
 namespace bustub {
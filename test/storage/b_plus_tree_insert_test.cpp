@@ -12,6 +12,10 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
@@ -195,4 +199,223 @@ TEST(BPlusTreeTests, InsertTest3) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, PrefixCompressedKeysTest) {
+  // create KeyComparator and index schema, the keys have two columns and are prefix compressed in the pages
+  auto key_schema = ParseCreateStatement("a bigint,b bigint");
+  GenericComparator<16> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<16>, RID, GenericComparator<16>> tree("foo_pk", bpm, comparator);
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  auto make_key = [](int64_t key) {
+    GenericKey<16> index_key;
+    int64_t columns[2] = {key % 20, key * 7919};
+    memcpy(index_key.data_, columns, sizeof(columns));
+    return index_key;
+  };
+  std::vector<int64_t> keys(20000);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  for (auto key : keys) {
+    ASSERT_TRUE(tree.Insert(make_key(key), RID(static_cast<page_id_t>(key), 0), transaction));
+  }
+  ASSERT_FALSE(tree.Insert(make_key(keys[0]), RID(), transaction));
+
+  // the keys come out in order, first column first
+  int64_t num_keys = 0;
+  int64_t prev_key = -1;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    auto key = (*iterator).second.GetPageId();
+    if (prev_key >= 0) {
+      ASSERT_LT(comparator(make_key(prev_key), make_key(key)), 0);
+    }
+    ASSERT_EQ(comparator((*iterator).first, make_key(key)), 0);
+    prev_key = key;
+    num_keys++;
+  }
+  ASSERT_EQ(num_keys, keys.size());
+
+  // remove every other key, in random order
+  for (size_t i = 0; i < keys.size(); i += 2) {
+    tree.Remove(make_key(keys[i]), transaction);
+  }
+  std::vector<RID> rids;
+  for (size_t i = 0; i < keys.size(); i++) {
+    rids.clear();
+    ASSERT_EQ(tree.GetValue(make_key(keys[i]), &rids), i % 2 == 1);
+    if (i % 2 == 1) {
+      ASSERT_EQ(rids[0].GetPageId(), keys[i]);
+    }
+  }
+  for (size_t i = 1; i < keys.size(); i += 2) {
+    tree.Remove(make_key(keys[i]), transaction);
+  }
+  ASSERT_TRUE(tree.IsEmpty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, GetValuesTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 16, 16);
+  GenericKey<8> index_key;
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  std::vector<GenericKey<8>> keys;
+  std::vector<std::vector<RID>> results;
+  ASSERT_EQ(tree.GetValues(keys, &results), 0);
+  index_key.SetFromInteger(0);
+  keys.push_back(index_key);
+  ASSERT_EQ(tree.GetValues(keys, &results), 0);
+  ASSERT_EQ(results.size(), 1);
+  ASSERT_TRUE(results[0].empty());
+
+  // the even keys are in the tree
+  for (int64_t key = 0; key < 2000; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(static_cast<page_id_t>(key), 0), transaction);
+  }
+
+  // sorted batches of keys, close to each other or far apart, present or not, repeated or not
+  std::mt19937 generator(0);
+  for (int64_t spread : {4, 64, 4000}) {
+    std::vector<int64_t> values(200);
+    for (auto &value : values) {
+      value = std::uniform_int_distribution<int64_t>(-10, spread)(generator);
+    }
+    std::sort(values.begin(), values.end());
+    keys.clear();
+    for (auto value : values) {
+      index_key.SetFromInteger(value);
+      keys.push_back(index_key);
+    }
+    size_t num_found = tree.GetValues(keys, &results);
+    ASSERT_EQ(results.size(), values.size());
+    size_t num_expected = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+      bool present = values[i] >= 0 && values[i] < 2000 && values[i] % 2 == 0;
+      ASSERT_EQ(results[i].size(), present ? 1 : 0);
+      if (present) {
+        ASSERT_EQ(results[i][0].GetPageId(), values[i]);
+        num_expected++;
+      }
+    }
+    ASSERT_EQ(num_found, num_expected);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, IteratorTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  const size_t pool_size = 20;
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(pool_size, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 8, 8);
+  GenericKey<8> index_key;
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  const int64_t num_keys = 1000;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(static_cast<page_id_t>(key), 0), transaction);
+  }
+
+  // a scan holds a leaf or two, and the pages of a small pool come back to it between the scans
+  for (bool prefetch : {false, true}) {
+    index_scan_prefetch = prefetch;
+    int64_t current_key = 0;
+    for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+      ASSERT_EQ((*iterator).second.GetPageId(), current_key);
+      current_key++;
+    }
+    ASSERT_EQ(current_key, num_keys);
+
+    // an iterator left in the middle of the scan, or moved from, gives its leaf back
+    index_key.SetFromInteger(num_keys / 2);
+    auto iterator = tree.Begin(index_key);
+    ASSERT_EQ((*iterator).second.GetPageId(), num_keys / 2);
+    auto moved_iterator = std::move(iterator);
+    ++moved_iterator;
+    ASSERT_EQ((*moved_iterator).second.GetPageId(), num_keys / 2 + 1);
+    iterator = tree.Begin();
+    ASSERT_EQ((*iterator).second.GetPageId(), 0);
+
+    // iterators scanning side by side, whose next leaves the prefetcher fetches in turn
+    std::vector<IndexIterator<GenericKey<8>, RID, GenericComparator<8>>> iterators;
+    for (int i = 0; i < 4; i++) {
+      iterators.push_back(tree.Begin());
+    }
+    for (int64_t key = 0; key < num_keys; key++) {
+      for (auto &side_iterator : iterators) {
+        ASSERT_EQ((*side_iterator).second.GetPageId(), key);
+        ++side_iterator;
+      }
+    }
+    for (auto &side_iterator : iterators) {
+      ASSERT_TRUE(side_iterator.IsEnd());
+    }
+  }
+  index_scan_prefetch = false;
+
+  std::vector<page_id_t> page_ids(pool_size - 1);
+  for (auto &new_page_id : page_ids) {
+    ASSERT_NE(bpm->NewPage(&new_page_id), nullptr);
+  }
+  for (auto new_page_id : page_ids) {
+    bpm->UnpinPage(new_page_id, false);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
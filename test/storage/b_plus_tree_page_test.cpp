@@ -0,0 +1,196 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_page_test.cpp
+//
+// Identification: test/storage/b_plus_tree_page_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_search.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BPlusTreePageTest, IntegerLowerBoundTest) {
+  std::mt19937 generator(0);
+  for (int num_keys : {0, 1, 3, 8, 31, 32, 33, 100, 1000}) {
+    std::vector<int32_t> keys32(num_keys);
+    std::vector<int64_t> keys64(num_keys);
+    for (int i = 0; i < num_keys; i++) {
+      keys32[i] = std::uniform_int_distribution<int32_t>(-1000, 1000)(generator);
+      keys64[i] = static_cast<int64_t>(keys32[i]) << 33;
+    }
+    std::sort(keys32.begin(), keys32.end());
+    std::sort(keys64.begin(), keys64.end());
+    // the keys start one byte into the buffer, as they need not be aligned
+    std::vector<char> buffer32(num_keys * sizeof(int32_t) + 1);
+    std::vector<char> buffer64(num_keys * sizeof(int64_t) + 1);
+    memcpy(buffer32.data() + 1, keys32.data(), num_keys * sizeof(int32_t));
+    memcpy(buffer64.data() + 1, keys64.data(), num_keys * sizeof(int64_t));
+    for (int32_t key = -1002; key <= 1002; key++) {
+      ASSERT_EQ(std::lower_bound(keys32.begin(), keys32.end(), key) - keys32.begin(),
+                IntegerLowerBound(buffer32.data() + 1, num_keys, key));
+      int64_t key64 = static_cast<int64_t>(key) << 33;
+      ASSERT_EQ(std::lower_bound(keys64.begin(), keys64.end(), key64) - keys64.begin(),
+                IntegerLowerBound(buffer64.data() + 1, num_keys, key64));
+    }
+    ASSERT_EQ(num_keys, IntegerLowerBound(buffer32.data() + 1, num_keys, std::numeric_limits<int32_t>::max()));
+    ASSERT_EQ(0, IntegerLowerBound(buffer64.data() + 1, num_keys, std::numeric_limits<int64_t>::min()));
+  }
+}
+
+/** Fill a leaf and an internal page with the same keys, and check that both comparators find the same indexes. */
+template <size_t KeySize, typename IntType>
+void CheckFindKeyIndex(Schema *key_schema) {
+  using LeafPage = BPlusTreeLeafPage<GenericKey<KeySize>, RID, IntegerComparator<KeySize, IntType>>;
+  using InternalPage = BPlusTreeInternalPage<GenericKey<KeySize>, page_id_t, IntegerComparator<KeySize, IntType>>;
+  GenericComparator<KeySize> generic_comparator(key_schema);
+  IntegerComparator<KeySize, IntType> comparator(key_schema);
+  std::vector<char> leaf_data(BUSTUB_PAGE_SIZE);
+  std::vector<char> internal_data(BUSTUB_PAGE_SIZE);
+  auto *leaf_page = reinterpret_cast<LeafPage *>(leaf_data.data());
+  auto *internal_page = reinterpret_cast<InternalPage *>(internal_data.data());
+  leaf_page->Init(1);
+  internal_page->Init(2);
+  internal_page->InsertKeyValueAt(0, {}, 0);
+
+  // insert the even keys in random order, the keys and the values have to stay in step
+  std::vector<int64_t> keys;
+  for (int64_t i = -100; i < 100; i++) {
+    keys.push_back(i * 2);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(KeySize));
+  auto make_key = [](int64_t value) {
+    GenericKey<KeySize> key;
+    auto int_value = static_cast<IntType>(value);
+    memcpy(key.data_, &int_value, sizeof(IntType));
+    return key;
+  };
+  for (auto value : keys) {
+    int index;
+    ASSERT_FALSE(leaf_page->FindKeyIndex(&index, make_key(value), comparator));
+    leaf_page->InsertKeyValueAt(index, make_key(value), RID(static_cast<page_id_t>(value), 0));
+    ASSERT_FALSE(internal_page->FindKeyIndex(&index, make_key(value), comparator));
+    internal_page->InsertKeyValueAt(index + 1, make_key(value), static_cast<page_id_t>(value));
+  }
+  for (int i = 0; i < 50; i++) {
+    leaf_page->RemoveKeyValueAt(i);
+    internal_page->RemoveKeyValueAt(i + 1);
+  }
+
+  // a leaf searched with the generic comparator holds prefix compressed keys, it gets the same entries
+  std::vector<char> generic_leaf_data(BUSTUB_PAGE_SIZE);
+  auto *generic_leaf_page =
+      reinterpret_cast<BPlusTreeLeafPage<GenericKey<KeySize>, RID, GenericComparator<KeySize>> *>(
+          generic_leaf_data.data());
+  generic_leaf_page->Init(3);
+  for (int i = 0; i < leaf_page->GetSize(); i++) {
+    generic_leaf_page->InsertKeyValueAt(i, leaf_page->KeyAt(i), leaf_page->ValueAt(i));
+  }
+  for (int64_t value = -210; value <= 210; value++) {
+    int index;
+    int generic_index;
+    bool found = leaf_page->FindKeyIndex(&index, make_key(value), comparator);
+    ASSERT_EQ(generic_leaf_page->FindKeyIndex(&generic_index, make_key(value), generic_comparator), found);
+    ASSERT_EQ(generic_index, index);
+    if (found) {
+      ASSERT_EQ(RID(static_cast<page_id_t>(value), 0), leaf_page->ValueAt(index));
+    }
+    found = internal_page->FindKeyIndex(&index, make_key(value), comparator);
+    ASSERT_TRUE(index == 0 || comparator(internal_page->KeyAt(index), make_key(value)) <= 0);
+    ASSERT_TRUE(index == internal_page->GetSize() - 1 ||
+                comparator(internal_page->KeyAt(index + 1), make_key(value)) > 0);
+    if (found) {
+      ASSERT_EQ(value, internal_page->ValueAt(index));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreePageTest, FindKeyIndexTest) {
+  auto integer_schema = ParseCreateStatement("a integer");
+  CheckFindKeyIndex<4, int32_t>(integer_schema.get());
+  auto bigint_schema = ParseCreateStatement("a bigint");
+  CheckFindKeyIndex<8, int64_t>(bigint_schema.get());
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreePageTest, PrefixCompressedKeysTest) {
+  using LeafPage = BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
+  static_assert(LeafPage::ELIDES_KEY_BYTES);
+  auto key_schema = ParseCreateStatement("a bigint,b bigint");
+  GenericComparator<16> comparator(key_schema.get());
+  auto make_key = [](int64_t a, int64_t b) {
+    GenericKey<16> key;
+    memcpy(key.data_, &a, sizeof(a));
+    memcpy(key.data_ + sizeof(a), &b, sizeof(b));
+    return key;
+  };
+  std::vector<char> leaf_data(BUSTUB_PAGE_SIZE);
+  auto *leaf_page = reinterpret_cast<LeafPage *>(leaf_data.data());
+  leaf_page->Init(1);
+
+  // keys which share their first column and the high bytes of the second one, more than fit at full key width
+  std::vector<int64_t> values(400);
+  std::iota(values.begin(), values.end(), 0);
+  std::shuffle(values.begin(), values.end(), std::mt19937(0));
+  for (auto value : values) {
+    ASSERT_TRUE(leaf_page->HasRoomFor(leaf_page->GetSize() + 1, make_key(7, value)));
+    int index;
+    ASSERT_FALSE(leaf_page->FindKeyIndex(&index, make_key(7, value), comparator));
+    leaf_page->InsertKeyValueAt(index, make_key(7, value), RID(static_cast<page_id_t>(value), 0));
+  }
+  ASSERT_GT(leaf_page->GetSize(), (BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (sizeof(GenericKey<16>) + sizeof(RID)));
+  for (int i = 0; i < leaf_page->GetSize(); i++) {
+    ASSERT_EQ(comparator(leaf_page->KeyAt(i), make_key(7, i)), 0);
+    ASSERT_EQ(RID(i, 0), leaf_page->ValueAt(i));
+  }
+
+  // a key of another first column shares fewer bytes with the others, which then take more room
+  ASSERT_FALSE(leaf_page->HasRoomFor(leaf_page->GetSize() + 1, make_key(8, 0)));
+  while (leaf_page->GetSize() > 100) {
+    leaf_page->RemoveKeyValueAt(leaf_page->GetSize() - 1);
+  }
+  ASSERT_TRUE(leaf_page->HasRoomFor(leaf_page->GetSize() + 1, make_key(8, 0)));
+  int index;
+  ASSERT_FALSE(leaf_page->FindKeyIndex(&index, make_key(8, 0), comparator));
+  ASSERT_EQ(100, index);
+  leaf_page->InsertKeyValueAt(index, make_key(8, 0), RID(-1, 0));
+  ASSERT_EQ(comparator(leaf_page->KeyAt(100), make_key(8, 0)), 0);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(leaf_page->FindKeyIndex(&index, make_key(7, i), comparator));
+    ASSERT_EQ(i, index);
+    ASSERT_EQ(RID(i, 0), leaf_page->ValueAt(i));
+  }
+
+  // whole pages of entries are written at once
+  std::vector<std::pair<GenericKey<16>, RID>> entries;
+  for (int i = 0; i < 400; i++) {
+    entries.emplace_back(make_key(7, i), RID(i, 0));
+  }
+  ASSERT_TRUE(LeafPage::HasRoomFor(entries.data(), static_cast<int>(entries.size())));
+  entries.emplace_back(make_key(8, 0), RID(-1, 0));
+  ASSERT_FALSE(LeafPage::HasRoomFor(entries.data(), static_cast<int>(entries.size())));
+  leaf_page->SetEntries(entries.data(), 200);
+  ASSERT_EQ(200, leaf_page->GetSize());
+  for (int i = 0; i < 200; i++) {
+    ASSERT_EQ(comparator(leaf_page->KeyAt(i), make_key(7, i)), 0);
+  }
+}
+
+}  // namespace bustub
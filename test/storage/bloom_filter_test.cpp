@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter_test.cpp
+//
+// Identification: test/storage/bloom_filter_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+
+#include "container/hash/hash_function.h"
+#include "gtest/gtest.h"
+#include "storage/index/bloom_filter.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BloomFilterTest, FalsePositiveTest) {
+  const int num_keys = 10000;
+  HashFunction<int64_t> hash_fn;
+  BloomFilter filter(num_keys, 10);
+  EXPECT_EQ(num_keys, filter.GetCapacity());
+  EXPECT_GE(filter.GetMemoryUsage() * 8, num_keys * 10);
+  EXPECT_EQ(0, filter.ExpectedFalsePositiveRate());
+  for (int64_t key = 0; key < num_keys; key++) {
+    filter.Add(hash_fn.GetHash(key));
+  }
+  EXPECT_EQ(num_keys, filter.GetNumKeys());
+
+  // no false negatives, and about 1% false positives at 10 bits per key
+  for (int64_t key = 0; key < num_keys; key++) {
+    EXPECT_TRUE(filter.MayContain(hash_fn.GetHash(key)));
+  }
+  const int num_absent_keys = 10 * num_keys;
+  int false_positives = 0;
+  for (int64_t key = num_keys; key < num_keys + num_absent_keys; key++) {
+    false_positives += filter.MayContain(hash_fn.GetHash(key)) ? 1 : 0;
+  }
+  EXPECT_GT(false_positives, 0);
+  EXPECT_LT(false_positives, 2 * num_absent_keys / 100);
+  EXPECT_GT(filter.ExpectedFalsePositiveRate(), 0.005);
+  EXPECT_LT(filter.ExpectedFalsePositiveRate(), 0.015);
+
+  // past its capacity, the filter lets more absent keys through
+  for (int64_t key = 0; key < 4 * num_keys; key++) {
+    filter.Add(hash_fn.GetHash(-key - 1));
+  }
+  EXPECT_GT(filter.ExpectedFalsePositiveRate(), 0.1);
+}
+
+}  // namespace bustub
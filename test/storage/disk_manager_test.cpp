@@ -10,9 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <sys/stat.h>
 #include <cstring>
+#include <string>
+#include <vector>
 
 #include "common/exception.h"
+#include "fmt/format.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
 
@@ -24,13 +28,26 @@ class DiskManagerTest : public ::testing::Test {
   void SetUp() override {
     remove("test.db");
     remove("test.log");
+    RemoveLogSegments();
   }
 
   // This function is called after every test.
   void TearDown() override {
     remove("test.db");
     remove("test.log");
+    RemoveLogSegments();
   };
+
+  static void RemoveLogSegments() {
+    for (int segment = 0; segment < 16; segment++) {
+      remove(fmt::format("test.log.{:06}", segment).c_str());
+    }
+  }
+
+  static auto FileSize(const std::string &file_name) -> int {
+    struct stat stat_buf;
+    return stat(file_name.c_str(), &stat_buf) == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  }
 };
 
 // NOLINTNEXTLINE
@@ -72,6 +89,112 @@ TEST_F(DiskManagerTest, ReadWriteLogTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, LogSegmentTest) {
+  const int segment_size = 4 * BUSTUB_PAGE_SIZE;
+  const int capacity = segment_size - DiskManager::LOG_SEGMENT_HEADER_SIZE;
+  std::vector<char> data(capacity * 5 / 2);
+  std::vector<char> buf(data.size());
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<char>('a' + i % 26);
+  }
+
+  {
+    auto dm = DiskManager("test.db", segment_size);
+    EXPECT_FALSE(dm.ReadLog(buf.data(), 16, 0));
+
+    // writes crossing segment boundaries go to preallocated segment files
+    EXPECT_EQ(capacity, dm.GetLogSegmentCapacity());
+    dm.WriteLog(data.data(), capacity / 2);
+    dm.WriteLog(data.data() + capacity / 2, static_cast<int>(data.size()) - capacity / 2);
+    EXPECT_EQ(static_cast<int>(data.size()), dm.GetLogEndOffset());
+    EXPECT_EQ(segment_size, FileSize("test.log.000000"));
+    EXPECT_EQ(segment_size, FileSize("test.log.000001"));
+    EXPECT_EQ(segment_size, FileSize("test.log.000002"));
+    EXPECT_TRUE(dm.ReadLog(buf.data(), static_cast<int>(buf.size()), 0));
+    EXPECT_EQ(std::memcmp(buf.data(), data.data(), buf.size()), 0);
+
+    // segments before the redo point are renamed to the next segments, not deleted
+    dm.RecycleLogSegments(capacity * 2 + 10);
+    EXPECT_EQ(-1, FileSize("test.log.000000"));
+    EXPECT_EQ(-1, FileSize("test.log.000001"));
+    EXPECT_EQ(segment_size, FileSize("test.log.000003"));
+    EXPECT_EQ(segment_size, FileSize("test.log.000004"));
+    EXPECT_FALSE(dm.ReadLog(buf.data(), 16, 0));
+    EXPECT_TRUE(dm.ReadLog(buf.data(), 16, capacity * 2));
+    EXPECT_EQ(std::memcmp(buf.data(), data.data() + capacity * 2, 16), 0);
+
+    // appending fills the current segment, then reuses a recycled one
+    dm.WriteLog(data.data(), capacity);
+    EXPECT_EQ(-1, FileSize("test.log.000005"));
+    EXPECT_TRUE(dm.ReadLog(buf.data(), capacity, capacity * 5 / 2));
+    EXPECT_EQ(std::memcmp(buf.data(), data.data(), capacity), 0);
+    dm.ShutDown();
+  }
+
+  // after a restart, the old log is still readable and appending starts at a fresh segment
+  {
+    auto dm = DiskManager("test.db", segment_size);
+    EXPECT_EQ(capacity * 4, dm.GetLogEndOffset());
+    EXPECT_TRUE(dm.ReadLog(buf.data(), 16, capacity * 2));
+    EXPECT_EQ(std::memcmp(buf.data(), data.data() + capacity * 2, 16), 0);
+    // a segment is in use even if its first log byte is zero
+    std::vector<char> zeros(16);
+    dm.WriteLog(zeros.data(), 16);
+    EXPECT_TRUE(dm.ReadLog(buf.data(), 16, capacity * 4));
+    EXPECT_EQ(std::memcmp(buf.data(), zeros.data(), 16), 0);
+    EXPECT_EQ(-1, FileSize("test.log.000005"));
+    dm.ShutDown();
+  }
+
+  // a segment header records the log offset of the segment
+  std::vector<char> header(DiskManager::LOG_SEGMENT_HEADER_SIZE);
+  FILE *file = fopen("test.log.000004", "rb");
+  ASSERT_NE(nullptr, file);
+  ASSERT_EQ(header.size(), fread(header.data(), 1, header.size(), file));
+  fclose(file);
+  uint64_t magic;
+  int64_t start_offset;
+  std::memcpy(&magic, header.data(), sizeof(magic));
+  std::memcpy(&start_offset, header.data() + sizeof(magic), sizeof(start_offset));
+  EXPECT_EQ(DiskManager::LOG_SEGMENT_MAGIC, magic);
+  EXPECT_EQ(capacity * 4, start_offset);
+
+  auto dm = DiskManager("test.db", segment_size);
+  EXPECT_EQ(capacity * 5, dm.GetLogEndOffset());
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, LargeLogOffsetTest) {
+  // a segment left by a previous run, at a log offset past 2 GiB
+  const int segment_size = 4 * BUSTUB_PAGE_SIZE;
+  const int capacity = segment_size - DiskManager::LOG_SEGMENT_HEADER_SIZE;
+  const int64_t segment = 200000;
+  std::vector<char> segment_data(segment_size);
+  uint64_t header[2] = {DiskManager::LOG_SEGMENT_MAGIC, static_cast<uint64_t>(segment * capacity)};
+  std::memcpy(segment_data.data(), header, sizeof(header));
+  FILE *file = fopen("test.log.200000", "wb");
+  ASSERT_NE(nullptr, file);
+  ASSERT_EQ(segment_data.size(), fwrite(segment_data.data(), 1, segment_data.size(), file));
+  fclose(file);
+
+  auto dm = DiskManager("test.db", segment_size);
+  const int64_t offset = (segment + 1) * capacity;
+  EXPECT_LT(int64_t{INT32_MAX}, offset);
+  EXPECT_EQ(offset, dm.GetLogEndOffset());
+  char data[16] = "past 2 GiB";
+  char buf[16] = {0};
+  dm.WriteLog(data, sizeof(data));
+  EXPECT_EQ(offset + static_cast<int64_t>(sizeof(data)), dm.GetLogEndOffset());
+  EXPECT_EQ(segment_size, FileSize("test.log.200001"));
+  EXPECT_TRUE(dm.ReadLog(buf, sizeof(buf), offset));
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  dm.ShutDown();
+  remove("test.log.200000");
+  remove("test.log.200001");
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_join_test.cpp
+//
+// Identification: test/storage/index_join_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "catalog/catalog.h"
+#include "common/bustub_instance.h"
+#include "common/config.h"
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(IndexJoinTest, BatchedProbeTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  NoopWriter noop;
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE TABLE t (a INTEGER, b INTEGER);", noop));
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE TABLE u (x INTEGER);", noop));
+  std::string t_values;
+  for (int i = 0; i < 3000; i += 3) {
+    t_values += fmt::format("{}({}, {})", t_values.empty() ? "" : ", ", i, -i);
+  }
+  ASSERT_TRUE(bustub->ExecuteSql(fmt::format("INSERT INTO t VALUES {};", t_values), noop));
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE INDEX ta ON t(a);", noop));
+  // outer keys in no order, repeated, missing from t or NULL
+  std::string u_values;
+  for (int i = 0; i < 1000; i++) {
+    u_values += fmt::format("{}({})", u_values.empty() ? "" : ", ", (i * 7919) % 3100);
+  }
+  ASSERT_TRUE(bustub->ExecuteSql(fmt::format("INSERT INTO u VALUES {}, (3), (3), (NULL);", u_values), noop));
+
+  auto query = [&](const std::string &sql) {
+    std::stringstream result;
+    SimpleStreamWriter writer(result, true, ",");
+    EXPECT_TRUE(bustub->ExecuteSql(sql, writer));
+    return result.str();
+  };
+  EXPECT_NE(std::string::npos,
+            query("EXPLAIN (o) SELECT * FROM u INNER JOIN t ON u.x = t.a;").find("NestedIndexJoin"));
+
+  // the outer tuples come out in their order, whatever the batch size
+  const auto inner_join = "SELECT u.x, t.b FROM u INNER JOIN t ON u.x = t.a;";
+  const auto left_join = "SELECT u.x, t.b FROM u LEFT OUTER JOIN t ON u.x = t.a;";
+  const auto counts = "SELECT COUNT(*), COUNT(t.b), SUM(t.b) FROM u LEFT OUTER JOIN t ON u.x = t.a;";
+  auto saved_batch_size = index_join_batch_size;
+  index_join_batch_size = 1;
+  auto expected_inner = query(inner_join);
+  auto expected_left = query(left_join);
+  auto expected_counts = query(counts);
+  for (size_t batch_size : {2, 7, 256, 5000}) {
+    index_join_batch_size = batch_size;
+    EXPECT_EQ(expected_inner, query(inner_join));
+    EXPECT_EQ(expected_left, query(left_join));
+    EXPECT_EQ(expected_counts, query(counts));
+  }
+  index_join_batch_size = saved_batch_size;
+
+  int num_matches = 0;
+  int sum = 0;
+  for (int i = 0; i < 1000; i++) {
+    int x = (i * 7919) % 3100;
+    if (x < 3000 && x % 3 == 0) {
+      num_matches++;
+      sum -= x;
+    }
+  }
+  EXPECT_EQ(fmt::format("{},{},{},\n", 1003, num_matches + 2, sum - 6), expected_counts);
+  EXPECT_EQ(num_matches + 2, std::count(expected_inner.begin(), expected_inner.end(), '\n'));
+  EXPECT_EQ(1003, std::count(expected_left.begin(), expected_left.end(), '\n'));
+}
+
+// NOLINTNEXTLINE
+TEST(IndexJoinTest, BloomFilterTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  NoopWriter noop;
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE TABLE t (a INTEGER, b INTEGER);", noop));
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE TABLE u (x INTEGER);", noop));
+  std::string t_values;
+  for (int i = 0; i < 3000; i += 3) {
+    t_values += fmt::format("{}({}, {})", t_values.empty() ? "" : ", ", i, -i);
+  }
+  ASSERT_TRUE(bustub->ExecuteSql(fmt::format("INSERT INTO t VALUES {};", t_values), noop));
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE INDEX ta ON t(a) WITH (bloom_filter = true);", noop));
+  // most outer keys are not in t
+  std::string u_values;
+  for (int i = 0; i < 3000; i++) {
+    u_values += fmt::format("{}({})", u_values.empty() ? "" : ", ", i + 1);
+  }
+  ASSERT_TRUE(bustub->ExecuteSql(fmt::format("INSERT INTO u VALUES {};", u_values), noop));
+
+  auto query = [&](const std::string &sql) {
+    std::stringstream result;
+    SimpleStreamWriter writer(result, true, ",");
+    EXPECT_TRUE(bustub->ExecuteSql(sql, writer));
+    return result.str();
+  };
+  const auto *index = bustub->catalog_->GetIndex("ta", "t")->index_.get();
+  ASSERT_TRUE(index->GetBloomFilterStats().has_value());
+
+  // the filter answers the lookups of most absent keys, and never hides a present one
+  for (size_t batch_size : {1, 256}) {
+    auto saved_batch_size = index_join_batch_size;
+    index_join_batch_size = batch_size;
+    EXPECT_EQ("999,\n", query("SELECT COUNT(*) FROM u INNER JOIN t ON u.x = t.a;"));
+    index_join_batch_size = saved_batch_size;
+  }
+  EXPECT_EQ("0,0,\n", query("SELECT * FROM t WHERE a = 0;"));
+  EXPECT_EQ("", query("SELECT * FROM t WHERE a = 1;"));
+  auto stats = *index->GetBloomFilterStats();
+  EXPECT_EQ(1000, stats.num_keys_);
+  EXPECT_EQ(2 * 3000 + 2, stats.lookups_);
+  EXPECT_EQ(2 * 2001 + 1, stats.negatives_ + stats.false_positives_);
+  EXPECT_LT(stats.FalsePositiveRate(), 0.05);
+  EXPECT_GT(stats.memory_usage_, 0);
+  EXPECT_NE(std::string::npos, query("\\di").find("keys=1000/"));
+
+  // keys inserted later are added, and the filter is rebuilt larger once they outgrow it
+  std::string new_values;
+  for (int i = 0; i < 5000; i++) {
+    new_values += fmt::format("{}({}, 0)", new_values.empty() ? "" : ", ", 100000 + i);
+  }
+  ASSERT_TRUE(bustub->ExecuteSql(fmt::format("INSERT INTO t VALUES {};", new_values), noop));
+  stats = *index->GetBloomFilterStats();
+  EXPECT_GE(stats.capacity_, 6000);
+  EXPECT_LT(stats.expected_false_positive_rate_, 0.05);
+  for (int i = 0; i < 5000; i += 97) {
+    EXPECT_EQ(fmt::format("{},\n", 100000 + i), query(fmt::format("SELECT a FROM t WHERE a = {};", 100000 + i)));
+  }
+
+  EXPECT_THROW(bustub->ExecuteSql("CREATE INDEX tb ON t USING HASH (b) WITH (bloom_filter);", noop), Exception);
+}
+
+}  // namespace bustub
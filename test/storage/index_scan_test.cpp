@@ -0,0 +1,231 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_scan_test.cpp
+//
+// Identification: test/storage/index_scan_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/bustub_instance.h"
+#include "concurrency/transaction_manager.h"
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+class IndexScanTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    bustub_ = std::make_unique<BustubInstance>();
+    NoopWriter noop;
+    ASSERT_TRUE(bustub_->ExecuteSql("CREATE TABLE t (a INTEGER, b INTEGER);", noop));
+    std::vector<int> keys(2000);
+    for (int i = 0; i < static_cast<int>(keys.size()); i++) {
+      keys[i] = i;
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+    std::string values;
+    for (auto key : keys) {
+      values += fmt::format("{}({}, {})", values.empty() ? "" : ", ", key, key * 10);
+    }
+    ASSERT_TRUE(bustub_->ExecuteSql(fmt::format("INSERT INTO t VALUES {};", values), noop));
+    ASSERT_TRUE(bustub_->ExecuteSql("CREATE INDEX ta ON t(a);", noop));
+  }
+
+  auto Query(const std::string &sql) -> std::string {
+    std::stringstream result;
+    SimpleStreamWriter writer(result, true, ",");
+    EXPECT_TRUE(bustub_->ExecuteSql(sql, writer));
+    return result.str();
+  }
+
+  std::unique_ptr<BustubInstance> bustub_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(IndexScanTest, PlanTest) {
+  auto plan = Query("EXPLAIN SELECT * FROM t WHERE a = 100;");
+  EXPECT_NE(std::string::npos, plan.find("IndexScan { index_oid=0, range=[100, 100]"));
+  plan = Query("EXPLAIN SELECT * FROM t WHERE a BETWEEN 10 AND 20;");
+  EXPECT_NE(std::string::npos, plan.find("range=[10, 20]"));
+  plan = Query("EXPLAIN SELECT * FROM t WHERE 5 < a AND a < 100 AND a <= 50 AND b > 0;");
+  EXPECT_NE(std::string::npos, plan.find("range=(5, 50]"));
+  plan = Query("EXPLAIN SELECT * FROM t WHERE a > 1990;");
+  EXPECT_NE(std::string::npos, plan.find("range=(1990, +inf)"));
+
+  // the index scan returns the tuples in key order
+  plan = Query("EXPLAIN (o) SELECT * FROM t WHERE a > 1990 ORDER BY a;");
+  EXPECT_NE(std::string::npos, plan.find("IndexScan"));
+  EXPECT_EQ(std::string::npos, plan.find("Sort"));
+
+  // no bound on an indexed column
+  EXPECT_EQ(std::string::npos, Query("EXPLAIN SELECT * FROM t WHERE b = 100;").find("IndexScan"));
+  EXPECT_EQ(std::string::npos, Query("EXPLAIN SELECT * FROM t WHERE a != 100;").find("IndexScan"));
+  EXPECT_EQ(std::string::npos, Query("EXPLAIN SELECT * FROM t WHERE a = 1 OR a = 2;").find("IndexScan"));
+}
+
+// NOLINTNEXTLINE
+TEST_F(IndexScanTest, RangeTest) {
+  EXPECT_EQ("100,1000,\n", Query("SELECT * FROM t WHERE a = 100;"));
+  EXPECT_EQ("", Query("SELECT * FROM t WHERE a = 5000;"));
+  EXPECT_EQ("10,\n11,\n12,\n13,\n", Query("SELECT a FROM t WHERE a BETWEEN 10 AND 13;"));
+  EXPECT_EQ("1996,\n1997,\n1998,\n1999,\n", Query("SELECT a FROM t WHERE a > 1995;"));
+  EXPECT_EQ("0,\n1,\n", Query("SELECT a FROM t WHERE 2 > a;"));
+  EXPECT_EQ("6,\n", Query("SELECT a FROM t WHERE a > 5 AND a < 9 AND b = 60;"));
+  EXPECT_EQ("", Query("SELECT a FROM t WHERE a > 10 AND a < 10;"));
+  EXPECT_EQ("1996,\n", Query("SELECT COUNT(*) FROM t WHERE a NOT BETWEEN 1 AND 4;"));
+
+  // a delete reads the tuples to delete through the index, which it updates
+  EXPECT_EQ("1,\n", Query("DELETE FROM t WHERE a = 7;"));
+  EXPECT_EQ("6,\n8,\n", Query("SELECT a FROM t WHERE a BETWEEN 6 AND 8;"));
+  EXPECT_EQ("10,\n", Query("DELETE FROM t WHERE a >= 1990;"));
+  EXPECT_EQ("1988,\n1989,\n", Query("SELECT a FROM t WHERE a > 1987;"));
+}
+
+// NOLINTNEXTLINE
+TEST_F(IndexScanTest, CompositeKeyTest) {
+  // SQL has no BIGINT columns, the table is created and loaded through the catalog
+  Schema schema({Column("tenant", TypeId::INTEGER), Column("id", TypeId::BIGINT), Column("v", TypeId::INTEGER)});
+  auto *txn = bustub_->txn_manager_->Begin();
+  auto *table_info = bustub_->catalog_->CreateTable(txn, "o", schema);
+  std::vector<std::pair<int, int>> keys;
+  for (int tenant = 0; tenant < 10; tenant++) {
+    for (int id = 0; id < 200; id++) {
+      keys.emplace_back(tenant, id);
+    }
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  for (auto [tenant, id] : keys) {
+    RID rid;
+    Tuple tuple({Value(TypeId::INTEGER, tenant), Value(TypeId::BIGINT, static_cast<int64_t>(id)),
+                 Value(TypeId::INTEGER, tenant * 1000 + id)},
+                &schema);
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, txn));
+  }
+  bustub_->txn_manager_->Commit(txn);
+  delete txn;
+  NoopWriter noop;
+  ASSERT_TRUE(bustub_->ExecuteSql("CREATE INDEX o_tenant_id ON o(tenant, id);", noop));
+
+  // equality on the leading key columns and a range on the next one
+  auto plan = Query("EXPLAIN SELECT * FROM o WHERE tenant = 3 AND id >= 10 AND id < 20;");
+  EXPECT_NE(std::string::npos, plan.find("range=[(3, 10), (3, 20))"));
+  EXPECT_NE(std::string::npos, Query("EXPLAIN SELECT * FROM o WHERE tenant = 3;").find("range=[3, 3]"));
+  EXPECT_NE(std::string::npos, Query("EXPLAIN SELECT * FROM o WHERE tenant > 8;").find("range=(8, +inf)"));
+  EXPECT_EQ(std::string::npos, Query("EXPLAIN SELECT * FROM o WHERE id = 5;").find("IndexScan"));
+  plan = Query("EXPLAIN (o) SELECT * FROM o ORDER BY tenant, id;");
+  EXPECT_NE(std::string::npos, plan.find("IndexScan"));
+  EXPECT_EQ(std::string::npos, plan.find("Sort"));
+
+  EXPECT_EQ("3010,\n3011,\n3012,\n", Query("SELECT v FROM o WHERE tenant = 3 AND id BETWEEN 10 AND 12;"));
+  EXPECT_EQ("198,\n199,\n", Query("SELECT id FROM o WHERE id > 197 AND tenant = 3;"));
+  EXPECT_EQ("0,\n1,\n", Query("SELECT id FROM o WHERE tenant = 9 AND id < 2;"));
+  EXPECT_EQ("200,\n", Query("SELECT COUNT(*) FROM o WHERE tenant = 3;"));
+  EXPECT_EQ("200,\n", Query("SELECT COUNT(*) FROM o WHERE tenant > 8;"));
+  EXPECT_EQ("400,\n", Query("SELECT COUNT(*) FROM o WHERE tenant < 2;"));
+  EXPECT_EQ("", Query("SELECT id FROM o WHERE tenant = 10;"));
+  EXPECT_EQ("", Query("SELECT id FROM o WHERE tenant = 3 AND id > 199;"));
+}
+
+// NOLINTNEXTLINE
+TEST_F(IndexScanTest, VarcharKeyTest) {
+  NoopWriter noop;
+  ASSERT_TRUE(bustub_->ExecuteSql("CREATE TABLE u (name VARCHAR(20), v INTEGER);", noop));
+  std::string values;
+  for (int i = 0; i < 500; i++) {
+    values += fmt::format("{}('user{:04}', {})", values.empty() ? "" : ", ", (i * 7) % 500, i);
+  }
+  ASSERT_TRUE(bustub_->ExecuteSql(fmt::format("INSERT INTO u VALUES {};", values), noop));
+  ASSERT_TRUE(bustub_->ExecuteSql("CREATE INDEX u_name ON u(name);", noop));
+
+  EXPECT_NE(std::string::npos, Query("EXPLAIN SELECT * FROM u WHERE name = 'user0042';").find("IndexScan"));
+  EXPECT_EQ("user0042,6,\n", Query("SELECT * FROM u WHERE name = 'user0042';"));
+  EXPECT_EQ("user0010,\nuser0011,\nuser0012,\n",
+            Query("SELECT name FROM u WHERE name BETWEEN 'user0010' AND 'user0012';"));
+  EXPECT_EQ("user0498,\nuser0499,\n", Query("SELECT name FROM u WHERE name > 'user0497';"));
+  EXPECT_EQ("1,\n", Query("INSERT INTO u VALUES ('a', 1);"));
+  EXPECT_EQ("a,\n", Query("SELECT name FROM u WHERE name < 'user';"));
+
+  // a string longer than the column does not fit in a key, the table is scanned
+  auto long_name = std::string(30, 'u');
+  auto plan = Query(fmt::format("EXPLAIN SELECT * FROM u WHERE name = '{}';", long_name));
+  EXPECT_EQ(std::string::npos, plan.find("IndexScan"));
+  EXPECT_EQ("", Query(fmt::format("SELECT * FROM u WHERE name = '{}';", long_name)));
+}
+
+// NOLINTNEXTLINE
+TEST_F(IndexScanTest, WideVarcharKeyTest) {
+  NoopWriter noop;
+  ASSERT_TRUE(bustub_->ExecuteSql("CREATE TABLE w (name VARCHAR(128), v INTEGER);", noop));
+  // long names sharing a long prefix, which the leaves elide
+  auto prefix = std::string(100, 'w');
+  std::string values;
+  for (int i = 0; i < 300; i++) {
+    values += fmt::format("{}('{}{:04}', {})", values.empty() ? "" : ", ", prefix, (i * 7) % 300, i);
+  }
+  ASSERT_TRUE(bustub_->ExecuteSql(fmt::format("INSERT INTO w VALUES {};", values), noop));
+  ASSERT_TRUE(bustub_->ExecuteSql("CREATE INDEX w_name ON w(name);", noop));
+  ASSERT_TRUE(bustub_->ExecuteSql("CREATE INDEX w_name_v ON w USING HASH (name, v);", noop));
+
+  auto query = fmt::format("SELECT v FROM w WHERE name = '{}0042';", prefix);
+  EXPECT_NE(std::string::npos, Query("EXPLAIN " + query).find("IndexScan"));
+  EXPECT_EQ("6,\n", Query(query));
+  query = fmt::format("SELECT v FROM w WHERE name > '{}0296' ORDER BY v;", prefix);
+  EXPECT_EQ("171,\n214,\n257,\n", Query(query));
+  query = fmt::format("SELECT v FROM w WHERE name = '{}0042' AND v = 6;", prefix);
+  EXPECT_NE(std::string::npos, Query("EXPLAIN " + query).find("index_oid=2"));
+  EXPECT_EQ("6,\n", Query(query));
+
+  // a key wider than the widest key type is not indexed
+  ASSERT_TRUE(bustub_->ExecuteSql("CREATE TABLE x (name VARCHAR(300));", noop));
+  EXPECT_THROW(bustub_->ExecuteSql("CREATE INDEX x_name ON x(name);", noop), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(IndexScanTest, HashIndexTest) {
+  NoopWriter noop;
+  ASSERT_TRUE(bustub_->ExecuteSql("CREATE INDEX tb ON t USING HASH (b);", noop));
+  ASSERT_TRUE(bustub_->ExecuteSql("CREATE INDEX tab ON t USING HASH (a, b);", noop));
+
+  // a hash index is probed for a whole key, and preferred to a B+ tree restricted as much
+  EXPECT_NE(std::string::npos, Query("EXPLAIN SELECT * FROM t WHERE b = 100;").find("index_oid=1, range=[100, 100]"));
+  auto plan = Query("EXPLAIN SELECT * FROM t WHERE a = 10 AND b = 100;");
+  EXPECT_NE(std::string::npos, plan.find("index_oid=2, range=[(10, 100), (10, 100)]"));
+  EXPECT_NE(std::string::npos, Query("EXPLAIN SELECT * FROM t WHERE a = 10;").find("index_oid=0"));
+  EXPECT_EQ(std::string::npos, Query("EXPLAIN SELECT * FROM t WHERE b > 100;").find("IndexScan"));
+  plan = Query("EXPLAIN (o) SELECT * FROM t ORDER BY b;");
+  EXPECT_EQ(std::string::npos, plan.find("IndexScan"));
+  ASSERT_TRUE(bustub_->ExecuteSql("CREATE TABLE s (x INTEGER);", noop));
+  ASSERT_TRUE(bustub_->ExecuteSql("INSERT INTO s VALUES (100), (200), (250);", noop));
+  EXPECT_NE(std::string::npos, Query("EXPLAIN SELECT * FROM s, t WHERE s.x = t.b;").find("NestedIndexJoin"));
+
+  EXPECT_EQ("10,100,\n", Query("SELECT * FROM t WHERE b = 100;"));
+  EXPECT_EQ("", Query("SELECT * FROM t WHERE b = 105;"));
+  EXPECT_EQ("10,100,\n", Query("SELECT * FROM t WHERE a = 10 AND b = 100;"));
+  EXPECT_EQ("", Query("SELECT * FROM t WHERE a = 11 AND b = 100;"));
+  EXPECT_EQ("10,100,\n20,200,\n25,250,\n", Query("SELECT t.a, t.b FROM s, t WHERE s.x = t.b ORDER BY t.a;"));
+
+  // the hash indexes are kept up to date
+  EXPECT_EQ("1,\n", Query("DELETE FROM t WHERE b = 100;"));
+  EXPECT_EQ("", Query("SELECT * FROM t WHERE b = 100;"));
+  EXPECT_EQ("2,\n", Query("INSERT INTO t VALUES (3000, 100), (3001, 100);"));
+  EXPECT_EQ("3000,\n3001,\n", Query("SELECT a FROM t WHERE b = 100 ORDER BY a;"));
+  EXPECT_EQ("3001,100,\n", Query("SELECT * FROM t WHERE a = 3001 AND b = 100;"));
+
+  EXPECT_THROW(bustub_->ExecuteSql("CREATE INDEX tg ON t USING GIST (a);", noop), Exception);
+}
+
+}  // namespace bustub
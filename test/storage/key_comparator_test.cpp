@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_comparator_test.cpp
+//
+// Identification: test/storage/key_comparator_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <limits>
+#include <random>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/**
+ * Check that a comparator orders random keys of the schema as the GenericComparator does. The values of each column
+ * are drawn from a few candidates, so that the keys often share their first columns.
+ */
+template <size_t KeySize, typename KeyComparator>
+void CheckComparator(Schema *key_schema, const std::vector<std::vector<int64_t>> &candidates) {
+  GenericComparator<KeySize> generic_comparator(key_schema);
+  KeyComparator comparator(key_schema);
+  std::mt19937_64 generator(KeySize);
+  auto random_key = [&] {
+    std::vector<Value> values;
+    for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+      auto pick = std::uniform_int_distribution<size_t>(0, candidates[i].size() - 1)(generator);
+      values.push_back(ValueFactory::GetBigIntValue(candidates[i][pick]).CastAs(key_schema->GetColumn(i).GetType()));
+    }
+    GenericKey<KeySize> key;
+    key.SetFromKey(Tuple(values, key_schema));
+    return key;
+  };
+  for (int i = 0; i < 2000; i++) {
+    auto lhs = random_key();
+    auto rhs = random_key();
+    ASSERT_EQ(generic_comparator(lhs, rhs), comparator(lhs, rhs));
+    ASSERT_EQ(-comparator(lhs, rhs), comparator(rhs, lhs));
+    ASSERT_EQ(0, comparator(lhs, lhs));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(KeyComparatorTest, IntegerComparatorTest) {
+  // the smallest value of each type stands for NULL, so the keys hold the values above it
+  const int64_t int_max = std::numeric_limits<int32_t>::max();
+  const int64_t bigint_max = std::numeric_limits<int64_t>::max();
+  Schema integer_schema({{"a", TypeId::INTEGER}});
+  CheckComparator<4, IntegerComparator<4, int32_t>>(&integer_schema, {{-int_max, -256, -1, 0, 1, 255, 256, int_max}});
+  Schema bigint_schema({{"a", TypeId::BIGINT}});
+  CheckComparator<8, IntegerComparator<8, int64_t>>(&bigint_schema, {{-bigint_max, -1, 0, 1, int_max + 1, bigint_max}});
+
+  Schema columns_schema(
+      {{"a", TypeId::SMALLINT}, {"b", TypeId::BIGINT}, {"c", TypeId::TINYINT}, {"d", TypeId::INTEGER}});
+  CheckComparator<16, IntegerColumnsComparator<16>>(
+      &columns_schema, {{-1000, 0, 1000}, {-(int64_t{1} << 40), 7, int64_t{1} << 40}, {-100, 1, 100}, {-1, 0, 1}});
+}
+
+// NOLINTNEXTLINE
+TEST(KeyComparatorTest, PickComparatorTest) {
+  auto comparator_of = [](const Schema &key_schema) {
+    return VisitBPlusTreeIndexTypes(key_schema, [](auto types) {
+      return std::string(typeid(typename decltype(types)::KeyComparator).name());
+    });
+  };
+  EXPECT_EQ(typeid(IntegerComparator<4, int32_t>).name(), comparator_of(Schema({{"a", TypeId::INTEGER}})));
+  EXPECT_EQ(typeid(IntegerComparator<8, int64_t>).name(), comparator_of(Schema({{"a", TypeId::BIGINT}})));
+  EXPECT_EQ(typeid(IntegerColumnsComparator<8>).name(),
+            comparator_of(Schema({{"a", TypeId::INTEGER}, {"b", TypeId::SMALLINT}})));
+  EXPECT_EQ(typeid(IntegerColumnsComparator<16>).name(),
+            comparator_of(Schema({{"a", TypeId::INTEGER}, {"b", TypeId::BIGINT}})));
+  EXPECT_EQ(typeid(GenericComparator<8>).name(), comparator_of(Schema({{"a", TypeId::DECIMAL}})));
+  EXPECT_EQ(typeid(GenericComparator<16>).name(),
+            comparator_of(Schema({{"a", TypeId::INTEGER}, {"b", TypeId::DECIMAL}})));
+  EXPECT_EQ(typeid(GenericComparator<128>).name(), comparator_of(Schema({{"a", TypeId::VARCHAR, 64}})));
+  EXPECT_EQ(typeid(GenericComparator<256>).name(),
+            comparator_of(Schema({{"a", TypeId::VARCHAR, VARCHAR_DEFAULT_LENGTH}})));
+}
+
+}  // namespace bustub
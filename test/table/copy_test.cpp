@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// copy_test.cpp
+//
+// Identification: test/table/copy_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/bustub_instance.h"
+#include "execution/executors/copy_executor.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(CopyTest, BulkInsertTuplesTest) {
+  remove("test.db");
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(10, disk_manager.get());
+  Schema schema(std::vector<Column>{{"a", TypeId::INTEGER}, {"b", TypeId::VARCHAR, 100}});
+  Transaction txn(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, &txn);
+
+  RID first_rid;
+  ASSERT_TRUE(table.InsertTuple(
+      Tuple({ValueFactory::GetIntegerValue(-1), ValueFactory::GetVarcharValue("first")}, &schema), &first_rid, &txn));
+
+  // Many more pages than frames: the filled pages are written out as the load goes.
+  const int num_tuples = 2000;
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < num_tuples; i++) {
+    tuples.emplace_back(
+        std::vector<Value>{ValueFactory::GetIntegerValue(i),
+                           ValueFactory::GetVarcharValue(std::string(100, static_cast<char>('a' + i % 26)))},
+        &schema);
+  }
+  std::vector<RID> rids;
+  ASSERT_TRUE(table.BulkInsertTuples(tuples, &rids, &txn));
+  ASSERT_EQ(num_tuples, rids.size());
+  // The last page of the table is filled before new pages are appended.
+  EXPECT_EQ(first_rid.GetPageId(), rids[0].GetPageId());
+
+  int count = -1;
+  for (auto iter = table.Begin(&txn); iter != table.End(); ++iter) {
+    EXPECT_EQ(count, iter->GetValue(&schema, 0).GetAs<int32_t>());
+    count++;
+  }
+  EXPECT_EQ(num_tuples, count);
+
+  Tuple tuple;
+  ASSERT_TRUE(table.GetTuple(rids[1234], &tuple, &txn));
+  EXPECT_EQ(1234, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("test.db");
+}
+
+// NOLINTNEXTLINE
+TEST(CopyTest, CopyFromFileTest) {
+  const std::string file_name = "copy_test.csv";
+  {
+    std::ofstream file(file_name);
+    file << "id,name,score\n";
+    // more rows than a batch, which are indexed batch by batch
+    for (int i = 0; i < 10000; i++) {
+      file << (9999 - i) << ",\"name, " << i << "\"," << (i % 2 == 0 ? std::to_string(i * 10) : "") << "\n";
+    }
+  }
+
+  auto bustub = std::make_unique<BustubInstance>();
+  NoopWriter noop;
+  bustub->ExecuteSql("CREATE TABLE t (id INTEGER, name VARCHAR(32), score INTEGER);", noop);
+  bustub->ExecuteSql("CREATE INDEX t_id ON t(id);", noop);
+
+  std::stringstream result;
+  SimpleStreamWriter writer(result, true, ",");
+  bustub->ExecuteSql("COPY t FROM '" + file_name + "' (FORMAT csv, HEADER);", writer);
+  EXPECT_EQ("10000,\n", result.str());
+
+  // The index was built from the loaded rows.
+  result.str("");
+  bustub->ExecuteSql("SELECT id, name, score FROM t WHERE id = 997;", writer);
+  EXPECT_EQ("997,name, 9002,90020,\n", result.str());
+
+  result.str("");
+  bustub->ExecuteSql("SELECT id, name, score FROM t WHERE id = 9997;", writer);
+  EXPECT_EQ("9997,name, 2,20,\n", result.str());
+
+  result.str("");
+  bustub->ExecuteSql("SELECT COUNT(*), COUNT(score) FROM t;", writer);
+  EXPECT_EQ("10000,5000,\n", result.str());
+
+  // A malformed file loads nothing, even past the rows of a full batch before the bad line.
+  {
+    std::ofstream file(file_name);
+    for (size_t i = 0; i < CopyExecutor::BATCH_SIZE + 10; i++) {
+      file << (20000 + i) << ",a,1\n";
+    }
+    file << "2,b\n";
+  }
+  result.str("");
+  EXPECT_FALSE(bustub->ExecuteSql("COPY t FROM '" + file_name + "';", writer));
+
+  result.str("");
+  bustub->ExecuteSql("SELECT COUNT(*) FROM t;", writer);
+  EXPECT_EQ("10000,\n", result.str());
+
+  result.str("");
+  bustub->ExecuteSql("SELECT id FROM t WHERE id = 20000;", writer);
+  EXPECT_EQ("", result.str());
+
+  remove(file_name.c_str());
+}
+
+}  // namespace bustub
@@ -0,0 +1,270 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// dictionary_test.cpp
+//
+// Identification: test/table/dictionary_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "common/bustub_instance.h"
+#include "execution/dictionary_filter.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/table_scanner.h"
+#include "storage/table/tuple.h"
+#include "table_heap_test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class DictionaryTest : public TableHeapTestBase {
+ protected:
+  DictionaryTest()
+      : TableHeapTestBase(
+            20, {{"a", TypeId::INTEGER}, {"b", TypeId::VARCHAR, 32, true}, {"c", TypeId::VARCHAR, 32, true}}),
+        plain_schema_(std::make_unique<Schema>(
+            std::vector<Column>{{"a", TypeId::INTEGER}, {"b", TypeId::VARCHAR, 32}, {"c", TypeId::VARCHAR, 32}})) {}
+
+  /** A low-cardinality status in b, and a country in c which is NULL for every tenth i. */
+  static auto Status(int i) -> std::string { return "status-" + std::to_string(i % 4); }
+
+  static auto Country(int i) -> std::string { return i % 3 == 0 ? "status-0" : "country-" + std::to_string(i % 3); }
+
+  auto MakeTuple(int i, const Schema *schema) -> Tuple {
+    auto c =
+        i % 10 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR) : ValueFactory::GetVarcharValue(Country(i));
+    return Tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(Status(i)), c}, schema};
+  }
+
+  /** @return the expression `#0.column_idx comp_type 'value'` */
+  static auto Compare(uint32_t column_idx, ComparisonType comp_type, const std::string &value)
+      -> AbstractExpressionRef {
+    return std::make_shared<ComparisonExpression>(
+        std::make_shared<ColumnValueExpression>(0, column_idx, TypeId::VARCHAR),
+        std::make_shared<ConstantValueExpression>(ValueFactory::GetVarcharValue(value)), comp_type);
+  }
+
+  std::unique_ptr<Schema> plain_schema_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(DictionaryTest, EncodeDecodeTest) {
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), nullptr, nullptr, &txn, TableFormat::ROW, schema_.get());
+  TableHeap plain_table(bpm_.get(), nullptr, nullptr, &txn, TableFormat::ROW, plain_schema_.get());
+  auto *dictionary = table.GetDictionary();
+  ASSERT_NE(nullptr, dictionary);
+  EXPECT_EQ(nullptr, plain_table.GetDictionary());
+
+  const int num_tuples = 2000;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; i++) {
+    RID rid;
+    RID plain_rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(i, schema_.get()), &rid, &txn));
+    ASSERT_TRUE(plain_table.InsertTuple(MakeTuple(i, plain_schema_.get()), &plain_rid, &txn));
+    rids.push_back(rid);
+  }
+  // The columns share one dictionary: "status-0" appears in both.
+  EXPECT_EQ(6, dictionary->Size());
+  EXPECT_TRUE(dictionary->Lookup("country-1").has_value());
+  EXPECT_FALSE(dictionary->Lookup("country-0").has_value());
+  // Codes take less room than the strings.
+  EXPECT_LT(table.GetFreeSpaceMap()->Size() * 3 / 2, plain_table.GetFreeSpaceMap()->Size());
+
+  Tuple tuple;
+  ASSERT_TRUE(table.GetTuple(rids[7], &tuple, &txn));
+  EXPECT_EQ(Status(7), tuple.GetValue(schema_.get(), 1).ToString());
+  EXPECT_EQ(Country(7), tuple.GetValue(schema_.get(), 2).ToString());
+  EXPECT_EQ(rids[7], tuple.GetRid());
+  ASSERT_TRUE(table.GetTuple(rids[10], &tuple, &txn));
+  EXPECT_TRUE(tuple.IsNull(schema_.get(), 2));
+
+  int i = 0;
+  for (auto it = table.Begin(&txn); it != table.End(); ++it, ++i) {
+    EXPECT_EQ(Status(i), it->GetValue(schema_.get(), 1).ToString());
+  }
+  EXPECT_EQ(num_tuples, i);
+
+  // An update adds its new value; the write set keeps the old values for a rollback.
+  auto updated = Tuple{{ValueFactory::GetIntegerValue(7), ValueFactory::GetVarcharValue("new"),
+                        ValueFactory::GetVarcharValue(Country(7))},
+                       schema_.get()};
+  ASSERT_TRUE(table.UpdateTuple(updated, rids[7], &txn));
+  EXPECT_EQ(7, dictionary->Size());
+  EXPECT_EQ(Status(7), txn.GetWriteSet()->back().tuple_.GetValue(schema_.get(), 1).ToString());
+  ASSERT_TRUE(table.GetTuple(rids[7], &tuple, &txn));
+  EXPECT_EQ("new", tuple.GetValue(schema_.get(), 1).ToString());
+
+  // Enough distinct values to fill a few dictionary pages, which are read back by a reopened table.
+  for (int j = 0; j < 500; j++) {
+    RID rid;
+    auto value = std::string(20, 'x') + std::to_string(j);
+    Tuple distinct{{ValueFactory::GetIntegerValue(j), ValueFactory::GetVarcharValue(value),
+                    ValueFactory::GetVarcharValue(value)},
+                   schema_.get()};
+    ASSERT_TRUE(table.InsertTuple(distinct, &rid, &txn));
+    rids.push_back(rid);
+  }
+  TableHeap reopened(bpm_.get(), nullptr, nullptr, table.GetFirstPageId(), TableFormat::ROW, schema_.get(),
+                     dictionary->GetFirstPageId());
+  EXPECT_EQ(dictionary->Size(), reopened.GetDictionary()->Size());
+  ASSERT_TRUE(reopened.GetTuple(rids.back(), &tuple, &txn));
+  EXPECT_EQ(std::string(20, 'x') + "499", tuple.GetValue(schema_.get(), 2).ToString());
+  ASSERT_TRUE(reopened.GetTuple(rids[7], &tuple, &txn));
+  EXPECT_EQ("new", tuple.GetValue(schema_.get(), 1).ToString());
+}
+
+// NOLINTNEXTLINE
+TEST_F(DictionaryTest, PaxTest) {
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), nullptr, nullptr, &txn, TableFormat::PAX, schema_.get());
+  const int num_tuples = 1000;
+  for (int i = 0; i < num_tuples; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(i, schema_.get()), &rid, &txn));
+  }
+  // Three 4-byte minipage entries per tuple.
+  EXPECT_EQ(12, PaxLayout(table.GetDictionary()->GetEncodedSchema()).GetTupleWidth());
+
+  int i = 0;
+  for (auto it = table.Begin(&txn, {1}); it != table.End(); ++it, ++i) {
+    EXPECT_EQ(Status(i), it->GetValue(schema_.get(), 1).ToString());
+    EXPECT_TRUE(it->IsNull(schema_.get(), 2));
+  }
+  EXPECT_EQ(num_tuples, i);
+}
+
+// NOLINTNEXTLINE
+TEST_F(DictionaryTest, FilterTest) {
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), nullptr, nullptr, &txn, TableFormat::ROW, schema_.get());
+  const int num_tuples = 1000;
+  for (int i = 0; i < num_tuples; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(i, schema_.get()), &rid, &txn));
+  }
+
+  // Count the tuples passing a filter on their codes, and check they are decoded.
+  auto count = [&](const AbstractExpressionRef &predicate) {
+    DictionaryFilter filter(predicate, &table);
+    EXPECT_FALSE(filter.IsEmpty());
+    TableScanner scanner(&table, std::nullopt, nullptr, [&](const Tuple &encoded) { return filter.Evaluate(encoded); });
+    int num_matched = 0;
+    while (scanner.NextPage([&](const TupleView &view) {
+      EXPECT_EQ(Status(view.GetValue(schema_.get(), 0).GetAs<int32_t>()), view.GetValue(schema_.get(), 1).ToString());
+      num_matched++;
+    })) {
+    }
+    return num_matched;
+  };
+  EXPECT_EQ(num_tuples / 4, count(Compare(1, ComparisonType::Equal, "status-1")));
+  EXPECT_EQ(num_tuples * 3 / 4, count(Compare(1, ComparisonType::NotEqual, "status-1")));
+  EXPECT_EQ(0, count(Compare(1, ComparisonType::Equal, "missing")));
+  // b = c compares the codes of both columns; only "status-0" is in both, for i % 12 == 0 but not i % 10 == 0.
+  EXPECT_EQ(67, count(std::make_shared<ComparisonExpression>(
+                    std::make_shared<ColumnValueExpression>(0, 1, TypeId::VARCHAR),
+                    std::make_shared<ColumnValueExpression>(0, 2, TypeId::VARCHAR), ComparisonType::Equal)));
+  // The other columns of a conjunction are evaluated as they are.
+  auto conjunction = std::make_shared<LogicExpression>(
+      Compare(1, ComparisonType::Equal, "status-2"),
+      std::make_shared<ComparisonExpression>(
+          std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER),
+          std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(100)), ComparisonType::LessThan),
+      LogicType::And);
+  EXPECT_EQ(25, count(conjunction));
+
+  // Codes do not follow the order of the strings.
+  EXPECT_TRUE(DictionaryFilter(Compare(1, ComparisonType::LessThan, "status-1"), &table).IsEmpty());
+}
+
+// NOLINTNEXTLINE
+TEST(DictionarySqlTest, QueryTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  NoopWriter noop;
+  ASSERT_TRUE(bustub->ExecuteSql(
+      "CREATE TABLE t (a INTEGER, b VARCHAR(16) USING COMPRESSION dictionary, c VARCHAR(16) USING COMPRESSION "
+      "dictionary);",
+      noop));
+  ASSERT_TRUE(bustub->catalog_->GetTable("t")->schema_.GetColumn(1).IsDictionaryEncoded());
+  ASSERT_TRUE(bustub->ExecuteSql(
+      "INSERT INTO t VALUES (1, 'open', 'fr'), (2, 'closed', 'de'), (3, 'open', 'de'), (4, 'open', 'it');", noop));
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE TABLE u (c VARCHAR(16), name VARCHAR(16));", noop));
+  ASSERT_TRUE(bustub->ExecuteSql("INSERT INTO u VALUES ('fr', 'France'), ('de', 'Germany');", noop));
+
+  std::stringstream result;
+  SimpleStreamWriter writer(result, true, ",");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT a FROM t WHERE b = 'open' AND c <> 'fr' ORDER BY a;", writer));
+  EXPECT_EQ("3,\n4,\n", result.str());
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT b, COUNT(*) FROM t GROUP BY b ORDER BY b;", writer));
+  EXPECT_EQ("closed,1,\nopen,3,\n", result.str());
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT t.a, u.name FROM t INNER JOIN u ON t.c = u.c ORDER BY t.a;", writer));
+  EXPECT_EQ("1,France,\n2,Germany,\n3,Germany,\n", result.str());
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT a FROM t WHERE b > 'closed' ORDER BY a;", writer));
+  EXPECT_EQ("1,\n3,\n4,\n", result.str());
+
+  EXPECT_THROW(bustub->ExecuteSql("CREATE TABLE v (a INTEGER USING COMPRESSION dictionary);", noop), Exception);
+  EXPECT_THROW(bustub->ExecuteSql("CREATE TABLE v (a VARCHAR(8) USING COMPRESSION rle);", noop),
+               NotImplementedException);
+}
+
+// NOLINTNEXTLINE
+TEST(DictionarySqlTest, ReopenTest) {
+  remove("dictionary_test.db");
+  Schema schema{std::vector<Column>{{"a", TypeId::INTEGER}, {"b", TypeId::VARCHAR, 16, true}}};
+  {
+    auto disk_manager = std::make_unique<DiskManager>("dictionary_test.db");
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+    auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+    catalog->Bootstrap(true);
+    Transaction txn(0);
+    auto *table_info = catalog->CreateTable(&txn, "t", schema);
+    for (int i = 0; i < 100; i++) {
+      RID rid;
+      Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::to_string(i % 7))}, &schema);
+      ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, &txn));
+    }
+    catalog.reset();
+    bpm->FlushAllPages();
+    disk_manager->ShutDown();
+  }
+
+  auto disk_manager = std::make_unique<DiskManager>("dictionary_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  catalog->Bootstrap(false);
+  Transaction txn(1);
+  auto *table_info = catalog->GetTable("t");
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  EXPECT_TRUE(table_info->schema_.GetColumn(1).IsDictionaryEncoded());
+  EXPECT_EQ(7, table_info->table_->GetDictionary()->Size());
+  int i = 0;
+  for (auto it = table_info->table_->Begin(&txn); it != table_info->table_->End(); ++it, ++i) {
+    EXPECT_EQ(std::to_string(i % 7), it->GetValue(&schema, 1).ToString());
+  }
+  EXPECT_EQ(100, i);
+
+  disk_manager->ShutDown();
+  remove("dictionary_test.db");
+}
+
+}  // namespace bustub
@@ -0,0 +1,171 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_test.cpp
+//
+// Identification: test/table/free_space_map_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/table/free_space_map.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FreeSpaceMapTest, FindPageTest) {
+  FreeSpaceMap fsm;
+  EXPECT_EQ(INVALID_PAGE_ID, fsm.FindPage(1));
+
+  for (page_id_t page_id = 0; page_id < 10; page_id++) {
+    fsm.Update(page_id, 100);
+  }
+  fsm.Update(7, 1000);
+  EXPECT_EQ(10, fsm.Size());
+
+  // Free space is rounded down to a category, so a page is never reported with more room than it has.
+  EXPECT_EQ(96, fsm.GetFreeSpace(3));
+  EXPECT_EQ(7, fsm.FindPage(500));
+  EXPECT_EQ(7, fsm.FindPage(500, 8));
+  EXPECT_EQ(INVALID_PAGE_ID, fsm.FindPage(1001));
+  EXPECT_EQ(INVALID_PAGE_ID, fsm.FindPage(BUSTUB_PAGE_SIZE * 2));
+
+  // The hint picks where the search starts, and the search wraps around.
+  EXPECT_EQ(0, fsm.FindPage(50));
+  EXPECT_EQ(4, fsm.FindPage(50, 4));
+  EXPECT_EQ(2, fsm.FindPage(50, 12));
+
+  fsm.Update(7, 0);
+  EXPECT_EQ(INVALID_PAGE_ID, fsm.FindPage(500));
+  EXPECT_EQ(0, fsm.GetFreeSpace(42));
+}
+
+// NOLINTNEXTLINE
+TEST(FreeSpaceMapTest, RemoveTest) {
+  FreeSpaceMap fsm;
+  for (page_id_t page_id = 0; page_id < 5; page_id++) {
+    fsm.Update(page_id, 100 * (page_id + 1));
+  }
+  fsm.Remove(1);
+  fsm.Remove(42);
+  EXPECT_EQ(4, fsm.Size());
+  EXPECT_EQ(0, fsm.GetFreeSpace(1));
+  EXPECT_EQ(496, fsm.GetFreeSpace(4));
+  // The last page moved into the hole left by page 1, and is still found.
+  EXPECT_EQ(4, fsm.FindPage(400));
+
+  fsm.Remove(4);
+  EXPECT_EQ(INVALID_PAGE_ID, fsm.FindPage(450));
+  EXPECT_EQ(3, fsm.FindPage(300));
+}
+
+class FreeSpaceMapTableHeapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    remove("test.db");
+    disk_manager_ = std::make_unique<DiskManager>("test.db");
+    bpm_ = std::make_unique<BufferPoolManagerInstance>(50, disk_manager_.get());
+    schema_ = std::make_unique<Schema>(std::vector<Column>{{"a", TypeId::INTEGER}, {"b", TypeId::VARCHAR, 100}});
+  }
+
+  void TearDown() override {
+    bpm_.reset();
+    disk_manager_->ShutDown();
+    remove("test.db");
+  }
+
+  auto MakeTuple(int i) -> Tuple {
+    return Tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(100, 'x'))},
+                 schema_.get()};
+  }
+
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManagerInstance> bpm_;
+  std::unique_ptr<Schema> schema_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(FreeSpaceMapTableHeapTest, ReuseFreedSpaceTest) {
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), nullptr, nullptr, &txn);
+
+  std::vector<RID> rids;
+  for (int i = 0; i < 500; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(i), &rid, &txn));
+    rids.push_back(rid);
+  }
+  auto num_pages = table.GetFreeSpaceMap()->Size();
+  ASSERT_GT(num_pages, 10);
+
+  // Free every other tuple, then insert as many again: all of them must land in the freed space.
+  for (size_t i = 0; i < rids.size(); i += 2) {
+    table.ApplyDelete(rids[i], &txn);
+  }
+  for (int i = 0; i < 250; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(i), &rid, &txn));
+  }
+  EXPECT_EQ(num_pages, table.GetFreeSpaceMap()->Size());
+
+  // A reopened table heap rebuilds the map from the page chain.
+  TableHeap reopened(bpm_.get(), nullptr, nullptr, table.GetFirstPageId());
+  EXPECT_EQ(num_pages, reopened.GetFreeSpaceMap()->Size());
+  EXPECT_EQ(table.GetFreeSpaceMap()->GetFreeSpace(rids.back().GetPageId()),
+            reopened.GetFreeSpaceMap()->GetFreeSpace(rids.back().GetPageId()));
+  RID rid;
+  ASSERT_TRUE(reopened.InsertTuple(MakeTuple(0), &rid, &txn));
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreeSpaceMapTableHeapTest, ConcurrentInsertTest) {
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), nullptr, nullptr, &txn);
+
+  const int num_threads = 4;
+  const int num_tuples = 300;
+  std::vector<std::vector<RID>> rids(num_threads);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid] {
+      Transaction thread_txn(tid + 1);
+      for (int i = 0; i < num_tuples; i++) {
+        RID rid;
+        ASSERT_TRUE(table.InsertTuple(MakeTuple(tid * num_tuples + i), &rid, &thread_txn));
+        rids[tid].push_back(rid);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::unordered_set<RID> unique_rids;
+  for (const auto &thread_rids : rids) {
+    unique_rids.insert(thread_rids.begin(), thread_rids.end());
+  }
+  EXPECT_EQ(num_threads * num_tuples, unique_rids.size());
+
+  std::set<int> values;
+  for (auto it = table.Begin(&txn); it != table.End(); ++it) {
+    values.insert(it->GetValue(schema_.get(), 0).GetAs<int32_t>());
+  }
+  EXPECT_EQ(num_threads * num_tuples, values.size());
+}
+
+}  // namespace bustub
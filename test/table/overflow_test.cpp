@@ -0,0 +1,164 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_test.cpp
+//
+// Identification: test/table/overflow_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "table_heap_test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class OverflowTest : public TableHeapTestBase {
+ protected:
+  OverflowTest()
+      : TableHeapTestBase(
+            20, {{"a", TypeId::INTEGER}, {"b", TypeId::VARCHAR, 100000}, {"c", TypeId::VARCHAR, 100000}}) {}
+
+  /** A value spanning a few overflow pages, different for every i. */
+  static auto LongValue(int i, size_t len = 3 * BUSTUB_PAGE_SIZE) -> std::string {
+    std::string value(len, static_cast<char>('a' + i % 26));
+    value.replace(0, std::to_string(i).size(), std::to_string(i));
+    return value;
+  }
+
+  auto MakeTuple(int i, const std::string &b, const std::string &c) -> Tuple {
+    return Tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(b), ValueFactory::GetVarcharValue(c)},
+                 schema_.get()};
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(OverflowTest, InsertScanTest) {
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), nullptr, nullptr, &txn, TableFormat::ROW, schema_.get());
+  EXPECT_TRUE(table.SupportsColumnPruning());
+
+  // Large tuples have their long values moved out of line, small ones are stored as they are.
+  const int num_tuples = 50;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; i++) {
+    RID rid;
+    auto tuple = i % 2 == 0 ? MakeTuple(i, LongValue(i), "short") : MakeTuple(i, "short", "short");
+    ASSERT_TRUE(table.InsertTuple(tuple, &rid, &txn));
+    rids.push_back(rid);
+  }
+  // Both values of a tuple may go out of line.
+  RID rid;
+  ASSERT_TRUE(table.InsertTuple(MakeTuple(num_tuples, LongValue(1, 2000), LongValue(2, 2000)), &rid, &txn));
+  rids.push_back(rid);
+
+  Tuple tuple;
+  ASSERT_TRUE(table.GetTuple(rids[10], &tuple, &txn));
+  EXPECT_EQ(LongValue(10), tuple.GetValue(schema_.get(), 1).ToString());
+  EXPECT_EQ("short", tuple.GetValue(schema_.get(), 2).ToString());
+  EXPECT_EQ(rids[10], tuple.GetRid());
+  ASSERT_TRUE(table.GetTuple(rids[num_tuples], &tuple, &txn));
+  EXPECT_EQ(LongValue(1, 2000), tuple.GetValue(schema_.get(), 1).ToString());
+  EXPECT_EQ(LongValue(2, 2000), tuple.GetValue(schema_.get(), 2).ToString());
+
+  int i = 0;
+  for (auto it = table.Begin(&txn); it != table.End(); ++it, ++i) {
+    EXPECT_EQ(i, it->GetValue(schema_.get(), 0).GetAs<int32_t>());
+    if (i % 2 == 0 && i < num_tuples) {
+      EXPECT_EQ(LongValue(i), it->GetValue(schema_.get(), 1).ToString());
+    }
+  }
+  EXPECT_EQ(num_tuples + 1, i);
+
+  // A scan which does not read the long column does not fetch its values.
+  i = 0;
+  for (auto it = table.Begin(&txn, {0, 2}); it != table.End(); ++it, ++i) {
+    EXPECT_EQ(i, it->GetValue(schema_.get(), 0).GetAs<int32_t>());
+    EXPECT_EQ(i % 2 == 0, it->IsNull(schema_.get(), 1));
+  }
+  EXPECT_EQ(num_tuples + 1, i);
+
+  // A tuple larger than a page even with its values out of line is still rejected.
+  std::vector<Column> columns;
+  std::vector<Value> values;
+  for (int j = 0; j < 400; j++) {
+    columns.emplace_back("v" + std::to_string(j), TypeId::VARCHAR, 100);
+    values.push_back(ValueFactory::GetVarcharValue(std::string(20, 'x')));
+  }
+  Schema wide_schema(columns);
+  TableHeap wide_table(bpm_.get(), nullptr, nullptr, &txn, TableFormat::ROW, &wide_schema);
+  EXPECT_FALSE(wide_table.InsertTuple(Tuple{values, &wide_schema}, &rid, &txn));
+}
+
+// NOLINTNEXTLINE
+TEST_F(OverflowTest, UpdateDeleteTest) {
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), nullptr, nullptr, &txn, TableFormat::ROW, schema_.get());
+  RID rid;
+  ASSERT_TRUE(table.InsertTuple(MakeTuple(0, LongValue(0), "short"), &rid, &txn));
+
+  // The write set keeps the whole old value, as its overflow pages are freed by the update.
+  ASSERT_TRUE(table.UpdateTuple(MakeTuple(0, LongValue(1), LongValue(2, 5000)), rid, &txn));
+  auto old_tuple = txn.GetWriteSet()->back().tuple_;
+  EXPECT_EQ(LongValue(0), old_tuple.GetValue(schema_.get(), 1).ToString());
+  Tuple tuple;
+  ASSERT_TRUE(table.GetTuple(rid, &tuple, &txn));
+  EXPECT_EQ(LongValue(1), tuple.GetValue(schema_.get(), 1).ToString());
+  EXPECT_EQ(LongValue(2, 5000), tuple.GetValue(schema_.get(), 2).ToString());
+
+  // Writing the old tuple back, as a rollback does, stores its value out of line again.
+  ASSERT_TRUE(table.UpdateTuple(old_tuple, rid, &txn));
+  ASSERT_TRUE(table.GetTuple(rid, &tuple, &txn));
+  EXPECT_EQ(LongValue(0), tuple.GetValue(schema_.get(), 1).ToString());
+
+  // Many inserts and deletes recycle the overflow pages through the small buffer pool.
+  for (int i = 1; i < 100; i++) {
+    ASSERT_TRUE(table.MarkDelete(rid, &txn));
+    table.ApplyDelete(rid, &txn);
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(i, LongValue(i), "short"), &rid, &txn));
+  }
+  ASSERT_TRUE(table.GetTuple(rid, &tuple, &txn));
+  EXPECT_EQ(LongValue(99), tuple.GetValue(schema_.get(), 1).ToString());
+
+  // A reopened table heap reads the values stored out of line.
+  TableHeap reopened(bpm_.get(), nullptr, nullptr, table.GetFirstPageId(), TableFormat::ROW, schema_.get());
+  ASSERT_TRUE(reopened.GetTuple(rid, &tuple, &txn));
+  EXPECT_EQ(LongValue(99), tuple.GetValue(schema_.get(), 1).ToString());
+}
+
+// NOLINTNEXTLINE
+TEST(OverflowSqlTest, LargeValueTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  NoopWriter noop;
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE TABLE t (a INTEGER, b VARCHAR(20000));", noop));
+  auto long_value = std::string(10000, 'x');
+  ASSERT_TRUE(bustub->ExecuteSql(fmt::format("INSERT INTO t VALUES (1, '{}'), (2, 'y');", long_value), noop));
+
+  std::stringstream result;
+  SimpleStreamWriter writer(result, true, ",");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT * FROM t;", writer));
+  EXPECT_EQ(fmt::format("1,{},\n2,y,\n", long_value), result.str());
+
+  // The scan only fetches the values of the columns it filters on and projects.
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("EXPLAIN SELECT a FROM t WHERE a > 0;", writer));
+  EXPECT_NE(std::string::npos, result.str().find("SeqScan { table=t, filter=(#0.0>0), columns=[0] }"));
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT a FROM t WHERE a > 0;", writer));
+  EXPECT_EQ("1,\n2,\n", result.str());
+}
+
+}  // namespace bustub
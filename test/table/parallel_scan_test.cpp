@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_scan_test.cpp
+//
+// Identification: test/table/parallel_scan_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "storage/table/morsel_dispenser.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(MorselDispenserTest, ConcurrentClaimTest) {
+  remove("test.db");
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(20, disk_manager.get());
+  Schema schema(std::vector<Column>{{"a", TypeId::INTEGER}, {"b", TypeId::VARCHAR, 100}});
+  Transaction txn(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, &txn, TableFormat::ROW, &schema);
+  const int num_tuples = 5000;
+  for (int i = 0; i < num_tuples; i++) {
+    RID rid;
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(50, 'x'))}, &schema};
+    ASSERT_TRUE(table.InsertTuple(tuple, &rid, &txn));
+  }
+  auto num_pages = table.GetFreeSpaceMap()->Size();
+
+  // Every page is handed out exactly once, and every tuple is visited once.
+  MorselDispenser dispenser(&table, 4);
+  std::mutex latch;
+  std::vector<page_id_t> page_ids;
+  std::set<size_t> indexes;
+  std::vector<int> values;
+  std::vector<std::thread> workers;
+  for (int w = 0; w < 4; w++) {
+    workers.emplace_back([&] {
+      Morsel morsel;
+      while (dispenser.Next(&morsel)) {
+        std::vector<int> morsel_values;
+        dispenser.VisitMorsel(morsel, nullptr, [&](const TupleView &view) {
+          morsel_values.push_back(view.GetValue(&schema, 0).GetAs<int32_t>());
+        });
+        std::scoped_lock lock(latch);
+        EXPECT_GE(4, morsel.page_ids_.size());
+        page_ids.insert(page_ids.end(), morsel.page_ids_.begin(), morsel.page_ids_.end());
+        indexes.insert(morsel.index_);
+        values.insert(values.end(), morsel_values.begin(), morsel_values.end());
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  EXPECT_EQ(num_pages, page_ids.size());
+  EXPECT_EQ(num_pages, std::set<page_id_t>(page_ids.begin(), page_ids.end()).size());
+  EXPECT_EQ((num_pages + 3) / 4, indexes.size());
+  EXPECT_EQ((num_pages + 3) / 4 - 1, *indexes.rbegin());
+  std::sort(values.begin(), values.end());
+  ASSERT_EQ(num_tuples, values.size());
+  for (int i = 0; i < num_tuples; i++) {
+    EXPECT_EQ(i, values[i]);
+  }
+
+  Morsel morsel;
+  EXPECT_FALSE(dispenser.Next(&morsel));
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove("test.db");
+}
+
+class ParallelScanSqlTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    saved_threads_ = parallel_scan_threads;
+    bustub_ = std::make_unique<BustubInstance>();
+    NoopWriter noop;
+    ASSERT_TRUE(bustub_->ExecuteSql("CREATE TABLE t (a INTEGER, b VARCHAR(100));", noop));
+    // Enough rows for well over PARALLEL_SCAN_MIN_PAGES pages.
+    for (int i = 0; i < num_tuples_; i += 500) {
+      std::string sql = "INSERT INTO t VALUES ";
+      for (int j = i; j < i + 500; j++) {
+        sql += fmt::format("{}({}, '{}')", j == i ? "" : ", ", j, std::string(50, 'a' + j % 3));
+      }
+      ASSERT_TRUE(bustub_->ExecuteSql(sql + ";", noop));
+    }
+    ASSERT_LE(PARALLEL_SCAN_MIN_PAGES, bustub_->catalog_->GetTable("t")->table_->GetFreeSpaceMap()->Size());
+  }
+
+  void TearDown() override { parallel_scan_threads = saved_threads_; }
+
+  auto Query(const std::string &sql) -> std::string {
+    std::stringstream result;
+    SimpleStreamWriter writer(result, true, ",");
+    EXPECT_TRUE(bustub_->ExecuteSql(sql, writer));
+    return result.str();
+  }
+
+  const int num_tuples_ = 10000;
+  size_t saved_threads_;
+  std::unique_ptr<BustubInstance> bustub_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(ParallelScanSqlTest, ScanTest) {
+  const std::vector<std::string> queries = {
+      "SELECT a FROM t;",
+      "SELECT a, b FROM t WHERE a >= 1234 AND a < 4321;",
+      "SELECT a FROM t WHERE b = 'nothing';",
+  };
+  parallel_scan_threads = 1;
+  std::vector<std::string> expected;
+  for (const auto &query : queries) {
+    expected.push_back(Query(query));
+  }
+
+  // The workers filter the tuples, which are still produced in table order.
+  parallel_scan_threads = 4;
+  for (size_t i = 0; i < queries.size(); i++) {
+    EXPECT_EQ(expected[i], Query(queries[i])) << queries[i];
+  }
+  EXPECT_NE(std::string::npos, Query("EXPLAIN SELECT a FROM t WHERE a > 5;").find("SeqScan { table=t, filter="));
+
+  // Deleting through a parallel scan.
+  NoopWriter noop;
+  ASSERT_TRUE(bustub_->ExecuteSql("DELETE FROM t WHERE a >= 100;", noop));
+  parallel_scan_threads = 1;
+  EXPECT_EQ("100,\n", Query("SELECT COUNT(*) FROM t;"));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ParallelScanSqlTest, AggregationTest) {
+  parallel_scan_threads = 4;
+  // The workers aggregate into partial hash tables, which are merged.
+  EXPECT_EQ(fmt::format("{},{},0,{},\n", num_tuples_, num_tuples_ * (num_tuples_ - 1) / 2, num_tuples_ - 1),
+            Query("SELECT COUNT(*), SUM(a), MIN(a), MAX(a) FROM t;"));
+  EXPECT_EQ("3000,\n", Query("SELECT COUNT(b) FROM t WHERE a >= 7000;"));
+  EXPECT_EQ("0,\n", Query("SELECT COUNT(*) FROM t WHERE a < 0;"));
+
+  auto grouped = Query("SELECT b, COUNT(*), MIN(a) FROM t GROUP BY b;");
+  for (int i = 0; i < 3; i++) {
+    auto row = fmt::format("{},{},{},\n", std::string(50, 'a' + i), (num_tuples_ + 2 - i) / 3, i);
+    EXPECT_NE(std::string::npos, grouped.find(row)) << row;
+  }
+}
+
+}  // namespace bustub
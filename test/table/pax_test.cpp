@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_test.cpp
+//
+// Identification: test/table/pax_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "table_heap_test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class PaxTableHeapTest : public TableHeapTestBase {};
+
+// NOLINTNEXTLINE
+TEST_F(PaxTableHeapTest, InsertScanTest) {
+  PaxLayout layout(*schema_);
+  // 4 + 4 bytes for the integers, and 4 + 20 + 1 bytes for the VARCHAR padded to 28.
+  EXPECT_EQ(36, layout.GetTupleWidth());
+  EXPECT_EQ(109, layout.GetCapacity());
+  EXPECT_EQ(0, layout.GetMinipageOffset(1) % 8);
+
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), nullptr, nullptr, &txn, TableFormat::PAX, schema_.get());
+  const int num_tuples = 1000;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(i), &rid, &txn));
+    rids.push_back(rid);
+  }
+  EXPECT_EQ((num_tuples + layout.GetCapacity() - 1) / layout.GetCapacity(), table.GetFreeSpaceMap()->Size());
+
+  // A value longer than its column does not fit in the minipage.
+  RID rid;
+  Tuple too_long{{ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue(std::string(30, 'x')),
+                  ValueFactory::GetIntegerValue(0)},
+                 schema_.get()};
+  EXPECT_FALSE(table.InsertTuple(too_long, &rid, &txn));
+  txn.SetState(TransactionState::GROWING);
+
+  Tuple tuple;
+  ASSERT_TRUE(table.GetTuple(rids[500], &tuple, &txn));
+  EXPECT_EQ(500, tuple.GetValue(schema_.get(), 0).GetAs<int32_t>());
+  EXPECT_EQ("value-500", tuple.GetValue(schema_.get(), 1).ToString());
+  EXPECT_EQ(1000, tuple.GetValue(schema_.get(), 2).GetAs<int32_t>());
+  EXPECT_EQ(rids[500], tuple.GetRid());
+
+  // Update in place, delete, and scan the rest.
+  ASSERT_TRUE(table.UpdateTuple(MakeTuple(-1), rids[1], &txn));
+  ASSERT_TRUE(table.MarkDelete(rids[2], &txn));
+  EXPECT_FALSE(table.GetTuple(rids[2], &tuple, &txn));
+  table.RollbackDelete(rids[2], &txn);
+  ASSERT_TRUE(table.GetTuple(rids[2], &tuple, &txn));
+  ASSERT_TRUE(table.MarkDelete(rids[3], &txn));
+  table.ApplyDelete(rids[3], &txn);
+  ASSERT_TRUE(table.MarkDelete(rids[4], &txn));
+  table.ApplyDelete(rids[4], &txn);
+
+  int count = 0;
+  int64_t sum = 0;
+  for (auto it = table.Begin(&txn); it != table.End(); ++it) {
+    sum += it->GetValue(schema_.get(), 0).GetAs<int32_t>();
+    count++;
+  }
+  EXPECT_EQ(num_tuples - 2, count);
+  EXPECT_EQ(static_cast<int64_t>(num_tuples) * (num_tuples - 1) / 2 - 2 - 3 - 4, sum);
+
+  // The freed slots are reused.
+  ASSERT_TRUE(table.InsertTuple(MakeTuple(3), &rid, &txn));
+  EXPECT_EQ(rids[3], rid);
+
+  // A reopened table reads the same pages.
+  TableHeap reopened(bpm_.get(), nullptr, nullptr, table.GetFirstPageId(), TableFormat::PAX, schema_.get());
+  ASSERT_TRUE(reopened.GetTuple(rids[999], &tuple, &txn));
+  EXPECT_EQ("value-999", tuple.GetValue(schema_.get(), 1).ToString());
+}
+
+// NOLINTNEXTLINE
+TEST_F(PaxTableHeapTest, ProjectionTest) {
+  Transaction txn(0);
+  TableHeap pax_table(bpm_.get(), nullptr, nullptr, &txn, TableFormat::PAX, schema_.get());
+  TableHeap row_table(bpm_.get(), nullptr, nullptr, &txn);
+  for (int i = 0; i < 200; i++) {
+    RID rid;
+    ASSERT_TRUE(pax_table.InsertTuple(MakeTuple(i), &rid, &txn));
+    ASSERT_TRUE(row_table.InsertTuple(MakeTuple(i), &rid, &txn));
+  }
+
+  // Only the requested columns are read from a PAX table.
+  int i = 0;
+  for (auto it = pax_table.Begin(&txn, {2}); it != pax_table.End(); ++it, ++i) {
+    EXPECT_TRUE(it->IsNull(schema_.get(), 0));
+    EXPECT_TRUE(it->IsNull(schema_.get(), 1));
+    EXPECT_EQ(i * 2, it->GetValue(schema_.get(), 2).GetAs<int32_t>());
+  }
+  EXPECT_EQ(200, i);
+
+  // A row table hands out whole tuples.
+  i = 0;
+  for (auto it = row_table.Begin(&txn, {2}); it != row_table.End(); ++it, ++i) {
+    EXPECT_EQ(i, it->GetValue(schema_.get(), 0).GetAs<int32_t>());
+    EXPECT_EQ(i * 2, it->GetValue(schema_.get(), 2).GetAs<int32_t>());
+  }
+  EXPECT_EQ(200, i);
+}
+
+// NOLINTNEXTLINE
+TEST(PaxTest, CreateTableTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  NoopWriter noop;
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE TABLE t (a INTEGER, b VARCHAR(16), c INTEGER) WITH (format = pax);", noop));
+  ASSERT_EQ(TableFormat::PAX, bustub->catalog_->GetTable("t")->table_->GetFormat());
+  ASSERT_TRUE(bustub->ExecuteSql("INSERT INTO t VALUES (1, 'a', 10), (2, 'b', 20), (3, 'c', 30);", noop));
+  ASSERT_TRUE(bustub->ExecuteSql("DELETE FROM t WHERE a = 2;", noop));
+
+  std::stringstream result;
+  SimpleStreamWriter writer(result, true, ",");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT * FROM t;", writer));
+  EXPECT_EQ("1,a,10,\n3,c,30,\n", result.str());
+
+  // The scan below the aggregation only reads the columns it uses.
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("EXPLAIN SELECT SUM(c) FROM t WHERE a > 1;", writer));
+  EXPECT_NE(std::string::npos, result.str().find("SeqScan { table=t, filter=(#0.0>1), columns=[0, 2] }"));
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT SUM(c) FROM t WHERE a > 1;", writer));
+  EXPECT_EQ("30,\n", result.str());
+
+  EXPECT_THROW(bustub->ExecuteSql("CREATE TABLE u (a INTEGER) WITH (format = columnar);", noop),
+               NotImplementedException);
+  EXPECT_THROW(bustub->ExecuteSql("CREATE TABLE u (a VARCHAR(8192)) WITH (format = pax);", noop), Exception);
+}
+
+}  // namespace bustub
@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_sample_test.cpp
+//
+// Identification: test/table/table_sample_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/bustub_instance.h"
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/table_scanner.h"
+#include "storage/table/tuple.h"
+#include "table_heap_test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class TableSampleTest : public TableHeapTestBase {
+ protected:
+  TableSampleTest() : TableHeapTestBase(50, {{"a", TypeId::INTEGER}, {"b", TypeId::VARCHAR, 100}}) {}
+
+  auto MakeTuple(int i) -> Tuple {
+    return Tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(100, 'x'))},
+                 schema_.get()};
+  }
+
+  /** @return the pages and the number of tuples visited by a scan of the sample */
+  static auto Scan(TableHeap *table, const TableSample &sample) -> std::pair<std::set<page_id_t>, size_t> {
+    std::set<page_id_t> page_ids;
+    size_t num_tuples = 0;
+    TableScanner scanner(table, std::nullopt, nullptr, nullptr, nullptr, sample);
+    while (scanner.NextPage([&](const TupleView &view) {
+      page_ids.insert(view.GetRid().GetPageId());
+      num_tuples++;
+    })) {
+    }
+    return {page_ids, num_tuples};
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(TableSampleTest, SampleTest) {
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), nullptr, nullptr, &txn, TableFormat::ROW, schema_.get());
+  const int num_tuples = 10000;
+  for (int i = 0; i < num_tuples; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(i), &rid, &txn));
+  }
+  auto num_pages = table.GetFreeSpaceMap()->Size();
+  ASSERT_GT(num_pages, 200);
+
+  // A block-level sample reads whole pages, about the requested share of them, and the same ones for the same seed.
+  TableSample system{TableSample::Method::SYSTEM, 25, 42};
+  auto page_ids = table.SamplePages(system);
+  EXPECT_NEAR(num_pages / 4.0, page_ids.size(), num_pages / 10.0);
+  auto [scanned_pages, scanned_tuples] = Scan(&table, system);
+  EXPECT_EQ(std::set<page_id_t>(page_ids.begin(), page_ids.end()), scanned_pages);
+  EXPECT_NEAR(num_tuples / 4.0, scanned_tuples, num_tuples / 10.0);
+  EXPECT_EQ(scanned_tuples, Scan(&table, system).second);
+  TableSample other_seed{TableSample::Method::SYSTEM, 25, 43};
+  EXPECT_NE(page_ids, table.SamplePages(other_seed));
+
+  EXPECT_EQ(num_pages, table.SamplePages({TableSample::Method::SYSTEM, 100, 1}).size());
+  EXPECT_TRUE(table.SamplePages({TableSample::Method::SYSTEM, 0, 1}).empty());
+  EXPECT_EQ(0, Scan(&table, {TableSample::Method::SYSTEM, 0, 1}).second);
+
+  // A row-level sample keeps tuples from almost every page.
+  auto [bernoulli_pages, bernoulli_tuples] = Scan(&table, {TableSample::Method::BERNOULLI, 25, 42});
+  EXPECT_NEAR(num_tuples / 4.0, bernoulli_tuples, num_tuples / 20.0);
+  EXPECT_GT(bernoulli_pages.size(), num_pages * 9 / 10);
+
+  // The size of the table is estimated from a few pages.
+  EXPECT_NEAR(num_tuples, table.EstimateTupleCount(), num_tuples / 5.0);
+  EXPECT_EQ(num_tuples, table.EstimateTupleCount(num_pages * 2));
+}
+
+// NOLINTNEXTLINE
+TEST(TableSampleSqlTest, TableSampleTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  NoopWriter noop;
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE TABLE t (a INTEGER, b VARCHAR(100));", noop));
+  std::string values;
+  for (int i = 0; i < 2000; i++) {
+    values += fmt::format("{}({}, '{}')", i == 0 ? "" : ", ", i, std::string(100, 'x'));
+  }
+  ASSERT_TRUE(bustub->ExecuteSql(fmt::format("INSERT INTO t VALUES {};", values), noop));
+
+  std::stringstream result;
+  SimpleStreamWriter writer(result, true, ",");
+  ASSERT_TRUE(
+      bustub->ExecuteSql("EXPLAIN SELECT a FROM t TABLESAMPLE SYSTEM (10) REPEATABLE (7) WHERE a > 5;", writer));
+  EXPECT_NE(std::string::npos, result.str().find("sample=SYSTEM(10) REPEATABLE(7)"));
+
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT COUNT(*) FROM t TABLESAMPLE SYSTEM (100);", writer));
+  EXPECT_EQ("2000,\n", result.str());
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT COUNT(*) FROM t TABLESAMPLE 0%;", writer));
+  EXPECT_EQ("0,\n", result.str());
+
+  // A repeatable sample returns the same tuples every time.
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT a FROM t TABLESAMPLE BERNOULLI (30) REPEATABLE (1);", writer));
+  auto first = result.str();
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT a FROM t TABLESAMPLE BERNOULLI (30) REPEATABLE (1);", writer));
+  EXPECT_EQ(first, result.str());
+  auto num_rows = std::count(first.begin(), first.end(), '\n');
+  EXPECT_NEAR(600, num_rows, 150);
+
+  EXPECT_THROW(bustub->ExecuteSql("SELECT * FROM t TABLESAMPLE RESERVOIR (10);", noop), NotImplementedException);
+  EXPECT_THROW(bustub->ExecuteSql("SELECT * FROM t TABLESAMPLE 10 ROWS;", noop), NotImplementedException);
+  EXPECT_THROW(bustub->ExecuteSql("SELECT * FROM t TABLESAMPLE SYSTEM (200);", noop), Exception);
+}
+
+}  // namespace bustub
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_scanner_test.cpp
+//
+// Identification: test/table/table_scanner_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/table_scanner.h"
+#include "storage/table/tuple.h"
+#include "table_heap_test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class TableScannerTest : public TableHeapTestBase {
+ protected:
+  /** Fill a table, delete the tuples in [100, 300) to leave empty pages, and scan it page by page. */
+  void ScanTest(TableFormat format) {
+    Transaction txn(0);
+    TableHeap table(bpm_.get(), nullptr, nullptr, &txn, format, schema_.get());
+    const int num_tuples = 1000;
+    std::vector<RID> rids;
+    for (int i = 0; i < num_tuples; i++) {
+      RID rid;
+      ASSERT_TRUE(table.InsertTuple(MakeTuple(i), &rid, &txn));
+      rids.push_back(rid);
+    }
+    for (int i = 100; i < 300; i++) {
+      ASSERT_TRUE(table.MarkDelete(rids[i], &txn));
+      table.ApplyDelete(rids[i], &txn);
+    }
+
+    TableScanner scanner(&table);
+    std::vector<Tuple> kept;
+    int num_visited = 0;
+    int num_pages = 0;
+    while (scanner.NextPage([&](const TupleView &view) {
+      EXPECT_EQ(rids[view.GetValue(schema_.get(), 0).GetAs<int32_t>()], view.GetRid());
+      if (view.GetValue(schema_.get(), 0).GetAs<int32_t>() % 100 == 0) {
+        kept.push_back(view.ToTuple());
+      }
+      num_visited++;
+    })) {
+      num_pages++;
+    }
+    EXPECT_EQ(num_tuples - 200, num_visited);
+    EXPECT_LT(1, num_pages);
+    EXPECT_FALSE(scanner.NextPage([](const TupleView &) { FAIL(); }));
+
+    // The tuples copied out of the views outlive the pages.
+    ASSERT_EQ(8, kept.size());
+    EXPECT_EQ(300, kept[1].GetValue(schema_.get(), 0).GetAs<int32_t>());
+    EXPECT_EQ("value-300", kept[1].GetValue(schema_.get(), 1).ToString());
+    EXPECT_EQ(rids[300], kept[1].GetRid());
+
+    // Only the requested columns are read from a PAX table, a row table hands out whole tuples.
+    TableScanner projecting(&table, std::vector<uint32_t>{2});
+    int i = 0;
+    while (projecting.NextPage([&](const TupleView &view) {
+      EXPECT_EQ(format == TableFormat::PAX, view.IsNull(schema_.get(), 0));
+      EXPECT_EQ(view.GetValue(schema_.get(), 2).GetAs<int32_t>(), (i < 100 ? i : i + 200) * 2);
+      i++;
+    })) {
+    }
+    EXPECT_EQ(num_tuples - 200, i);
+
+    // An open scanner keeps the empty pages from being freed.
+    {
+      TableScanner open_scanner(&table);
+      EXPECT_EQ(0, table.Vacuum());
+    }
+    EXPECT_LT(0, table.Vacuum());
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(TableScannerTest, RowScanTest) { ScanTest(TableFormat::ROW); }
+
+// NOLINTNEXTLINE
+TEST_F(TableScannerTest, PaxScanTest) { ScanTest(TableFormat::PAX); }
+
+// NOLINTNEXTLINE
+TEST_F(TableScannerTest, TupleViewTest) {
+  auto tuple = MakeTuple(7);
+  TupleView view(tuple);
+  EXPECT_EQ(tuple.GetData(), view.GetData());
+  EXPECT_EQ(tuple.GetLength(), view.GetLength());
+  EXPECT_EQ("value-7", view.GetValue(schema_.get(), 1).ToString());
+  EXPECT_FALSE(view.AsTuple().IsAllocated());
+
+  auto copy = view.ToTuple();
+  EXPECT_TRUE(copy.IsAllocated());
+  EXPECT_NE(tuple.GetData(), copy.GetData());
+  EXPECT_EQ(14, copy.GetValue(schema_.get(), 2).GetAs<int32_t>());
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableScannerTest, TupleMoveTest) {
+  auto tuple = MakeTuple(1);
+  const char *data = tuple.GetData();
+
+  // A moved tuple hands its data over without copying it.
+  Tuple moved(std::move(tuple));
+  EXPECT_EQ(data, moved.GetData());
+  EXPECT_EQ(nullptr, tuple.GetData());  // NOLINT
+  EXPECT_EQ(0, tuple.GetLength());      // NOLINT
+
+  Tuple assigned = MakeTuple(2);
+  assigned = std::move(moved);
+  EXPECT_EQ(data, assigned.GetData());
+  EXPECT_EQ("value-1", assigned.GetValue(schema_.get(), 1).ToString());
+
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 100; i++) {
+    tuples.push_back(MakeTuple(i));
+  }
+  EXPECT_EQ(99, tuples.back().GetValue(schema_.get(), 0).GetAs<int32_t>());
+}
+
+}  // namespace bustub
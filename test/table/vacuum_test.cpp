@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vacuum_test.cpp
+//
+// Identification: test/table/vacuum_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/bustub_instance.h"
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "table_heap_test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class VacuumTest : public TableHeapTestBase {
+ protected:
+  VacuumTest() : TableHeapTestBase(50, {{"a", TypeId::INTEGER}, {"b", TypeId::VARCHAR, 100}}) {}
+
+  auto MakeTuple(int i) -> Tuple {
+    return Tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(100, 'x'))},
+                 schema_.get()};
+  }
+
+  /** Insert tuples 0 to n - 1, then delete all but every tenth one. */
+  void Fill(TableHeap *table, int n, Transaction *txn) {
+    std::vector<RID> rids;
+    for (int i = 0; i < n; i++) {
+      RID rid;
+      ASSERT_TRUE(table->InsertTuple(MakeTuple(i), &rid, txn));
+      rids.push_back(rid);
+    }
+    for (int i = 0; i < n; i++) {
+      if (i % 10 != 0) {
+        table->ApplyDelete(rids[i], txn);
+      }
+    }
+  }
+
+  auto Scan(TableHeap *table, Transaction *txn) -> std::vector<int> {
+    std::vector<int> values;
+    for (auto it = table->Begin(txn); it != table->End(); ++it) {
+      values.push_back(it->GetValue(schema_.get(), 0).GetAs<int32_t>());
+    }
+    return values;
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(VacuumTest, FreeEmptyPagesTest) {
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), nullptr, nullptr, &txn);
+  // The tuples of a page are deleted together, so most pages end up empty.
+  std::vector<RID> rids;
+  for (int i = 0; i < 500; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(i), &rid, &txn));
+    rids.push_back(rid);
+  }
+  auto num_pages = table.GetFreeSpaceMap()->Size();
+  ASSERT_GT(num_pages, 10);
+  for (const auto &rid : rids) {
+    if (rid.GetPageId() != rids[100].GetPageId() && rid.GetPageId() != rids.back().GetPageId()) {
+      table.ApplyDelete(rid, &txn);
+    }
+  }
+  EXPECT_TRUE(table.NeedsVacuum());
+
+  // The first page stays as the head of the chain, the two pages with tuples are kept.
+  EXPECT_EQ(num_pages - 3, table.Vacuum());
+  EXPECT_EQ(3, table.GetFreeSpaceMap()->Size());
+  EXPECT_FALSE(table.NeedsVacuum());
+  EXPECT_EQ(0, table.Vacuum());
+
+  std::vector<int> expected;
+  for (int i = 0; i < 500; i++) {
+    if (rids[i].GetPageId() == rids[100].GetPageId() || rids[i].GetPageId() == rids.back().GetPageId()) {
+      expected.push_back(i);
+    }
+  }
+  EXPECT_EQ(expected, Scan(&table, &txn));
+
+  // New tuples fill the remaining pages first, then the chain grows from its new last page.
+  for (int i = 500; i < 1000; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(i), &rid, &txn));
+    expected.push_back(i);
+  }
+  auto values = Scan(&table, &txn);
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(expected, values);
+
+  // A reopened table heap walks the relinked chain.
+  TableHeap reopened(bpm_.get(), nullptr, nullptr, table.GetFirstPageId());
+  EXPECT_EQ(expected.size(), Scan(&reopened, &txn).size());
+}
+
+// NOLINTNEXTLINE
+TEST_F(VacuumTest, OpenScanTest) {
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), nullptr, nullptr, &txn);
+  std::vector<RID> rids;
+  for (int i = 0; i < 200; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(i), &rid, &txn));
+    rids.push_back(rid);
+  }
+  for (int i = 1; i < 200; i++) {
+    table.ApplyDelete(rids[i], &txn);
+  }
+
+  // Pages are not freed under an open scan, which may be about to walk them.
+  {
+    auto it = table.Begin(&txn);
+    EXPECT_EQ(0, table.Vacuum());
+    EXPECT_EQ(0, it->GetValue(schema_.get(), 0).GetAs<int32_t>());
+    ++it;
+    EXPECT_TRUE(it == table.End());
+  }
+  EXPECT_GT(table.Vacuum(), 0);
+  EXPECT_EQ(std::vector<int>{0}, Scan(&table, &txn));
+}
+
+// NOLINTNEXTLINE
+TEST_F(VacuumTest, PaxTest) {
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), nullptr, nullptr, &txn, TableFormat::PAX, schema_.get());
+  Fill(&table, 1000, &txn);
+  auto num_pages = table.GetFreeSpaceMap()->Size();
+  // Every page keeps a tenth of its tuples, so only the trailing free slots are trimmed.
+  EXPECT_EQ(0, table.Vacuum());
+  EXPECT_EQ(num_pages, table.GetFreeSpaceMap()->Size());
+
+  std::vector<int> expected;
+  for (int i = 0; i < 1000; i += 10) {
+    expected.push_back(i);
+  }
+  EXPECT_EQ(expected, Scan(&table, &txn));
+}
+
+// NOLINTNEXTLINE
+TEST(VacuumStatementTest, VacuumTableTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  NoopWriter noop;
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE TABLE t (a INTEGER, b VARCHAR(128));", noop));
+  std::string values;
+  for (int i = 0; i < 300; i++) {
+    values += fmt::format("{}({}, '{}')", i == 0 ? "" : ", ", i, std::string(100, 'x'));
+  }
+  ASSERT_TRUE(bustub->ExecuteSql("INSERT INTO t VALUES " + values + ";", noop));
+  ASSERT_TRUE(bustub->ExecuteSql("DELETE FROM t WHERE a > 0;", noop));
+
+  std::stringstream result;
+  SimpleStreamWriter writer(result, true, ",");
+  ASSERT_TRUE(bustub->ExecuteSql("VACUUM t;", writer));
+  EXPECT_NE("Vacuum freed 0 pages,\n", result.str());
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("VACUUM;", writer));
+  EXPECT_EQ("Vacuum freed 0 pages,\n", result.str());
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT a FROM t;", writer));
+  EXPECT_EQ("0,\n", result.str());
+
+  EXPECT_THROW(bustub->ExecuteSql("VACUUM ANALYZE t;", noop), NotImplementedException);
+  EXPECT_THROW(bustub->ExecuteSql("VACUUM u;", noop), Exception);
+}
+
+}  // namespace bustub
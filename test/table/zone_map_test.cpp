@@ -0,0 +1,189 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map_test.cpp
+//
+// Identification: test/table/zone_map_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/bustub_instance.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/zone_filter.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/table_scanner.h"
+#include "storage/table/tuple.h"
+#include "table_heap_test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class ZoneMapTest : public TableHeapTestBase {
+ protected:
+  /** A tuple whose c is NULL for every tenth i. */
+  auto MakeTuple(int i) -> Tuple {
+    auto c = i % 10 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i * 2);
+    return Tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue("value-" + std::to_string(i)), c},
+                 schema_.get()};
+  }
+
+  /** @return the expression `#0.column_idx comp_type value` */
+  static auto Compare(uint32_t column_idx, ComparisonType comp_type, int value) -> AbstractExpressionRef {
+    return std::make_shared<ComparisonExpression>(
+        std::make_shared<ColumnValueExpression>(0, column_idx, TypeId::INTEGER),
+        std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(value)), comp_type);
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(ZoneMapTest, MaintainTest) {
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), nullptr, nullptr, &txn, TableFormat::ROW, schema_.get());
+  auto *zone_map = table.GetZoneMap();
+  ASSERT_NE(nullptr, zone_map);
+  EXPECT_TRUE(zone_map->IsTracked(0));
+  EXPECT_FALSE(zone_map->IsTracked(1));
+  EXPECT_TRUE(zone_map->IsTracked(2));
+
+  const int num_tuples = 1000;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(i), &rid, &txn));
+    rids.push_back(rid);
+  }
+
+  // The tuples of the first page are [0, last].
+  auto first_page_id = rids[0].GetPageId();
+  int last = 0;
+  while (rids[last + 1].GetPageId() == first_page_id) {
+    last++;
+  }
+  auto zones = zone_map->GetZones(first_page_id);
+  ASSERT_TRUE(zones.has_value());
+  EXPECT_EQ(0, (*zones)[0].min_.GetAs<int32_t>());
+  EXPECT_EQ(last, (*zones)[0].max_.GetAs<int32_t>());
+  EXPECT_EQ(0, (*zones)[0].null_count_);
+  EXPECT_EQ(2, (*zones)[2].min_.GetAs<int32_t>());
+  EXPECT_EQ(static_cast<uint32_t>(last / 10 + 1), (*zones)[2].null_count_);
+
+  // Updates widen the zones; deletes leave them as they are.
+  ASSERT_TRUE(table.UpdateTuple(MakeTuple(-5), rids[11], &txn));
+  ASSERT_TRUE(table.MarkDelete(rids[last], &txn));
+  table.ApplyDelete(rids[last], &txn);
+  zones = zone_map->GetZones(first_page_id);
+  EXPECT_EQ(-5, (*zones)[0].min_.GetAs<int32_t>());
+  EXPECT_EQ(last, (*zones)[0].max_.GetAs<int32_t>());
+
+  // A vacuum forgets the pages it frees.
+  auto second_page_id = rids[last + 1].GetPageId();
+  for (int i = last + 1; i < num_tuples && rids[i].GetPageId() == second_page_id; i++) {
+    ASSERT_TRUE(table.MarkDelete(rids[i], &txn));
+    table.ApplyDelete(rids[i], &txn);
+  }
+  EXPECT_EQ(1, table.Vacuum());
+  EXPECT_FALSE(zone_map->GetZones(second_page_id).has_value());
+  EXPECT_TRUE(zone_map->GetZones(first_page_id).has_value());
+
+  // The pages of a reopened table are not summarized.
+  TableHeap reopened(bpm_.get(), nullptr, nullptr, table.GetFirstPageId(), TableFormat::ROW, schema_.get());
+  EXPECT_FALSE(reopened.GetZoneMap()->GetZones(first_page_id).has_value());
+}
+
+// NOLINTNEXTLINE
+TEST_F(ZoneMapTest, FilterTest) {
+  Transaction txn(0);
+  TableHeap table(bpm_.get(), nullptr, nullptr, &txn, TableFormat::PAX, schema_.get());
+  const int num_tuples = 2000;
+  std::set<page_id_t> page_ids;
+  for (int i = 0; i < num_tuples; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(i), &rid, &txn));
+    page_ids.insert(rid.GetPageId());
+  }
+  ASSERT_GT(page_ids.size(), 10);
+
+  auto count_pages = [&](const ZoneFilter &filter) {
+    size_t count = 0;
+    for (auto page_id : page_ids) {
+      count += filter.MayMatch(page_id) ? 1 : 0;
+    }
+    return count;
+  };
+
+  // A range matches one or two pages; the constant may be on either side.
+  auto range = std::make_shared<LogicExpression>(Compare(0, ComparisonType::GreaterThanOrEqual, 500),
+                                                 Compare(0, ComparisonType::LessThan, 520), LogicType::And);
+  ZoneFilter range_filter(range, table.GetZoneMap());
+  EXPECT_LE(count_pages(range_filter), 2);
+  auto flipped = std::make_shared<ComparisonExpression>(
+      std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(10)),
+      std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER), ComparisonType::GreaterThan);
+  EXPECT_EQ(1, count_pages(ZoneFilter(flipped, table.GetZoneMap())));
+  EXPECT_EQ(0, count_pages(ZoneFilter(Compare(2, ComparisonType::Equal, 1), table.GetZoneMap())));
+  EXPECT_EQ(page_ids.size(), count_pages(ZoneFilter(Compare(0, ComparisonType::NotEqual, 1), table.GetZoneMap())));
+
+  // A disjunction, or a predicate on an untracked column, cannot skip any page.
+  auto disjunction = std::make_shared<LogicExpression>(Compare(0, ComparisonType::Equal, 1),
+                                                       Compare(0, ComparisonType::Equal, 1500), LogicType::Or);
+  EXPECT_TRUE(ZoneFilter(disjunction, table.GetZoneMap()).IsEmpty());
+  EXPECT_TRUE(ZoneFilter(Compare(1, ComparisonType::Equal, 1), table.GetZoneMap()).IsEmpty());
+
+  // A scanner only visits the tuples of the pages the filter keeps, which include every tuple in the range.
+  TableScanner scanner(&table, std::nullopt, [&](page_id_t page_id) { return range_filter.MayMatch(page_id); });
+  int num_visited = 0;
+  int num_matched = 0;
+  while (scanner.NextPage([&](const TupleView &view) {
+    auto a = view.GetValue(schema_.get(), 0).GetAs<int32_t>();
+    num_visited++;
+    num_matched += a >= 500 && a < 520 ? 1 : 0;
+  })) {
+  }
+  EXPECT_EQ(20, num_matched);
+  EXPECT_LT(num_visited, num_tuples / 5);
+}
+
+// NOLINTNEXTLINE
+TEST(ZoneMapSqlTest, ScanTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  NoopWriter noop;
+  ASSERT_TRUE(bustub->ExecuteSql("CREATE TABLE t (a INTEGER, b VARCHAR(64));", noop));
+  for (int batch = 0; batch < 10; batch++) {
+    std::string sql = "INSERT INTO t VALUES ";
+    for (int i = batch * 200; i < (batch + 1) * 200; i++) {
+      auto separator = i + 1 < (batch + 1) * 200 ? ", " : ";";
+      sql += fmt::format("({}, 'a value long enough to fill some pages'){}", i, separator);
+    }
+    ASSERT_TRUE(bustub->ExecuteSql(sql, noop));
+  }
+  ASSERT_TRUE(bustub->ExecuteSql("DELETE FROM t WHERE a = 3;", noop));
+  ASSERT_TRUE(bustub->ExecuteSql("INSERT INTO t VALUES (5000, 'x');", noop));
+
+  std::stringstream result;
+  SimpleStreamWriter writer(result, true, ",");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT a FROM t WHERE a >= 1500 AND a < 1503;", writer));
+  EXPECT_EQ("1500,\n1501,\n1502,\n", result.str());
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT COUNT(*) FROM t WHERE a > 4000;", writer));
+  EXPECT_EQ("1,\n", result.str());
+  result.str("");
+  ASSERT_TRUE(bustub->ExecuteSql("SELECT COUNT(*) FROM t WHERE 100 > a;", writer));
+  EXPECT_EQ("99,\n", result.str());
+}
+
+}  // namespace bustub
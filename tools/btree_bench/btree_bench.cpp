@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "catalog/schema.h"
+#include "fmt/core.h"
+#include "storage/index/generic_key.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+/**
+ * Micro-benchmarks of the search and the insert of a B+ tree leaf page, for the current page layout, with separate
+ * key and value arrays, against the previous one, which interleaved keys and values in an array of pairs.
+ */
+
+/** The previous leaf layout: pairs of key and value, searched by binary search and shifted one pair at a time. */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class InterleavedLeaf {
+ public:
+  static constexpr int CAPACITY =
+      (bustub::BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<KeyType, ValueType>);
+
+  void Init() { size_ = 0; }
+
+  auto GetSize() const -> int { return size_; }
+
+  auto FindKeyIndex(int *index, const KeyType &key, const KeyComparator &comparator) const -> bool {
+    int left_index = 0;
+    int right_index = size_;
+    while (left_index < right_index) {
+      int middle_index = (left_index + right_index) >> 1;
+      if (comparator(array_[middle_index].first, key) >= 0) {
+        right_index = middle_index;
+      } else {
+        left_index = middle_index + 1;
+      }
+    }
+    *index = left_index;
+    return left_index < size_ && comparator(array_[left_index].first, key) == 0;
+  }
+
+  void InsertKeyValueAt(int index, const KeyType &key, const ValueType &value) {
+    for (int i = size_; i > index; i--) {
+      array_[i] = array_[i - 1];
+    }
+    array_[index] = {key, value};
+    size_++;
+  }
+
+ private:
+  int size_{0};
+  std::pair<KeyType, ValueType> array_[CAPACITY];
+};
+
+/** The current leaf layout, on a page sized buffer, filled with as many entries as the previous one. */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class SeparateLeaf {
+  using LeafPage = bustub::BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  static constexpr int CAPACITY =
+      std::min(InterleavedLeaf<KeyType, ValueType, KeyComparator>::CAPACITY, LeafPage::DEFAULT_MAX_SIZE);
+
+  void Init() { Page()->Init(0, bustub::INVALID_PAGE_ID, CAPACITY); }
+
+  auto GetSize() const -> int { return Page()->GetSize(); }
+
+  auto FindKeyIndex(int *index, const KeyType &key, const KeyComparator &comparator) const -> bool {
+    return Page()->FindKeyIndex(index, key, comparator);
+  }
+
+  void InsertKeyValueAt(int index, const KeyType &key, const ValueType &value) {
+    Page()->InsertKeyValueAt(index, key, value);
+  }
+
+ private:
+  auto Page() -> LeafPage * { return reinterpret_cast<LeafPage *>(data_); }
+  auto Page() const -> const LeafPage * { return reinterpret_cast<const LeafPage *>(data_); }
+
+  alignas(8) char data_[bustub::BUSTUB_PAGE_SIZE]{};
+};
+
+template <typename IntType, size_t KeySize>
+auto MakeKey(IntType value) -> bustub::GenericKey<KeySize> {
+  bustub::GenericKey<KeySize> key;
+  memcpy(key.data_, &value, sizeof(IntType));
+  return key;
+}
+
+/**
+ * Fill a leaf with random keys over and over, and look up random keys in the full leaf.
+ * @return the millions of inserts and of lookups per second
+ */
+template <typename Leaf, typename IntType, size_t KeySize, typename KeyComparator>
+auto RunLeafBench(const KeyComparator &comparator, size_t num_ops) -> std::pair<double, double> {
+  std::mt19937_64 generator(0);
+  std::uniform_int_distribution<IntType> distribution;
+  std::vector<bustub::GenericKey<KeySize>> keys(num_ops);
+  for (auto &key : keys) {
+    key = MakeKey<IntType, KeySize>(distribution(generator));
+  }
+  auto leaf = std::make_unique<Leaf>();
+  const int num_entries = Leaf::CAPACITY - 1;
+
+  auto start = std::chrono::steady_clock::now();
+  leaf->Init();
+  for (const auto &key : keys) {
+    if (leaf->GetSize() == num_entries) {
+      leaf->Init();
+    }
+    int index;
+    if (!leaf->FindKeyIndex(&index, key, comparator)) {
+      leaf->InsertKeyValueAt(index, key, bustub::RID());
+    }
+  }
+  std::chrono::duration<double> insert_seconds = std::chrono::steady_clock::now() - start;
+
+  leaf->Init();
+  for (int i = 0; i < num_entries; i++) {
+    int index;
+    auto key = MakeKey<IntType, KeySize>(static_cast<IntType>(i * 2));
+    leaf->FindKeyIndex(&index, key, comparator);
+    leaf->InsertKeyValueAt(index, key, bustub::RID());
+  }
+  std::uniform_int_distribution<IntType> lookup_distribution(0, num_entries * 2);
+  for (auto &key : keys) {
+    key = MakeKey<IntType, KeySize>(lookup_distribution(generator));
+  }
+  size_t num_found = 0;
+  start = std::chrono::steady_clock::now();
+  for (const auto &key : keys) {
+    int index;
+    num_found += static_cast<size_t>(leaf->FindKeyIndex(&index, key, comparator));
+  }
+  std::chrono::duration<double> lookup_seconds = std::chrono::steady_clock::now() - start;
+  if (num_found == 0) {
+    std::cerr << "no key found" << std::endl;
+  }
+  return {num_ops / insert_seconds.count() / 1e6, num_ops / lookup_seconds.count() / 1e6};
+}
+
+template <typename IntType, size_t KeySize>
+void RunKeyBench(const std::string &type_name, size_t num_ops) {
+  auto type = std::is_same_v<IntType, int32_t> ? bustub::TypeId::INTEGER : bustub::TypeId::BIGINT;
+  bustub::Schema key_schema({{"k", type}});
+  bustub::GenericComparator<KeySize> generic_comparator(&key_schema);
+  bustub::IntegerComparator<KeySize, IntType> integer_comparator(&key_schema);
+  using Key = bustub::GenericKey<KeySize>;
+  using GenericComparator = bustub::GenericComparator<KeySize>;
+  using IntegerComparator = bustub::IntegerComparator<KeySize, IntType>;
+
+  auto report = [&](const std::string &name, std::pair<double, double> result) {
+    fmt::print("{:<8}{:<40}{:>14.2f}{:>14.2f}\n", type_name, name, result.first, result.second);
+  };
+  report("interleaved, generic comparator",
+         RunLeafBench<InterleavedLeaf<Key, bustub::RID, GenericComparator>, IntType, KeySize>(generic_comparator,
+                                                                                              num_ops));
+  report("interleaved, integer comparator",
+         RunLeafBench<InterleavedLeaf<Key, bustub::RID, IntegerComparator>, IntType, KeySize>(integer_comparator,
+                                                                                              num_ops));
+  report("separate, generic comparator",
+         RunLeafBench<SeparateLeaf<Key, bustub::RID, GenericComparator>, IntType, KeySize>(generic_comparator,
+                                                                                           num_ops));
+  report("separate, integer comparator (SIMD)",
+         RunLeafBench<SeparateLeaf<Key, bustub::RID, IntegerComparator>, IntType, KeySize>(integer_comparator,
+                                                                                           num_ops));
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-btree-bench");
+  program.add_argument("--ops").help("number of inserts and of lookups of each benchmark");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_ops = 2000000;
+  if (program.present("--ops")) {
+    num_ops = std::stoul(program.get("--ops"));
+  }
+
+  fmt::print("{:<8}{:<40}{:>14}{:>14}\n", "key", "leaf layout", "M inserts/s", "M lookups/s");
+  RunKeyBench<int32_t, 4>("INTEGER", num_ops);
+  RunKeyBench<int64_t, 8>("BIGINT", num_ops);
+  return 0;
+}